@@ -1506,9 +1506,18 @@ static void *kvm_dirty_ring_reaper_thread(void *data)
         r->reaper_state = KVM_DIRTY_RING_REAPER_WAIT;
         trace_kvm_dirty_ring_reaper("wait");
         /*
-         * TODO: provide a smarter timeout rather than a constant?
+         * While dirty tracking is active (e.g. a migration is in
+         * flight), harvest aggressively: everything collected here is
+         * work the migration thread's synchronous kvm_dirty_ring_flush()
+         * no longer has to do with the BQL held, and full rings won't
+         * stall vcpus waiting for a reap.  Otherwise once a second is
+         * plenty to keep the rings from filling up.
          */
-        sleep(1);
+        if (qatomic_read(&global_dirty_tracking) & GLOBAL_DIRTY_MIGRATION) {
+            g_usleep(50 * 1000);
+        } else {
+            sleep(1);
+        }
 
         /* keep sleeping so that dirtylimit not be interfered by reaper */
         if (dirtylimit_in_service()) {
@@ -1973,6 +1982,10 @@ void kvm_add_routing_entry(KVMState *s,
     set_gsi(s, entry->gsi);
 }
 
+/*
+ * Returns 1 if the entry was modified, 0 if it matched the existing route
+ * (so no commit is needed), -ESRCH if the gsi has no route.
+ */
 static int kvm_update_routing_entry(KVMState *s,
                                     struct kvm_irq_routing_entry *new_entry)
 {
@@ -1991,7 +2004,7 @@ static int kvm_update_routing_entry(KVMState *s,
 
         *entry = *new_entry;
 
-        return 0;
+        return 1;
     }
 
     return -ESRCH;
@@ -0,0 +1,226 @@
+/*
+ * Tracing breakpoints: record hits without stopping the machine.
+ *
+ * Stopping every vCPU for each breakpoint or watchpoint hit makes the
+ * workload unrepresentative while it is being investigated.  A
+ * breakpoint or watchpoint inserted with BP_TRACE instead appends a
+ * record to a lock-free ring and lets the vCPU run on; the machine only
+ * stops once a configurable hit threshold is reached.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/atomic.h"
+#include "qemu/module.h"
+#include "qemu/timer.h"
+#include "qapi/error.h"
+#include "qapi/type-helpers.h"
+#include "qapi/qapi-commands-machine.h"
+#include "qapi/qmp/qdict.h"
+#include "monitor/monitor.h"
+#include "hw/core/cpu.h"
+#include "sysemu/tcg.h"
+#include "internal-common.h"
+
+/* Must be a power of 2. */
+#define BP_TRACE_RING_LEN 4096
+
+typedef struct BpTraceRecord {
+    uint64_t addr;
+    int64_t when;
+    uint32_t cpu_index;
+    uint32_t flags;
+} BpTraceRecord;
+
+static BpTraceRecord bp_trace_ring[BP_TRACE_RING_LEN];
+static unsigned bp_trace_next;
+static unsigned bp_trace_threshold;
+
+bool bp_trace_hit(CPUState *cpu, uint64_t addr, int flags,
+                  uint64_t hit_count)
+{
+    unsigned threshold = qatomic_read(&bp_trace_threshold);
+    unsigned i = qatomic_fetch_inc(&bp_trace_next) & (BP_TRACE_RING_LEN - 1);
+    BpTraceRecord *rec = &bp_trace_ring[i];
+
+    /*
+     * Each producer owns the slot it claimed above.  Readers copy
+     * records without taking a lock and tolerate the rare torn entry;
+     * this keeps the hot path down to an atomic increment.
+     */
+    rec->addr = addr;
+    rec->when = get_clock();
+    rec->cpu_index = cpu->cpu_index;
+    rec->flags = flags;
+
+    return threshold && hit_count >= threshold;
+}
+
+static const char *bp_trace_kind(int flags)
+{
+    switch (flags & BP_MEM_ACCESS) {
+    case BP_MEM_READ:
+        return "read";
+    case BP_MEM_WRITE:
+        return "write";
+    case BP_MEM_ACCESS:
+        return "access";
+    default:
+        return "exec";
+    }
+}
+
+HumanReadableText *qmp_x_query_trace_breakpoints(Error **errp)
+{
+    g_autoptr(GString) buf = g_string_new("");
+    unsigned threshold = qatomic_read(&bp_trace_threshold);
+    unsigned next, i;
+    CPUState *cpu;
+
+    if (!tcg_enabled()) {
+        error_setg(errp, "Tracing breakpoints require accel=tcg");
+        return NULL;
+    }
+
+    if (threshold) {
+        g_string_append_printf(buf, "stop threshold      %u hits\n",
+                               threshold);
+    } else {
+        g_string_append_printf(buf, "stop threshold      none\n");
+    }
+
+    CPU_FOREACH(cpu) {
+        CPUBreakpoint *bp;
+        CPUWatchpoint *wp;
+
+        QTAILQ_FOREACH(bp, &cpu->breakpoints, entry) {
+            if (bp->flags & BP_TRACE) {
+                g_string_append_printf(buf,
+                                       "CPU %d bp 0x%" PRIx64
+                                       "          hits %" PRIu64 "\n",
+                                       cpu->cpu_index, (uint64_t)bp->pc,
+                                       bp->hit_count);
+            }
+        }
+        QTAILQ_FOREACH(wp, &cpu->watchpoints, entry) {
+            if (wp->flags & BP_TRACE) {
+                g_string_append_printf(buf,
+                                       "CPU %d wp 0x%" PRIx64 " len %" PRIu64
+                                       " %s hits %" PRIu64 "\n",
+                                       cpu->cpu_index, (uint64_t)wp->vaddr,
+                                       (uint64_t)wp->len,
+                                       bp_trace_kind(wp->flags),
+                                       wp->hit_count);
+            }
+        }
+    }
+
+    next = qatomic_read(&bp_trace_next);
+    g_string_append_printf(buf, "recent hits (newest first):\n");
+    for (i = 0; i < 32 && i < next; i++) {
+        BpTraceRecord rec =
+            bp_trace_ring[(next - 1 - i) & (BP_TRACE_RING_LEN - 1)];
+
+        g_string_append_printf(buf,
+                               "  cpu %u %s 0x%" PRIx64 " at %" PRId64 " ns\n",
+                               rec.cpu_index, bp_trace_kind(rec.flags),
+                               rec.addr, rec.when);
+    }
+
+    return human_readable_text_from_str(buf);
+}
+
+static void hmp_trace_break(Monitor *mon, const QDict *qdict)
+{
+    bool delete = qdict_get_try_bool(qdict, "delete", false);
+    uint64_t addr = qdict_get_int(qdict, "addr");
+    CPUState *cpu;
+
+    if (!tcg_enabled()) {
+        monitor_printf(mon, "Tracing breakpoints require accel=tcg\n");
+        return;
+    }
+
+    CPU_FOREACH(cpu) {
+        int ret;
+
+        if (delete) {
+            ret = cpu_breakpoint_remove(cpu, addr, BP_TRACE);
+        } else {
+            ret = cpu_breakpoint_insert(cpu, addr, BP_TRACE, NULL);
+        }
+        if (ret < 0) {
+            monitor_printf(mon, "Could not %s tracing breakpoint on CPU %d\n",
+                           delete ? "remove" : "insert", cpu->cpu_index);
+            return;
+        }
+        /* Leave the current TB so the next lookup sees the breakpoint. */
+        cpu_exit(cpu);
+    }
+}
+
+static void hmp_trace_watch(Monitor *mon, const QDict *qdict)
+{
+    bool delete = qdict_get_try_bool(qdict, "delete", false);
+    uint64_t addr = qdict_get_int(qdict, "addr");
+    uint64_t len = qdict_get_int(qdict, "len");
+    const char *rw = qdict_get_try_str(qdict, "rw");
+    CPUState *cpu;
+    int flags;
+
+    if (!tcg_enabled()) {
+        monitor_printf(mon, "Tracing breakpoints require accel=tcg\n");
+        return;
+    }
+
+    if (!rw || !strcmp(rw, "w")) {
+        flags = BP_MEM_WRITE;
+    } else if (!strcmp(rw, "r")) {
+        flags = BP_MEM_READ;
+    } else if (!strcmp(rw, "rw")) {
+        flags = BP_MEM_ACCESS;
+    } else {
+        monitor_printf(mon, "Invalid access type '%s', expected r|w|rw\n", rw);
+        return;
+    }
+
+    CPU_FOREACH(cpu) {
+        int ret;
+
+        if (delete) {
+            ret = cpu_watchpoint_remove(cpu, addr, len, flags | BP_TRACE);
+        } else {
+            ret = cpu_watchpoint_insert(cpu, addr, len, flags | BP_TRACE,
+                                        NULL);
+        }
+        if (ret < 0) {
+            monitor_printf(mon, "Could not %s tracing watchpoint on CPU %d\n",
+                           delete ? "remove" : "insert", cpu->cpu_index);
+            return;
+        }
+    }
+}
+
+static void hmp_trace_break_threshold(Monitor *mon, const QDict *qdict)
+{
+    int64_t count = qdict_get_int(qdict, "count");
+
+    if (count < 0 || count > UINT32_MAX) {
+        monitor_printf(mon, "Invalid threshold\n");
+        return;
+    }
+    qatomic_set(&bp_trace_threshold, count);
+}
+
+static void bp_trace_register(void)
+{
+    monitor_register_hmp("trace-break", false, hmp_trace_break);
+    monitor_register_hmp("trace-watch", false, hmp_trace_watch);
+    monitor_register_hmp("trace-break-threshold", false,
+                         hmp_trace_break_threshold);
+    monitor_register_hmp_info_hrt("trace-breakpoints",
+                                  qmp_x_query_trace_breakpoints);
+}
+
+type_init(bp_trace_register);
@@ -245,6 +245,27 @@ static TranslationBlock *tb_htable_lookup(CPUState *cpu, vaddr pc,
     return qht_lookup_custom(&tb_ctx.htable, &desc, h, tb_lookup_cmp);
 }
 
+/*
+ * Install @tb for @pc in its primary jump cache slot, displacing the
+ * current occupant to the alternate slot.  A displaced entry that was
+ * concurrently invalidated is harmless: lookups reject it through the
+ * CF_INVALID check, exactly as for a stale entry left in place.
+ */
+static inline void tb_jmp_cache_insert(CPUJumpCache *jc, uint32_t hash,
+                                       TranslationBlock *tb, vaddr pc)
+{
+    TranslationBlock *old = qatomic_read(&jc->array[hash].tb);
+
+    if (old && old != tb) {
+        uint32_t alt = TB_JMP_CACHE_ALT(hash);
+
+        jc->array[alt].pc = jc->array[hash].pc;
+        qatomic_set(&jc->array[alt].tb, old);
+    }
+    jc->array[hash].pc = pc;
+    qatomic_set(&jc->array[hash].tb, tb);
+}
+
 /* Might cause an exception, so have a longjmp destination ready */
 static inline TranslationBlock *tb_lookup(CPUState *cpu, vaddr pc,
                                           uint64_t cs_base, uint32_t flags,
@@ -252,7 +273,7 @@ static inline TranslationBlock *tb_lookup(CPUState *cpu, vaddr pc,
 {
     TranslationBlock *tb;
     CPUJumpCache *jc;
-    uint32_t hash;
+    uint32_t hash, alt;
 
     /* we should never be trying to look up an INVALID tb */
     tcg_debug_assert(!(cflags & CF_INVALID));
@@ -269,13 +290,23 @@ static inline TranslationBlock *tb_lookup(CPUState *cpu, vaddr pc,
         goto hit;
     }
 
+    /* Second-chance probe of the alternate slot. */
+    alt = TB_JMP_CACHE_ALT(hash);
+    tb = qatomic_read(&jc->array[alt].tb);
+    if (tb &&
+        jc->array[alt].pc == pc &&
+        tb->cs_base == cs_base &&
+        tb->flags == flags &&
+        tb_cflags(tb) == cflags) {
+        goto hit;
+    }
+
     tb = tb_htable_lookup(cpu, pc, cs_base, flags, cflags);
     if (tb == NULL) {
         return NULL;
     }
 
-    jc->array[hash].pc = pc;
-    qatomic_set(&jc->array[hash].tb, tb);
+    tb_jmp_cache_insert(jc, hash, tb, pc);
 
 hit:
     /*
@@ -283,6 +314,8 @@ hit:
      * the virtual PC has to match for non-CF_PCREL translations.
      */
     assert((tb_cflags(tb) & CF_PCREL) || tb->pc == pc);
+    /* Start pulling in the translated code before we branch to it. */
+    __builtin_prefetch(tb->tc.ptr);
     return tb;
 }
 
@@ -344,7 +377,18 @@ static bool check_for_breakpoints_slow(CPUState *cpu, vaddr pc,
         if (pc == bp->pc) {
             bool match_bp = false;
 
-            if (bp->flags & BP_GDB) {
+            if (bp->flags & BP_TRACE) {
+#ifdef CONFIG_USER_ONLY
+                g_assert_not_reached();
+#else
+                /*
+                 * Tracing breakpoints record the hit and let the vCPU
+                 * run on, unless the stop threshold has been reached.
+                 */
+                bp->hit_count++;
+                match_bp = bp_trace_hit(cpu, pc, bp->flags, bp->hit_count);
+#endif
+            } else if (bp->flags & BP_GDB) {
                 match_bp = true;
             } else if (bp->flags & BP_CPU) {
 #ifdef CONFIG_USER_ONLY
@@ -390,17 +434,75 @@ static inline bool check_for_breakpoints(CPUState *cpu, vaddr pc,
         check_for_breakpoints_slow(cpu, pc, cflags);
 }
 
+/*
+ * Probe @last_tb's inline cache of indirect branch targets.  Entries
+ * are mere hints; a hit requires the target block to match the cpu
+ * state, and entries filled before the last code buffer reclamation
+ * are rejected wholesale via the flush count stamp, as they may point
+ * into recycled regions.  With CF_PCREL the target's stored pc cannot
+ * be validated, so the cache is not used.
+ */
+static inline TranslationBlock *tb_indirect_cache_lookup(
+    TranslationBlock *last_tb, vaddr pc, uint64_t cs_base,
+    uint32_t flags, uint32_t cflags)
+{
+    unsigned i;
+
+    if (cflags & CF_PCREL) {
+        return NULL;
+    }
+    if (qatomic_load_acquire(&last_tb->indirect_flush_count) !=
+        qatomic_read(&tb_ctx.tb_flush_count)) {
+        return NULL;
+    }
+    for (i = 0; i < TB_INDIRECT_CACHE_SIZE; i++) {
+        TranslationBlock *tb = qatomic_read(&last_tb->indirect[i].tb);
+
+        if (tb &&
+            tb->pc == pc &&
+            tb->cs_base == cs_base &&
+            tb->flags == flags &&
+            tb_cflags(tb) == cflags) {
+            return tb;
+        }
+    }
+    return NULL;
+}
+
+static inline void tb_indirect_cache_insert(TranslationBlock *last_tb,
+                                            TranslationBlock *tb, vaddr pc)
+{
+    unsigned cur = qatomic_read(&tb_ctx.tb_flush_count);
+    unsigned i;
+
+    if (tb->cflags & CF_PCREL) {
+        return;
+    }
+    if (qatomic_read(&last_tb->indirect_flush_count) != cur) {
+        for (i = 0; i < TB_INDIRECT_CACHE_SIZE; i++) {
+            qatomic_set(&last_tb->indirect[i].tb, NULL);
+        }
+        /* Order the clears before unstale entries become acceptable. */
+        qatomic_store_release(&last_tb->indirect_flush_count, cur);
+    }
+    i = (pc >> 2) & (TB_INDIRECT_CACHE_SIZE - 1);
+    last_tb->indirect[i].pc = pc;
+    qatomic_set(&last_tb->indirect[i].tb, tb);
+}
+
 /**
  * helper_lookup_tb_ptr: quick check for next tb
  * @env: current cpu state
+ * @source: the TB issuing the indirect branch
  *
  * Look for an existing TB matching the current cpu state.
  * If found, return the code pointer.  If not found, return
  * the tcg epilogue so that we return into cpu_tb_exec.
  */
-const void *HELPER(lookup_tb_ptr)(CPUArchState *env)
+const void *HELPER(lookup_tb_ptr)(CPUArchState *env, void *source)
 {
     CPUState *cpu = env_cpu(env);
+    TranslationBlock *last_tb = source;
     TranslationBlock *tb;
     vaddr pc;
     uint64_t cs_base;
@@ -421,9 +523,13 @@ const void *HELPER(lookup_tb_ptr)(CPUArchState *env)
         cpu_loop_exit(cpu);
     }
 
-    tb = tb_lookup(cpu, pc, cs_base, flags, cflags);
+    tb = tb_indirect_cache_lookup(last_tb, pc, cs_base, flags, cflags);
     if (tb == NULL) {
-        return tcg_code_gen_epilogue;
+        tb = tb_lookup(cpu, pc, cs_base, flags, cflags);
+        if (tb == NULL) {
+            return tcg_code_gen_epilogue;
+        }
+        tb_indirect_cache_insert(last_tb, tb, pc);
     }
 
     if (qemu_loglevel_mask(CPU_LOG_TB_CPU | CPU_LOG_EXEC)) {
@@ -433,6 +539,12 @@ const void *HELPER(lookup_tb_ptr)(CPUArchState *env)
     return tb->tc.ptr;
 }
 
+/*
+ * Execution count at which a TB ending in a direct jump is invalidated
+ * and retranslated once as an extended region; see region_extend_pc.
+ */
+#define TB_REGION_EXTEND_THRESHOLD 2048
+
 /* Execute a TB, and fix up the CPU state afterwards if necessary */
 /*
  * Disable CFI checks.
@@ -454,6 +566,26 @@ cpu_tb_exec(CPUState *cpu, TranslationBlock *itb, int *tb_exit)
         log_cpu_exec(log_pc(cpu, itb), cpu, itb);
     }
 
+    /* Approximate hotness signal; see the field's documentation. */
+    qatomic_set(&itb->exec_count, itb->exec_count + 1);
+
+    /*
+     * Once a TB that chains onward proves hot, invalidate it and leave a
+     * hint so that its retranslation may continue through the trailing
+     * direct jump, keeping globals in host registers across the old
+     * block boundary.  The current code stays runnable until the next
+     * lookup misses; a concurrent invalidation is harmless since
+     * do_tb_phys_invalidate bails out when the TB is already gone.
+     */
+    if (unlikely(itb->exec_count == TB_REGION_EXTEND_THRESHOLD) &&
+        !itb->region_extended && !(itb->cflags & CF_PCREL) &&
+        itb->jmp_reset_offset[0] != TB_JMP_OFFSET_INVALID) {
+        cpu->region_extend_pc = itb->pc;
+        mmap_lock();
+        tb_phys_invalidate(itb, -1);
+        mmap_unlock();
+    }
+
     qemu_thread_jit_execute();
     ret = tcg_qemu_tb_exec(cpu_env(cpu), tb_ptr);
     cpu->neg.can_do_io = true;
@@ -946,6 +1078,48 @@ static inline void cpu_loop_exec_tb(CPUState *cpu, TranslationBlock *tb,
 #endif
 }
 
+/*
+ * Maximum number of additional straight-line blocks translated on one
+ * htable miss.  Translating a run of blocks under a single mmap_lock
+ * amortizes the per-miss stall for cold code; anything not executed is
+ * reclaimed with the rest of the code cache.
+ */
+#define TB_TRANSLATE_AHEAD_MAX 4
+
+static void tb_translate_ahead(CPUState *cpu, TranslationBlock *tb,
+                               vaddr pc, uint64_t cs_base,
+                               uint32_t flags, uint32_t cflags)
+{
+    vaddr page_end = (pc & TARGET_PAGE_MASK) + TARGET_PAGE_SIZE;
+    int i;
+
+    /*
+     * Speculative translation must never raise a guest fault.  We stop
+     * at the page boundary below, but a block starting near the end of
+     * the page may still span into the next one; refuse to speculate
+     * unless that page is known to be executable too.
+     */
+#ifdef CONFIG_USER_ONLY
+    if (!(page_get_flags(page_end) & PAGE_EXEC)) {
+        return;
+    }
+#else
+    if (get_page_addr_code(cpu_env(cpu), page_end) == -1) {
+        return;
+    }
+#endif
+
+    for (i = 0; i < TB_TRANSLATE_AHEAD_MAX; i++) {
+        vaddr next_pc = pc + tb->size;
+
+        if (tb->size == 0 || next_pc >= page_end) {
+            break;
+        }
+        tb = tb_gen_code(cpu, next_pc, cs_base, flags, cflags);
+        pc = next_pc;
+    }
+}
+
 /* main execution loop */
 
 static int __attribute__((noinline))
@@ -953,6 +1127,11 @@ cpu_exec_loop(CPUState *cpu, SyncClocks *sc)
 {
     int ret;
 
+    /* Bulk-translate blocks recorded by a previous run, if requested. */
+    if (unlikely(tb_prewarm_pending())) {
+        tb_prewarm_replay(cpu);
+    }
+
     /* if an exception is pending, we execute it here */
     while (!cpu_handle_exception(cpu, &ret)) {
         TranslationBlock *last_tb = NULL;
@@ -991,6 +1170,14 @@ cpu_exec_loop(CPUState *cpu, SyncClocks *sc)
 
                 mmap_lock();
                 tb = tb_gen_code(cpu, pc, cs_base, flags, cflags);
+                /*
+                 * Batch translation of the straight-line successors
+                 * while we already hold the lock, unless cflags ask
+                 * for a restricted (counted) translation.
+                 */
+                if ((cflags & CF_COUNT_MASK) == 0) {
+                    tb_translate_ahead(cpu, tb, pc, cs_base, flags, cflags);
+                }
                 mmap_unlock();
 
                 /*
@@ -999,8 +1186,7 @@ cpu_exec_loop(CPUState *cpu, SyncClocks *sc)
                  */
                 h = tb_jmp_cache_hash_func(pc);
                 jc = cpu->tb_jmp_cache;
-                jc->array[h].pc = pc;
-                qatomic_set(&jc->array[h].tb, tb);
+                tb_jmp_cache_insert(jc, h, tb, pc);
             }
 
 #ifndef CONFIG_USER_ONLY
@@ -1092,6 +1278,24 @@ bool tcg_exec_realizefn(CPUState *cpu, Error **errp)
     return true;
 }
 
+/*
+ * Replace the jump cache with a freshly allocated one.  Called from the
+ * vCPU thread itself once it starts, so that first-touch places the
+ * cache on the thread's local NUMA node; the cache allocated at realize
+ * time was faulted in by whichever thread created the vCPU and may be
+ * remote.  The swap is safe because it happens before the vCPU executes
+ * any TB: the replacement starts out empty, i.e. flushed, so concurrent
+ * invalidations of the old cache cannot be lost, and readers are
+ * protected by RCU.
+ */
+void tcg_realloc_jmp_cache(CPUState *cpu)
+{
+    CPUJumpCache *old = cpu->tb_jmp_cache;
+
+    qatomic_rcu_set(&cpu->tb_jmp_cache, g_new0(CPUJumpCache, 1));
+    g_free_rcu(old, rcu);
+}
+
 /* undo the initializations in reverse order */
 void tcg_exec_unrealizefn(CPUState *cpu)
 {
@@ -225,7 +225,14 @@ static void tlb_mmu_resize_locked(CPUTLBDesc *desc, CPUTLBDescFast *fast,
     rate = desc->window_max_entries * 100 / old_size;
 
     if (rate > 70) {
-        new_size = MIN(old_size << 1, 1 << CPU_TLB_DYN_MAX_BITS);
+        /*
+         * A use rate above 90% means the TLB is badly undersized for
+         * the current working set and conflict misses dominate; skip
+         * one doubling step to converge faster.
+         */
+        size_t grown = rate > 90 ? old_size << 2 : old_size << 1;
+
+        new_size = MIN(grown, 1 << CPU_TLB_DYN_MAX_BITS);
     } else if (rate < 30 && window_expired) {
         size_t ceil = pow2ceil(desc->window_max_entries);
         size_t expected_rate = desc->window_max_entries * 100 / ceil;
@@ -2345,6 +2352,20 @@ static uint16_t do_ld2_mmu(CPUState *cpu, vaddr addr, MemOpIdx oi,
     return ret;
 }
 
+/*
+ * Cross-page accesses are assembled byte-wise even when both halves are
+ * plain RAM.  If the two guest pages are also adjacent in the host
+ * address space, a single unaligned host access produces the same bytes
+ * in one go.  Restricted to MO_ATOM_NONE, where the byte-wise path it
+ * replaces guarantees no subobject atomicity either.
+ */
+static bool mmu_crosspage_contiguous(MMULookupLocals *l, int slow_flags)
+{
+    return (l->memop & MO_ATOM_MASK) == MO_ATOM_NONE &&
+           !((l->page[0].flags | l->page[1].flags) & slow_flags) &&
+           l->page[0].haddr + l->page[0].size == l->page[1].haddr;
+}
+
 static uint32_t do_ld4_mmu(CPUState *cpu, vaddr addr, MemOpIdx oi,
                            uintptr_t ra, MMUAccessType access_type)
 {
@@ -2358,6 +2379,12 @@ static uint32_t do_ld4_mmu(CPUState *cpu, vaddr addr, MemOpIdx oi,
         return do_ld_4(cpu, &l.page[0], l.mmu_idx, access_type, l.memop, ra);
     }
 
+    if (mmu_crosspage_contiguous(&l, TLB_MMIO)) {
+        return (l.memop & MO_BSWAP) == MO_LE
+               ? ldl_le_p(l.page[0].haddr)
+               : ldl_be_p(l.page[0].haddr);
+    }
+
     ret = do_ld_beN(cpu, &l.page[0], 0, l.mmu_idx, access_type, l.memop, ra);
     ret = do_ld_beN(cpu, &l.page[1], ret, l.mmu_idx, access_type, l.memop, ra);
     if ((l.memop & MO_BSWAP) == MO_LE) {
@@ -2379,6 +2406,12 @@ static uint64_t do_ld8_mmu(CPUState *cpu, vaddr addr, MemOpIdx oi,
         return do_ld_8(cpu, &l.page[0], l.mmu_idx, access_type, l.memop, ra);
     }
 
+    if (mmu_crosspage_contiguous(&l, TLB_MMIO)) {
+        return (l.memop & MO_BSWAP) == MO_LE
+               ? ldq_le_p(l.page[0].haddr)
+               : ldq_be_p(l.page[0].haddr);
+    }
+
     ret = do_ld_beN(cpu, &l.page[0], 0, l.mmu_idx, access_type, l.memop, ra);
     ret = do_ld_beN(cpu, &l.page[1], ret, l.mmu_idx, access_type, l.memop, ra);
     if ((l.memop & MO_BSWAP) == MO_LE) {
@@ -2771,6 +2804,10 @@ static void do_st4_mmu(CPUState *cpu, vaddr addr, uint32_t val,
     if ((l.memop & MO_BSWAP) != MO_LE) {
         val = bswap32(val);
     }
+    if (mmu_crosspage_contiguous(&l, TLB_MMIO | TLB_DISCARD_WRITE)) {
+        stl_le_p(l.page[0].haddr, val);
+        return;
+    }
     val = do_st_leN(cpu, &l.page[0], val, l.mmu_idx, l.memop, ra);
     (void) do_st_leN(cpu, &l.page[1], val, l.mmu_idx, l.memop, ra);
 }
@@ -2792,6 +2829,10 @@ static void do_st8_mmu(CPUState *cpu, vaddr addr, uint64_t val,
     if ((l.memop & MO_BSWAP) != MO_LE) {
         val = bswap64(val);
     }
+    if (mmu_crosspage_contiguous(&l, TLB_MMIO | TLB_DISCARD_WRITE)) {
+        stq_le_p(l.page[0].haddr, val);
+        return;
+    }
     val = do_st_leN(cpu, &l.page[0], val, l.mmu_idx, l.memop, ra);
     (void) do_st_leN(cpu, &l.page[1], val, l.mmu_idx, l.memop, ra);
 }
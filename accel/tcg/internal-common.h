@@ -55,5 +55,20 @@ void cpu_restore_state_from_tb(CPUState *cpu, TranslationBlock *tb,
 
 bool tcg_exec_realizefn(CPUState *cpu, Error **errp);
 void tcg_exec_unrealizefn(CPUState *cpu);
+void tcg_realloc_jmp_cache(CPUState *cpu);
+
+/* tb-prewarm.c */
+void tb_prewarm_init(const char *path);
+bool tb_prewarm_pending(void);
+void tb_prewarm_replay(CPUState *cpu);
+
+/*
+ * bp-trace.c
+ * Record a BP_TRACE breakpoint/watchpoint hit without stopping the
+ * vCPU.  Returns true if the stop threshold has been reached and the
+ * caller should raise a debug exception after all.
+ */
+bool bp_trace_hit(CPUState *cpu, uint64_t addr, int flags,
+                  uint64_t hit_count);
 
 #endif
@@ -16,6 +16,7 @@
 #include "sysemu/cpus.h"
 #include "sysemu/cpu-timers.h"
 #include "sysemu/tcg.h"
+#include "tcg/perf.h"
 #include "tcg/tcg.h"
 #include "internal-common.h"
 #include "tb-context.h"
@@ -91,6 +92,11 @@ static void print_qht_statistics(struct qht_stats hst, GString *buf)
                            "Histogram: %s\n",
                            qdist_avg(&hst.chain), hgram);
     g_free(hgram);
+
+    g_string_append_printf(buf, "TB hash resizes     %zu "
+                           "(writers stalled %0.3f ms total)\n",
+                           hst.n_resizes,
+                           (double)hst.resize_stall_ns / SCALE_MS);
 }
 
 struct tb_tree_stats {
@@ -126,6 +132,64 @@ static gboolean tb_tree_stats_iter(gpointer key, gpointer value, gpointer data)
     return false;
 }
 
+#define HOT_TB_MAX 10
+
+struct hot_tb_stats {
+    const TranslationBlock *tb[HOT_TB_MAX];
+    uint32_t count[HOT_TB_MAX];
+    size_t nb;
+};
+
+static gboolean hot_tb_stats_iter(gpointer key, gpointer value, gpointer data)
+{
+    const TranslationBlock *tb = value;
+    struct hot_tb_stats *hot = data;
+    uint32_t count = qatomic_read(&tb->exec_count);
+    size_t i;
+
+    if (tb_cflags(tb) & CF_INVALID) {
+        return false;
+    }
+    if (hot->nb == HOT_TB_MAX && count <= hot->count[HOT_TB_MAX - 1]) {
+        return false;
+    }
+    if (hot->nb < HOT_TB_MAX) {
+        hot->nb++;
+    }
+    for (i = hot->nb - 1; i > 0 && hot->count[i - 1] < count; i--) {
+        hot->tb[i] = hot->tb[i - 1];
+        hot->count[i] = hot->count[i - 1];
+    }
+    hot->tb[i] = tb;
+    hot->count[i] = count;
+    return false;
+}
+
+static void dump_hot_tbs(GString *buf)
+{
+    struct hot_tb_stats hot = {};
+    size_t i;
+
+    tcg_tb_foreach(hot_tb_stats_iter, &hot);
+    if (!hot.nb || !hot.count[0]) {
+        return;
+    }
+
+    g_string_append_printf(buf, "\nHottest TBs (by main-loop entry count):\n");
+    for (i = 0; i < hot.nb && hot.count[i]; i++) {
+        const TranslationBlock *tb = hot.tb[i];
+
+        if (tb_cflags(tb) & CF_PCREL) {
+            g_string_append_printf(buf, "  pc=(pcrel)");
+        } else {
+            g_string_append_printf(buf, "  pc=0x%" VADDR_PRIx, tb->pc);
+        }
+        g_string_append_printf(buf,
+                               " size=%u host=%zu flags=0x%08x count=%u\n",
+                               tb->size, tb->tc.size, tb->flags, hot.count[i]);
+    }
+}
+
 static void tlb_flush_counts(size_t *pfull, size_t *ppart, size_t *pelide)
 {
     CPUState *cpu;
@@ -151,6 +215,7 @@ static void dump_exec_info(GString *buf)
     struct tb_tree_stats tst = {};
     struct qht_stats hst;
     size_t nb_tbs, flush_full, flush_part, flush_elide;
+    uint64_t itlb_misses;
 
     tcg_tb_foreach(tb_tree_stats_iter, &tst);
     nb_tbs = tst.nb_tbs;
@@ -186,6 +251,8 @@ static void dump_exec_info(GString *buf)
     print_qht_statistics(hst, buf);
     qht_statistics_destroy(&hst);
 
+    dump_hot_tbs(buf);
+
     g_string_append_printf(buf, "\nStatistics:\n");
     g_string_append_printf(buf, "TB flush count      %u\n",
                            qatomic_read(&tb_ctx.tb_flush_count));
@@ -196,6 +263,10 @@ static void dump_exec_info(GString *buf)
     g_string_append_printf(buf, "TLB full flushes    %zu\n", flush_full);
     g_string_append_printf(buf, "TLB partial flushes %zu\n", flush_part);
     g_string_append_printf(buf, "TLB elided flushes  %zu\n", flush_elide);
+    if (perf_itlb_misses(&itlb_misses)) {
+        g_string_append_printf(buf, "host iTLB misses    %" PRIu64 "\n",
+                               itlb_misses);
+    }
     tcg_dump_info(buf);
 }
 
@@ -200,6 +200,33 @@ static void gen_inline_store_u64_cb(struct qemu_plugin_inline_cb *cb)
     tcg_temp_free_ptr(ptr);
 }
 
+static void gen_inline_range_cb(struct qemu_plugin_inline_range_cb *cb,
+                                bool is_store, TCGv_i64 addr)
+{
+    TCGLabel *after_op = gen_new_label();
+
+    tcg_gen_brcondi_i64(TCG_COND_LTU, addr, cb->low, after_op);
+    tcg_gen_brcondi_i64(TCG_COND_GTU, addr, cb->high, after_op);
+
+    {
+        TCGv_ptr ptr = gen_plugin_u64_ptr(cb->entry);
+
+        if (is_store) {
+            tcg_gen_st_i64(tcg_constant_i64(cb->imm), ptr, 0);
+        } else {
+            TCGv_i64 val = tcg_temp_ebb_new_i64();
+
+            tcg_gen_ld_i64(val, ptr, 0);
+            tcg_gen_addi_i64(val, val, cb->imm);
+            tcg_gen_st_i64(val, ptr, 0);
+            tcg_temp_free_i64(val);
+        }
+        tcg_temp_free_ptr(ptr);
+    }
+
+    gen_set_label(after_op);
+}
+
 static void gen_mem_cb(struct qemu_plugin_regular_cb *cb,
                        qemu_plugin_meminfo_t meminfo, TCGv_i64 addr)
 {
@@ -249,6 +276,14 @@ static void inject_mem_cb(struct qemu_plugin_dyn_cb *cb,
             inject_cb(cb);
         }
         break;
+    case PLUGIN_CB_INLINE_RANGE_ADD_U64:
+    case PLUGIN_CB_INLINE_RANGE_STORE_U64:
+        if (rw & cb->inline_range.rw) {
+            gen_inline_range_cb(&cb->inline_range,
+                                cb->type == PLUGIN_CB_INLINE_RANGE_STORE_U64,
+                                addr);
+        }
+        break;
     default:
         g_assert_not_reached();
     }
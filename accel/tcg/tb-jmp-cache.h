@@ -30,4 +30,13 @@ typedef struct CPUJumpCache {
     } array[TB_JMP_CACHE_SIZE];
 } CPUJumpCache;
 
+/*
+ * The cache is pseudo two-way associative: a pc whose primary slot is
+ * taken may also live in the neighbouring slot, to which the previous
+ * occupant is displaced on insertion.  Using the adjacent index keeps
+ * both probes in one cache line, and in softmmu it stays within the
+ * same TB_JMP_PAGE group so per-page invalidation still covers it.
+ */
+#define TB_JMP_CACHE_ALT(hash)  ((hash) ^ 1)
+
 #endif /* ACCEL_TCG_TB_JMP_CACHE_H */
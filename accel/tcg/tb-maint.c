@@ -756,6 +756,17 @@ static void tb_remove(TranslationBlock *tb)
 #endif /* CONFIG_USER_ONLY */
 
 /* flush all the translation blocks */
+static void tb_region_evict(TranslationBlock *tb)
+{
+    /*
+     * The region tree also holds blocks that were invalidated earlier
+     * and have already been unlinked; those need no further work.
+     */
+    if (!(tb_cflags(tb) & CF_INVALID)) {
+        tb_phys_invalidate(tb, -1);
+    }
+}
+
 static void do_tb_flush(CPUState *cpu, run_on_cpu_data tb_flush_count)
 {
     bool did_flush = false;
@@ -767,6 +778,17 @@ static void do_tb_flush(CPUState *cpu, run_on_cpu_data tb_flush_count)
     }
     did_flush = true;
 
+    /*
+     * Before throwing away the whole code cache, try to reclaim only
+     * the oldest filled regions.  Hot blocks evicted this way are
+     * retranslated on demand, while the rest of the cache survives:
+     * cache pressure no longer costs a full retranslation of the guest.
+     */
+    if (tcg_region_evict_cold(tb_region_evict) != 0) {
+        qatomic_inc(&tb_ctx.tb_flush_count);
+        goto done;
+    }
+
     CPU_FOREACH(cpu) {
         tcg_flush_jmp_cache(cpu);
     }
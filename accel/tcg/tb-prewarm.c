@@ -0,0 +1,188 @@
+/*
+ * Persistent translation-block prewarm profiles.
+ *
+ * Re-using host code generated by a previous run is not possible:
+ * translated code embeds absolute host addresses (the code_gen buffer,
+ * helpers, TB structures) that change between invocations.  What we can
+ * persist cheaply are the guest keys of every block that was translated:
+ * (pc, cs_base, flags).  On the next run of the same guest image these
+ * keys are replayed through tb_gen_code() when the first vCPU enters the
+ * execution loop, so that warm boots pay translation cost up front and
+ * in bulk instead of stalling on every cold block.
+ *
+ * The profile file is selected with the "tb-prewarm" property of the TCG
+ * accelerator; the user is responsible for keying the file to the guest
+ * binary (e.g. by hashing the kernel image into the file name).  A stale
+ * profile is harmless: blocks translated from changed code simply never
+ * match a lookup and age out with the rest of the code cache.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/error-report.h"
+#include "qemu/atomic.h"
+#include "exec/exec-all.h"
+#include "exec/cpu-all.h"
+#include "exec/translation-block.h"
+#include "tb-context.h"
+#include "internal-common.h"
+
+#define TB_PREWARM_MAGIC    0x50425451  /* "QTBP" */
+#define TB_PREWARM_VERSION  1
+
+typedef struct TBPrewarmHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t nb_records;
+} TBPrewarmHeader;
+
+typedef struct TBPrewarmRecord {
+    uint64_t pc;
+    uint64_t cs_base;
+    uint32_t flags;
+    uint32_t unused;
+} TBPrewarmRecord;
+
+static char *tb_prewarm_path;
+static TBPrewarmRecord *tb_prewarm_records;
+static uint64_t tb_prewarm_nb_records;
+static bool tb_prewarm_replay_pending;
+
+bool tb_prewarm_pending(void)
+{
+    return qatomic_read(&tb_prewarm_replay_pending);
+}
+
+static void tb_prewarm_collect(void *p, uint32_t hash, void *userp)
+{
+    const TranslationBlock *tb = p;
+    GArray *out = userp;
+    TBPrewarmRecord rec = { };
+
+    /*
+     * CF_PCREL blocks do not record their virtual pc, and invalid
+     * blocks are about to disappear; neither is worth persisting.
+     */
+    if (tb_cflags(tb) & (CF_PCREL | CF_INVALID)) {
+        return;
+    }
+
+    rec.pc = tb->pc;
+    rec.cs_base = tb->cs_base;
+    rec.flags = tb->flags;
+    g_array_append_val(out, rec);
+}
+
+static void tb_prewarm_save(void)
+{
+    TBPrewarmHeader hdr = {
+        .magic = TB_PREWARM_MAGIC,
+        .version = TB_PREWARM_VERSION,
+    };
+    GArray *out;
+    FILE *f;
+
+    f = fopen(tb_prewarm_path, "wb");
+    if (f == NULL) {
+        warn_report("tb-prewarm: cannot write %s: %s",
+                    tb_prewarm_path, strerror(errno));
+        return;
+    }
+
+    out = g_array_new(false, false, sizeof(TBPrewarmRecord));
+    qht_iter(&tb_ctx.htable, tb_prewarm_collect, out);
+    hdr.nb_records = out->len;
+
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+        (out->len != 0 &&
+         fwrite(out->data, sizeof(TBPrewarmRecord), out->len, f) != out->len)) {
+        warn_report("tb-prewarm: short write to %s", tb_prewarm_path);
+    }
+
+    fclose(f);
+    g_array_free(out, true);
+}
+
+static void tb_prewarm_load(void)
+{
+    TBPrewarmHeader hdr;
+    FILE *f;
+
+    f = fopen(tb_prewarm_path, "rb");
+    if (f == NULL) {
+        /* No profile yet: we will write one at exit. */
+        return;
+    }
+
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        hdr.magic != TB_PREWARM_MAGIC ||
+        hdr.version != TB_PREWARM_VERSION) {
+        warn_report("tb-prewarm: %s is not a valid profile, ignoring",
+                    tb_prewarm_path);
+        fclose(f);
+        return;
+    }
+
+    tb_prewarm_records = g_try_new(TBPrewarmRecord, hdr.nb_records);
+    if (tb_prewarm_records == NULL ||
+        fread(tb_prewarm_records, sizeof(TBPrewarmRecord),
+              hdr.nb_records, f) != hdr.nb_records) {
+        warn_report("tb-prewarm: truncated profile %s, ignoring",
+                    tb_prewarm_path);
+        g_free(tb_prewarm_records);
+        tb_prewarm_records = NULL;
+        fclose(f);
+        return;
+    }
+
+    tb_prewarm_nb_records = hdr.nb_records;
+    tb_prewarm_replay_pending = hdr.nb_records != 0;
+    fclose(f);
+}
+
+void tb_prewarm_replay(CPUState *cpu)
+{
+    uint32_t cflags = curr_cflags(cpu);
+    uint64_t i;
+
+    /*
+     * Clear the flag before translating anything: if one of the
+     * recorded blocks faults at translation time, the longjmp back
+     * into the execution loop abandons the remainder of the profile
+     * instead of retrying it forever.
+     */
+    if (!qatomic_xchg(&tb_prewarm_replay_pending, false)) {
+        return;
+    }
+
+    for (i = 0; i < tb_prewarm_nb_records; i++) {
+        const TBPrewarmRecord *rec = &tb_prewarm_records[i];
+
+#ifdef CONFIG_USER_ONLY
+        if (!(page_get_flags(rec->pc) & PAGE_EXEC)) {
+            continue;
+        }
+#else
+        if (get_page_addr_code(cpu_env(cpu), rec->pc) == -1) {
+            continue;
+        }
+#endif
+        mmap_lock();
+        tb_gen_code(cpu, rec->pc, rec->cs_base, rec->flags, cflags);
+        mmap_unlock();
+    }
+
+    g_free(tb_prewarm_records);
+    tb_prewarm_records = NULL;
+    tb_prewarm_nb_records = 0;
+}
+
+void tb_prewarm_init(const char *path)
+{
+    assert(tb_prewarm_path == NULL);
+    tb_prewarm_path = g_strdup(path);
+
+    tb_prewarm_load();
+    atexit(tb_prewarm_save);
+}
@@ -35,6 +35,7 @@
 #include "tcg/startup.h"
 #include "tcg-accel-ops.h"
 #include "tcg-accel-ops-mttcg.h"
+#include "internal-common.h"
 
 typedef struct MttcgForceRcuNotifier {
     Notifier notifier;
@@ -76,6 +77,9 @@ static void *mttcg_cpu_thread_fn(void *arg)
     rcu_add_force_rcu_notifier(&force_rcu.notifier);
     tcg_register_thread();
 
+    /* re-allocate on this thread for NUMA-local first touch */
+    tcg_realloc_jmp_cache(cpu);
+
     bql_lock();
     qemu_thread_get_self(cpu->thread);
 
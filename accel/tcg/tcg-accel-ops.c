@@ -196,10 +196,60 @@ static inline void tcg_remove_all_breakpoints(CPUState *cpu)
     cpu_watchpoint_remove_all(cpu, BP_GDB);
 }
 
+static int64_t tcg_vclock_slack_ns;
+
+void tcg_vclock_set_slack(int64_t ns)
+{
+    tcg_vclock_slack_ns = ns;
+}
+
+/*
+ * Without icount, QEMU_CLOCK_VIRTUAL follows the host clock, and
+ * timer-heavy guests read it constantly from vCPU context.  Serve
+ * repeated reads from a per-thread cache whose staleness is bounded by
+ * the configured slack.  Staleness is measured with the host cycle
+ * counter, calibrated against the clock at each refresh; when the host
+ * has no usable cycle counter the calibrated budget collapses to zero
+ * and every read goes to the clock as before.  Reads from non-vCPU
+ * threads (main loop timer bookkeeping) are never cached.
+ */
+static __thread struct {
+    int64_t clock;
+    int64_t ticks;
+    int64_t ticks_budget;
+} tcg_vclock_cache;
+
+static int64_t tcg_get_virtual_clock(void)
+{
+    int64_t now_ticks, now, d_ticks;
+
+    if (!current_cpu || !tcg_vclock_slack_ns) {
+        return cpu_get_clock();
+    }
+
+    now_ticks = cpu_get_host_ticks();
+    d_ticks = now_ticks - tcg_vclock_cache.ticks;
+    if (tcg_vclock_cache.clock &&
+        d_ticks >= 0 && d_ticks < tcg_vclock_cache.ticks_budget) {
+        return tcg_vclock_cache.clock;
+    }
+
+    now = cpu_get_clock();
+    if (tcg_vclock_cache.clock && now > tcg_vclock_cache.clock) {
+        /* Re-derive the tick budget corresponding to the slack window. */
+        tcg_vclock_cache.ticks_budget =
+            d_ticks * tcg_vclock_slack_ns / (now - tcg_vclock_cache.clock);
+    }
+    tcg_vclock_cache.clock = now;
+    tcg_vclock_cache.ticks = now_ticks;
+    return now;
+}
+
 static void tcg_accel_ops_init(AccelOpsClass *ops)
 {
     if (qemu_tcg_mttcg_enabled()) {
         ops->create_vcpu_thread = mttcg_start_vcpu_thread;
+        ops->parallel_vcpu_create = true;
         ops->kick_vcpu_thread = mttcg_kick_vcpu_thread;
         ops->handle_interrupt = tcg_handle_interrupt;
     } else {
@@ -215,6 +265,15 @@ static void tcg_accel_ops_init(AccelOpsClass *ops)
         }
     }
 
+    if (!icount_enabled()) {
+        /*
+         * Clock caching and deadline slack only make sense when the
+         * virtual clock follows the host clock.
+         */
+        ops->get_virtual_clock = tcg_get_virtual_clock;
+        qemu_timer_set_virtual_slack(tcg_vclock_slack_ns);
+    }
+
     ops->cpu_reset_hold = tcg_cpu_reset_hold;
     ops->supports_guest_debug = tcg_supports_guest_debug;
     ops->insert_breakpoint = tcg_insert_breakpoint;
@@ -35,8 +35,10 @@
 #include "qemu/atomic.h"
 #include "qapi/qapi-builtin-visit.h"
 #include "qemu/units.h"
+#include "qemu/timer.h"
 #if !defined(CONFIG_USER_ONLY)
 #include "hw/boards.h"
+#include "tcg-accel-ops.h"
 #endif
 #include "internal-common.h"
 
@@ -47,6 +49,8 @@ struct TCGState {
     bool one_insn_per_tb;
     int splitwx_enabled;
     unsigned long tb_size;
+    char *prewarm_file;
+    int64_t vclock_slack;
 };
 typedef struct TCGState TCGState;
 
@@ -95,6 +99,9 @@ static void tcg_accel_instance_init(Object *obj)
 #else
     s->splitwx_enabled = 0;
 #endif
+
+    /* Matches the kernel's default timer slack. */
+    s->vclock_slack = 50 * SCALE_US;
 }
 
 bool mttcg_enabled;
@@ -116,12 +123,19 @@ static int tcg_init_machine(MachineState *ms)
     tb_htable_init();
     tcg_init(s->tb_size * MiB, s->splitwx_enabled, max_cpus);
 
+    if (s->prewarm_file) {
+        tb_prewarm_init(s->prewarm_file);
+    }
+
 #if defined(CONFIG_SOFTMMU)
     /*
      * There's no guest base to take into account, so go ahead and
      * initialize the prologue now.
      */
     tcg_prologue_init();
+
+    /* Only applied when running without icount; see tcg_accel_ops_init. */
+    tcg_vclock_set_slack(s->vclock_slack);
 #endif
 
     return 0;
@@ -181,6 +195,34 @@ static void tcg_set_tb_size(Object *obj, Visitor *v,
     s->tb_size = value;
 }
 
+static void tcg_get_vclock_slack(Object *obj, Visitor *v,
+                                 const char *name, void *opaque,
+                                 Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+    int64_t value = s->vclock_slack;
+
+    visit_type_int64(v, name, &value, errp);
+}
+
+static void tcg_set_vclock_slack(Object *obj, Visitor *v,
+                                 const char *name, void *opaque,
+                                 Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+    int64_t value;
+
+    if (!visit_type_int64(v, name, &value, errp)) {
+        return;
+    }
+    if (value < 0) {
+        error_setg(errp, "virtual-clock-slack must not be negative");
+        return;
+    }
+
+    s->vclock_slack = value;
+}
+
 static bool tcg_get_splitwx(Object *obj, Error **errp)
 {
     TCGState *s = TCG_STATE(obj);
@@ -193,6 +235,21 @@ static void tcg_set_splitwx(Object *obj, bool value, Error **errp)
     s->splitwx_enabled = value;
 }
 
+static char *tcg_get_tb_prewarm(Object *obj, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+
+    return g_strdup(s->prewarm_file);
+}
+
+static void tcg_set_tb_prewarm(Object *obj, const char *value, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+
+    g_free(s->prewarm_file);
+    s->prewarm_file = g_strdup(value);
+}
+
 static bool tcg_get_one_insn_per_tb(Object *obj, Error **errp)
 {
     TCGState *s = TCG_STATE(obj);
@@ -247,11 +304,24 @@ static void tcg_accel_class_init(ObjectClass *oc, void *data)
     object_class_property_set_description(oc, "split-wx",
         "Map jit pages into separate RW and RX regions");
 
+    object_class_property_add_str(oc, "tb-prewarm",
+                                  tcg_get_tb_prewarm,
+                                  tcg_set_tb_prewarm);
+    object_class_property_set_description(oc, "tb-prewarm",
+        "File used to persist and replay translated block keys");
+
     object_class_property_add_bool(oc, "one-insn-per-tb",
                                    tcg_get_one_insn_per_tb,
                                    tcg_set_one_insn_per_tb);
     object_class_property_set_description(oc, "one-insn-per-tb",
         "Only put one guest insn in each translation block");
+
+    object_class_property_add(oc, "virtual-clock-slack", "int",
+        tcg_get_vclock_slack, tcg_set_vclock_slack,
+        NULL, NULL);
+    object_class_property_set_description(oc, "virtual-clock-slack",
+        "Virtual clock timer coalescing window in ns, 0 to disable "
+        "(ignored with icount)");
 }
 
 static const TypeInfo tcg_accel_type = {
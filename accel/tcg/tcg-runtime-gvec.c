@@ -451,11 +451,63 @@ void HELPER(gvec_not)(void *d, void *a, uint32_t desc)
     clear_high(d, oprsz, desc);
 }
 
+/*
+ * The bitwise helpers below are simple element loops that the compiler
+ * vectorizes for the baseline host ISA, which on x86-64 is only SSE2.
+ * When built with AVX2 support, emit a second clone of each loop with
+ * the wider ISA enabled and select it at startup from cpuinfo, in the
+ * same way util/bufferiszero.c picks its accelerator.
+ */
+#ifdef CONFIG_AVX2_OPT
+#include "host/cpuinfo.h"
+
+static bool gvec_have_avx2;
+
+static void __attribute__((constructor)) gvec_init_accel(void)
+{
+    gvec_have_avx2 = cpuinfo_init() & CPUINFO_AVX2;
+}
+
+#define GEN_GVEC_AVX2(NAME, EXPR)                                         \
+static void __attribute__((target("avx2")))                               \
+NAME##_avx2(void *d, void *a, void *b, intptr_t oprsz)                    \
+{                                                                         \
+    for (intptr_t i = 0; i < oprsz; i += sizeof(uint64_t)) {              \
+        uint64_t va = *(uint64_t *)(a + i);                               \
+        uint64_t vb = *(uint64_t *)(b + i);                               \
+        *(uint64_t *)(d + i) = (EXPR);                                    \
+    }                                                                     \
+}
+
+GEN_GVEC_AVX2(gvec_and, va & vb)
+GEN_GVEC_AVX2(gvec_or, va | vb)
+GEN_GVEC_AVX2(gvec_xor, va ^ vb)
+GEN_GVEC_AVX2(gvec_andc, va & ~vb)
+GEN_GVEC_AVX2(gvec_orc, va | ~vb)
+GEN_GVEC_AVX2(gvec_nand, ~(va & vb))
+GEN_GVEC_AVX2(gvec_nor, ~(va | vb))
+GEN_GVEC_AVX2(gvec_eqv, ~(va ^ vb))
+
+#undef GEN_GVEC_AVX2
+
+#define GVEC_BITWISE_ACCEL(NAME, d, a, b, oprsz)                          \
+    do {                                                                  \
+        if (gvec_have_avx2) {                                             \
+            NAME##_avx2(d, a, b, oprsz);                                  \
+            clear_high(d, oprsz, desc);                                   \
+            return;                                                       \
+        }                                                                 \
+    } while (0)
+#else
+#define GVEC_BITWISE_ACCEL(NAME, d, a, b, oprsz) do { } while (0)
+#endif /* CONFIG_AVX2_OPT */
+
 void HELPER(gvec_and)(void *d, void *a, void *b, uint32_t desc)
 {
     intptr_t oprsz = simd_oprsz(desc);
     intptr_t i;
 
+    GVEC_BITWISE_ACCEL(gvec_and, d, a, b, oprsz);
     for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) & *(uint64_t *)(b + i);
     }
@@ -467,6 +519,7 @@ void HELPER(gvec_or)(void *d, void *a, void *b, uint32_t desc)
     intptr_t oprsz = simd_oprsz(desc);
     intptr_t i;
 
+    GVEC_BITWISE_ACCEL(gvec_or, d, a, b, oprsz);
     for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) | *(uint64_t *)(b + i);
     }
@@ -478,6 +531,7 @@ void HELPER(gvec_xor)(void *d, void *a, void *b, uint32_t desc)
     intptr_t oprsz = simd_oprsz(desc);
     intptr_t i;
 
+    GVEC_BITWISE_ACCEL(gvec_xor, d, a, b, oprsz);
     for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) ^ *(uint64_t *)(b + i);
     }
@@ -489,6 +543,7 @@ void HELPER(gvec_andc)(void *d, void *a, void *b, uint32_t desc)
     intptr_t oprsz = simd_oprsz(desc);
     intptr_t i;
 
+    GVEC_BITWISE_ACCEL(gvec_andc, d, a, b, oprsz);
     for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) &~ *(uint64_t *)(b + i);
     }
@@ -500,6 +555,7 @@ void HELPER(gvec_orc)(void *d, void *a, void *b, uint32_t desc)
     intptr_t oprsz = simd_oprsz(desc);
     intptr_t i;
 
+    GVEC_BITWISE_ACCEL(gvec_orc, d, a, b, oprsz);
     for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = *(uint64_t *)(a + i) |~ *(uint64_t *)(b + i);
     }
@@ -511,6 +567,7 @@ void HELPER(gvec_nand)(void *d, void *a, void *b, uint32_t desc)
     intptr_t oprsz = simd_oprsz(desc);
     intptr_t i;
 
+    GVEC_BITWISE_ACCEL(gvec_nand, d, a, b, oprsz);
     for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = ~(*(uint64_t *)(a + i) & *(uint64_t *)(b + i));
     }
@@ -522,6 +579,7 @@ void HELPER(gvec_nor)(void *d, void *a, void *b, uint32_t desc)
     intptr_t oprsz = simd_oprsz(desc);
     intptr_t i;
 
+    GVEC_BITWISE_ACCEL(gvec_nor, d, a, b, oprsz);
     for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = ~(*(uint64_t *)(a + i) | *(uint64_t *)(b + i));
     }
@@ -533,6 +591,7 @@ void HELPER(gvec_eqv)(void *d, void *a, void *b, uint32_t desc)
     intptr_t oprsz = simd_oprsz(desc);
     intptr_t i;
 
+    GVEC_BITWISE_ACCEL(gvec_eqv, d, a, b, oprsz);
     for (i = 0; i < oprsz; i += sizeof(uint64_t)) {
         *(uint64_t *)(d + i) = ~(*(uint64_t *)(a + i) ^ *(uint64_t *)(b + i));
     }
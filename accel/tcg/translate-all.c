@@ -332,6 +332,10 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     tb->cs_base = cs_base;
     tb->flags = flags;
     tb->cflags = cflags;
+    tb->exec_count = 0;
+    tb->region_extended = false;
+    memset(tb->indirect, 0, sizeof(tb->indirect));
+    tb->indirect_flush_count = qatomic_read(&tb_ctx.tb_flush_count);
     tb_set_page_addr0(tb, phys_pc);
     tb_set_page_addr1(tb, -1);
     if (phys_pc != -1) {
@@ -137,6 +137,19 @@ void translator_loop(CPUState *cpu, TranslationBlock *tb, int *max_insns,
     db->record_start = 0;
     db->record_len = 0;
 
+    /*
+     * One-shot hint from cpu_tb_exec: this pc was hot enough to warrant
+     * retranslation as an extended region.  Targets that support it may
+     * continue translating through unconditional direct jumps; targets
+     * that ignore the flag simply regenerate the same TB.
+     */
+    db->region_extend = false;
+    if (unlikely(cpu->region_extend_pc == pc)) {
+        cpu->region_extend_pc = -1;
+        db->region_extend = true;
+        tb->region_extended = true;
+    }
+
     ops->init_disas_context(db, cpu);
     tcg_debug_assert(db->is_jmp == DISAS_NEXT);  /* no early exit */
 
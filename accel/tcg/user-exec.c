@@ -576,21 +576,22 @@ bool page_check_range(target_ulong start, target_ulong len, int flags)
             break;
         }
         if (missing & PAGE_WRITE) {
+            target_ulong run_last = MIN(last, p->itree.last);
+
             if (!(p->flags & PAGE_WRITE_ORG)) {
                 ret = false; /* page not writable */
                 break;
             }
             /* Asking about writable, but has been protected: undo. */
-            if (!page_unprotect(start, 0)) {
+            if (!page_unprotect_range(start, run_last)) {
                 ret = false;
                 break;
             }
-            /* TODO: page_unprotect should take a range, not a single page. */
-            if (last - start < TARGET_PAGE_SIZE) {
+            if (last <= run_last) {
                 ret = true; /* ok */
                 break;
             }
-            start += TARGET_PAGE_SIZE;
+            start = run_last + 1;
             continue;
         }
 
@@ -781,6 +782,81 @@ int page_unprotect(target_ulong address, uintptr_t pc)
     return current_tb_invalidated ? 2 : 1;
 }
 
+/*
+ * Remove write protection from a range of pages, invalidating the
+ * translated code within.  As with page_unprotect(), return 0 if no
+ * page in the range had really been writable.  Unlike that function,
+ * this is never called from the signal handler, so there is no fault
+ * to unwind and the range may span multiple protection regions.
+ */
+int page_unprotect_range(target_ulong start, target_ulong last)
+{
+    int host_page_size = qemu_real_host_page_size();
+    int ret = 1;
+
+    start &= TARGET_PAGE_MASK;
+    last |= ~TARGET_PAGE_MASK;
+
+    if (unlikely(host_page_size > TARGET_PAGE_SIZE)) {
+        /*
+         * A host page may cover pages from several protection regions,
+         * so let page_unprotect() reconstruct each one individually.
+         */
+        while (1) {
+            if (!page_unprotect(start, 0)) {
+                ret = 0;
+            }
+            if (last - start < host_page_size) {
+                return ret;
+            }
+            start += host_page_size;
+        }
+    }
+
+    mmap_lock();
+
+    while (1) {
+        PageFlagsNode *p = pageflags_find(start, last);
+        target_ulong run_last;
+        int prot;
+
+        /* If these pages were not really writable, nothing to do. */
+        if (!p || start < p->itree.start || !(p->flags & PAGE_WRITE_ORG)) {
+            ret = 0;
+            break;
+        }
+
+        run_last = MIN(last, p->itree.last);
+        if (p->flags & PAGE_WRITE) {
+            /*
+             * If the pages are already marked WRITE then another thread
+             * got here first and did the TB invalidate for us.
+             */
+        } else {
+            /*
+             * Restore write access for the whole run at once; beyond
+             * this point @p may have been merged away.
+             */
+            prot = p->flags | PAGE_WRITE;
+            pageflags_set_clear(start, run_last, PAGE_WRITE, 0);
+            tb_invalidate_phys_range(start, run_last);
+            if (prot & PAGE_EXEC) {
+                prot = (prot & ~PAGE_EXEC) | PAGE_READ;
+            }
+            mprotect(g2h_untagged(start), run_last - start + 1,
+                     prot & PAGE_RWX);
+        }
+
+        if (last <= run_last) {
+            break;
+        }
+        start = run_last + 1;
+    }
+
+    mmap_unlock();
+    return ret;
+}
+
 static int probe_access_internal(CPUArchState *env, vaddr addr,
                                  int fault_size, MMUAccessType access_type,
                                  bool nonfault, uintptr_t ra)
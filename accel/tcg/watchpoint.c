@@ -27,6 +27,8 @@
 #include "hw/core/tcg-cpu-ops.h"
 #include "hw/core/cpu.h"
 
+#include "internal-common.h"
+
 /*
  * Return true if this watchpoint address matches the specified
  * access (ie the address range covered by the watchpoint overlaps
@@ -121,6 +123,19 @@ void cpu_check_watchpoint(CPUState *cpu, vaddr addr, vaddr len,
                 wp->flags &= ~BP_WATCHPOINT_HIT;
                 continue;
             }
+
+            if (wp->flags & BP_TRACE) {
+                /*
+                 * Tracing watchpoints record the hit and let the access
+                 * proceed, unless the stop threshold has been reached.
+                 */
+                wp->hit_count++;
+                if (!bp_trace_hit(cpu, wp->hitaddr, wp->flags,
+                                  wp->hit_count)) {
+                    wp->flags &= ~BP_WATCHPOINT_HIT;
+                    continue;
+                }
+            }
             cpu->watchpoint_hit = wp;
 
             mmap_lock();
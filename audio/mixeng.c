@@ -532,6 +532,15 @@ void mixeng_volume (struct st_sample *buf, int len, struct mixeng_volume *vol)
         return;
     }
 
+    /*
+     * Multiplying by the nominal volume is an identity operation, skip
+     * the pass over the buffer entirely.  Most guests never change the
+     * volume, so this is the common case.
+     */
+    if (vol->l == nominal_volume.l && vol->r == nominal_volume.r) {
+        return;
+    }
+
     while (len--) {
 #ifdef FLOAT_MIXENG
         buf->l = buf->l * vol->l;
@@ -6227,15 +6227,12 @@ BlockDriverState *bdrv_find_node(const char *node_name)
 }
 
 /* Put this QMP function here so it can access the static graph_bdrv_states. */
-BlockDeviceInfoList *bdrv_named_nodes_list(bool flat,
-                                           Error **errp)
+static BlockDeviceInfoList * GRAPH_RDLOCK
+bdrv_do_named_nodes_list(bool flat, Error **errp)
 {
     BlockDeviceInfoList *list;
     BlockDriverState *bs;
 
-    GLOBAL_STATE_CODE();
-    GRAPH_RDLOCK_GUARD_MAINLOOP();
-
     list = NULL;
     QTAILQ_FOREACH(bs, &graph_bdrv_states, node_list) {
         BlockDeviceInfo *info = bdrv_block_device_info(NULL, bs, flat, errp);
@@ -6249,6 +6246,24 @@ BlockDeviceInfoList *bdrv_named_nodes_list(bool flat,
     return list;
 }
 
+BlockDeviceInfoList *bdrv_named_nodes_list(bool flat,
+                                           Error **errp)
+{
+    GLOBAL_STATE_CODE();
+    GRAPH_RDLOCK_GUARD_MAINLOOP();
+
+    return bdrv_do_named_nodes_list(flat, errp);
+}
+
+BlockDeviceInfoList *coroutine_fn bdrv_co_named_nodes_list(bool flat,
+                                                           Error **errp)
+{
+    GLOBAL_STATE_CODE();
+    GRAPH_RDLOCK_GUARD();
+
+    return bdrv_do_named_nodes_list(flat, errp);
+}
+
 typedef struct XDbgBlockGraphConstructor {
     XDbgBlockGraph *graph;
     GHashTable *graph_nodes;
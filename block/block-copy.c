@@ -35,6 +35,7 @@
 #define BLOCK_COPY_MAX_WORKERS 64
 #define BLOCK_COPY_SLICE_TIME 100000000ULL /* ns */
 #define BLOCK_COPY_CLUSTER_SIZE_DEFAULT (1 << 16)
+#define BLOCK_COPY_MAX_SEQ_CHUNK (16 * MiB)
 
 typedef enum {
     COPY_READ_WRITE_CLUSTER,
@@ -54,6 +55,12 @@ typedef struct BlockCopyCallState {
     int max_workers;
     int64_t max_chunk;
     bool ignore_ratelimit;
+    /*
+     * Chunk size grown beyond block_copy_chunk_size() while the dirty
+     * bitmap keeps producing full-sized sequential runs.  Protected by
+     * lock in BlockCopyState.
+     */
+    int64_t seq_chunk;
     BlockCopyAsyncCallbackFunc cb;
     void *cb_opaque;
     /* Coroutine where async block-copy is running */
@@ -190,10 +197,15 @@ block_copy_task_create(BlockCopyState *s, BlockCopyCallState *call_state,
                        int64_t offset, int64_t bytes)
 {
     BlockCopyTask *task;
+    int64_t chunk;
     int64_t max_chunk;
 
     QEMU_LOCK_GUARD(&s->lock);
-    max_chunk = MIN_NON_ZERO(block_copy_chunk_size(s), call_state->max_chunk);
+    chunk = block_copy_chunk_size(s);
+    if (s->method != COPY_READ_WRITE_CLUSTER && call_state->seq_chunk > chunk) {
+        chunk = MIN(call_state->seq_chunk, s->max_transfer);
+    }
+    max_chunk = MIN_NON_ZERO(chunk, call_state->max_chunk);
     if (!bdrv_dirty_bitmap_next_dirty_area(s->copy_bitmap,
                                            offset, offset + bytes,
                                            max_chunk, &offset, &bytes))
@@ -201,6 +213,18 @@ block_copy_task_create(BlockCopyState *s, BlockCopyCallState *call_state,
         return NULL;
     }
 
+    /*
+     * While the bitmap keeps handing us full-sized dirty areas we are in
+     * the middle of a long sequential run, which is cheaper to copy in
+     * fewer, larger requests.  Grow the chunk for the next task; any
+     * shorter area drops back to the default size.
+     */
+    if (s->method != COPY_READ_WRITE_CLUSTER && bytes == max_chunk) {
+        call_state->seq_chunk = MIN(max_chunk * 2, BLOCK_COPY_MAX_SEQ_CHUNK);
+    } else {
+        call_state->seq_chunk = 0;
+    }
+
     assert(QEMU_IS_ALIGNED(offset, s->cluster_size));
     bytes = QEMU_ALIGN_UP(bytes, s->cluster_size);
 
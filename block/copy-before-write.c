@@ -122,6 +122,19 @@ static coroutine_fn int cbw_do_copy_before_write(BlockDriverState *bs,
     off = QEMU_ALIGN_DOWN(offset, cluster_size);
     end = QEMU_ALIGN_UP(offset + bytes, cluster_size);
 
+    /*
+     * Fast path for writes to areas that have already been copied to the
+     * target: only the frozen-read bookkeeping remains, and setting up a
+     * block-copy call (including its timeout coroutine) for every such
+     * guest write is pure overhead.
+     */
+    WITH_QEMU_LOCK_GUARD(&s->lock) {
+        if (bdrv_dirty_bitmap_next_zero(s->done_bitmap, off, end - off) < 0) {
+            reqlist_wait_all(&s->frozen_read_reqs, off, end - off, &s->lock);
+            return 0;
+        }
+    }
+
     /*
      * Increase in_flight, so that in case of timed-out block-copy, the
      * remaining background block_copy() request (which can't be immediately
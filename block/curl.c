@@ -48,9 +48,9 @@
                    CURLPROTO_FTP | CURLPROTO_FTPS)
 #endif
 
-#define CURL_NUM_STATES 8
 #define CURL_NUM_ACB    8
 #define CURL_TIMEOUT_MAX 10000
+#define CURL_CONNECTIONS_MAX 256
 
 #define CURL_BLOCK_OPT_URL       "url"
 #define CURL_BLOCK_OPT_READAHEAD "readahead"
@@ -62,10 +62,14 @@
 #define CURL_BLOCK_OPT_PASSWORD_SECRET "password-secret"
 #define CURL_BLOCK_OPT_PROXY_USERNAME "proxy-username"
 #define CURL_BLOCK_OPT_PROXY_PASSWORD_SECRET "proxy-password-secret"
+#define CURL_BLOCK_OPT_CACHE_SIZE "cache-size"
+#define CURL_BLOCK_OPT_MAX_CONNECTIONS "max-connections"
 
 #define CURL_BLOCK_OPT_READAHEAD_DEFAULT (256 * 1024)
 #define CURL_BLOCK_OPT_SSLVERIFY_DEFAULT true
 #define CURL_BLOCK_OPT_TIMEOUT_DEFAULT 5
+#define CURL_BLOCK_OPT_CACHE_SIZE_DEFAULT 0
+#define CURL_BLOCK_OPT_MAX_CONNECTIONS_DEFAULT 8
 
 struct BDRVCURLState;
 struct CURLState;
@@ -103,14 +107,30 @@ typedef struct CURLState
     char in_use;
 } CURLState;
 
+/*
+ * A fully downloaded range donated to the read cache when its CURLState
+ * is reused.  Kept in LRU order; the total buffer size is bounded by the
+ * "cache-size" option.
+ */
+typedef struct CURLCachedBuf {
+    uint64_t start;
+    size_t len;
+    char *buf;
+    QTAILQ_ENTRY(CURLCachedBuf) next;
+} CURLCachedBuf;
+
 typedef struct BDRVCURLState {
     CURLM *multi;
     QEMUTimer timer;
     uint64_t len;
-    CURLState states[CURL_NUM_STATES];
+    CURLState *states;
+    int num_states;
     GHashTable *sockets; /* GINT_TO_POINTER(fd) -> socket */
     char *url;
     size_t readahead_size;
+    QTAILQ_HEAD(, CURLCachedBuf) cache; /* LRU, most recent first */
+    size_t cache_size;
+    size_t cache_used;
     bool sslverify;
     uint64_t timeout;
     char *cookie;
@@ -269,8 +289,9 @@ static bool curl_find_buf(BDRVCURLState *s, uint64_t start, uint64_t len,
     uint64_t end = start + len;
     uint64_t clamped_end = MIN(end, s->len);
     uint64_t clamped_len = clamped_end - start;
+    CURLCachedBuf *cached;
 
-    for (i=0; i<CURL_NUM_STATES; i++) {
+    for (i = 0; i < s->num_states; i++) {
         CURLState *state = &s->states[i];
         uint64_t buf_end = (state->buf_start + state->buf_off);
         uint64_t buf_fend = (state->buf_start + state->buf_len);
@@ -317,9 +338,68 @@ static bool curl_find_buf(BDRVCURLState *s, uint64_t start, uint64_t len,
         }
     }
 
+    // Check ranges retained from completed downloads
+    QTAILQ_FOREACH(cached, &s->cache, next) {
+        if ((start >= cached->start) &&
+            (clamped_end <= cached->start + cached->len))
+        {
+            char *buf = cached->buf + (start - cached->start);
+
+            qemu_iovec_from_buf(acb->qiov, 0, buf, clamped_len);
+            if (clamped_len < len) {
+                qemu_iovec_memset(acb->qiov, clamped_len, 0, len - clamped_len);
+            }
+            QTAILQ_REMOVE(&s->cache, cached, next);
+            QTAILQ_INSERT_HEAD(&s->cache, cached, next);
+            acb->ret = 0;
+            return true;
+        }
+    }
+
     return false;
 }
 
+/*
+ * Called with s->mutex held.
+ *
+ * Take ownership of @state's download buffer and either add it to the
+ * read cache or free it.  Only the downloaded prefix is kept; anything
+ * beyond buf_off was never received.  Older entries are evicted until
+ * the cache fits into the configured "cache-size" again.
+ */
+static void curl_cache_state_buf(BDRVCURLState *s, CURLState *state)
+{
+    CURLCachedBuf *cached;
+
+    if (!state->orig_buf) {
+        return;
+    }
+
+    if (!s->cache_size || !state->buf_off || state->buf_off > s->cache_size) {
+        g_free(state->orig_buf);
+        state->orig_buf = NULL;
+        return;
+    }
+
+    cached = g_new(CURLCachedBuf, 1);
+    cached->start = state->buf_start;
+    cached->len = state->buf_off;
+    cached->buf = state->orig_buf;
+    state->orig_buf = NULL;
+
+    QTAILQ_INSERT_HEAD(&s->cache, cached, next);
+    s->cache_used += cached->len;
+
+    while (s->cache_used > s->cache_size) {
+        CURLCachedBuf *victim = QTAILQ_LAST(&s->cache);
+
+        QTAILQ_REMOVE(&s->cache, victim, next);
+        s->cache_used -= victim->len;
+        g_free(victim->buf);
+        g_free(victim);
+    }
+}
+
 /* Called with s->mutex held.  */
 static void curl_multi_check_completion(BDRVCURLState *s)
 {
@@ -441,7 +521,7 @@ static CURLState *curl_find_state(BDRVCURLState *s)
     CURLState *state = NULL;
     int i;
 
-    for (i = 0; i < CURL_NUM_STATES; i++) {
+    for (i = 0; i < s->num_states; i++) {
         if (!s->states[i].in_use) {
             state = &s->states[i];
             state->in_use = 1;
@@ -573,7 +653,7 @@ static void curl_detach_aio_context(BlockDriverState *bs)
 
     WITH_QEMU_LOCK_GUARD(&s->mutex) {
         curl_drop_all_sockets(s->sockets);
-        for (i = 0; i < CURL_NUM_STATES; i++) {
+        for (i = 0; i < s->num_states; i++) {
             if (s->states[i].in_use) {
                 curl_clean_state(&s->states[i]);
             }
@@ -664,6 +744,16 @@ static QemuOptsList runtime_opts = {
             .type = QEMU_OPT_STRING,
             .help = "ID of secret used as password for HTTP proxy auth",
         },
+        {
+            .name = CURL_BLOCK_OPT_CACHE_SIZE,
+            .type = QEMU_OPT_SIZE,
+            .help = "Total size of completed downloads kept for reads",
+        },
+        {
+            .name = CURL_BLOCK_OPT_MAX_CONNECTIONS,
+            .type = QEMU_OPT_NUMBER,
+            .help = "Maximum number of parallel connections",
+        },
         { /* end of list */ }
     },
 };
@@ -686,6 +776,7 @@ static int curl_open(BlockDriverState *bs, QDict *options, int flags,
 #endif
     const char *secretid;
     const char *protocol_delimiter;
+    uint64_t max_connections;
     int ret;
 
     bdrv_graph_rdlock_main_loop();
@@ -719,6 +810,18 @@ static int curl_open(BlockDriverState *bs, QDict *options, int flags,
         goto out_noclean;
     }
 
+    s->cache_size = qemu_opt_get_size(opts, CURL_BLOCK_OPT_CACHE_SIZE,
+                                      CURL_BLOCK_OPT_CACHE_SIZE_DEFAULT);
+
+    max_connections = qemu_opt_get_number(opts, CURL_BLOCK_OPT_MAX_CONNECTIONS,
+                                          CURL_BLOCK_OPT_MAX_CONNECTIONS_DEFAULT);
+    if (max_connections < 1 || max_connections > CURL_CONNECTIONS_MAX) {
+        error_setg(errp, "max-connections must be between 1 and %d",
+                   CURL_CONNECTIONS_MAX);
+        goto out_noclean;
+    }
+    s->num_states = max_connections;
+
     s->timeout = qemu_opt_get_number(opts, CURL_BLOCK_OPT_TIMEOUT,
                                      CURL_BLOCK_OPT_TIMEOUT_DEFAULT);
     if (s->timeout > CURL_TIMEOUT_MAX) {
@@ -784,8 +887,10 @@ static int curl_open(BlockDriverState *bs, QDict *options, int flags,
 
     trace_curl_open(file);
     qemu_co_queue_init(&s->free_state_waitq);
+    QTAILQ_INIT(&s->cache);
     s->aio_context = bdrv_get_aio_context(bs);
     s->url = g_strdup(file);
+    s->states = g_new0(CURLState, s->num_states);
     s->sockets = g_hash_table_new_full(NULL, NULL, NULL, g_free);
     qemu_mutex_lock(&s->mutex);
     state = curl_find_state(s);
@@ -869,6 +974,7 @@ out:
     state->curl = NULL;
 out_noclean:
     qemu_mutex_destroy(&s->mutex);
+    g_free(s->states);
     g_free(s->cookie);
     g_free(s->url);
     g_free(s->username);
@@ -918,8 +1024,8 @@ static void coroutine_fn curl_setup_preadv(BlockDriverState *bs, CURLAIOCB *acb)
     acb->start = 0;
     acb->end = MIN(acb->bytes, s->len - start);
 
+    curl_cache_state_buf(s, state);
     state->buf_off = 0;
-    g_free(state->orig_buf);
     state->buf_start = start;
     state->buf_len = MIN(acb->end + s->readahead_size, s->len - start);
     end = start + state->buf_len - 1;
@@ -971,11 +1077,18 @@ static int coroutine_fn curl_co_preadv(BlockDriverState *bs,
 static void curl_close(BlockDriverState *bs)
 {
     BDRVCURLState *s = bs->opaque;
+    CURLCachedBuf *cached;
 
     trace_curl_close();
     curl_detach_aio_context(bs);
     qemu_mutex_destroy(&s->mutex);
 
+    while ((cached = QTAILQ_FIRST(&s->cache))) {
+        QTAILQ_REMOVE(&s->cache, cached, next);
+        g_free(cached->buf);
+        g_free(cached);
+    }
+    g_free(s->states);
     g_hash_table_destroy(s->sockets);
     g_free(s->cookie);
     g_free(s->url);
@@ -18,6 +18,7 @@
 #include "vhost-user-blk-server.h"
 #include "qapi/error.h"
 #include "qom/object_interfaces.h"
+#include "sysemu/iothread.h"
 #include "util/block-helpers.h"
 #include "virtio-blk-handler.h"
 
@@ -98,6 +99,7 @@ static void vu_blk_process_vq(VuDev *vu_dev, int idx)
         Coroutine *co =
             qemu_coroutine_create(vu_blk_virtio_process_req, req);
 
+        vhost_user_server_inc_queue_requests(server, idx);
         vhost_user_server_inc_in_flight(server);
         qemu_coroutine_enter(co);
     }
@@ -322,6 +324,8 @@ static int vu_blk_exp_create(BlockExport *exp, BlockExportOptions *opts,
     Error *local_err = NULL;
     uint64_t logical_block_size;
     uint16_t num_queues = VHOST_USER_BLK_NUM_QUEUES_DEFAULT;
+    g_autofree AioContext **vq_ctx = NULL;
+    unsigned int n_vq_ctx = 0;
 
     vexp->blkcfg.wce = 0;
 
@@ -344,6 +348,27 @@ static int vu_blk_exp_create(BlockExport *exp, BlockExportOptions *opts,
         error_setg(errp, "num-queues must be greater than 0");
         return -EINVAL;
     }
+
+    if (vu_opts->has_iothreads) {
+        strList *entry;
+
+        for (entry = vu_opts->iothreads; entry; entry = entry->next) {
+            n_vq_ctx++;
+        }
+
+        vq_ctx = g_new0(AioContext *, n_vq_ctx);
+        n_vq_ctx = 0;
+        for (entry = vu_opts->iothreads; entry; entry = entry->next) {
+            IOThread *iothread = iothread_by_id(entry->value);
+
+            if (!iothread) {
+                error_setg(errp, "iothread \"%s\" not found", entry->value);
+                return -EINVAL;
+            }
+            vq_ctx[n_vq_ctx++] = iothread_get_aio_context(iothread);
+        }
+    }
+
     vexp->handler.blk = exp->blk;
     vexp->handler.serial = g_strdup("vhost_user_blk");
     vexp->handler.logical_block_size = logical_block_size;
@@ -365,6 +390,11 @@ static int vu_blk_exp_create(BlockExport *exp, BlockExportOptions *opts,
         return -EADDRNOTAVAIL;
     }
 
+    if (n_vq_ctx > 0) {
+        vhost_user_server_set_queue_contexts(&vexp->vu_server, vq_ctx,
+                                             n_vq_ctx);
+    }
+
     return 0;
 }
 
@@ -3564,6 +3564,22 @@ raw_do_pdiscard(BlockDriverState *bs, int64_t offset, int64_t bytes,
         acb.aio_type |= QEMU_AIO_BLKDEV;
     }
 
+#ifdef CONFIG_LINUX_IO_URING
+    /*
+     * Punch holes asynchronously through the ring so that a guest TRIM
+     * storm does not tie up the whole thread pool and starve data I/O.
+     * Block devices need the BLKDISCARD ioctl and stay on the thread
+     * pool, as do kernels without IORING_OP_FALLOCATE.
+     */
+    if (!blkdev && s->has_discard && raw_check_linux_io_uring(s)) {
+        ret = luring_co_pdiscard(bs, s->fd, offset, bytes);
+        if (ret != -EINVAL && ret != -EOPNOTSUPP && ret != -ENOTSUP) {
+            raw_account_discard(s, bytes, ret);
+            return ret;
+        }
+    }
+#endif
+
     ret = raw_thread_pool_submit(handle_aiocb_discard, &acb);
     raw_account_discard(s, bytes, ret);
     return ret;
@@ -19,7 +19,9 @@
  */
 
 #include "qemu/osdep.h"
+#include "qemu/lock-stats.h"
 #include "qemu/main-loop.h"
+#include "trace.h"
 #include "block/graph-lock.h"
 #include "block/block.h"
 #include "block/block_int.h"
@@ -69,6 +71,7 @@ static QTAILQ_HEAD(, BdrvGraphRWlock) aio_context_list =
 static void __attribute__((__constructor__)) bdrv_init_graph_lock(void)
 {
     qemu_mutex_init(&aio_context_list_lock);
+    qemu_mutex_enable_stats(&aio_context_list_lock, "block-graph-lock");
     qemu_co_queue_init(&reader_queue);
 }
 
@@ -108,13 +111,24 @@ static uint32_t reader_count(void)
 
 void no_coroutine_fn bdrv_graph_wrlock(void)
 {
+    int64_t start_ns, wait_ns;
+
     GLOBAL_STATE_CODE();
     assert(!qatomic_read(&has_writer));
     assert(!qemu_in_coroutine());
 
+    /*
+     * Taking the write lock stalls I/O across the whole graph, so keep
+     * track of how long that takes: draining and waiting for in-flight
+     * readers is a prime source of guest latency outliers.
+     */
+    start_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+
     /* Make sure that constantly arriving new I/O doesn't cause starvation */
     bdrv_drain_all_begin_nopoll();
 
+    wait_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+
     /*
      * reader_count == 0: this means writer will read has_reader as 1
      * reader_count >= 1: we don't know if writer read has_writer == 0 or 1,
@@ -139,7 +153,12 @@ void no_coroutine_fn bdrv_graph_wrlock(void)
         smp_mb();
     } while (reader_count() >= 1);
 
+    wait_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME) - wait_ns;
+
     bdrv_drain_all_end();
+
+    trace_bdrv_graph_wrlock(qemu_clock_get_ns(QEMU_CLOCK_REALTIME) - start_ns,
+                            wait_ns);
 }
 
 void no_coroutine_fn bdrv_graph_wrunlock(void)
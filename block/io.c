@@ -577,8 +577,24 @@ void bdrv_drain_all(void)
     bdrv_drain_all_end();
 }
 
+/*
+ * Insert a request into the interval tree of its BDS, keyed by the
+ * overlap range.  Zero-length requests cannot be represented as an
+ * interval, so index them as a single byte; tracked_request_overlaps()
+ * remains the authoritative filter for candidates found in the tree.
+ *
+ * Called with req->bs->reqs_lock held.
+ */
+static void tracked_request_insert(BdrvTrackedRequest *req)
+{
+    req->tree_node.start = req->overlap_offset;
+    req->tree_node.last = req->overlap_offset +
+                          MAX(req->overlap_bytes, 1) - 1;
+    interval_tree_insert(&req->tree_node, &req->bs->tracked_requests);
+}
+
 /**
- * Remove an active request from the tracked requests list
+ * Remove an active request from the tracked requests tree
  *
  * This function should be called when a tracked request is completing.
  */
@@ -589,7 +605,7 @@ static void coroutine_fn tracked_request_end(BdrvTrackedRequest *req)
     }
 
     qemu_mutex_lock(&req->bs->reqs_lock);
-    QLIST_REMOVE(req, list);
+    interval_tree_remove(&req->tree_node, &req->bs->tracked_requests);
     qemu_mutex_unlock(&req->bs->reqs_lock);
 
     /*
@@ -601,7 +617,7 @@ static void coroutine_fn tracked_request_end(BdrvTrackedRequest *req)
 }
 
 /**
- * Add an active request to the tracked requests list
+ * Add an active request to the tracked requests tree
  */
 static void coroutine_fn tracked_request_begin(BdrvTrackedRequest *req,
                                                BlockDriverState *bs,
@@ -625,7 +641,7 @@ static void coroutine_fn tracked_request_begin(BdrvTrackedRequest *req,
     qemu_co_queue_init(&req->wait_queue);
 
     qemu_mutex_lock(&bs->reqs_lock);
-    QLIST_INSERT_HEAD(&bs->tracked_requests, req, list);
+    tracked_request_insert(req);
     qemu_mutex_unlock(&bs->reqs_lock);
 }
 
@@ -645,13 +661,39 @@ static bool tracked_request_overlaps(BdrvTrackedRequest *req,
     return true;
 }
 
+/*
+ * Return true if the chain of requests that @req is waiting for leads
+ * back to @self, i.e. waiting for @req in turn would deadlock.
+ *
+ * Called with self->bs->reqs_lock held.
+ */
+static bool bdrv_request_is_waiting_for(BdrvTrackedRequest *req,
+                                        BdrvTrackedRequest *self)
+{
+    while (req) {
+        if (req == self) {
+            return true;
+        }
+        req = req->waiting_for;
+    }
+
+    return false;
+}
+
 /* Called with self->bs->reqs_lock held */
 static coroutine_fn BdrvTrackedRequest *
 bdrv_find_conflicting_request(BdrvTrackedRequest *self)
 {
-    BdrvTrackedRequest *req;
+    uint64_t start = self->overlap_offset;
+    uint64_t last = self->overlap_offset + MAX(self->overlap_bytes, 1) - 1;
+    IntervalTreeNode *node;
+
+    for (node = interval_tree_iter_first(&self->bs->tracked_requests,
+                                         start, last);
+         node; node = interval_tree_iter_next(node, start, last)) {
+        BdrvTrackedRequest *req =
+            container_of(node, BdrvTrackedRequest, tree_node);
 
-    QLIST_FOREACH(req, &self->bs->tracked_requests, list) {
         if (req == self || (!req->serialising && !self->serialising)) {
             continue;
         }
@@ -666,11 +708,13 @@ bdrv_find_conflicting_request(BdrvTrackedRequest *self)
             assert(qemu_coroutine_self() != req->co);
 
             /*
-             * If the request is already (indirectly) waiting for us, or
-             * will wait for us as soon as it wakes up, then just go on
-             * (instead of producing a deadlock in the former case).
+             * Wait for @req unless it is (indirectly) waiting for us,
+             * which would deadlock.  A sleeping request that is not
+             * part of such a cycle is still a conflict: skipping it,
+             * as this code used to do, let a stream of overlapping
+             * requests starve it indefinitely.
              */
-            if (!req->waiting_for) {
+            if (!bdrv_request_is_waiting_for(req, self)) {
                 return req;
             }
         }
@@ -707,8 +751,11 @@ static void tracked_request_set_serialising(BdrvTrackedRequest *req,
         req->serialising = true;
     }
 
+    /* The overlap range is the key in the interval tree, so re-insert. */
+    interval_tree_remove(&req->tree_node, &req->bs->tracked_requests);
     req->overlap_offset = MIN(req->overlap_offset, overlap_offset);
     req->overlap_bytes = MAX(req->overlap_bytes, overlap_bytes);
+    tracked_request_insert(req);
 }
 
 /**
@@ -717,11 +764,18 @@ static void tracked_request_set_serialising(BdrvTrackedRequest *req,
  */
 BdrvTrackedRequest *coroutine_fn bdrv_co_get_self_request(BlockDriverState *bs)
 {
-    BdrvTrackedRequest *req;
+    IntervalTreeNode *node;
     Coroutine *self = qemu_coroutine_self();
     IO_CODE();
 
-    QLIST_FOREACH(req, &bs->tracked_requests, list) {
+    QEMU_LOCK_GUARD(&bs->reqs_lock);
+
+    for (node = interval_tree_iter_first(&bs->tracked_requests,
+                                         0, UINT64_MAX);
+         node; node = interval_tree_iter_next(node, 0, UINT64_MAX)) {
+        BdrvTrackedRequest *req =
+            container_of(node, BdrvTrackedRequest, tree_node);
+
         if (req->co == self) {
             return req;
         }
@@ -10,14 +10,19 @@
  */
 #include "qemu/osdep.h"
 #include <liburing.h>
+#ifdef CONFIG_FALLOCATE_PUNCH_HOLE
+#include <linux/falloc.h>
+#endif
 #include "block/aio.h"
 #include "qemu/queue.h"
 #include "block/block.h"
 #include "block/raw-aio.h"
 #include "qemu/coroutine.h"
 #include "qemu/defer-call.h"
+#include "qemu/lockable.h"
 #include "qapi/error.h"
 #include "sysemu/block-backend.h"
+#include "exec/ramlist.h"
 #include "trace.h"
 
 /* Only used for assertions.  */
@@ -26,11 +31,90 @@
 /* io_uring ring size */
 #define MAX_ENTRIES 128
 
+/* Maximum number of RAM regions registered as fixed buffers per ring */
+#define MAX_BUF_REGIONS 128
+
+typedef struct {
+    void *host;
+    size_t size;
+} LuringBufRegion;
+
+/*
+ * Guest RAM regions eligible for IORING_REGISTER_BUFFERS, maintained by a
+ * RAMBlockNotifier.  Each LuringState registers a snapshot of this list
+ * with its own ring (bumping luring_buf_generation invalidates the
+ * snapshots) so that request submission only ever touches ring-local
+ * state.  Registration is best effort: if the kernel refuses (RLIMIT_MEMLOCK,
+ * regions too large for the kernel version, too many regions) the whole
+ * mechanism is disabled and requests fall back to READV/WRITEV.
+ */
+static QemuMutex luring_buf_lock;
+static LuringBufRegion luring_buf_regions[MAX_BUF_REGIONS];
+static unsigned luring_buf_count;
+static unsigned luring_buf_generation = 1;
+static bool luring_buf_disabled;
+
+static void luring_ram_block_added(RAMBlockNotifier *n, void *host,
+                                   size_t size, size_t max_size)
+{
+    QEMU_LOCK_GUARD(&luring_buf_lock);
+
+    if (luring_buf_disabled) {
+        return;
+    }
+    if (luring_buf_count == MAX_BUF_REGIONS) {
+        luring_buf_disabled = true;
+        qatomic_set(&luring_buf_generation, luring_buf_generation + 1);
+        return;
+    }
+    luring_buf_regions[luring_buf_count++] = (LuringBufRegion) {
+        .host = host,
+        .size = max_size,
+    };
+    qatomic_set(&luring_buf_generation, luring_buf_generation + 1);
+}
+
+static void luring_ram_block_removed(RAMBlockNotifier *n, void *host,
+                                     size_t size, size_t max_size)
+{
+    unsigned i;
+
+    QEMU_LOCK_GUARD(&luring_buf_lock);
+
+    for (i = 0; i < luring_buf_count; i++) {
+        if (luring_buf_regions[i].host == host) {
+            luring_buf_regions[i] = luring_buf_regions[--luring_buf_count];
+            qatomic_set(&luring_buf_generation, luring_buf_generation + 1);
+            return;
+        }
+    }
+}
+
+static RAMBlockNotifier luring_ram_notifier = {
+    .ram_block_added = luring_ram_block_added,
+    .ram_block_removed = luring_ram_block_removed,
+
+    /* .ram_block_resized() is not needed, regions are sized by max_size */
+};
+
+/*
+ * Runs before any thread is created, which also makes it the one safe
+ * place to hook into the RAM block notifier list without holding the
+ * BQL (luring_init() itself can run in an iothread).
+ */
+static void __attribute__((constructor)) luring_buf_init(void)
+{
+    qemu_mutex_init(&luring_buf_lock);
+    ram_block_notifier_add(&luring_ram_notifier);
+}
+
 typedef struct LuringAIOCB {
     Coroutine *co;
     struct io_uring_sqe sqeq;
     ssize_t ret;
     QEMUIOVector *qiov;
+    /* Length of a discard request; data requests carry their size in qiov */
+    uint64_t bytes;
     bool is_read;
     QSIMPLEQ_ENTRY(LuringAIOCB) next;
 
@@ -58,6 +142,16 @@ struct LuringState {
     LuringQueue io_q;
 
     QEMUBH *completion_bh;
+
+    /*
+     * Ring-local snapshot of the registered RAM regions; index i is the
+     * fixed buffer index i of this ring.  Only touched from the home
+     * thread, refreshed when buf_generation falls behind.
+     */
+    LuringBufRegion bufs[MAX_BUF_REGIONS];
+    unsigned nbufs;
+    unsigned buf_generation;
+    bool bufs_registered;
 };
 
 /**
@@ -323,6 +417,77 @@ static void luring_deferred_fn(void *opaque)
     }
 }
 
+/*
+ * Re-register the current RAM regions with this ring.  Must only be
+ * called while the ring has no requests in flight or queued, because
+ * re-registration renumbers the fixed buffer indices.
+ */
+static void luring_update_registered_bufs(LuringState *s)
+{
+    struct iovec iovs[MAX_BUF_REGIONS];
+    unsigned i;
+    int ret;
+
+    assert(s->io_q.in_flight == 0 && s->io_q.in_queue == 0);
+
+    if (s->bufs_registered) {
+        io_uring_unregister_buffers(&s->ring);
+        s->bufs_registered = false;
+    }
+    s->nbufs = 0;
+
+    WITH_QEMU_LOCK_GUARD(&luring_buf_lock) {
+        s->buf_generation = luring_buf_generation;
+        if (luring_buf_disabled || luring_buf_count == 0) {
+            return;
+        }
+        memcpy(s->bufs, luring_buf_regions,
+               luring_buf_count * sizeof(s->bufs[0]));
+        s->nbufs = luring_buf_count;
+    }
+
+    for (i = 0; i < s->nbufs; i++) {
+        iovs[i] = (struct iovec) {
+            .iov_base = s->bufs[i].host,
+            .iov_len = s->bufs[i].size,
+        };
+    }
+
+    ret = io_uring_register_buffers(&s->ring, iovs, s->nbufs);
+    if (ret < 0) {
+        /*
+         * Typically RLIMIT_MEMLOCK, or a kernel that caps the size of a
+         * single registered buffer below our largest RAM region.  Not
+         * worth retrying on every ring, so turn the feature off.
+         */
+        trace_luring_register_buffers_failed(s, ret);
+        s->nbufs = 0;
+        WITH_QEMU_LOCK_GUARD(&luring_buf_lock) {
+            luring_buf_disabled = true;
+        }
+        return;
+    }
+
+    s->bufs_registered = true;
+}
+
+/* Returns the fixed buffer index covering @iov, or -1 for none */
+static int luring_fixed_buf_index(LuringState *s, const struct iovec *iov)
+{
+    unsigned i;
+
+    for (i = 0; i < s->nbufs; i++) {
+        LuringBufRegion *region = &s->bufs[i];
+
+        if (iov->iov_base >= region->host &&
+            iov->iov_len <= region->size -
+                ((uint8_t *)iov->iov_base - (uint8_t *)region->host)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 /**
  * luring_do_submit:
  * @fd: file descriptor for I/O
@@ -339,23 +504,60 @@ static int luring_do_submit(int fd, LuringAIOCB *luringcb, LuringState *s,
 {
     int ret;
     struct io_uring_sqe *sqes = &luringcb->sqeq;
+    int buf_index = -1;
+
+    /*
+     * Catch up with RAM region changes while the ring is empty; a stale
+     * snapshot is still safe to use otherwise, it just misses new RAM.
+     */
+    if (s->buf_generation != qatomic_read(&luring_buf_generation) &&
+        s->io_q.in_flight == 0 && s->io_q.in_queue == 0) {
+        luring_update_registered_bufs(s);
+    }
+
+    /*
+     * FIXED opcodes take a single contiguous buffer, so only
+     * single-segment requests inside a registered region qualify; they
+     * skip the per-request page pinning that READV/WRITEV pay.
+     */
+    if (luringcb->qiov && luringcb->qiov->niov == 1 && s->bufs_registered) {
+        buf_index = luring_fixed_buf_index(s, &luringcb->qiov->iov[0]);
+    }
 
     switch (type) {
     case QEMU_AIO_WRITE:
-        io_uring_prep_writev(sqes, fd, luringcb->qiov->iov,
-                             luringcb->qiov->niov, offset);
-        break;
     case QEMU_AIO_ZONE_APPEND:
-        io_uring_prep_writev(sqes, fd, luringcb->qiov->iov,
-                             luringcb->qiov->niov, offset);
+        if (buf_index >= 0) {
+            io_uring_prep_write_fixed(sqes, fd,
+                                      luringcb->qiov->iov[0].iov_base,
+                                      luringcb->qiov->iov[0].iov_len,
+                                      offset, buf_index);
+        } else {
+            io_uring_prep_writev(sqes, fd, luringcb->qiov->iov,
+                                 luringcb->qiov->niov, offset);
+        }
         break;
     case QEMU_AIO_READ:
-        io_uring_prep_readv(sqes, fd, luringcb->qiov->iov,
-                            luringcb->qiov->niov, offset);
+        if (buf_index >= 0) {
+            io_uring_prep_read_fixed(sqes, fd,
+                                     luringcb->qiov->iov[0].iov_base,
+                                     luringcb->qiov->iov[0].iov_len,
+                                     offset, buf_index);
+        } else {
+            io_uring_prep_readv(sqes, fd, luringcb->qiov->iov,
+                                luringcb->qiov->niov, offset);
+        }
         break;
     case QEMU_AIO_FLUSH:
         io_uring_prep_fsync(sqes, fd, IORING_FSYNC_DATASYNC);
         break;
+#ifdef CONFIG_FALLOCATE_PUNCH_HOLE
+    case QEMU_AIO_DISCARD:
+        io_uring_prep_fallocate(sqes, fd,
+                                FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                                offset, luringcb->bytes);
+        break;
+#endif
     default:
         fprintf(stderr, "%s: invalid AIO request type, aborting 0x%x.\n",
                         __func__, type);
@@ -405,6 +607,41 @@ int coroutine_fn luring_co_submit(BlockDriverState *bs, int fd, uint64_t offset,
     return luringcb.ret;
 }
 
+/*
+ * Submit a discard as IORING_OP_FALLOCATE.  Returns -EINVAL or -EOPNOTSUPP
+ * when the kernel or the filesystem cannot punch holes through io_uring;
+ * the caller is expected to fall back to the thread pool then.
+ */
+int coroutine_fn luring_co_pdiscard(BlockDriverState *bs, int fd,
+                                    uint64_t offset, uint64_t bytes)
+{
+#ifdef CONFIG_FALLOCATE_PUNCH_HOLE
+    int ret;
+    AioContext *ctx = qemu_get_current_aio_context();
+    LuringState *s = aio_get_linux_io_uring(ctx);
+    LuringAIOCB luringcb = {
+        .co         = qemu_coroutine_self(),
+        .ret        = -EINPROGRESS,
+        .bytes      = bytes,
+    };
+
+    trace_luring_co_submit(bs, s, &luringcb, fd, offset, bytes,
+                           QEMU_AIO_DISCARD);
+    ret = luring_do_submit(fd, &luringcb, s, offset, QEMU_AIO_DISCARD);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (luringcb.ret == -EINPROGRESS) {
+        qemu_coroutine_yield();
+    }
+    return luringcb.ret;
+#else
+    return -ENOTSUP;
+#endif
+}
+
 void luring_detach_aio_context(LuringState *s, AioContext *old_context)
 {
     aio_set_fd_handler(old_context, s->ring.ring_fd,
@@ -439,7 +676,6 @@ LuringState *luring_init(Error **errp)
 
     ioq_init(&s->io_q);
     return s;
-
 }
 
 void luring_cleanup(LuringState *s)
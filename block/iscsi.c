@@ -381,7 +381,17 @@ static void iscsi_timed_check_events(void *opaque)
 
         if (iscsilun->request_timed_out) {
             iscsilun->request_timed_out = false;
+#if LIBISCSI_API_VERSION >= (20160603)
+            /*
+             * Ask libiscsi to reconnect from its event loop instead of
+             * blocking this AioContext until the portal answers; queued
+             * and in-flight requests are re-issued once the session is
+             * re-established.
+             */
+            iscsi_reconnect_request(iscsilun->iscsi);
+#else
             iscsi_reconnect(iscsilun->iscsi);
+#endif
         }
 
         /*
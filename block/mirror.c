@@ -1132,7 +1132,8 @@ static int coroutine_fn mirror_run(Job *job, Error **errp)
             /* The two disks are in sync.  Exit and report successful
              * completion.
              */
-            assert(QLIST_EMPTY(&bs->tracked_requests));
+            assert(!interval_tree_iter_first(&bs->tracked_requests,
+                                             0, UINT64_MAX));
             need_drain = false;
             break;
         }
@@ -416,7 +416,7 @@ void hmp_nbd_server_start(Monitor *mon, const QDict *qdict)
     /* Then try adding all block devices.  If one fails, close all and
      * exit.
      */
-    block_list = qmp_query_block(NULL);
+    block_list = bdrv_query_block_info_list(NULL);
 
     for (info = block_list; info; info = info->next) {
         if (!info->value->inserted) {
@@ -734,7 +734,7 @@ void hmp_info_block(Monitor *mon, const QDict *qdict)
 
     /* Print BlockBackend information */
     if (!nodes) {
-        block_list = qmp_query_block(NULL);
+        block_list = bdrv_query_block_info_list(NULL);
     } else {
         block_list = NULL;
     }
@@ -760,7 +760,7 @@ void hmp_info_block(Monitor *mon, const QDict *qdict)
     }
 
     /* Print node information */
-    blockdev_list = qmp_query_named_block_nodes(false, false, NULL);
+    blockdev_list = bdrv_named_nodes_list(false, NULL);
     for (blockdev = blockdev_list; blockdev; blockdev = blockdev->next) {
         assert(blockdev->value->node_name);
         if (device && strcmp(device, blockdev->value->node_name)) {
@@ -780,7 +780,7 @@ void hmp_info_blockstats(Monitor *mon, const QDict *qdict)
 {
     BlockStatsList *stats_list, *stats;
 
-    stats_list = qmp_query_blockstats(false, false, NULL);
+    stats_list = bdrv_query_blockstats_list(false);
 
     for (stats = stats_list; stats; stats = stats->next) {
         if (!stats->value->device) {
@@ -492,13 +492,26 @@ nbd_co_send_request(BlockDriverState *bs, NBDRequest *request,
                     QEMUIOVector *qiov)
 {
     BDRVNBDState *s = (BDRVNBDState *)bs->opaque;
+    int64_t stall_start_ns = 0;
     int rc, i = -1;
 
     qemu_mutex_lock(&s->requests_lock);
     while (s->in_flight == MAX_NBD_REQUESTS ||
            (s->state != NBD_CLIENT_CONNECTED && s->in_flight > 0)) {
+        /*
+         * The connection is saturated (or down); record for how long new
+         * requests stall on the in-flight window, it is the signal for
+         * sizing the export's queue depth.
+         */
+        if (!stall_start_ns) {
+            stall_start_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+        }
         qemu_co_queue_wait(&s->free_sema, &s->requests_lock);
     }
+    if (stall_start_ns) {
+        trace_nbd_co_send_request_stall(
+            qemu_clock_get_ns(QEMU_CLOCK_REALTIME) - stall_start_ns);
+    }
 
     s->in_flight++;
     if (s->state != NBD_CLIENT_CONNECTED) {
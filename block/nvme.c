@@ -49,6 +49,15 @@ typedef struct BDRVNVMeState BDRVNVMeState;
 #define INDEX_ADMIN     0
 #define INDEX_IO(n)     (1 + n)
 
+/*
+ * How many I/O queue pairs to try to create.  Multiqueue block devices
+ * can submit from several iothreads at once; spreading those threads
+ * over their own SQ/CQ pairs keeps them off each other's queue lock and
+ * SQ doorbell.  Queues beyond the first are optional, a device that
+ * refuses to create them just leaves us with fewer.
+ */
+#define MAX_IO_QUEUES   4
+
 /* This driver shares a single MSIX IRQ for the admin and I/O queues */
 enum {
     MSIX_SHARED_IRQ_IDX = 0,
@@ -709,6 +718,29 @@ out_error:
     return false;
 }
 
+/*
+ * Pick the I/O queue for a request submitted from the current thread.
+ * Threads are spread round-robin over the available queues the first
+ * time they submit; completions for all queues are still processed in
+ * the BDS's home AioContext via the shared IRQ and poll handlers.
+ */
+static NVMeQueuePair *nvme_get_io_queue(BDRVNVMeState *s)
+{
+    static unsigned next_thread_seq;
+    static __thread unsigned thread_seq;
+    unsigned nr_io_queues = s->queue_count - 1;
+
+    assert(s->queue_count > 1);
+
+    if (nr_io_queues == 1) {
+        return s->queues[INDEX_IO(0)];
+    }
+    if (thread_seq == 0) {
+        thread_seq = qatomic_fetch_inc(&next_thread_seq) + 1;
+    }
+    return s->queues[INDEX_IO((thread_seq - 1) % nr_io_queues)];
+}
+
 static bool nvme_poll_cb(void *opaque)
 {
     EventNotifier *e = opaque;
@@ -883,6 +915,20 @@ static int nvme_init(BlockDriverState *bs, const char *device, int namespace,
     /* Set up command queues. */
     if (!nvme_add_io_queue(bs, errp)) {
         ret = -EIO;
+        goto out;
+    }
+
+    /*
+     * Additional queues are an optimization; a device that cannot create
+     * them simply leaves us submitting everything on the first one.
+     */
+    while (s->queue_count - 1 < MAX_IO_QUEUES) {
+        Error *local_err = NULL;
+
+        if (!nvme_add_io_queue(bs, &local_err)) {
+            error_free(local_err);
+            break;
+        }
     }
 out:
     if (regs) {
@@ -1188,7 +1234,7 @@ static coroutine_fn int nvme_co_prw_aligned(BlockDriverState *bs,
 {
     int r;
     BDRVNVMeState *s = bs->opaque;
-    NVMeQueuePair *ioq = s->queues[INDEX_IO(0)];
+    NVMeQueuePair *ioq = nvme_get_io_queue(s);
     NVMeRequest *req;
 
     uint32_t cdw12 = (((bytes >> s->blkshift) - 1) & 0xFFFF) |
@@ -1309,7 +1355,7 @@ static coroutine_fn int nvme_co_pwritev(BlockDriverState *bs,
 static coroutine_fn int nvme_co_flush(BlockDriverState *bs)
 {
     BDRVNVMeState *s = bs->opaque;
-    NVMeQueuePair *ioq = s->queues[INDEX_IO(0)];
+    NVMeQueuePair *ioq = nvme_get_io_queue(s);
     NVMeRequest *req;
     NvmeCmd cmd = {
         .opcode = NVME_CMD_FLUSH,
@@ -1340,7 +1386,7 @@ static coroutine_fn int nvme_co_pwrite_zeroes(BlockDriverState *bs,
                                               BdrvRequestFlags flags)
 {
     BDRVNVMeState *s = bs->opaque;
-    NVMeQueuePair *ioq = s->queues[INDEX_IO(0)];
+    NVMeQueuePair *ioq = nvme_get_io_queue(s);
     NVMeRequest *req;
     uint32_t cdw12;
 
@@ -1403,7 +1449,7 @@ static int coroutine_fn nvme_co_pdiscard(BlockDriverState *bs,
                                          int64_t bytes)
 {
     BDRVNVMeState *s = bs->opaque;
-    NVMeQueuePair *ioq = s->queues[INDEX_IO(0)];
+    NVMeQueuePair *ioq = nvme_get_io_queue(s);
     NVMeRequest *req;
     QEMU_AUTO_VFREE NvmeDsmRange *buf = NULL;
     QEMUIOVector local_qiov;
@@ -476,18 +476,24 @@ static uint64List *uint64_list(uint64_t *list, int size)
     return out_list;
 }
 
+/* Called within an RCU read-side critical section */
 static BlockLatencyHistogramInfo *
 bdrv_latency_histogram_stats(BlockLatencyHistogram *hist)
 {
     BlockLatencyHistogramInfo *info;
+    uint64List **tail;
+    int i;
 
-    if (!hist->bins) {
+    if (!hist) {
         return NULL;
     }
 
     info = g_new0(BlockLatencyHistogramInfo, 1);
     info->boundaries = uint64_list(hist->boundaries, hist->nbins - 1);
-    info->bins = uint64_list(hist->bins, hist->nbins);
+    tail = &info->bins;
+    for (i = 0; i < hist->nbins; i++) {
+        QAPI_LIST_APPEND(tail, stat64_get(&hist->bins[i]));
+    }
     return info;
 }
 
@@ -495,45 +501,53 @@ static void bdrv_query_blk_stats(BlockDeviceStats *ds, BlockBackend *blk)
 {
     BlockAcctStats *stats = blk_get_stats(blk);
     BlockAcctTimedStats *ts = NULL;
-    BlockLatencyHistogram *hgram;
-
-    ds->rd_bytes = stats->nr_bytes[BLOCK_ACCT_READ];
-    ds->wr_bytes = stats->nr_bytes[BLOCK_ACCT_WRITE];
-    ds->zone_append_bytes = stats->nr_bytes[BLOCK_ACCT_ZONE_APPEND];
-    ds->unmap_bytes = stats->nr_bytes[BLOCK_ACCT_UNMAP];
-    ds->rd_operations = stats->nr_ops[BLOCK_ACCT_READ];
-    ds->wr_operations = stats->nr_ops[BLOCK_ACCT_WRITE];
-    ds->zone_append_operations = stats->nr_ops[BLOCK_ACCT_ZONE_APPEND];
-    ds->unmap_operations = stats->nr_ops[BLOCK_ACCT_UNMAP];
-
-    ds->failed_rd_operations = stats->failed_ops[BLOCK_ACCT_READ];
-    ds->failed_wr_operations = stats->failed_ops[BLOCK_ACCT_WRITE];
+    BlockLatencyHistogram **hgram;
+
+    ds->rd_bytes = stat64_get(&stats->nr_bytes[BLOCK_ACCT_READ]);
+    ds->wr_bytes = stat64_get(&stats->nr_bytes[BLOCK_ACCT_WRITE]);
+    ds->zone_append_bytes = stat64_get(&stats->nr_bytes[BLOCK_ACCT_ZONE_APPEND]);
+    ds->unmap_bytes = stat64_get(&stats->nr_bytes[BLOCK_ACCT_UNMAP]);
+    ds->rd_operations = stat64_get(&stats->nr_ops[BLOCK_ACCT_READ]);
+    ds->wr_operations = stat64_get(&stats->nr_ops[BLOCK_ACCT_WRITE]);
+    ds->zone_append_operations =
+        stat64_get(&stats->nr_ops[BLOCK_ACCT_ZONE_APPEND]);
+    ds->unmap_operations = stat64_get(&stats->nr_ops[BLOCK_ACCT_UNMAP]);
+
+    ds->failed_rd_operations = stat64_get(&stats->failed_ops[BLOCK_ACCT_READ]);
+    ds->failed_wr_operations = stat64_get(&stats->failed_ops[BLOCK_ACCT_WRITE]);
     ds->failed_zone_append_operations =
-        stats->failed_ops[BLOCK_ACCT_ZONE_APPEND];
-    ds->failed_flush_operations = stats->failed_ops[BLOCK_ACCT_FLUSH];
-    ds->failed_unmap_operations = stats->failed_ops[BLOCK_ACCT_UNMAP];
-
-    ds->invalid_rd_operations = stats->invalid_ops[BLOCK_ACCT_READ];
-    ds->invalid_wr_operations = stats->invalid_ops[BLOCK_ACCT_WRITE];
+        stat64_get(&stats->failed_ops[BLOCK_ACCT_ZONE_APPEND]);
+    ds->failed_flush_operations =
+        stat64_get(&stats->failed_ops[BLOCK_ACCT_FLUSH]);
+    ds->failed_unmap_operations =
+        stat64_get(&stats->failed_ops[BLOCK_ACCT_UNMAP]);
+
+    ds->invalid_rd_operations =
+        stat64_get(&stats->invalid_ops[BLOCK_ACCT_READ]);
+    ds->invalid_wr_operations =
+        stat64_get(&stats->invalid_ops[BLOCK_ACCT_WRITE]);
     ds->invalid_zone_append_operations =
-        stats->invalid_ops[BLOCK_ACCT_ZONE_APPEND];
+        stat64_get(&stats->invalid_ops[BLOCK_ACCT_ZONE_APPEND]);
     ds->invalid_flush_operations =
-        stats->invalid_ops[BLOCK_ACCT_FLUSH];
-    ds->invalid_unmap_operations = stats->invalid_ops[BLOCK_ACCT_UNMAP];
-
-    ds->rd_merged = stats->merged[BLOCK_ACCT_READ];
-    ds->wr_merged = stats->merged[BLOCK_ACCT_WRITE];
-    ds->zone_append_merged = stats->merged[BLOCK_ACCT_ZONE_APPEND];
-    ds->unmap_merged = stats->merged[BLOCK_ACCT_UNMAP];
-    ds->flush_operations = stats->nr_ops[BLOCK_ACCT_FLUSH];
-    ds->wr_total_time_ns = stats->total_time_ns[BLOCK_ACCT_WRITE];
+        stat64_get(&stats->invalid_ops[BLOCK_ACCT_FLUSH]);
+    ds->invalid_unmap_operations =
+        stat64_get(&stats->invalid_ops[BLOCK_ACCT_UNMAP]);
+
+    ds->rd_merged = stat64_get(&stats->merged[BLOCK_ACCT_READ]);
+    ds->wr_merged = stat64_get(&stats->merged[BLOCK_ACCT_WRITE]);
+    ds->zone_append_merged = stat64_get(&stats->merged[BLOCK_ACCT_ZONE_APPEND]);
+    ds->unmap_merged = stat64_get(&stats->merged[BLOCK_ACCT_UNMAP]);
+    ds->flush_operations = stat64_get(&stats->nr_ops[BLOCK_ACCT_FLUSH]);
+    ds->wr_total_time_ns = stat64_get(&stats->total_time_ns[BLOCK_ACCT_WRITE]);
     ds->zone_append_total_time_ns =
-        stats->total_time_ns[BLOCK_ACCT_ZONE_APPEND];
-    ds->rd_total_time_ns = stats->total_time_ns[BLOCK_ACCT_READ];
-    ds->flush_total_time_ns = stats->total_time_ns[BLOCK_ACCT_FLUSH];
-    ds->unmap_total_time_ns = stats->total_time_ns[BLOCK_ACCT_UNMAP];
-
-    ds->has_idle_time_ns = stats->last_access_time_ns > 0;
+        stat64_get(&stats->total_time_ns[BLOCK_ACCT_ZONE_APPEND]);
+    ds->rd_total_time_ns = stat64_get(&stats->total_time_ns[BLOCK_ACCT_READ]);
+    ds->flush_total_time_ns =
+        stat64_get(&stats->total_time_ns[BLOCK_ACCT_FLUSH]);
+    ds->unmap_total_time_ns =
+        stat64_get(&stats->total_time_ns[BLOCK_ACCT_UNMAP]);
+
+    ds->has_idle_time_ns = stat64_get(&stats->last_access_time_ns) > 0;
     if (ds->has_idle_time_ns) {
         ds->idle_time_ns = block_acct_idle_time_ns(stats);
     }
@@ -578,14 +592,16 @@ static void bdrv_query_blk_stats(BlockDeviceStats *ds, BlockBackend *blk)
     }
 
     hgram = stats->latency_histogram;
-    ds->rd_latency_histogram
-        = bdrv_latency_histogram_stats(&hgram[BLOCK_ACCT_READ]);
-    ds->wr_latency_histogram
-        = bdrv_latency_histogram_stats(&hgram[BLOCK_ACCT_WRITE]);
-    ds->zone_append_latency_histogram
-        = bdrv_latency_histogram_stats(&hgram[BLOCK_ACCT_ZONE_APPEND]);
-    ds->flush_latency_histogram
-        = bdrv_latency_histogram_stats(&hgram[BLOCK_ACCT_FLUSH]);
+    WITH_RCU_READ_LOCK_GUARD() {
+        ds->rd_latency_histogram = bdrv_latency_histogram_stats(
+            qatomic_rcu_read(&hgram[BLOCK_ACCT_READ]));
+        ds->wr_latency_histogram = bdrv_latency_histogram_stats(
+            qatomic_rcu_read(&hgram[BLOCK_ACCT_WRITE]));
+        ds->zone_append_latency_histogram = bdrv_latency_histogram_stats(
+            qatomic_rcu_read(&hgram[BLOCK_ACCT_ZONE_APPEND]));
+        ds->flush_latency_histogram = bdrv_latency_histogram_stats(
+            qatomic_rcu_read(&hgram[BLOCK_ACCT_FLUSH]));
+    }
 }
 
 static BlockStats * GRAPH_RDLOCK
@@ -660,14 +676,12 @@ bdrv_query_bds_stats(BlockDriverState *bs, bool blk_level)
     return s;
 }
 
-BlockInfoList *qmp_query_block(Error **errp)
+static BlockInfoList * GRAPH_RDLOCK bdrv_do_query_block(Error **errp)
 {
     BlockInfoList *head = NULL, **p_next = &head;
     BlockBackend *blk;
     Error *local_err = NULL;
 
-    GRAPH_RDLOCK_GUARD_MAINLOOP();
-
     for (blk = blk_all_next(NULL); blk; blk = blk_all_next(blk)) {
         BlockInfoList *info;
 
@@ -691,18 +705,27 @@ BlockInfoList *qmp_query_block(Error **errp)
     return head;
 }
 
-BlockStatsList *qmp_query_blockstats(bool has_query_nodes,
-                                     bool query_nodes,
-                                     Error **errp)
+BlockInfoList *bdrv_query_block_info_list(Error **errp)
+{
+    GRAPH_RDLOCK_GUARD_MAINLOOP();
+
+    return bdrv_do_query_block(errp);
+}
+
+BlockInfoList *coroutine_fn qmp_query_block(Error **errp)
+{
+    GRAPH_RDLOCK_GUARD();
+
+    return bdrv_do_query_block(errp);
+}
+
+static BlockStatsList * GRAPH_RDLOCK bdrv_do_query_blockstats(bool query_nodes)
 {
     BlockStatsList *head = NULL, **tail = &head;
     BlockBackend *blk;
     BlockDriverState *bs;
 
-    GRAPH_RDLOCK_GUARD_MAINLOOP();
-
-    /* Just to be safe if query_nodes is not always initialized */
-    if (has_query_nodes && query_nodes) {
+    if (query_nodes) {
         for (bs = bdrv_next_node(NULL); bs; bs = bdrv_next_node(bs)) {
             QAPI_LIST_APPEND(tail, bdrv_query_bds_stats(bs, false));
         }
@@ -734,6 +757,23 @@ BlockStatsList *qmp_query_blockstats(bool has_query_nodes,
     return head;
 }
 
+BlockStatsList *bdrv_query_blockstats_list(bool query_nodes)
+{
+    GRAPH_RDLOCK_GUARD_MAINLOOP();
+
+    return bdrv_do_query_blockstats(query_nodes);
+}
+
+BlockStatsList *coroutine_fn qmp_query_blockstats(bool has_query_nodes,
+                                                  bool query_nodes,
+                                                  Error **errp)
+{
+    GRAPH_RDLOCK_GUARD();
+
+    /* Just to be safe if query_nodes is not always initialized */
+    return bdrv_do_query_blockstats(has_query_nodes && query_nodes);
+}
+
 void bdrv_snapshot_dump(QEMUSnapshotInfo *sn)
 {
     char clock_buf[128];
@@ -964,13 +964,80 @@ int qcow2_update_cluster_refcount(BlockDriverState *bs,
 
 
 
+/*
+ * Counts how many consecutive clusters starting at @cluster_index have a
+ * refcount of zero, up to a maximum of @nb_clusters.  Unlike calling
+ * qcow2_get_refcount() in a loop, this pins each refcount block in the
+ * cache only once and then scans its entries directly, so the cost of a
+ * large allocation no longer grows with one cache lookup per cluster.
+ *
+ * Returns the length of the run (which may be 0) or -errno.
+ */
+static int64_t qcow2_free_cluster_run(BlockDriverState *bs,
+                                      int64_t cluster_index,
+                                      uint64_t nb_clusters)
+{
+    BDRVQcow2State *s = bs->opaque;
+    uint64_t run = 0;
+
+    while (run < nb_clusters) {
+        uint64_t refcount_table_index =
+            (cluster_index + run) >> s->refcount_block_bits;
+        uint64_t block_index =
+            (cluster_index + run) & (s->refcount_block_size - 1);
+        int64_t refcount_block_offset;
+        void *refcount_block;
+        int ret;
+
+        if (refcount_table_index >= s->refcount_table_size) {
+            /* Clusters beyond the refcount table are unallocated */
+            return nb_clusters;
+        }
+
+        refcount_block_offset =
+            s->refcount_table[refcount_table_index] & REFT_OFFSET_MASK;
+        if (!refcount_block_offset) {
+            /* The whole rest of this refcount block is unallocated */
+            run += s->refcount_block_size - block_index;
+            continue;
+        }
+
+        if (offset_into_cluster(s, refcount_block_offset)) {
+            qcow2_signal_corruption(bs, true, -1, -1, "Refblock offset %#"
+                                    PRIx64 " unaligned (reftable index: %#"
+                                    PRIx64 ")", refcount_block_offset,
+                                    refcount_table_index);
+            return -EIO;
+        }
+
+        ret = qcow2_cache_get(bs, s->refcount_block_cache,
+                              refcount_block_offset, &refcount_block);
+        if (ret < 0) {
+            return ret;
+        }
+
+        while (run < nb_clusters && block_index < s->refcount_block_size) {
+            if (s->get_refcount(refcount_block, block_index) != 0) {
+                qcow2_cache_put(s->refcount_block_cache, &refcount_block);
+                return run;
+            }
+            block_index++;
+            run++;
+        }
+
+        qcow2_cache_put(s->refcount_block_cache, &refcount_block);
+    }
+
+    return MIN(run, nb_clusters);
+}
+
 /* return < 0 if error */
 static int64_t GRAPH_RDLOCK
 alloc_clusters_noref(BlockDriverState *bs, uint64_t size, uint64_t max)
 {
     BDRVQcow2State *s = bs->opaque;
-    uint64_t i, nb_clusters, refcount;
-    int ret;
+    uint64_t nb_clusters;
+    int64_t run;
 
     /* We can't allocate clusters if they may still be queued for discard. */
     if (s->cache_discards) {
@@ -979,16 +1046,15 @@ alloc_clusters_noref(BlockDriverState *bs, uint64_t size, uint64_t max)
 
     nb_clusters = size_to_clusters(s, size);
 retry:
-    for(i = 0; i < nb_clusters; i++) {
-        uint64_t next_cluster_index = s->free_cluster_index++;
-        ret = qcow2_get_refcount(bs, next_cluster_index, &refcount);
-
-        if (ret < 0) {
-            return ret;
-        } else if (refcount != 0) {
-            goto retry;
-        }
+    run = qcow2_free_cluster_run(bs, s->free_cluster_index, nb_clusters);
+    if (run < 0) {
+        return run;
+    } else if (run < nb_clusters) {
+        /* Skip past the cluster that cut the run short and try again */
+        s->free_cluster_index += run + 1;
+        goto retry;
     }
+    s->free_cluster_index += nb_clusters;
 
     /* Make sure that all offsets in the "allocated" range are representable
      * in the requested max */
@@ -1032,8 +1098,9 @@ int64_t coroutine_fn qcow2_alloc_clusters_at(BlockDriverState *bs, uint64_t offs
                                              int64_t nb_clusters)
 {
     BDRVQcow2State *s = bs->opaque;
-    uint64_t cluster_index, refcount;
+    uint64_t cluster_index;
     uint64_t i;
+    int64_t run;
     int ret;
 
     assert(nb_clusters >= 0);
@@ -1044,14 +1111,11 @@ int64_t coroutine_fn qcow2_alloc_clusters_at(BlockDriverState *bs, uint64_t offs
     do {
         /* Check how many clusters there are free */
         cluster_index = offset >> s->cluster_bits;
-        for(i = 0; i < nb_clusters; i++) {
-            ret = qcow2_get_refcount(bs, cluster_index++, &refcount);
-            if (ret < 0) {
-                return ret;
-            } else if (refcount != 0) {
-                break;
-            }
+        run = qcow2_free_cluster_run(bs, cluster_index, nb_clusters);
+        if (run < 0) {
+            return run;
         }
+        i = run;
 
         /* And then allocate them */
         ret = update_refcount(bs, offset, i << s->cluster_bits, 1, false,
@@ -1590,6 +1654,9 @@ enum {
     CHECK_FRAG_INFO = 0x2,      /* update BlockFragInfo counters */
 };
 
+/* Read at most this many bytes of contiguous L2 tables in one request */
+#define QCOW2_CHECK_L2_BATCH_SIZE (16 * MiB)
+
 /*
  * Fix L2 entry by making it QCOW2_CLUSTER_ZERO_PLAIN (or making all its present
  * subclusters QCOW2_SUBCLUSTER_ZERO_PLAIN).
@@ -1656,6 +1723,9 @@ fail:
  * referenced in the L2 table. While doing so, performs some checks on L2
  * entries.
  *
+ * If @l2_preread is non-NULL it holds the table contents, already read
+ * from @l2_offset by the caller; otherwise the table is read here.
+ *
  * Returns the number of errors found by the checks or -errno if an internal
  * error occurred.
  */
@@ -1663,6 +1733,7 @@ static int coroutine_fn GRAPH_RDLOCK
 check_refcounts_l2(BlockDriverState *bs, BdrvCheckResult *res,
                    void **refcount_table,
                    int64_t *refcount_table_size, int64_t l2_offset,
+                   uint64_t *l2_preread,
                    int flags, BdrvCheckMode fix, bool active)
 {
     BDRVQcow2State *s = bs->opaque;
@@ -1670,15 +1741,21 @@ check_refcounts_l2(BlockDriverState *bs, BdrvCheckResult *res,
     uint64_t next_contiguous_offset = 0;
     int i, ret;
     size_t l2_size_bytes = s->l2_size * l2_entry_size(s);
-    g_autofree uint64_t *l2_table = g_malloc(l2_size_bytes);
+    g_autofree uint64_t *l2_table_alloc = NULL;
+    uint64_t *l2_table = l2_preread;
     bool metadata_overlap;
 
-    /* Read L2 table from disk */
-    ret = bdrv_co_pread(bs->file, l2_offset, l2_size_bytes, l2_table, 0);
-    if (ret < 0) {
-        fprintf(stderr, "ERROR: I/O error in check_refcounts_l2\n");
-        res->check_errors++;
-        return ret;
+    if (!l2_table) {
+        l2_table_alloc = g_malloc(l2_size_bytes);
+        l2_table = l2_table_alloc;
+
+        /* Read L2 table from disk */
+        ret = bdrv_co_pread(bs->file, l2_offset, l2_size_bytes, l2_table, 0);
+        if (ret < 0) {
+            fprintf(stderr, "ERROR: I/O error in check_refcounts_l2\n");
+            res->check_errors++;
+            return ret;
+        }
     }
 
     /* Do the actual checks */
@@ -1867,7 +1944,13 @@ check_refcounts_l1(BlockDriverState *bs, BdrvCheckResult *res,
 {
     BDRVQcow2State *s = bs->opaque;
     size_t l1_size_bytes = l1_size * L1E_SIZE;
+    size_t l2_size_bytes = s->l2_size * l2_entry_size(s);
+    size_t l2_stride = l2_size_bytes / sizeof(uint64_t);
     g_autofree uint64_t *l1_table = NULL;
+    g_autofree uint64_t *l2_batch = NULL;
+    int max_batch = MAX(1, (int)(QCOW2_CHECK_L2_BATCH_SIZE / l2_size_bytes));
+    int64_t batch_start = -1;
+    int batch_len = 0;
     uint64_t l2_offset;
     int i, ret;
 
@@ -1896,6 +1979,12 @@ check_refcounts_l1(BlockDriverState *bs, BdrvCheckResult *res,
         return ret;
     }
 
+    /*
+     * Best effort: without the batch buffer every L2 table is simply
+     * read individually as before.
+     */
+    l2_batch = g_try_malloc((size_t)max_batch * l2_size_bytes);
+
     for (i = 0; i < l1_size; i++) {
         be64_to_cpus(&l1_table[i]);
     }
@@ -1929,10 +2018,39 @@ check_refcounts_l1(BlockDriverState *bs, BdrvCheckResult *res,
             res->corruptions++;
         }
 
+        /*
+         * L2 tables of an image written sequentially tend to sit next
+         * to each other on disk.  Fetch such a run with one big read
+         * instead of a round trip per table; a failed batch read just
+         * falls back to the per-table read in check_refcounts_l2().
+         */
+        if (l2_batch && (batch_start < 0 || i >= batch_start + batch_len) &&
+            !offset_into_cluster(s, l2_offset)) {
+            int run = 1;
+
+            while (run < max_batch && i + run < l1_size &&
+                   (l1_table[i + run] & L1E_OFFSET_MASK) ==
+                       l2_offset + (uint64_t)run * l2_size_bytes) {
+                run++;
+            }
+            batch_start = -1;
+            batch_len = 0;
+            if (run > 1 &&
+                bdrv_co_pread(bs->file, l2_offset,
+                              (uint64_t)run * l2_size_bytes, l2_batch, 0) == 0)
+            {
+                batch_start = i;
+                batch_len = run;
+            }
+        }
+
         /* Process and check L2 entries */
         ret = check_refcounts_l2(bs, res, refcount_table,
-                                 refcount_table_size, l2_offset, flags,
-                                 fix, active);
+                                 refcount_table_size, l2_offset,
+                                 batch_start >= 0 && i < batch_start + batch_len
+                                     ? l2_batch + (i - batch_start) * l2_stride
+                                     : NULL,
+                                 flags, fix, active);
         if (ret < 0) {
             return ret;
         }
@@ -1020,6 +1020,8 @@ qcow2_cache_get_empty(BlockDriverState *bs, Qcow2Cache *c, uint64_t offset,
 
 void qcow2_cache_put(Qcow2Cache *c, void **table);
 void *qcow2_cache_is_table_offset(Qcow2Cache *c, uint64_t offset);
+uint64_t qcow2_cache_get_hits(Qcow2Cache *c);
+uint64_t qcow2_cache_get_misses(Qcow2Cache *c);
 void qcow2_cache_discard(Qcow2Cache *c, void *table);
 
 /* qcow2-bitmap.c functions */
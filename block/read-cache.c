@@ -0,0 +1,412 @@
+/*
+ * Read cache filter block driver
+ *
+ * The driver keeps recently read data in a RAM arena so that repeated
+ * reads are served locally instead of going to a slow protocol backend
+ * (NFS, RBD, ...).  The cache is organized in fixed-size lines with
+ * CLOCK (second chance) eviction.  Writes go around the cache: they are
+ * forwarded to the underlying node and invalidate any cached lines they
+ * touch, so the cache never holds dirty data and losing it is always
+ * safe.
+ *
+ * Copyright (c) 2026 QEMU contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qemu/osdep.h"
+
+#include "qapi/error.h"
+#include "qemu/coroutine.h"
+#include "qemu/memalign.h"
+#include "qemu/module.h"
+#include "qemu/option.h"
+#include "qemu/stats64.h"
+#include "qemu/units.h"
+#include "block/block-io.h"
+#include "block/block_int.h"
+
+#define READ_CACHE_DEFAULT_CACHE_SIZE (64 * MiB)
+#define READ_CACHE_DEFAULT_LINE_SIZE (64 * KiB)
+
+typedef struct ReadCacheLine {
+    int64_t offset;             /* line-aligned guest offset, -1 if unused */
+    bool referenced;            /* CLOCK second-chance bit */
+} ReadCacheLine;
+
+typedef struct BDRVReadCacheState {
+    uint64_t line_size;
+    unsigned num_lines;
+    uint8_t *arena;             /* num_lines * line_size bytes */
+    ReadCacheLine *lines;
+    GHashTable *map;            /* line offset -> line index */
+    unsigned clock_hand;
+
+    /*
+     * Protects map, lines, clock_hand, arena contents and write_gen.
+     * Never held across I/O to the underlying node.
+     */
+    CoMutex lock;
+
+    /*
+     * Bumped on every write/zero/discard.  A read that went to the
+     * underlying node only populates the cache if no invalidation
+     * happened while it was in flight, so it can never insert data
+     * that a concurrent write has already superseded.
+     */
+    uint64_t write_gen;
+
+    Stat64 hits;
+    Stat64 misses;
+} BDRVReadCacheState;
+
+#define READ_CACHE_OPT_CACHE_SIZE "cache-size"
+#define READ_CACHE_OPT_LINE_SIZE "line-size"
+static QemuOptsList runtime_opts = {
+    .name = "read-cache",
+    .head = QTAILQ_HEAD_INITIALIZER(runtime_opts.head),
+    .desc = {
+        {
+            .name = READ_CACHE_OPT_CACHE_SIZE,
+            .type = QEMU_OPT_SIZE,
+            .help = "total size of the RAM cache, default 64M",
+        },
+        {
+            .name = READ_CACHE_OPT_LINE_SIZE,
+            .type = QEMU_OPT_SIZE,
+            .help = "size of one cache line, default 64k",
+        },
+        { /* end of list */ }
+    },
+};
+
+static int GRAPH_UNLOCKED
+read_cache_open(BlockDriverState *bs, QDict *options, int flags, Error **errp)
+{
+    BDRVReadCacheState *s = bs->opaque;
+    QemuOpts *opts;
+    uint64_t cache_size;
+    int ret;
+    unsigned i;
+
+    GLOBAL_STATE_CODE();
+
+    ret = bdrv_open_file_child(NULL, options, "file", bs, errp);
+    if (ret < 0) {
+        return ret;
+    }
+
+    opts = qemu_opts_create(&runtime_opts, NULL, 0, &error_abort);
+    if (!qemu_opts_absorb_qdict(opts, options, errp)) {
+        qemu_opts_del(opts);
+        return -EINVAL;
+    }
+    cache_size = qemu_opt_get_size(opts, READ_CACHE_OPT_CACHE_SIZE,
+                                   READ_CACHE_DEFAULT_CACHE_SIZE);
+    s->line_size = qemu_opt_get_size(opts, READ_CACHE_OPT_LINE_SIZE,
+                                     READ_CACHE_DEFAULT_LINE_SIZE);
+    qemu_opts_del(opts);
+
+    if (!is_power_of_2(s->line_size) || s->line_size < BDRV_SECTOR_SIZE) {
+        error_setg(errp, "line-size must be a power of two of at least %llu",
+                   BDRV_SECTOR_SIZE);
+        return -EINVAL;
+    }
+    if (cache_size < s->line_size || cache_size / s->line_size > UINT_MAX) {
+        error_setg(errp, "cache-size must hold at least one line");
+        return -EINVAL;
+    }
+
+    s->num_lines = cache_size / s->line_size;
+    s->arena = qemu_try_blockalign(bs->file->bs,
+                                   (size_t)s->num_lines * s->line_size);
+    if (!s->arena) {
+        error_setg(errp, "Failed to allocate %" PRIu64 " bytes of cache",
+                   (uint64_t)s->num_lines * s->line_size);
+        return -ENOMEM;
+    }
+    s->lines = g_new(ReadCacheLine, s->num_lines);
+    for (i = 0; i < s->num_lines; i++) {
+        s->lines[i] = (ReadCacheLine) {
+            .offset = -1,
+        };
+    }
+    s->map = g_hash_table_new(g_int64_hash, g_int64_equal);
+    qemu_co_mutex_init(&s->lock);
+
+    GRAPH_RDLOCK_GUARD_MAINLOOP();
+
+    bs->supported_write_flags = BDRV_REQ_WRITE_UNCHANGED |
+        (BDRV_REQ_FUA & bs->file->bs->supported_write_flags);
+
+    bs->supported_zero_flags = BDRV_REQ_WRITE_UNCHANGED |
+        ((BDRV_REQ_FUA | BDRV_REQ_MAY_UNMAP | BDRV_REQ_NO_FALLBACK) &
+            bs->file->bs->supported_zero_flags);
+
+    return 0;
+}
+
+static void GRAPH_UNLOCKED read_cache_close(BlockDriverState *bs)
+{
+    BDRVReadCacheState *s = bs->opaque;
+
+    g_hash_table_destroy(s->map);
+    g_free(s->lines);
+    qemu_vfree(s->arena);
+}
+
+/* Called with s->lock held */
+static uint8_t *read_cache_line_buf(BDRVReadCacheState *s, unsigned idx)
+{
+    return s->arena + (size_t)idx * s->line_size;
+}
+
+/*
+ * Find the cache line holding @line_offset, or -1 on a miss.  Called
+ * with s->lock held.
+ */
+static int read_cache_lookup(BDRVReadCacheState *s, int64_t line_offset)
+{
+    gpointer idx;
+
+    if (g_hash_table_lookup_extended(s->map, &line_offset, NULL, &idx)) {
+        return GPOINTER_TO_UINT(idx);
+    }
+    return -1;
+}
+
+/*
+ * Pick a victim line with the CLOCK policy: sweep the hand, giving
+ * each referenced line a second chance.  Called with s->lock held.
+ */
+static unsigned read_cache_evict(BDRVReadCacheState *s)
+{
+    ReadCacheLine *line;
+
+    while (true) {
+        line = &s->lines[s->clock_hand];
+        if (!line->referenced) {
+            break;
+        }
+        line->referenced = false;
+        s->clock_hand = (s->clock_hand + 1) % s->num_lines;
+    }
+
+    if (line->offset >= 0) {
+        g_hash_table_remove(s->map, &line->offset);
+    }
+    line->offset = -1;
+
+    return s->clock_hand;
+}
+
+/*
+ * Insert a fully populated line.  @buf points at line_size bytes of
+ * data for @line_offset.  Called with s->lock held.
+ */
+static void read_cache_insert(BDRVReadCacheState *s, int64_t line_offset,
+                              const uint8_t *buf)
+{
+    unsigned idx;
+
+    if (read_cache_lookup(s, line_offset) >= 0) {
+        /* A concurrent read of the same line beat us to it */
+        return;
+    }
+
+    idx = read_cache_evict(s);
+    memcpy(read_cache_line_buf(s, idx), buf, s->line_size);
+    s->lines[idx] = (ReadCacheLine) {
+        .offset = line_offset,
+        .referenced = true,
+    };
+    g_hash_table_insert(s->map, &s->lines[idx].offset,
+                        GUINT_TO_POINTER(idx));
+}
+
+/* Drop all lines intersecting [offset, offset + bytes). */
+static void coroutine_fn
+read_cache_invalidate(BDRVReadCacheState *s, int64_t offset, int64_t bytes)
+{
+    int64_t line_offset = QEMU_ALIGN_DOWN(offset, s->line_size);
+    int64_t end = offset + bytes;
+
+    qemu_co_mutex_lock(&s->lock);
+    s->write_gen++;
+    for (; line_offset < end; line_offset += s->line_size) {
+        int idx = read_cache_lookup(s, line_offset);
+
+        if (idx >= 0) {
+            g_hash_table_remove(s->map, &s->lines[idx].offset);
+            s->lines[idx].offset = -1;
+            s->lines[idx].referenced = false;
+        }
+    }
+    qemu_co_mutex_unlock(&s->lock);
+}
+
+static int coroutine_fn GRAPH_RDLOCK
+read_cache_co_preadv_part(BlockDriverState *bs, int64_t offset, int64_t bytes,
+                          QEMUIOVector *qiov, size_t qiov_offset,
+                          BdrvRequestFlags flags)
+{
+    BDRVReadCacheState *s = bs->opaque;
+    int64_t end = offset + bytes;
+    int64_t pos = offset;
+    int ret;
+
+    if (flags) {
+        /* COPY_ON_READ etc. change semantics, let the request through */
+        return bdrv_co_preadv_part(bs->file, offset, bytes, qiov, qiov_offset,
+                                   flags);
+    }
+
+    while (pos < end) {
+        int64_t line_offset = QEMU_ALIGN_DOWN(pos, s->line_size);
+        int64_t chunk = MIN(end, line_offset + s->line_size) - pos;
+        bool full_line = pos == line_offset && chunk == s->line_size;
+        uint64_t write_gen;
+        int idx;
+
+        qemu_co_mutex_lock(&s->lock);
+        idx = read_cache_lookup(s, line_offset);
+        if (idx >= 0) {
+            s->lines[idx].referenced = true;
+            qemu_iovec_from_buf(qiov, qiov_offset + (pos - offset),
+                                read_cache_line_buf(s, idx) +
+                                (pos - line_offset), chunk);
+            qemu_co_mutex_unlock(&s->lock);
+            stat64_add(&s->hits, 1);
+            pos += chunk;
+            continue;
+        }
+        write_gen = s->write_gen;
+        qemu_co_mutex_unlock(&s->lock);
+
+        stat64_add(&s->misses, 1);
+        ret = bdrv_co_preadv_part(bs->file, pos, chunk, qiov,
+                                  qiov_offset + (pos - offset), 0);
+        if (ret < 0) {
+            return ret;
+        }
+
+        /*
+         * Only fully covered lines are inserted; caching the head of a
+         * partial line would require an extra read for the tail, which
+         * is not worth it for the sequential reads this filter targets.
+         */
+        if (full_line) {
+            g_autofree uint8_t *buf = g_malloc(s->line_size);
+
+            qemu_iovec_to_buf(qiov, qiov_offset + (pos - offset), buf,
+                              s->line_size);
+            qemu_co_mutex_lock(&s->lock);
+            if (write_gen == s->write_gen) {
+                read_cache_insert(s, line_offset, buf);
+            }
+            qemu_co_mutex_unlock(&s->lock);
+        }
+
+        pos += chunk;
+    }
+
+    return 0;
+}
+
+static int coroutine_fn GRAPH_RDLOCK
+read_cache_co_pwritev_part(BlockDriverState *bs, int64_t offset, int64_t bytes,
+                           QEMUIOVector *qiov, size_t qiov_offset,
+                           BdrvRequestFlags flags)
+{
+    BDRVReadCacheState *s = bs->opaque;
+
+    read_cache_invalidate(s, offset, bytes);
+    return bdrv_co_pwritev_part(bs->file, offset, bytes, qiov, qiov_offset,
+                                flags);
+}
+
+static int coroutine_fn GRAPH_RDLOCK
+read_cache_co_pwrite_zeroes(BlockDriverState *bs, int64_t offset,
+                            int64_t bytes, BdrvRequestFlags flags)
+{
+    BDRVReadCacheState *s = bs->opaque;
+
+    read_cache_invalidate(s, offset, bytes);
+    return bdrv_co_pwrite_zeroes(bs->file, offset, bytes, flags);
+}
+
+static int coroutine_fn GRAPH_RDLOCK
+read_cache_co_pdiscard(BlockDriverState *bs, int64_t offset, int64_t bytes)
+{
+    BDRVReadCacheState *s = bs->opaque;
+
+    read_cache_invalidate(s, offset, bytes);
+    return bdrv_co_pdiscard(bs->file, offset, bytes);
+}
+
+static int64_t coroutine_fn GRAPH_RDLOCK
+read_cache_co_getlength(BlockDriverState *bs)
+{
+    return bdrv_co_getlength(bs->file->bs);
+}
+
+static BlockStatsSpecific *read_cache_get_specific_stats(BlockDriverState *bs)
+{
+    BDRVReadCacheState *s = bs->opaque;
+    BlockStatsSpecific *stats = g_new(BlockStatsSpecific, 1);
+
+    stats->driver = BLOCKDEV_DRIVER_READ_CACHE;
+    stats->u.read_cache = (BlockStatsSpecificReadCache) {
+        .cache_hits = stat64_get(&s->hits),
+        .cache_misses = stat64_get(&s->misses),
+        .cache_size = (uint64_t)s->num_lines * s->line_size,
+    };
+
+    return stats;
+}
+
+static const char *const read_cache_strong_runtime_opts[] = {
+    READ_CACHE_OPT_LINE_SIZE,
+
+    NULL
+};
+
+static BlockDriver bdrv_read_cache = {
+    .format_name                        = "read-cache",
+    .instance_size                      = sizeof(BDRVReadCacheState),
+
+    .bdrv_open                          = read_cache_open,
+    .bdrv_close                         = read_cache_close,
+    .bdrv_child_perm                    = bdrv_default_perms,
+
+    .bdrv_co_getlength                  = read_cache_co_getlength,
+
+    .bdrv_co_preadv_part                = read_cache_co_preadv_part,
+    .bdrv_co_pwritev_part               = read_cache_co_pwritev_part,
+    .bdrv_co_pwrite_zeroes              = read_cache_co_pwrite_zeroes,
+    .bdrv_co_pdiscard                   = read_cache_co_pdiscard,
+
+    .bdrv_get_specific_stats            = read_cache_get_specific_stats,
+
+    .strong_runtime_opts                = read_cache_strong_runtime_opts,
+
+    .is_filter                          = true,
+};
+
+static void bdrv_read_cache_init(void)
+{
+    bdrv_register(&bdrv_read_cache);
+}
+
+block_init(bdrv_read_cache_init);
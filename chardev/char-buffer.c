@@ -0,0 +1,307 @@
+/*
+ * QEMU System Emulator
+ *
+ * Copyright (c) 2003-2008 Fabrice Bellard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "qemu/osdep.h"
+#include "qapi/error.h"
+#include "qemu/module.h"
+#include "qemu/option.h"
+#include "chardev/char.h"
+#include "chardev-internal.h"
+
+/*
+ * Buffering driver in front of another chardev.  Frontend writes land
+ * in a ring buffer and are written to the base chardev in bulk, either
+ * from a timer or when the ring passes a fill watermark.  This keeps
+ * byte-at-a-time writers (serial consoles in particular) from paying
+ * one backend write per character.
+ */
+
+#define BUFFER_DEF_SIZE 65536
+/* Delay before queued data is flushed to the base chardev.  */
+#define BUFFER_FLUSH_DELAY_MS 10
+
+struct BufferChardev {
+    Chardev parent;
+    CharBackend chr;
+    size_t size;
+    uint8_t *cbuf;
+
+    /*
+     * Free-running producer/consumer positions and the statistics,
+     * all protected by the Chardev chr_write_lock.
+     */
+    size_t prod;
+    size_t cons;
+    GSource *flush_source;
+    uint64_t total_bytes;
+    uint64_t flushes;
+    uint64_t backpressure;
+    uint64_t dropped;
+};
+typedef struct BufferChardev BufferChardev;
+
+DECLARE_INSTANCE_CHECKER(BufferChardev, BUFFER_CHARDEV,
+                         TYPE_CHARDEV_BUFFER)
+
+/* Called with chr_write_lock held.  */
+static void buffer_chr_flush_locked(BufferChardev *d)
+{
+    while (d->cons != d->prod) {
+        size_t pos = d->cons & (d->size - 1);
+        size_t len = MIN(d->prod - d->cons, d->size - pos);
+        int ret = qemu_chr_fe_write_all(&d->chr, d->cbuf + pos, len);
+
+        if (ret <= 0) {
+            /*
+             * The base chardev will not take the data; drop it rather
+             * than letting it sit in the ring forever.
+             */
+            d->dropped += d->prod - d->cons;
+            d->cons = d->prod;
+            break;
+        }
+        d->cons += ret;
+    }
+    d->flushes++;
+}
+
+static gboolean buffer_chr_flush_timer(gpointer opaque)
+{
+    Chardev *chr = CHARDEV(opaque);
+    BufferChardev *d = BUFFER_CHARDEV(opaque);
+
+    qemu_mutex_lock(&chr->chr_write_lock);
+    g_source_unref(d->flush_source);
+    d->flush_source = NULL;
+    buffer_chr_flush_locked(d);
+    qemu_mutex_unlock(&chr->chr_write_lock);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Called with chr_write_lock held.  */
+static int buffer_chr_write(Chardev *chr, const uint8_t *buf, int len)
+{
+    BufferChardev *d = BUFFER_CHARDEV(chr);
+    size_t pos, chunk;
+
+    if (!buf || len < 0) {
+        return -1;
+    }
+
+    if ((size_t)len >= d->size) {
+        /* Too big for the ring, flush and write it through.  */
+        buffer_chr_flush_locked(d);
+        d->total_bytes += len;
+        return qemu_chr_fe_write_all(&d->chr, buf, len);
+    }
+
+    if (d->prod - d->cons + len > d->size) {
+        /* The frontend is outrunning the base chardev.  */
+        d->backpressure++;
+        buffer_chr_flush_locked(d);
+    }
+
+    pos = d->prod & (d->size - 1);
+    chunk = MIN((size_t)len, d->size - pos);
+    memcpy(d->cbuf + pos, buf, chunk);
+    memcpy(d->cbuf, buf + chunk, len - chunk);
+    d->prod += len;
+    d->total_bytes += len;
+
+    if (d->prod - d->cons >= d->size / 2) {
+        buffer_chr_flush_locked(d);
+    } else if (!d->flush_source) {
+        d->flush_source = qemu_chr_timeout_add_ms(chr, BUFFER_FLUSH_DELAY_MS,
+                                                  buffer_chr_flush_timer, chr);
+    }
+
+    return len;
+}
+
+static ChardevBufferStats *buffer_chr_query_stats(Chardev *chr)
+{
+    BufferChardev *d = BUFFER_CHARDEV(chr);
+    ChardevBufferStats *stats = g_new0(ChardevBufferStats, 1);
+
+    qemu_mutex_lock(&chr->chr_write_lock);
+    stats->bytes = d->total_bytes;
+    stats->queued = d->prod - d->cons;
+    stats->flushes = d->flushes;
+    stats->backpressure = d->backpressure;
+    stats->dropped = d->dropped;
+    qemu_mutex_unlock(&chr->chr_write_lock);
+
+    return stats;
+}
+
+static int buffer_chr_can_read(void *opaque)
+{
+    Chardev *chr = CHARDEV(opaque);
+
+    return qemu_chr_be_can_write(chr);
+}
+
+static void buffer_chr_read(void *opaque, const uint8_t *buf, int size)
+{
+    Chardev *chr = CHARDEV(opaque);
+
+    qemu_chr_be_write(chr, buf, size);
+}
+
+static void buffer_chr_event(void *opaque, QEMUChrEvent event)
+{
+    Chardev *chr = CHARDEV(opaque);
+
+    qemu_chr_be_event(chr, event);
+}
+
+static void buffer_chr_update_read_handlers(Chardev *chr)
+{
+    BufferChardev *d = BUFFER_CHARDEV(chr);
+
+    qemu_chr_fe_set_handlers_full(&d->chr,
+                                  buffer_chr_can_read,
+                                  buffer_chr_read,
+                                  buffer_chr_event,
+                                  NULL,
+                                  chr,
+                                  chr->gcontext, true, false);
+}
+
+static void buffer_chr_accept_input(Chardev *chr)
+{
+    BufferChardev *d = BUFFER_CHARDEV(chr);
+
+    qemu_chr_fe_accept_input(&d->chr);
+}
+
+static GSource *buffer_chr_add_watch(Chardev *s, GIOCondition cond)
+{
+    BufferChardev *d = BUFFER_CHARDEV(s);
+    Chardev *chr = qemu_chr_fe_get_driver(&d->chr);
+    ChardevClass *cc = CHARDEV_GET_CLASS(chr);
+
+    if (!cc->chr_add_watch) {
+        return NULL;
+    }
+
+    return cc->chr_add_watch(chr, cond);
+}
+
+static void char_buffer_finalize(Object *obj)
+{
+    Chardev *chr = CHARDEV(obj);
+    BufferChardev *d = BUFFER_CHARDEV(obj);
+
+    qemu_mutex_lock(&chr->chr_write_lock);
+    if (d->flush_source) {
+        g_source_destroy(d->flush_source);
+        g_source_unref(d->flush_source);
+        d->flush_source = NULL;
+    }
+    buffer_chr_flush_locked(d);
+    qemu_mutex_unlock(&chr->chr_write_lock);
+
+    g_free(d->cbuf);
+    qemu_chr_fe_deinit(&d->chr, false);
+}
+
+static void qemu_chr_open_buffer(Chardev *chr,
+                                 ChardevBackend *backend,
+                                 bool *be_opened,
+                                 Error **errp)
+{
+    ChardevBuffer *buffer = backend->u.buffer.data;
+    BufferChardev *d = BUFFER_CHARDEV(chr);
+    Chardev *drv;
+
+    d->size = buffer->has_size ? buffer->size : BUFFER_DEF_SIZE;
+
+    /* The size must be power of 2 */
+    if (d->size & (d->size - 1)) {
+        error_setg(errp, "size of buffer chardev must be power of two");
+        return;
+    }
+
+    drv = qemu_chr_find(buffer->chardev);
+    if (drv == NULL) {
+        error_setg(errp, "buffer: base chardev %s not found", buffer->chardev);
+        return;
+    }
+
+    d->cbuf = g_malloc0(d->size);
+    qemu_chr_fe_init(&d->chr, drv, errp);
+}
+
+static void qemu_chr_parse_buffer(QemuOpts *opts, ChardevBackend *backend,
+                                  Error **errp)
+{
+    const char *chardev = qemu_opt_get(opts, "chardev");
+    ChardevBuffer *buffer;
+    uint64_t size;
+
+    if (chardev == NULL) {
+        error_setg(errp, "chardev: buffer: no chardev given");
+        return;
+    }
+    backend->type = CHARDEV_BACKEND_KIND_BUFFER;
+    buffer = backend->u.buffer.data = g_new0(ChardevBuffer, 1);
+    qemu_chr_parse_common(opts, qapi_ChardevBuffer_base(buffer));
+    buffer->chardev = g_strdup(chardev);
+
+    size = qemu_opt_get_size(opts, "size", 0);
+    if (size != 0) {
+        buffer->has_size = true;
+        buffer->size = size;
+    }
+}
+
+static void char_buffer_class_init(ObjectClass *oc, void *data)
+{
+    ChardevClass *cc = CHARDEV_CLASS(oc);
+
+    cc->parse = qemu_chr_parse_buffer;
+    cc->open = qemu_chr_open_buffer;
+    cc->chr_write = buffer_chr_write;
+    cc->chr_accept_input = buffer_chr_accept_input;
+    cc->chr_add_watch = buffer_chr_add_watch;
+    cc->chr_update_read_handler = buffer_chr_update_read_handlers;
+    cc->chr_query_buffer_stats = buffer_chr_query_stats;
+}
+
+static const TypeInfo char_buffer_type_info = {
+    .name = TYPE_CHARDEV_BUFFER,
+    .parent = TYPE_CHARDEV,
+    .class_init = char_buffer_class_init,
+    .instance_size = sizeof(BufferChardev),
+    .instance_finalize = char_buffer_finalize,
+};
+
+static void register_types(void)
+{
+    type_register_static(&char_buffer_type_info);
+}
+
+type_init(register_types);
@@ -31,6 +31,15 @@ void hmp_info_chardev(Monitor *mon, const QDict *qdict)
     for (info = char_info; info; info = info->next) {
         monitor_printf(mon, "%s: filename=%s\n", info->value->label,
                                                  info->value->filename);
+        if (info->value->buffer_stats) {
+            ChardevBufferStats *stats = info->value->buffer_stats;
+
+            monitor_printf(mon, "  buffered: %" PRId64 " bytes (%" PRId64
+                           " queued), %" PRId64 " flushes, %" PRId64
+                           " backpressure stalls, %" PRId64 " dropped\n",
+                           stats->bytes, stats->queued, stats->flushes,
+                           stats->backpressure, stats->dropped);
+        }
     }
 
     qapi_free_ChardevInfoList(char_info);
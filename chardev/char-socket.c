@@ -24,6 +24,7 @@
 
 #include "qemu/osdep.h"
 #include "chardev/char.h"
+#include "crypto/tlssession.h"
 #include "io/channel-socket.h"
 #include "io/channel-websock.h"
 #include "qemu/error-report.h"
@@ -40,6 +41,7 @@
 
 static gboolean socket_reconnect_timeout(gpointer opaque);
 static void tcp_chr_telnet_init(Chardev *chr);
+static void tcp_chr_tls_init(Chardev *chr);
 
 static void tcp_chr_change_state(SocketChardev *s, TCPChardevState state)
 {
@@ -65,6 +67,33 @@ static void tcp_chr_reconn_timer_cancel(SocketChardev *s)
     }
 }
 
+/*
+ * Cap on concurrent TLS handshakes across all socket chardevs, so
+ * that a burst of incoming console connections cannot monopolize the
+ * main loop with handshake crypto.  Chardevs over the limit retry
+ * shortly afterwards.
+ */
+#define TCP_CHR_TLS_HANDSHAKE_MAX 16
+
+static unsigned tcp_chr_tls_inflight;
+
+static void tcp_chr_tls_handshake_end(SocketChardev *s)
+{
+    if (s->tls_in_handshake) {
+        s->tls_in_handshake = false;
+        tcp_chr_tls_inflight--;
+    }
+}
+
+static void tcp_chr_tls_defer_timer_cancel(SocketChardev *s)
+{
+    if (s->tls_defer_timer) {
+        g_source_destroy(s->tls_defer_timer);
+        g_source_unref(s->tls_defer_timer);
+        s->tls_defer_timer = NULL;
+    }
+}
+
 static void qemu_chr_socket_restart_timer(Chardev *chr)
 {
     SocketChardev *s = SOCKET_CHARDEV(chr);
@@ -389,6 +418,9 @@ static void tcp_chr_free_connection(Chardev *chr)
     if (s->ioc) {
         qio_channel_close(s->ioc, NULL);
     }
+    /* Closing the channel cancels any handshake still in flight */
+    tcp_chr_tls_handshake_end(s);
+    tcp_chr_tls_defer_timer_cancel(s);
     object_unref(OBJECT(s->sioc));
     s->sioc = NULL;
     object_unref(OBJECT(s->ioc));
@@ -816,12 +848,30 @@ static void tcp_chr_tls_handshake(QIOTask *task,
     SocketChardev *s = user_data;
     Error *err = NULL;
 
+    tcp_chr_tls_handshake_end(s);
+
     if (qio_task_propagate_error(task, &err)) {
         trace_chr_socket_tls_handshake_err(chr, chr->label,
                                            error_get_pretty(err));
         error_free(err);
         tcp_chr_disconnect(chr);
     } else {
+        if (!s->is_listen) {
+            QCryptoTLSSession *tls =
+                qio_channel_tls_get_session(QIO_CHANNEL_TLS(s->ioc));
+
+            if (qcrypto_tls_session_resumed(tls)) {
+                trace_chr_socket_tls_resumed(chr, chr->label);
+            }
+
+            /* Refresh the ticket cache so the next reconnect can resume */
+            g_free(s->tls_session_data);
+            s->tls_session_data = NULL;
+            s->tls_session_data_len = 0;
+            qcrypto_tls_session_get_session_data(tls, &s->tls_session_data,
+                                                 &s->tls_session_data_len,
+                                                 NULL);
+        }
         if (s->is_websock) {
             tcp_chr_websock_init(chr);
         } else if (s->do_telnetopt) {
@@ -833,6 +883,22 @@ static void tcp_chr_tls_handshake(QIOTask *task,
 }
 
 
+static gboolean tcp_chr_tls_defer_timeout(gpointer opaque)
+{
+    Chardev *chr = CHARDEV(opaque);
+    SocketChardev *s = SOCKET_CHARDEV(opaque);
+
+    g_source_unref(s->tls_defer_timer);
+    s->tls_defer_timer = NULL;
+
+    if (s->state == TCP_CHARDEV_STATE_CONNECTING) {
+        tcp_chr_tls_init(chr);
+    }
+
+    return FALSE;
+}
+
+
 static void tcp_chr_tls_init(Chardev *chr)
 {
     SocketChardev *s = SOCKET_CHARDEV(chr);
@@ -840,6 +906,19 @@ static void tcp_chr_tls_init(Chardev *chr)
     gchar *name;
     Error *err = NULL;
 
+    if (tcp_chr_tls_inflight >= TCP_CHR_TLS_HANDSHAKE_MAX) {
+        if (!s->tls_defer_timer) {
+            trace_chr_socket_tls_handshake_defer(chr, chr->label,
+                                                 tcp_chr_tls_inflight);
+            name = g_strdup_printf("chardev-socket-tls-defer-%s", chr->label);
+            s->tls_defer_timer = qemu_chr_timeout_add_ms(
+                chr, 25, tcp_chr_tls_defer_timeout, chr);
+            g_source_set_name(s->tls_defer_timer, name);
+            g_free(name);
+        }
+        return;
+    }
+
     if (s->is_listen) {
         tioc = qio_channel_tls_new_server(
             s->ioc, s->tls_creds,
@@ -865,6 +944,15 @@ static void tcp_chr_tls_init(Chardev *chr)
     object_unref(OBJECT(s->ioc));
     s->ioc = QIO_CHANNEL(tioc);
 
+    if (!s->is_listen && s->tls_session_data) {
+        /* A stale ticket merely falls back to a full handshake */
+        qcrypto_tls_session_set_session_data(
+            qio_channel_tls_get_session(tioc),
+            s->tls_session_data, s->tls_session_data_len, NULL);
+    }
+
+    tcp_chr_tls_inflight++;
+    s->tls_in_handshake = true;
     qio_channel_tls_handshake(tioc,
                               tcp_chr_tls_handshake,
                               chr,
@@ -1114,6 +1202,7 @@ static void char_socket_finalize(Object *obj)
         object_unref(OBJECT(s->tls_creds));
     }
     g_free(s->tls_authz);
+    g_free(s->tls_session_data);
     if (s->registered_yank) {
         /*
          * In the chardev-change special-case, we shouldn't unregister the yank
@@ -38,6 +38,7 @@
 #include "qemu/module.h"
 #include "qemu/option.h"
 #include "qemu/id.h"
+#include "qemu/lock-stats.h"
 #include "qemu/coroutine.h"
 #include "qemu/yank.h"
 
@@ -786,12 +787,16 @@ Chardev *qemu_chr_new_mux_mon(const char *label, const char *filename,
 static int qmp_query_chardev_foreach(Object *obj, void *data)
 {
     Chardev *chr = CHARDEV(obj);
+    ChardevClass *cc = CHARDEV_GET_CLASS(chr);
     ChardevInfoList **list = data;
     ChardevInfo *value = g_malloc0(sizeof(*value));
 
     value->label = g_strdup(chr->label);
     value->filename = g_strdup(chr->filename);
     value->frontend_open = chr->be && chr->be->fe_is_open;
+    if (cc->chr_query_buffer_stats) {
+        value->buffer_stats = cc->chr_query_buffer_stats(chr);
+    }
 
     QAPI_LIST_PREPEND(*list, value);
 
@@ -983,6 +988,7 @@ static Chardev *chardev_new(const char *id, const char *typename,
     Object *obj;
     Chardev *chr = NULL;
     Error *local_err = NULL;
+    g_autofree char *stats_name = NULL;
     bool be_opened = true;
 
     assert(g_str_has_prefix(typename, "chardev-"));
@@ -994,6 +1000,9 @@ static Chardev *chardev_new(const char *id, const char *typename,
     chr->label = g_strdup(id);
     chr->gcontext = gcontext;
 
+    stats_name = g_strdup_printf("chardev:%s", id);
+    qemu_mutex_enable_stats(&chr->chr_write_lock, stats_name);
+
     qemu_char_open(chr, backend, &be_opened, &local_err);
     if (local_err) {
         error_propagate(errp, local_err);
@@ -246,6 +246,18 @@ void end_exclusive(void)
 /* Wait for exclusive ops to finish, and begin cpu execution.  */
 void cpu_exec_start(CPUState *cpu)
 {
+    /*
+     * Mark the end of machine bring-up: the first vCPU is about to
+     * execute guest code.  Racing vCPUs may emit a second event, which
+     * boot time consumers can simply ignore.
+     */
+    static bool first_exec;
+
+    if (!first_exec) {
+        first_exec = true;
+        trace_cpu_exec_first(cpu->cpu_index);
+    }
+
     qatomic_set(&cpu->running, true);
 
     /* Write cpu->running before reading pending_cpus.  */
@@ -397,6 +409,7 @@ int cpu_breakpoint_insert(CPUState *cpu, vaddr pc, int flags,
 
     bp->pc = pc;
     bp->flags = flags;
+    bp->hit_count = 0;
 
     /* keep all GDB-injected breakpoints in front */
     if (flags & BP_GDB) {
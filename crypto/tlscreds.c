@@ -93,6 +93,32 @@ qcrypto_tls_creds_get_dh_params_file(QCryptoTLSCreds *creds,
 }
 
 
+int
+qcrypto_tls_creds_get_session_ticket_key(QCryptoTLSCreds *creds,
+                                         Error **errp)
+{
+    int ret;
+
+    /*
+     * Keep any previously generated key so that tickets issued to
+     * clients before a credentials reload remain resumable.
+     */
+    if (creds->session_ticket_key.data) {
+        return 0;
+    }
+
+    ret = gnutls_session_ticket_key_generate(&creds->session_ticket_key);
+    if (ret < 0) {
+        error_setg(errp, "Cannot generate session ticket key: %s",
+                   gnutls_strerror(ret));
+        return -1;
+    }
+
+    trace_qcrypto_tls_creds_session_ticket_key(creds);
+    return 0;
+}
+
+
 int
 qcrypto_tls_creds_get_path(QCryptoTLSCreds *creds,
                            const char *filename,
@@ -256,6 +282,13 @@ qcrypto_tls_creds_finalize(Object *obj)
 {
     QCryptoTLSCreds *creds = QCRYPTO_TLS_CREDS(obj);
 
+#ifdef CONFIG_GNUTLS
+    if (creds->session_ticket_key.data) {
+        gnutls_memset(creds->session_ticket_key.data, 0,
+                      creds->session_ticket_key.size);
+        gnutls_free(creds->session_ticket_key.data);
+    }
+#endif
     g_free(creds->dir);
     g_free(creds->priority);
 }
@@ -64,6 +64,11 @@ qcrypto_tls_creds_anon_load(QCryptoTLSCredsAnon *creds,
 
         gnutls_anon_set_server_dh_params(creds->data.server,
                                          creds->parent_obj.dh_params);
+
+        if (qcrypto_tls_creds_get_session_ticket_key(&creds->parent_obj,
+                                                     errp) < 0) {
+            return -1;
+        }
     } else {
         ret = gnutls_anon_allocate_client_credentials(&creds->data.client);
         if (ret < 0) {
@@ -33,6 +33,11 @@ struct QCryptoTLSCreds {
     QCryptoTLSCredsEndpoint endpoint;
 #ifdef CONFIG_GNUTLS
     gnutls_dh_params_t dh_params;
+    /*
+     * Key for encrypting session resumption tickets, shared by
+     * all server sessions created from these credentials.
+     */
+    gnutls_datum_t session_ticket_key;
 #endif
     bool verifyPeer;
     char *priority;
@@ -81,6 +86,9 @@ int qcrypto_tls_creds_get_dh_params_file(QCryptoTLSCreds *creds,
                                          gnutls_dh_params_t *dh_params,
                                          Error **errp);
 
+int qcrypto_tls_creds_get_session_ticket_key(QCryptoTLSCreds *creds,
+                                             Error **errp);
+
 #endif
 
 #endif /* QCRYPTO_TLSCREDSPRIV_H */
@@ -117,6 +117,11 @@ qcrypto_tls_creds_psk_load(QCryptoTLSCredsPSK *creds,
         }
         gnutls_psk_set_server_dh_params(creds->data.server,
                                         creds->parent_obj.dh_params);
+
+        if (qcrypto_tls_creds_get_session_ticket_key(&creds->parent_obj,
+                                                     errp) < 0) {
+            goto cleanup;
+        }
     } else {
         if (qcrypto_tls_creds_get_path(&creds->parent_obj,
                                        QCRYPTO_TLS_CREDS_PSKFILE,
@@ -638,6 +638,11 @@ qcrypto_tls_creds_x509_load(QCryptoTLSCredsX509 *creds,
         }
         gnutls_certificate_set_dh_params(creds->data,
                                          creds->parent_obj.dh_params);
+
+        if (qcrypto_tls_creds_get_session_ticket_key(&creds->parent_obj,
+                                                     errp) < 0) {
+            goto cleanup;
+        }
     }
 
     rv = 0;
@@ -276,6 +276,22 @@ qcrypto_tls_session_new(QCryptoTLSCreds *creds,
         goto error;
     }
 
+    if (creds->endpoint == QCRYPTO_TLS_CREDS_ENDPOINT_SERVER &&
+        creds->session_ticket_key.data) {
+        /*
+         * All sessions created from one credentials object share the
+         * ticket key, so a client holding a ticket can resume with any
+         * of them and skip the expensive key exchange.
+         */
+        ret = gnutls_session_ticket_enable_server(
+            session->handle, &creds->session_ticket_key);
+        if (ret < 0) {
+            error_setg(errp, "Cannot enable session tickets: %s",
+                       gnutls_strerror(ret));
+            goto error;
+        }
+    }
+
     gnutls_transport_set_ptr(session->handle, session);
     gnutls_transport_set_push_function(session->handle,
                                        qcrypto_tls_session_push);
@@ -502,6 +518,39 @@ qcrypto_tls_session_write(QCryptoTLSSession *session,
 }
 
 
+void
+qcrypto_tls_session_cork(QCryptoTLSSession *session)
+{
+    gnutls_record_cork(session->handle);
+}
+
+
+int
+qcrypto_tls_session_uncork(QCryptoTLSSession *session,
+                           Error **errp)
+{
+    ssize_t ret = gnutls_record_uncork(session->handle, 0);
+
+    if (ret < 0 && ret != GNUTLS_E_AGAIN) {
+        if (session->werr) {
+            error_propagate(errp, session->werr);
+            session->werr = NULL;
+        } else {
+            error_setg(errp,
+                       "Cannot flush TLS channel: %s",
+                       gnutls_strerror(ret));
+        }
+        return -1;
+    }
+
+    if (gnutls_record_check_corked(session->handle) > 0) {
+        return QCRYPTO_TLS_SESSION_ERR_BLOCK;
+    }
+
+    return 0;
+}
+
+
 ssize_t
 qcrypto_tls_session_read(QCryptoTLSSession *session,
                          char *buf,
@@ -613,6 +662,53 @@ qcrypto_tls_session_get_peer_name(QCryptoTLSSession *session)
 }
 
 
+int
+qcrypto_tls_session_get_session_data(QCryptoTLSSession *session,
+                                     uint8_t **data,
+                                     size_t *len,
+                                     Error **errp)
+{
+    gnutls_datum_t buf = { .data = NULL, .size = 0 };
+    int ret;
+
+    ret = gnutls_session_get_data2(session->handle, &buf);
+    if (ret < 0) {
+        error_setg(errp, "Cannot get session resumption data: %s",
+                   gnutls_strerror(ret));
+        return -1;
+    }
+
+    *data = g_memdup2(buf.data, buf.size);
+    *len = buf.size;
+    gnutls_free(buf.data);
+    return 0;
+}
+
+
+int
+qcrypto_tls_session_set_session_data(QCryptoTLSSession *session,
+                                     const uint8_t *data,
+                                     size_t len,
+                                     Error **errp)
+{
+    int ret = gnutls_session_set_data(session->handle, data, len);
+
+    if (ret < 0) {
+        error_setg(errp, "Cannot set session resumption data: %s",
+                   gnutls_strerror(ret));
+        return -1;
+    }
+    return 0;
+}
+
+
+bool
+qcrypto_tls_session_resumed(QCryptoTLSSession *session)
+{
+    return gnutls_session_is_resumed(session->handle) != 0;
+}
+
+
 #else /* ! CONFIG_GNUTLS */
 
 
@@ -714,4 +810,33 @@ qcrypto_tls_session_get_peer_name(QCryptoTLSSession *sess)
     return NULL;
 }
 
+
+int
+qcrypto_tls_session_get_session_data(QCryptoTLSSession *sess,
+                                     uint8_t **data,
+                                     size_t *len,
+                                     Error **errp)
+{
+    error_setg(errp, "TLS requires GNUTLS support");
+    return -1;
+}
+
+
+int
+qcrypto_tls_session_set_session_data(QCryptoTLSSession *sess,
+                                     const uint8_t *data,
+                                     size_t len,
+                                     Error **errp)
+{
+    error_setg(errp, "TLS requires GNUTLS support");
+    return -1;
+}
+
+
+bool
+qcrypto_tls_session_resumed(QCryptoTLSSession *sess)
+{
+    return false;
+}
+
 #endif
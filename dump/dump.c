@@ -13,6 +13,7 @@
 
 #include "qemu/osdep.h"
 #include "qemu/cutils.h"
+#include "qemu/units.h"
 #include "elf.h"
 #include "qemu/bswap.h"
 #include "exec/target_page.h"
@@ -45,6 +46,18 @@
 
 #define MAX_GUEST_NOTE_SIZE (1 << 20) /* 1MB should be enough */
 
+/* I/O chunk when writing guest RAM straight into an ELF vmcore */
+#define DUMP_IO_CHUNK_SIZE (8 * MiB)
+
+/* kdump-compressed pages are compressed and written in batches */
+#define DUMP_PAGES_PER_BATCH 64
+
+/* upper bound on the compression worker threads */
+#define DUMP_MAX_WORKERS 8
+
+/* accounting period of the write rate limit */
+#define DUMP_RATE_LIMIT_SLICE_NS (100 * 1000 * 1000)
+
 static Error *dump_migration_blocker;
 
 #define ELF_NOTE_SIZE(hdr_size, name_size, desc_size)   \
@@ -103,6 +116,7 @@ static int dump_cleanup(DumpState *s)
 
     guest_phys_blocks_free(&s->guest_phys_blocks);
     memory_mapping_list_free(&s->list);
+    ratelimit_destroy(&s->rate_limit);
     close(s->fd);
     g_free(s->guest_note);
     g_clear_pointer(&s->string_table_buf, g_array_unref);
@@ -121,6 +135,16 @@ static int dump_cleanup(DumpState *s)
     return 0;
 }
 
+/* account @size written bytes and sleep if the rate limit demands it */
+static void dump_write_ratelimit(DumpState *s, size_t size)
+{
+    int64_t delay_ns = ratelimit_calculate_delay(&s->rate_limit, size);
+
+    if (delay_ns > 0) {
+        g_usleep(delay_ns / 1000);
+    }
+}
+
 static int fd_write_vmcore(const void *buf, size_t size, void *opaque)
 {
     DumpState *s = opaque;
@@ -519,6 +543,7 @@ static void write_data(DumpState *s, void *buf, int length, Error **errp)
 {
     int ret;
 
+    dump_write_ratelimit(s, length);
     ret = fd_write_vmcore(buf, length, s);
     if (ret < 0) {
         error_setg_errno(errp, -ret, "dump: failed to save memory");
@@ -527,24 +552,20 @@ static void write_data(DumpState *s, void *buf, int length, Error **errp)
     }
 }
 
-/* write the memory to vmcore. 1 page per I/O. */
+/*
+ * Write the memory to vmcore, straight from guest RAM.  The data needs
+ * no transformation for the ELF format, so use chunks large enough to
+ * amortize the syscall cost instead of one I/O per target page.
+ */
 static void write_memory(DumpState *s, GuestPhysBlock *block, ram_addr_t start,
                          int64_t size, Error **errp)
 {
     ERRP_GUARD();
-    int64_t i;
+    int64_t off;
 
-    for (i = 0; i < size / s->dump_info.page_size; i++) {
-        write_data(s, block->host_addr + start + i * s->dump_info.page_size,
-                   s->dump_info.page_size, errp);
-        if (*errp) {
-            return;
-        }
-    }
-
-    if ((size % s->dump_info.page_size) != 0) {
-        write_data(s, block->host_addr + start + i * s->dump_info.page_size,
-                   size % s->dump_info.page_size, errp);
+    for (off = 0; off < size; off += DUMP_IO_CHUNK_SIZE) {
+        write_data(s, block->host_addr + start + off,
+                   MIN(size - off, DUMP_IO_CHUNK_SIZE), errp);
         if (*errp) {
             return;
         }
@@ -871,6 +892,8 @@ static int write_buffer(DumpState *s, off_t offset, const void *buf, size_t size
     MakedumpfileDataHeader mdh;
     off_t seek_loc;
 
+    dump_write_ratelimit(s, size);
+
     if (s->kdump_raw) {
         seek_loc = lseek(s->fd, offset, SEEK_SET);
         if (seek_loc == (off_t) -1) {
@@ -1401,53 +1424,6 @@ out:
     g_free(dump_bitmap_buf);
 }
 
-static void prepare_data_cache(DataCache *data_cache, DumpState *s,
-                               off_t offset)
-{
-    data_cache->state = s;
-    data_cache->data_size = 0;
-    data_cache->buf_size = 4 * dump_bitmap_get_bufsize(s);
-    data_cache->buf = g_malloc0(data_cache->buf_size);
-    data_cache->offset = offset;
-}
-
-static int write_cache(DataCache *dc, const void *buf, size_t size,
-                       bool flag_sync)
-{
-    /*
-     * dc->buf_size should not be less than size, otherwise dc will never be
-     * enough
-     */
-    assert(size <= dc->buf_size);
-
-    /*
-     * if flag_sync is set, synchronize data in dc->buf into vmcore.
-     * otherwise check if the space is enough for caching data in buf, if not,
-     * write the data in dc->buf to dc->state->fd and reset dc->buf
-     */
-    if ((!flag_sync && dc->data_size + size > dc->buf_size) ||
-        (flag_sync && dc->data_size > 0)) {
-        if (write_buffer(dc->state, dc->offset, dc->buf, dc->data_size) < 0) {
-            return -1;
-        }
-
-        dc->offset += dc->data_size;
-        dc->data_size = 0;
-    }
-
-    if (!flag_sync) {
-        memcpy(dc->buf + dc->data_size, buf, size);
-        dc->data_size += size;
-    }
-
-    return 0;
-}
-
-static void free_data_cache(DataCache *data_cache)
-{
-    g_free(data_cache->buf);
-}
-
 static size_t get_len_buf_out(size_t page_size, uint32_t flag_compress)
 {
     switch (flag_compress) {
@@ -1470,175 +1446,325 @@ static size_t get_len_buf_out(size_t page_size, uint32_t flag_compress)
     return 0;
 }
 
-static void write_dump_pages(DumpState *s, Error **errp)
+typedef struct DumpPageBatch {
+    QSIMPLEQ_ENTRY(DumpPageBatch) entry;
+    size_t start_idx;       /* dumpable-page index of pages[0] */
+    size_t nr_pages;
+    uint8_t *pages[DUMP_PAGES_PER_BATCH];   /* guest RAM or @scratch */
+    uint8_t *scratch;       /* backing store for partial pages */
+} DumpPageBatch;
+
+typedef struct DumpPagesState {
+    DumpState *s;
+    size_t len_buf_out;     /* worst case compressed size of one page */
+    PageDescriptor pd_zero; /* descriptor shared by all zero pages */
+    off_t offset_desc;      /* start of the page descriptor area */
+    off_t offset_data;      /* next free byte of the page data area */
+    QemuMutex lock;         /* protects the queue, offset_data and the fd */
+    QemuCond cond_work;     /* a batch was queued */
+    QemuCond cond_space;    /* a batch was consumed */
+    QSIMPLEQ_HEAD(, DumpPageBatch) batches;
+    unsigned nr_queued;
+    unsigned nr_workers;
+    bool producer_done;
+    bool failed;
+    Error *err;             /* first failure, consumed by the producer */
+} DumpPagesState;
+
+static void dump_page_batch_free(DumpPageBatch *batch)
+{
+    g_free(batch->scratch);
+    g_free(batch);
+}
+
+/*
+ * Collect the next batch of dumpable pages.  Whole target pages are
+ * referenced in place in guest RAM; pages assembled from partial
+ * mappings live in the batch's scratch buffer.  Returns NULL once the
+ * iteration is exhausted.
+ */
+static DumpPageBatch *dump_next_page_batch(DumpPagesState *dps,
+                                           GuestPhysBlock **block_iter,
+                                           uint64_t *pfn_iter,
+                                           size_t start_idx)
 {
-    int ret = 0;
-    DataCache page_desc, page_data;
-    size_t len_buf_out, size_out;
+    uint32_t page_size = dps->s->dump_info.page_size;
+    DumpPageBatch *batch = g_new0(DumpPageBatch, 1);
+
+    batch->start_idx = start_idx;
+    batch->scratch = g_malloc(DUMP_PAGES_PER_BATCH * page_size);
+
+    while (batch->nr_pages < DUMP_PAGES_PER_BATCH) {
+        uint8_t *buf = batch->scratch + batch->nr_pages * page_size;
+
+        if (!get_next_page(block_iter, pfn_iter, &buf, dps->s)) {
+            break;
+        }
+        batch->pages[batch->nr_pages++] = buf;
+    }
+
+    if (!batch->nr_pages) {
+        dump_page_batch_free(batch);
+        return NULL;
+    }
+
+    return batch;
+}
+
+/*
+ * Compress one page into @buf_out, which must have room for
+ * @len_buf_out bytes.  Returns the output size and sets @flags to the
+ * DUMP_DH_COMPRESSED_* bit actually used, or to zero when compression
+ * fails to shrink the page and it is saved in plaintext.
+ */
+static size_t dump_compress_page(DumpState *s, size_t len_buf_out,
+                                 const uint8_t *buf, uint8_t *buf_out,
+                                 void *wrkmem, uint32_t *flags)
+{
+    size_t size_out = len_buf_out;
+
+    if ((s->flag_compress & DUMP_DH_COMPRESSED_ZLIB) &&
+            (compress2(buf_out, (uLongf *)&size_out, buf,
+                       s->dump_info.page_size, Z_BEST_SPEED) == Z_OK) &&
+            (size_out < s->dump_info.page_size)) {
+        *flags = DUMP_DH_COMPRESSED_ZLIB;
+        return size_out;
+    }
 #ifdef CONFIG_LZO
-    lzo_bytep wrkmem = NULL;
+    size_out = len_buf_out;
+    if ((s->flag_compress & DUMP_DH_COMPRESSED_LZO) &&
+            (lzo1x_1_compress(buf, s->dump_info.page_size, buf_out,
+            (lzo_uint *)&size_out, wrkmem) == LZO_E_OK) &&
+            (size_out < s->dump_info.page_size)) {
+        *flags = DUMP_DH_COMPRESSED_LZO;
+        return size_out;
+    }
+#endif
+#ifdef CONFIG_SNAPPY
+    size_out = len_buf_out;
+    if ((s->flag_compress & DUMP_DH_COMPRESSED_SNAPPY) &&
+            (snappy_compress((const char *)buf, s->dump_info.page_size,
+            (char *)buf_out, &size_out) == SNAPPY_OK) &&
+            (size_out < s->dump_info.page_size)) {
+        *flags = DUMP_DH_COMPRESSED_SNAPPY;
+        return size_out;
+    }
 #endif
-    uint8_t *buf_out = NULL;
-    off_t offset_desc, offset_data;
-    PageDescriptor pd, pd_zero;
-    uint8_t *buf;
-    GuestPhysBlock *block_iter = NULL;
-    uint64_t pfn_iter;
-    g_autofree uint8_t *page = NULL;
 
-    /* get offset of page_desc and page_data in dump file */
-    offset_desc = s->offset_page;
-    offset_data = offset_desc + sizeof(PageDescriptor) * s->num_dumpable;
+    /* fall back to saving in plaintext */
+    memcpy(buf_out, buf, s->dump_info.page_size);
+    *flags = 0;
+    return s->dump_info.page_size;
+}
 
-    prepare_data_cache(&page_desc, s, offset_desc);
-    prepare_data_cache(&page_data, s, offset_data);
+/*
+ * Pull batches off the queue, compress them outside the lock, then
+ * reserve space in the page data area and write both the data and the
+ * page descriptors at their final offsets.  Descriptor slots are fixed
+ * by the dumpable-page index, so batches may complete out of order.
+ */
+static void *dump_pages_worker(void *opaque)
+{
+    DumpPagesState *dps = opaque;
+    DumpState *s = dps->s;
+    uint32_t page_size = s->dump_info.page_size;
+    g_autofree PageDescriptor *descs = g_new(PageDescriptor,
+                                             DUMP_PAGES_PER_BATCH);
+    g_autofree uint8_t *buf_out = g_malloc(dps->len_buf_out *
+                                           DUMP_PAGES_PER_BATCH);
+    void *wrkmem = NULL;
+#ifdef CONFIG_LZO
+    wrkmem = g_malloc(LZO1X_1_MEM_COMPRESS);
+#endif
 
-    /* prepare buffer to store compressed data */
-    len_buf_out = get_len_buf_out(s->dump_info.page_size, s->flag_compress);
-    assert(len_buf_out != 0);
+    for (;;) {
+        bool is_zero[DUMP_PAGES_PER_BATCH];
+        DumpPageBatch *batch;
+        size_t data_size = 0;
+        off_t data_off;
+        bool failed;
+        size_t i;
+        int ret;
+
+        qemu_mutex_lock(&dps->lock);
+        while (QSIMPLEQ_EMPTY(&dps->batches) &&
+               !dps->producer_done && !dps->failed) {
+            qemu_cond_wait(&dps->cond_work, &dps->lock);
+        }
+        batch = QSIMPLEQ_FIRST(&dps->batches);
+        if (batch) {
+            QSIMPLEQ_REMOVE_HEAD(&dps->batches, entry);
+            dps->nr_queued--;
+            qemu_cond_signal(&dps->cond_space);
+        }
+        failed = dps->failed;
+        qemu_mutex_unlock(&dps->lock);
+
+        if (!batch) {
+            break;
+        }
+        if (failed) {
+            /* just drain the queue */
+            dump_page_batch_free(batch);
+            continue;
+        }
+
+        for (i = 0; i < batch->nr_pages; i++) {
+            PageDescriptor *pd = &descs[i];
+            uint32_t flags;
+            size_t size_out;
+
+            is_zero[i] = buffer_is_zero(batch->pages[i], page_size);
+            if (is_zero[i]) {
+                *pd = dps->pd_zero;
+                continue;
+            }
+
+            size_out = dump_compress_page(s, dps->len_buf_out,
+                                          batch->pages[i],
+                                          buf_out + data_size, wrkmem,
+                                          &flags);
+            pd->flags = cpu_to_dump32(s, flags);
+            pd->size = cpu_to_dump32(s, size_out);
+            pd->page_flags = cpu_to_dump64(s, 0);
+            /* relative for now, made absolute once space is reserved */
+            pd->offset = data_size;
+            data_size += size_out;
+        }
+
+        qemu_mutex_lock(&dps->lock);
+        data_off = dps->offset_data;
+        dps->offset_data += data_size;
+
+        for (i = 0; i < batch->nr_pages; i++) {
+            if (!is_zero[i]) {
+                descs[i].offset = cpu_to_dump64(s,
+                                                data_off + descs[i].offset);
+            }
+        }
+
+        ret = 0;
+        if (data_size) {
+            ret = write_buffer(s, data_off, buf_out, data_size);
+        }
+        if (ret == 0) {
+            ret = write_buffer(s, dps->offset_desc +
+                               batch->start_idx * sizeof(PageDescriptor),
+                               descs,
+                               batch->nr_pages * sizeof(PageDescriptor));
+        }
+        if (ret < 0 && !dps->failed) {
+            dps->failed = true;
+            error_setg(&dps->err, "dump: failed to write page data");
+            qemu_cond_broadcast(&dps->cond_work);
+            qemu_cond_broadcast(&dps->cond_space);
+        }
+        s->written_size += batch->nr_pages * page_size;
+        qemu_mutex_unlock(&dps->lock);
+
+        dump_page_batch_free(batch);
+    }
 
 #ifdef CONFIG_LZO
-    wrkmem = g_malloc(LZO1X_1_MEM_COMPRESS);
+    g_free(wrkmem);
 #endif
 
-    buf_out = g_malloc(len_buf_out);
+    return NULL;
+}
+
+static void write_dump_pages(DumpState *s, Error **errp)
+{
+    ERRP_GUARD();
+    DumpPagesState dps = { .s = s };
+    g_autofree QemuThread *workers = NULL;
+    g_autofree uint8_t *zero_page = NULL;
+    GuestPhysBlock *block_iter = NULL;
+    uint64_t pfn_iter;
+    size_t page_idx = 0;
+    unsigned i;
+
+    dps.len_buf_out = get_len_buf_out(s->dump_info.page_size,
+                                      s->flag_compress);
+    assert(dps.len_buf_out != 0);
+
+    /* get offset of page_desc and page_data in dump file */
+    dps.offset_desc = s->offset_page;
+    dps.offset_data = dps.offset_desc +
+        sizeof(PageDescriptor) * s->num_dumpable;
 
     /*
      * init zero page's page_desc and page_data, because every zero page
      * uses the same page_data
      */
-    pd_zero.size = cpu_to_dump32(s, s->dump_info.page_size);
-    pd_zero.flags = cpu_to_dump32(s, 0);
-    pd_zero.offset = cpu_to_dump64(s, offset_data);
-    pd_zero.page_flags = cpu_to_dump64(s, 0);
-    buf = g_malloc0(s->dump_info.page_size);
-    ret = write_cache(&page_data, buf, s->dump_info.page_size, false);
-    g_free(buf);
-    if (ret < 0) {
+    dps.pd_zero.size = cpu_to_dump32(s, s->dump_info.page_size);
+    dps.pd_zero.flags = cpu_to_dump32(s, 0);
+    dps.pd_zero.offset = cpu_to_dump64(s, dps.offset_data);
+    dps.pd_zero.page_flags = cpu_to_dump64(s, 0);
+    zero_page = g_malloc0(s->dump_info.page_size);
+    if (write_buffer(s, dps.offset_data, zero_page,
+                     s->dump_info.page_size) < 0) {
         error_setg(errp, "dump: failed to write page data (zero page)");
-        goto out;
+        return;
     }
+    dps.offset_data += s->dump_info.page_size;
 
-    offset_data += s->dump_info.page_size;
-    page = g_malloc(s->dump_info.page_size);
+    qemu_mutex_init(&dps.lock);
+    qemu_cond_init(&dps.cond_work);
+    qemu_cond_init(&dps.cond_space);
+    QSIMPLEQ_INIT(&dps.batches);
 
     /*
-     * dump memory to vmcore page by page. zero page will all be resided in the
-     * first page of page section
+     * Compression dominates the cost of a kdump-compressed dump, so
+     * shard it across host CPUs.  Writes stay serialized on dps.lock,
+     * which also keeps write_buffer's seek-write pairs atomic.
      */
-    for (buf = page; get_next_page(&block_iter, &pfn_iter, &buf, s); buf = page) {
-        /* check zero page */
-        if (buffer_is_zero(buf, s->dump_info.page_size)) {
-            ret = write_cache(&page_desc, &pd_zero, sizeof(PageDescriptor),
-                              false);
-            if (ret < 0) {
-                error_setg(errp, "dump: failed to write page desc");
-                goto out;
-            }
-        } else {
-            /*
-             * not zero page, then:
-             * 1. compress the page
-             * 2. write the compressed page into the cache of page_data
-             * 3. get page desc of the compressed page and write it into the
-             *    cache of page_desc
-             *
-             * only one compression format will be used here, for
-             * s->flag_compress is set. But when compression fails to work,
-             * we fall back to save in plaintext.
-             */
-             size_out = len_buf_out;
-             if ((s->flag_compress & DUMP_DH_COMPRESSED_ZLIB) &&
-                    (compress2(buf_out, (uLongf *)&size_out, buf,
-                               s->dump_info.page_size, Z_BEST_SPEED) == Z_OK) &&
-                    (size_out < s->dump_info.page_size)) {
-                pd.flags = cpu_to_dump32(s, DUMP_DH_COMPRESSED_ZLIB);
-                pd.size  = cpu_to_dump32(s, size_out);
-
-                ret = write_cache(&page_data, buf_out, size_out, false);
-                if (ret < 0) {
-                    error_setg(errp, "dump: failed to write page data");
-                    goto out;
-                }
-#ifdef CONFIG_LZO
-            } else if ((s->flag_compress & DUMP_DH_COMPRESSED_LZO) &&
-                    (lzo1x_1_compress(buf, s->dump_info.page_size, buf_out,
-                    (lzo_uint *)&size_out, wrkmem) == LZO_E_OK) &&
-                    (size_out < s->dump_info.page_size)) {
-                pd.flags = cpu_to_dump32(s, DUMP_DH_COMPRESSED_LZO);
-                pd.size  = cpu_to_dump32(s, size_out);
-
-                ret = write_cache(&page_data, buf_out, size_out, false);
-                if (ret < 0) {
-                    error_setg(errp, "dump: failed to write page data");
-                    goto out;
-                }
-#endif
-#ifdef CONFIG_SNAPPY
-            } else if ((s->flag_compress & DUMP_DH_COMPRESSED_SNAPPY) &&
-                    (snappy_compress((char *)buf, s->dump_info.page_size,
-                    (char *)buf_out, &size_out) == SNAPPY_OK) &&
-                    (size_out < s->dump_info.page_size)) {
-                pd.flags = cpu_to_dump32(s, DUMP_DH_COMPRESSED_SNAPPY);
-                pd.size  = cpu_to_dump32(s, size_out);
-
-                ret = write_cache(&page_data, buf_out, size_out, false);
-                if (ret < 0) {
-                    error_setg(errp, "dump: failed to write page data");
-                    goto out;
-                }
-#endif
-            } else {
-                /*
-                 * fall back to save in plaintext, size_out should be
-                 * assigned the target's page size
-                 */
-                pd.flags = cpu_to_dump32(s, 0);
-                size_out = s->dump_info.page_size;
-                pd.size = cpu_to_dump32(s, size_out);
-
-                ret = write_cache(&page_data, buf,
-                                  s->dump_info.page_size, false);
-                if (ret < 0) {
-                    error_setg(errp, "dump: failed to write page data");
-                    goto out;
-                }
-            }
-
-            /* get and write page desc here */
-            pd.page_flags = cpu_to_dump64(s, 0);
-            pd.offset = cpu_to_dump64(s, offset_data);
-            offset_data += size_out;
+    dps.nr_workers = MIN(DUMP_MAX_WORKERS, g_get_num_processors());
+    workers = g_new(QemuThread, dps.nr_workers);
+    for (i = 0; i < dps.nr_workers; i++) {
+        qemu_thread_create(&workers[i], "dump_compress", dump_pages_worker,
+                           &dps, QEMU_THREAD_JOINABLE);
+    }
+
+    /* feed the workers batches of dumpable pages, in pfn order */
+    for (;;) {
+        DumpPageBatch *batch = dump_next_page_batch(&dps, &block_iter,
+                                                    &pfn_iter, page_idx);
+        if (!batch) {
+            break;
+        }
+        page_idx += batch->nr_pages;
 
-            ret = write_cache(&page_desc, &pd, sizeof(PageDescriptor), false);
-            if (ret < 0) {
-                error_setg(errp, "dump: failed to write page desc");
-                goto out;
-            }
+        qemu_mutex_lock(&dps.lock);
+        while (dps.nr_queued >= 2 * dps.nr_workers && !dps.failed) {
+            qemu_cond_wait(&dps.cond_space, &dps.lock);
         }
-        s->written_size += s->dump_info.page_size;
+        if (dps.failed) {
+            qemu_mutex_unlock(&dps.lock);
+            dump_page_batch_free(batch);
+            break;
+        }
+        QSIMPLEQ_INSERT_TAIL(&dps.batches, batch, entry);
+        dps.nr_queued++;
+        qemu_cond_signal(&dps.cond_work);
+        qemu_mutex_unlock(&dps.lock);
     }
 
-    ret = write_cache(&page_desc, NULL, 0, true);
-    if (ret < 0) {
-        error_setg(errp, "dump: failed to sync cache for page_desc");
-        goto out;
-    }
-    ret = write_cache(&page_data, NULL, 0, true);
-    if (ret < 0) {
-        error_setg(errp, "dump: failed to sync cache for page_data");
-        goto out;
-    }
+    qemu_mutex_lock(&dps.lock);
+    dps.producer_done = true;
+    qemu_cond_broadcast(&dps.cond_work);
+    qemu_mutex_unlock(&dps.lock);
 
-out:
-    free_data_cache(&page_desc);
-    free_data_cache(&page_data);
+    for (i = 0; i < dps.nr_workers; i++) {
+        qemu_thread_join(&workers[i]);
+    }
 
-#ifdef CONFIG_LZO
-    g_free(wrkmem);
-#endif
+    if (dps.failed) {
+        error_propagate(errp, dps.err);
+    }
 
-    g_free(buf_out);
+    qemu_cond_destroy(&dps.cond_space);
+    qemu_cond_destroy(&dps.cond_work);
+    qemu_mutex_destroy(&dps.lock);
 }
 
 static void create_kdump_vmcore(DumpState *s, Error **errp)
@@ -1780,7 +1906,7 @@ static void vmcoreinfo_update_phys_base(DumpState *s)
 static void dump_init(DumpState *s, int fd, bool has_format,
                       DumpGuestMemoryFormat format, bool paging, bool has_filter,
                       int64_t begin, int64_t length, bool kdump_raw,
-                      Error **errp)
+                      uint64_t rate_limit, Error **errp)
 {
     ERRP_GUARD();
     VMCoreInfoState *vmci = vmcoreinfo_find();
@@ -1792,6 +1918,8 @@ static void dump_init(DumpState *s, int fd, bool has_format,
     s->format = format;
     s->written_size = 0;
     s->kdump_raw = kdump_raw;
+    ratelimit_init(&s->rate_limit);
+    ratelimit_set_speed(&s->rate_limit, rate_limit, DUMP_RATE_LIMIT_SLICE_NS);
 
     /* kdump-compressed is conflict with paging and filter */
     if (has_format && format != DUMP_GUEST_MEMORY_FORMAT_ELF) {
@@ -2066,6 +2194,7 @@ void qmp_dump_guest_memory(bool paging, const char *protocol,
                            bool has_begin, int64_t begin,
                            bool has_length, int64_t length,
                            bool has_format, DumpGuestMemoryFormat format,
+                           bool has_rate_limit, uint64_t rate_limit,
                            Error **errp)
 {
     ERRP_GUARD();
@@ -2192,7 +2321,8 @@ void qmp_dump_guest_memory(bool paging, const char *protocol,
     dump_state_prepare(s);
 
     dump_init(s, fd, has_format, format, paging, has_begin,
-              begin, length, kdump_raw, errp);
+              begin, length, kdump_raw,
+              has_rate_limit ? rate_limit : 0, errp);
     if (*errp) {
         qatomic_set(&s->status, DUMP_STATUS_FAILED);
         return;
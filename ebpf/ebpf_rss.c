@@ -184,7 +184,14 @@ static bool ebpf_rss_set_config(struct EBPFRSSContext *ctx,
         return false;
     }
 
-    memcpy(ctx->mmap_configuration, config, sizeof(*config));
+    /*
+     * The mapped maps are written only by us and read by the in-kernel
+     * program on every packet, so don't dirty the shared pages when the
+     * configuration did not actually change.
+     */
+    if (memcmp(ctx->mmap_configuration, config, sizeof(*config)) != 0) {
+        memcpy(ctx->mmap_configuration, config, sizeof(*config));
+    }
     return true;
 }
 
@@ -200,7 +207,9 @@ static bool ebpf_rss_set_indirections_table(struct EBPFRSSContext *ctx,
     }
 
     for (size_t i = 0; i < len; i++) {
-        *(uint16_t *)cursor = indirections_table[i];
+        if (*(uint16_t *)cursor != indirections_table[i]) {
+            *(uint16_t *)cursor = indirections_table[i];
+        }
         cursor += 8;
     }
 
@@ -219,7 +228,9 @@ static bool ebpf_rss_set_toepliz_key(struct EBPFRSSContext *ctx,
     memcpy(toe, toeplitz_key, VIRTIO_NET_RSS_MAX_KEY_SIZE);
     *(uint32_t *)toe = ntohl(*(uint32_t *)toe);
 
-    memcpy(ctx->mmap_toeplitz_key, toe, VIRTIO_NET_RSS_MAX_KEY_SIZE);
+    if (memcmp(ctx->mmap_toeplitz_key, toe, VIRTIO_NET_RSS_MAX_KEY_SIZE) != 0) {
+        memcpy(ctx->mmap_toeplitz_key, toe, VIRTIO_NET_RSS_MAX_KEY_SIZE);
+    }
     return true;
 }
 
@@ -3039,6 +3039,81 @@ floatx80 floatx80_round_to_int(floatx80 a, float_status *status)
     return floatx80_round_pack_canonical(&p, status);
 }
 
+/*
+ * Hardfloat round-to-integer helpers for float to int conversions.
+ *
+ * The host FPU can only be used when no flags other than inexact may
+ * result: the input must be zero or normal once flushed, and the
+ * rounding mode must be one we can express without touching the host
+ * fenv (to-nearest-even is the host default; the directed modes map
+ * onto trunc/floor/ceil).  The callers check that the rounded value
+ * fits the destination before raising inexact, since an out-of-range
+ * value must take the softfloat path to raise invalid instead.
+ */
+static inline bool f32_round_to_int_hard(union_float32 *ua,
+                                         FloatRoundMode rmode,
+                                         float_status *s, float *rounded)
+{
+    if (unlikely(!can_use_fpu(s))) {
+        return false;
+    }
+
+    float32_input_flush1(&ua->s, s);
+    if (unlikely(!float32_is_zero_or_normal(ua->s))) {
+        return false;
+    }
+
+    switch (rmode) {
+    case float_round_nearest_even:
+        *rounded = rintf(ua->h);
+        break;
+    case float_round_to_zero:
+        *rounded = truncf(ua->h);
+        break;
+    case float_round_down:
+        *rounded = floorf(ua->h);
+        break;
+    case float_round_up:
+        *rounded = ceilf(ua->h);
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+static inline bool f64_round_to_int_hard(union_float64 *ua,
+                                         FloatRoundMode rmode,
+                                         float_status *s, double *rounded)
+{
+    if (unlikely(!can_use_fpu(s))) {
+        return false;
+    }
+
+    float64_input_flush1(&ua->s, s);
+    if (unlikely(!float64_is_zero_or_normal(ua->s))) {
+        return false;
+    }
+
+    switch (rmode) {
+    case float_round_nearest_even:
+        *rounded = rint(ua->h);
+        break;
+    case float_round_to_zero:
+        *rounded = trunc(ua->h);
+        break;
+    case float_round_down:
+        *rounded = floor(ua->h);
+        break;
+    case float_round_up:
+        *rounded = ceil(ua->h);
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
 /*
  * Floating-point to signed integer conversions
  */
@@ -3093,6 +3168,19 @@ int32_t float32_to_int32_scalbn(float32 a, FloatRoundMode rmode, int scale,
 {
     FloatParts64 p;
 
+    if (likely(scale == 0)) {
+        union_float32 ua = { .s = a };
+        float rounded;
+
+        if (f32_round_to_int_hard(&ua, rmode, s, &rounded) &&
+            rounded >= -0x1p31f && rounded < 0x1p31f) {
+            if (unlikely(rounded != ua.h)) {
+                float_raise(float_flag_inexact, s);
+            }
+            return (int32_t)rounded;
+        }
+    }
+
     float32_unpack_canonical(&p, a, s);
     return parts_float_to_sint(&p, rmode, scale, INT32_MIN, INT32_MAX, s);
 }
@@ -3102,6 +3190,19 @@ int64_t float32_to_int64_scalbn(float32 a, FloatRoundMode rmode, int scale,
 {
     FloatParts64 p;
 
+    if (likely(scale == 0)) {
+        union_float32 ua = { .s = a };
+        float rounded;
+
+        if (f32_round_to_int_hard(&ua, rmode, s, &rounded) &&
+            rounded >= -0x1p63f && rounded < 0x1p63f) {
+            if (unlikely(rounded != ua.h)) {
+                float_raise(float_flag_inexact, s);
+            }
+            return (int64_t)rounded;
+        }
+    }
+
     float32_unpack_canonical(&p, a, s);
     return parts_float_to_sint(&p, rmode, scale, INT64_MIN, INT64_MAX, s);
 }
@@ -3120,6 +3221,19 @@ int32_t float64_to_int32_scalbn(float64 a, FloatRoundMode rmode, int scale,
 {
     FloatParts64 p;
 
+    if (likely(scale == 0)) {
+        union_float64 ua = { .s = a };
+        double rounded;
+
+        if (f64_round_to_int_hard(&ua, rmode, s, &rounded) &&
+            rounded >= -0x1p31 && rounded < 0x1p31) {
+            if (unlikely(rounded != ua.h)) {
+                float_raise(float_flag_inexact, s);
+            }
+            return (int32_t)rounded;
+        }
+    }
+
     float64_unpack_canonical(&p, a, s);
     return parts_float_to_sint(&p, rmode, scale, INT32_MIN, INT32_MAX, s);
 }
@@ -3129,6 +3243,19 @@ int64_t float64_to_int64_scalbn(float64 a, FloatRoundMode rmode, int scale,
 {
     FloatParts64 p;
 
+    if (likely(scale == 0)) {
+        union_float64 ua = { .s = a };
+        double rounded;
+
+        if (f64_round_to_int_hard(&ua, rmode, s, &rounded) &&
+            rounded >= -0x1p63 && rounded < 0x1p63) {
+            if (unlikely(rounded != ua.h)) {
+                float_raise(float_flag_inexact, s);
+            }
+            return (int64_t)rounded;
+        }
+    }
+
     float64_unpack_canonical(&p, a, s);
     return parts_float_to_sint(&p, rmode, scale, INT64_MIN, INT64_MAX, s);
 }
@@ -3520,6 +3647,19 @@ uint32_t float32_to_uint32_scalbn(float32 a, FloatRoundMode rmode, int scale,
 {
     FloatParts64 p;
 
+    if (likely(scale == 0)) {
+        union_float32 ua = { .s = a };
+        float rounded;
+
+        if (f32_round_to_int_hard(&ua, rmode, s, &rounded) &&
+            rounded >= 0.0f && rounded < 0x1p32f) {
+            if (unlikely(rounded != ua.h)) {
+                float_raise(float_flag_inexact, s);
+            }
+            return (uint32_t)rounded;
+        }
+    }
+
     float32_unpack_canonical(&p, a, s);
     return parts_float_to_uint(&p, rmode, scale, UINT32_MAX, s);
 }
@@ -3529,6 +3669,19 @@ uint64_t float32_to_uint64_scalbn(float32 a, FloatRoundMode rmode, int scale,
 {
     FloatParts64 p;
 
+    if (likely(scale == 0)) {
+        union_float32 ua = { .s = a };
+        float rounded;
+
+        if (f32_round_to_int_hard(&ua, rmode, s, &rounded) &&
+            rounded >= 0.0f && rounded < 0x1p64f) {
+            if (unlikely(rounded != ua.h)) {
+                float_raise(float_flag_inexact, s);
+            }
+            return (uint64_t)rounded;
+        }
+    }
+
     float32_unpack_canonical(&p, a, s);
     return parts_float_to_uint(&p, rmode, scale, UINT64_MAX, s);
 }
@@ -3547,6 +3700,19 @@ uint32_t float64_to_uint32_scalbn(float64 a, FloatRoundMode rmode, int scale,
 {
     FloatParts64 p;
 
+    if (likely(scale == 0)) {
+        union_float64 ua = { .s = a };
+        double rounded;
+
+        if (f64_round_to_int_hard(&ua, rmode, s, &rounded) &&
+            rounded >= 0.0 && rounded < 0x1p32) {
+            if (unlikely(rounded != ua.h)) {
+                float_raise(float_flag_inexact, s);
+            }
+            return (uint32_t)rounded;
+        }
+    }
+
     float64_unpack_canonical(&p, a, s);
     return parts_float_to_uint(&p, rmode, scale, UINT32_MAX, s);
 }
@@ -3556,6 +3722,19 @@ uint64_t float64_to_uint64_scalbn(float64 a, FloatRoundMode rmode, int scale,
 {
     FloatParts64 p;
 
+    if (likely(scale == 0)) {
+        union_float64 ua = { .s = a };
+        double rounded;
+
+        if (f64_round_to_int_hard(&ua, rmode, s, &rounded) &&
+            rounded >= 0.0 && rounded < 0x1p64) {
+            if (unlikely(rounded != ua.h)) {
+                float_raise(float_flag_inexact, s);
+            }
+            return (uint64_t)rounded;
+        }
+    }
+
     float64_unpack_canonical(&p, a, s);
     return parts_float_to_uint(&p, rmode, scale, UINT64_MAX, s);
 }
@@ -256,6 +256,20 @@ SRST
     Show dynamic compiler info.
 ERST
 
+#if defined(CONFIG_TCG)
+    {
+        .name       = "trace-breakpoints",
+        .args_type  = "",
+        .params     = "",
+        .help       = "show tracing breakpoint hit counts and recent hits",
+    },
+#endif
+
+SRST
+  ``info trace-breakpoints``
+    Show tracing breakpoint hit counts and recent hits.
+ERST
+
 #if defined(CONFIG_TCG)
     {
         .name       = "opcount",
@@ -296,6 +310,36 @@ SRST
     being coalesced.
 ERST
 
+    {
+        .name       = "bql-profile",
+        .args_type  = "",
+        .params     = "",
+        .help       = "show the BQL sampling profile, including collapsed "
+                      "call stacks for flamegraph tooling",
+        .cmd        = hmp_info_bql_profile,
+    },
+
+SRST
+  ``info bql-profile``
+    Show the report of the Big QEMU Lock sampling profiler, with per-site
+    wait and hold times and collapsed call stacks.
+ERST
+
+    {
+        .name       = "vcpu-profile",
+        .args_type  = "",
+        .params     = "",
+        .help       = "show the vCPU sampling profile as collapsed "
+                      "guest PC stacks for flamegraph tooling",
+        .cmd        = hmp_info_vcpu_profile,
+    },
+
+SRST
+  ``info vcpu-profile``
+    Show the report of the vCPU sampling profiler, as collapsed guest PC
+    stacks to be symbolized against the guest.
+ERST
+
     {
         .name       = "kvm",
         .args_type  = "",
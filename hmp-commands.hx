@@ -450,6 +450,57 @@ SRST
   Start gdbserver session (default *port*\=1234)
 ERST
 
+#if defined(CONFIG_TCG)
+    {
+        .name       = "trace-break",
+        .args_type  = "delete:-d,addr:l",
+        .params     = "[-d] addr",
+        .help       = "insert (or -d remove) a tracing breakpoint; "
+                      "hits are recorded without stopping the machine",
+    },
+#endif
+
+SRST
+``trace-break [-d]`` *addr*
+  Insert a tracing breakpoint at *addr* on all CPUs, or remove it with
+  ``-d``.  Hits are recorded without stopping the machine; see
+  ``info trace-breakpoints`` and ``trace-break-threshold``.
+ERST
+
+#if defined(CONFIG_TCG)
+    {
+        .name       = "trace-watch",
+        .args_type  = "delete:-d,addr:l,len:l,rw:s?",
+        .params     = "[-d] addr len [r|w|rw]",
+        .help       = "insert (or -d remove) a tracing watchpoint "
+                      "(default write access); "
+                      "hits are recorded without stopping the machine",
+    },
+#endif
+
+SRST
+``trace-watch [-d]`` *addr* *len* [*r|w|rw*]
+  Insert a tracing watchpoint covering *len* bytes at *addr* on all
+  CPUs, or remove it with ``-d``.  Hits are recorded without stopping
+  the machine.
+ERST
+
+#if defined(CONFIG_TCG)
+    {
+        .name       = "trace-break-threshold",
+        .args_type  = "count:l",
+        .params     = "count",
+        .help       = "stop the machine once a tracing breakpoint or "
+                      "watchpoint reaches 'count' hits (0 to never stop)",
+    },
+#endif
+
+SRST
+``trace-break-threshold`` *count*
+  Stop the machine once a tracing breakpoint or watchpoint reaches
+  *count* hits.  A *count* of 0 (the default) never stops.
+ERST
+
     {
         .name       = "x",
         .args_type  = "fmt:/,addr:l",
@@ -639,6 +690,36 @@ SRST
   whether profiling is on or off.
 ERST
 
+    {
+        .name       = "bql-profile",
+        .args_type  = "op:s?",
+        .params     = "[on|off|reset]",
+        .help       = "enable, disable or reset BQL sampling profiling. "
+                      "With no arguments, prints whether profiling is on or off.",
+        .cmd        = hmp_bql_profile,
+    },
+
+SRST
+``bql-profile [on|off|reset]``
+  Enable, disable or reset sampling profiling of the Big QEMU Lock. With no
+  arguments, prints whether profiling is on or off.
+ERST
+
+    {
+        .name       = "vcpu-profile",
+        .args_type  = "op:s?",
+        .params     = "[on|off|reset]",
+        .help       = "enable, disable or reset vCPU guest PC sampling. "
+                      "With no arguments, prints whether profiling is on or off.",
+        .cmd        = hmp_vcpu_profile,
+    },
+
+SRST
+``vcpu-profile [on|off|reset]``
+  Enable, disable or reset sampling of the guest program counter on every
+  running vCPU. With no arguments, prints whether profiling is on or off.
+ERST
+
     {
         .name       = "system_reset",
         .args_type  = "",
@@ -2264,6 +2264,18 @@ static int v9fs_xattr_read(V9fsState *s, V9fsPDU *pdu, V9fsFidState *fidp,
     return offset;
 }
 
+static void v9fs_free_dirents(struct V9fsDirEnt *e)
+{
+    struct V9fsDirEnt *next = NULL;
+
+    for (; e; e = next) {
+        next = e->next;
+        g_free(e->dent);
+        g_free(e->st);
+        g_free(e);
+    }
+}
+
 static int coroutine_fn v9fs_do_readdir_with_stat(V9fsPDU *pdu,
                                                   V9fsFidState *fidp,
                                                   uint32_t max_count)
@@ -2272,68 +2284,84 @@ static int coroutine_fn v9fs_do_readdir_with_stat(V9fsPDU *pdu,
     V9fsStat v9stat;
     int len, err = 0;
     int32_t count = 0;
-    struct stat stbuf;
-    off_t saved_dir_pos;
+    off_t dir_pos;
     struct dirent *dent;
+    struct stat *st;
+    struct V9fsDirEnt *entries = NULL;
 
     /* save the directory position */
-    saved_dir_pos = v9fs_co_telldir(pdu, fidp);
-    if (saved_dir_pos < 0) {
-        return saved_dir_pos;
+    dir_pos = v9fs_co_telldir(pdu, fidp);
+    if (dir_pos < 0) {
+        return dir_pos;
     }
 
-    while (1) {
-        v9fs_path_init(&path);
-
-        v9fs_readdir_lock(&fidp->fs.dir);
+    /*
+     * Fetch the directory entries altogether, including their stat
+     * results, on a background IO thread.  Hopping between threads for
+     * every single entry would sum up to huge latencies.  A 9P2000.u
+     * stat record is never smaller than its Rreaddir counterpart used
+     * for accounting by v9fs_co_readdir_many(), so the entries
+     * collected for @max_count cover everything the response can hold.
+     */
+    err = v9fs_co_readdir_many(pdu, fidp, &entries, dir_pos, max_count,
+                               true);
+    if (err < 0) {
+        goto out;
+    }
 
-        err = v9fs_co_readdir(pdu, fidp, &dent);
-        if (err || !dent) {
-            break;
-        }
-        err = v9fs_co_name_to_path(pdu, &fidp->path, dent->d_name, &path);
-        if (err < 0) {
+    for (struct V9fsDirEnt *e = entries; e; e = e->next) {
+        dent = e->dent;
+        st = e->st;
+        /* e->st should never be NULL, but just to be sure */
+        if (!st) {
+            err = -1;
             break;
         }
-        err = v9fs_co_lstat(pdu, &path, &stbuf);
-        if (err < 0) {
-            break;
+
+        v9fs_path_init(&path);
+        if (S_ISLNK(st->st_mode)) {
+            /* only symlinks need the path, to read the link target */
+            err = v9fs_co_name_to_path(pdu, &fidp->path, dent->d_name,
+                                       &path);
+            if (err < 0) {
+                break;
+            }
         }
-        err = stat_to_v9stat(pdu, &path, dent->d_name, &stbuf, &v9stat);
+        err = stat_to_v9stat(pdu, &path, dent->d_name, st, &v9stat);
+        v9fs_path_free(&path);
         if (err < 0) {
             break;
         }
+
         if ((count + v9stat.size + 2) > max_count) {
-            v9fs_readdir_unlock(&fidp->fs.dir);
+            v9fs_stat_free(&v9stat);
 
             /* Ran out of buffer. Set dir back to old position and return */
-            v9fs_co_seekdir(pdu, fidp, saved_dir_pos);
-            v9fs_stat_free(&v9stat);
-            v9fs_path_free(&path);
-            return count;
+            v9fs_co_seekdir(pdu, fidp, dir_pos);
+            break;
         }
 
         /* 11 = 7 + 4 (7 = start offset, 4 = space for storing count) */
         len = pdu_marshal(pdu, 11 + count, "S", &v9stat);
-
-        v9fs_readdir_unlock(&fidp->fs.dir);
+        v9fs_stat_free(&v9stat);
 
         if (len < 0) {
-            v9fs_co_seekdir(pdu, fidp, saved_dir_pos);
-            v9fs_stat_free(&v9stat);
-            v9fs_path_free(&path);
-            return len;
+            err = len;
+            break;
         }
         count += len;
-        v9fs_stat_free(&v9stat);
-        v9fs_path_free(&path);
-        saved_dir_pos = qemu_dirent_off(dent);
+        dir_pos = qemu_dirent_off(dent);
     }
 
-    v9fs_readdir_unlock(&fidp->fs.dir);
-
-    v9fs_path_free(&path);
+out:
+    v9fs_free_dirents(entries);
     if (err < 0) {
+        /*
+         * Leave the directory position where the client last saw it;
+         * v9fs_co_readdir_many() advanced it past all collected
+         * entries.
+         */
+        v9fs_co_seekdir(pdu, fidp, dir_pos);
         return err;
     }
     return count;
@@ -2447,18 +2475,6 @@ size_t v9fs_readdir_response_size(V9fsString *name)
     return 24 + v9fs_string_size(name);
 }
 
-static void v9fs_free_dirents(struct V9fsDirEnt *e)
-{
-    struct V9fsDirEnt *next = NULL;
-
-    for (; e; e = next) {
-        next = e->next;
-        g_free(e->dent);
-        g_free(e->st);
-        g_free(e);
-    }
-}
-
 static int coroutine_fn v9fs_do_readdir(V9fsPDU *pdu, V9fsFidState *fidp,
                                         off_t offset, int32_t max_count)
 {
@@ -52,7 +52,7 @@ static void virtio_blk_init_request(VirtIOBlock *s, VirtQueue *vq,
 
 static void virtio_blk_free_request(VirtIOBlockReq *req)
 {
-    g_free(req);
+    virtqueue_element_recycle(req->vq, &req->elem);
 }
 
 static void virtio_blk_req_complete(VirtIOBlockReq *req, unsigned char status)
@@ -1483,18 +1483,18 @@ validate_iothread_vq_mapping_list(IOThreadVirtQueueMappingList *list,
 /**
  * apply_iothread_vq_mapping:
  * @iothread_vq_mapping_list: The mapping of virtqueues to IOThreads.
- * @vq_aio_context: The array of AioContext pointers to fill in.
- * @num_queues: The length of @vq_aio_context.
+ * @vq_iothread: The array of IOThread pointers to fill in.
+ * @num_queues: The length of @vq_iothread.
  * @errp: If an error occurs, a pointer to the area to store the error.
  *
- * Fill in the AioContext for each virtqueue in the @vq_aio_context array given
- * the iothread-vq-mapping parameter in @iothread_vq_mapping_list.
+ * Fill in the IOThread for each virtqueue in the @vq_iothread array given the
+ * iothread-vq-mapping parameter in @iothread_vq_mapping_list.
  *
  * Returns: %true on success, %false on failure.
  **/
 static bool apply_iothread_vq_mapping(
         IOThreadVirtQueueMappingList *iothread_vq_mapping_list,
-        AioContext **vq_aio_context,
+        IOThread **vq_iothread,
         uint16_t num_queues,
         Error **errp)
 {
@@ -1513,10 +1513,6 @@ static bool apply_iothread_vq_mapping(
 
     for (node = iothread_vq_mapping_list; node; node = node->next) {
         IOThread *iothread = iothread_by_id(node->value->iothread);
-        AioContext *ctx = iothread_get_aio_context(iothread);
-
-        /* Released in virtio_blk_vq_aio_context_cleanup() */
-        object_ref(OBJECT(iothread));
 
         if (node->value->vqs) {
             uint16List *vq;
@@ -1524,13 +1520,13 @@ static bool apply_iothread_vq_mapping(
             /* Explicit vq:IOThread assignment */
             for (vq = node->value->vqs; vq; vq = vq->next) {
                 assert(vq->value < num_queues);
-                vq_aio_context[vq->value] = ctx;
+                vq_iothread[vq->value] = iothread;
             }
         } else {
             /* Round-robin vq:IOThread assignment */
             for (unsigned i = cur_iothread; i < num_queues;
                  i += num_iothreads) {
-                vq_aio_context[i] = ctx;
+                vq_iothread[i] = iothread;
             }
         }
 
@@ -1579,28 +1575,35 @@ static bool virtio_blk_vq_aio_context_init(VirtIOBlock *s, Error **errp)
     }
 
     s->vq_aio_context = g_new(AioContext *, conf->num_queues);
+    s->vq_iothread = g_new0(IOThread *, conf->num_queues);
 
     if (conf->iothread_vq_mapping_list) {
         if (!apply_iothread_vq_mapping(conf->iothread_vq_mapping_list,
-                                       s->vq_aio_context,
+                                       s->vq_iothread,
                                        conf->num_queues,
                                        errp)) {
+            g_free(s->vq_iothread);
+            s->vq_iothread = NULL;
             g_free(s->vq_aio_context);
             s->vq_aio_context = NULL;
             return false;
         }
     } else if (conf->iothread) {
-        AioContext *ctx = iothread_get_aio_context(conf->iothread);
         for (unsigned i = 0; i < conf->num_queues; i++) {
-            s->vq_aio_context[i] = ctx;
+            s->vq_iothread[i] = conf->iothread;
         }
+    }
 
-        /* Released in virtio_blk_vq_aio_context_cleanup() */
-        object_ref(OBJECT(conf->iothread));
-    } else {
-        AioContext *ctx = qemu_get_aio_context();
-        for (unsigned i = 0; i < conf->num_queues; i++) {
-            s->vq_aio_context[i] = ctx;
+    for (unsigned i = 0; i < conf->num_queues; i++) {
+        if (s->vq_iothread[i]) {
+            /*
+             * Released in virtio_blk_vq_aio_context_cleanup() or when the
+             * virtqueue moves to another IOThread
+             */
+            object_ref(OBJECT(s->vq_iothread[i]));
+            s->vq_aio_context[i] = iothread_get_aio_context(s->vq_iothread[i]);
+        } else {
+            s->vq_aio_context[i] = qemu_get_aio_context();
         }
     }
 
@@ -1614,23 +1617,70 @@ static void virtio_blk_vq_aio_context_cleanup(VirtIOBlock *s)
 
     assert(!s->ioeventfd_started);
 
-    if (conf->iothread_vq_mapping_list) {
-        IOThreadVirtQueueMappingList *node;
-
-        for (node = conf->iothread_vq_mapping_list; node; node = node->next) {
-            IOThread *iothread = iothread_by_id(node->value->iothread);
-            object_unref(OBJECT(iothread));
+    for (unsigned i = 0; i < conf->num_queues; i++) {
+        if (s->vq_iothread[i]) {
+            object_unref(OBJECT(s->vq_iothread[i]));
         }
     }
 
-    if (conf->iothread) {
-        object_unref(OBJECT(conf->iothread));
-    }
-
+    g_free(s->vq_iothread);
+    s->vq_iothread = NULL;
     g_free(s->vq_aio_context);
     s->vq_aio_context = NULL;
 }
 
+/* Context: BQL held */
+static void virtio_blk_set_vq_iothread(VirtIODevice *vdev, uint16_t queue_index,
+                                       IOThread *iothread, Error **errp)
+{
+    VirtIOBlock *s = VIRTIO_BLK(vdev);
+    AioContext *new_ctx = iothread ? iothread_get_aio_context(iothread) :
+                                     qemu_get_aio_context();
+    BlockDriverState *bs;
+
+    if (queue_index >= s->conf.num_queues) {
+        error_setg(errp, "vq index %u must be less than num_queues %u",
+                   queue_index, s->conf.num_queues);
+        return;
+    }
+
+    if (iothread && !virtio_device_ioeventfd_enabled(vdev)) {
+        error_setg(errp,
+                   "ioeventfd is required to bind a virtqueue to an IOThread");
+        return;
+    }
+
+    if (s->vq_aio_context[queue_index] == new_ctx) {
+        return;
+    }
+
+    /*
+     * Drain the datapath so that no virtqueue handler is running while the
+     * mapping changes.  virtio_blk_drained_begin() detaches the host notifier
+     * from the old AioContext and virtio_blk_drained_end() reattaches it to
+     * the new one.
+     */
+    bs = blk_bs(s->conf.conf.blk);
+    if (bs) {
+        bdrv_ref(bs);
+        bdrv_drained_begin(bs);
+    }
+
+    if (s->vq_iothread[queue_index]) {
+        object_unref(OBJECT(s->vq_iothread[queue_index]));
+    }
+    if (iothread) {
+        object_ref(OBJECT(iothread));
+    }
+    s->vq_iothread[queue_index] = iothread;
+    s->vq_aio_context[queue_index] = new_ctx;
+
+    if (bs) {
+        bdrv_drained_end(bs);
+        bdrv_unref(bs);
+    }
+}
+
 /* Context: BQL held */
 static int virtio_blk_start_ioeventfd(VirtIODevice *vdev)
 {
@@ -2036,6 +2086,7 @@ static void virtio_blk_class_init(ObjectClass *klass, void *data)
     vdc->load = virtio_blk_load_device;
     vdc->start_ioeventfd = virtio_blk_start_ioeventfd;
     vdc->stop_ioeventfd = virtio_blk_stop_ioeventfd;
+    vdc->set_vq_iothread = virtio_blk_set_vq_iothread;
 }
 
 static const TypeInfo virtio_blk_info = {
@@ -256,9 +256,35 @@ static void serial_xmit(SerialState *s)
             /* in loopback mode, say that we just received a char */
             serial_receive1(s, &s->tsr, 1);
         } else {
-            int rc = qemu_chr_fe_write(&s->chr, &s->tsr, 1);
+            uint8_t buf[UART_FIFO_LENGTH];
+            uint32_t len = 1;
+            int rc;
 
-            if ((rc == 0 ||
+            /*
+             * Hand the whole pending FIFO to the backend in one write
+             * instead of a write per byte; only the bytes the backend
+             * accepts leave the FIFO, so a short write just means the
+             * remainder is retransmitted on the next iteration.
+             */
+            buf[0] = s->tsr;
+            if ((s->fcr & UART_FCR_FE) && !fifo8_is_empty(&s->xmit_fifo)) {
+                len += fifo8_peek_buf(&s->xmit_fifo, buf + 1,
+                                      MIN(UART_FIFO_LENGTH - 1,
+                                          fifo8_num_used(&s->xmit_fifo)));
+            }
+            rc = qemu_chr_fe_write(&s->chr, buf, len);
+
+            if (rc > 1) {
+                /* Bytes after the first came straight out of the FIFO */
+                fifo8_drop(&s->xmit_fifo, rc - 1);
+                if (fifo8_is_empty(&s->xmit_fifo)) {
+                    s->lsr |= UART_LSR_THRE;
+                    if (!s->thr_ipending) {
+                        s->thr_ipending = 1;
+                        serial_update_irq(s);
+                    }
+                }
+            } else if ((rc == 0 ||
                  (rc == -1 && errno == EAGAIN)) &&
                 s->tsr_retry < MAX_XMIT_RETRY) {
                 assert(s->watch_tag == 0);
@@ -13,6 +13,13 @@
 #include "hw/hotplug.h"
 #include "qemu/module.h"
 
+static unsigned int hotplug_generation;
+
+unsigned int hotplug_handler_generation(void)
+{
+    return hotplug_generation;
+}
+
 void hotplug_handler_pre_plug(HotplugHandler *plug_handler,
                               DeviceState *plugged_dev,
                               Error **errp)
@@ -30,6 +37,7 @@ void hotplug_handler_plug(HotplugHandler *plug_handler,
 {
     HotplugHandlerClass *hdc = HOTPLUG_HANDLER_GET_CLASS(plug_handler);
 
+    hotplug_generation++;
     if (hdc->plug) {
         hdc->plug(plug_handler, plugged_dev, errp);
     }
@@ -52,6 +60,7 @@ void hotplug_handler_unplug(HotplugHandler *plug_handler,
 {
     HotplugHandlerClass *hdc = HOTPLUG_HANDLER_GET_CLASS(plug_handler);
 
+    hotplug_generation++;
     if (hdc->unplug) {
         hdc->unplug(plug_handler, plugged_dev, errp);
     }
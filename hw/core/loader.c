@@ -975,7 +975,7 @@ static QTAILQ_HEAD(, Rom) roms = QTAILQ_HEAD_INITIALIZER(roms);
 
 /*
  * rom->data can be heap-allocated or memory-mapped (e.g. when added with
- * rom_add_elf_program())
+ * rom_add_file() or rom_add_elf_program())
  */
 static void rom_free_data(Rom *rom)
 {
@@ -1082,12 +1082,20 @@ ssize_t rom_add_file(const char *file, const char *fw_dir,
         rom->path = g_strdup(file);
     }
 
-    if (!g_file_get_contents(rom->path, (gchar **) &rom->data,
-                             &size, &gerr)) {
+    /*
+     * Map the file instead of copying it to the heap: the pages are
+     * shared with the page cache and only faulted in as the ROM is
+     * actually written into the guest, which matters for large
+     * kernels and initrds.  rom_free_data() drops the reference.
+     */
+    rom->mapped_file = g_mapped_file_new(rom->path, false, &gerr);
+    if (!rom->mapped_file) {
         fprintf(stderr, "rom: file %-20s: error %s\n",
                 rom->name, gerr->message);
         goto err;
     }
+    rom->data = (uint8_t *)g_mapped_file_get_contents(rom->mapped_file);
+    size = g_mapped_file_get_length(rom->mapped_file);
 
     if (fw_dir) {
         rom->fw_dir  = g_strdup(fw_dir);
@@ -8,6 +8,7 @@
  */
 
 #include "qemu/osdep.h"
+#include "exec/cpu-common.h"
 #include "hw/acpi/vmgenid.h"
 #include "hw/boards.h"
 #include "hw/intc/intc.h"
@@ -18,6 +19,7 @@
 #include "qapi/qmp/qobject.h"
 #include "qapi/qobject-input-visitor.h"
 #include "qapi/type-helpers.h"
+#include "qemu/bitmap.h"
 #include "qemu/uuid.h"
 #include "qom/qom-qobject.h"
 #include "sysemu/hostmem.h"
@@ -64,6 +66,39 @@ CpuInfoFastList *qmp_query_cpus_fast(Error **errp)
     return head;
 }
 
+void qmp_x_vcpu_set_affinity(int64_t cpu_index, uint16List *host_cpus,
+                             Error **errp)
+{
+    unsigned long *bitmap;
+    int nbits = 0, ret;
+    CPUState *cpu;
+    uint16List *l;
+
+    cpu = qemu_get_cpu(cpu_index);
+    if (!cpu) {
+        error_setg(errp, "CPU %" PRId64 " does not exist", cpu_index);
+        return;
+    }
+    if (!host_cpus) {
+        error_setg(errp, "CPU list is empty");
+        return;
+    }
+
+    for (l = host_cpus; l; l = l->next) {
+        nbits = MAX(nbits, l->value + 1);
+    }
+    bitmap = bitmap_new(nbits);
+    for (l = host_cpus; l; l = l->next) {
+        set_bit(l->value, bitmap);
+    }
+
+    ret = qemu_thread_set_affinity(cpu->thread, bitmap, nbits);
+    g_free(bitmap);
+    if (ret) {
+        error_setg(errp, "Setting CPU affinity failed: %s", strerror(ret));
+    }
+}
+
 MachineInfoList *qmp_query_machines(bool has_compat_props, bool compat_props,
                                     Error **errp)
 {
@@ -199,6 +234,18 @@ static int query_memdev(Object *obj, void *opaque)
         visit_free(v);
         qobject_unref(host_nodes);
 
+        if (host_memory_backend_mr_inited(MEMORY_BACKEND(obj))) {
+            MemoryRegion *mr = &MEMORY_BACKEND(obj)->mr;
+            size_t thp_bytes;
+
+            thp_bytes = qemu_get_thp_bytes(memory_region_get_ram_ptr(mr),
+                                           memory_region_size(mr));
+            if (thp_bytes != (size_t)-1) {
+                m->thp_bytes = thp_bytes;
+                m->has_thp_bytes = true;
+            }
+        }
+
         QAPI_LIST_PREPEND(*list, m);
     }
 
@@ -311,6 +358,31 @@ MemoryInfo *qmp_query_memory_size_summary(Error **errp)
     return mem_info;
 }
 
+PageoutGuestRamResult *qmp_x_pageout_guest_ram(bool has_cold_only,
+                                               bool cold_only,
+                                               bool has_max_bytes,
+                                               uint64_t max_bytes,
+                                               Error **errp)
+{
+    PageoutGuestRamResult *result;
+    uint64_t advised;
+    bool complete;
+    Error *err = NULL;
+
+    advised = qemu_ram_pageout_all(has_cold_only && cold_only,
+                                   has_max_bytes ? max_bytes : 0,
+                                   &complete, &err);
+    if (err) {
+        error_propagate(errp, err);
+        return NULL;
+    }
+
+    result = g_new0(PageoutGuestRamResult, 1);
+    result->bytes_advised = advised;
+    result->complete = complete;
+    return result;
+}
+
 HumanReadableText *qmp_x_query_ramblock(Error **errp)
 {
     g_autoptr(GString) buf = ram_block_format();
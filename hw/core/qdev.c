@@ -38,6 +38,7 @@
 #include "hw/sysbus.h"
 #include "hw/qdev-clock.h"
 #include "migration/vmstate.h"
+#include "qemu/timer.h"
 #include "trace.h"
 
 static bool qdev_hot_added = false;
@@ -507,10 +508,14 @@ static void device_set_realized(Object *obj, bool value, Error **errp)
         }
 
         if (dc->realize) {
+            int64_t start = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+
             dc->realize(dev, &local_err);
             if (local_err != NULL) {
                 goto fail;
             }
+            trace_qdev_realize(dev, object_get_typename(obj),
+                               qemu_clock_get_ns(QEMU_CLOCK_REALTIME) - start);
         }
 
         DEVICE_LISTENER_CALL(realize, Forward, dev);
@@ -848,6 +853,15 @@ char *qdev_get_human_name(DeviceState *dev)
 
 static MachineInitPhase machine_phase;
 
+static const char *const machine_phase_names[] = {
+    [PHASE_NO_MACHINE] = "no-machine",
+    [PHASE_MACHINE_CREATED] = "machine-created",
+    [PHASE_ACCEL_CREATED] = "accel-created",
+    [PHASE_LATE_BACKENDS_CREATED] = "late-backends-created",
+    [PHASE_MACHINE_INITIALIZED] = "machine-initialized",
+    [PHASE_MACHINE_READY] = "machine-ready",
+};
+
 bool phase_check(MachineInitPhase phase)
 {
     return machine_phase >= phase;
@@ -857,6 +871,7 @@ void phase_advance(MachineInitPhase phase)
 {
     assert(machine_phase == phase - 1);
     machine_phase = phase;
+    trace_qdev_machine_init_phase(phase, machine_phase_names[phase]);
 }
 
 static const TypeInfo device_type_info = {
@@ -485,11 +485,25 @@ static void virtio_gpu_transfer_to_host_2d(VirtIOGPU *g,
     img_data = pixman_image_get_data(res->image);
 
     if (t2d.r.x || t2d.r.width != pixman_image_get_width(res->image)) {
+        unsigned int iov_idx = 0;
+        size_t iov_base_off = 0;
+
         for (h = 0; h < t2d.r.height; h++) {
             src_offset = t2d.offset + stride * h;
             dst_offset = (t2d.r.y + h) * stride + (t2d.r.x * bpp);
 
-            iov_to_buf(res->iov, res->iov_cnt, src_offset,
+            /*
+             * The source offset grows by a full stride per line, so
+             * carry the iovec cursor from line to line instead of
+             * rescanning the backing list from the start each time.
+             */
+            while (iov_idx < res->iov_cnt &&
+                   iov_base_off + res->iov[iov_idx].iov_len <= src_offset) {
+                iov_base_off += res->iov[iov_idx].iov_len;
+                iov_idx++;
+            }
+            iov_to_buf(res->iov + iov_idx, res->iov_cnt - iov_idx,
+                       src_offset - iov_base_off,
                        (uint8_t *)img_data + dst_offset,
                        t2d.r.width * bpp);
         }
@@ -535,8 +549,18 @@ static void virtio_gpu_resource_flush(VirtIOGPU *g,
                 within_bounds = true;
 
                 if (console_has_gl(scanout->con)) {
-                    dpy_gl_update(scanout->con, 0, 0, scanout->width,
-                                  scanout->height);
+                    QemuRect rect;
+
+                    /* Only flush the damaged part of the scanout */
+                    qemu_rect_init(&flush_rect, rf.r.x, rf.r.y,
+                                   rf.r.width, rf.r.height);
+                    qemu_rect_init(&rect, scanout->x, scanout->y,
+                                   scanout->width, scanout->height);
+                    if (qemu_rect_intersect(&flush_rect, &rect, &rect)) {
+                        qemu_rect_translate(&rect, -scanout->x, -scanout->y);
+                        dpy_gl_update(scanout->con, rect.x, rect.y,
+                                      rect.width, rect.height);
+                    }
                     update_submitted = true;
                 }
             }
@@ -30,6 +30,7 @@
 #include "hw/pci/pci_bridge.h"
 #include "hw/cxl/cxl.h"
 #include "hw/core/cpu.h"
+#include "hw/hotplug.h"
 #include "target/i386/cpu.h"
 #include "hw/timer/hpet.h"
 #include "hw/acpi/acpi-defs.h"
@@ -2385,6 +2386,10 @@ struct AcpiBuildState {
     uint8_t patched;
     MemoryRegion *rsdp_mr;
     MemoryRegion *linker_mr;
+    /* Last built tables, reused across resets while they stay valid. */
+    AcpiBuildTables tables;
+    bool tables_valid;
+    unsigned int hotplug_generation;
 } AcpiBuildState;
 
 static bool acpi_get_mcfg(AcpiMcfgInfo *mcfg)
@@ -2624,7 +2629,6 @@ static void acpi_ram_update(MemoryRegion *mr, GArray *data)
 static void acpi_build_update(void *build_opaque)
 {
     AcpiBuildState *build_state = build_opaque;
-    AcpiBuildTables tables;
 
     /* No state to update or already patched? Nothing to do. */
     if (!build_state || build_state->patched) {
@@ -2632,16 +2636,30 @@ static void acpi_build_update(void *build_opaque)
     }
     build_state->patched = 1;
 
-    acpi_build_tables_init(&tables);
-
-    acpi_build(&tables, MACHINE(qdev_get_machine()));
+    /*
+     * After machine creation the tables only change through device
+     * plug and unplug, so a reboot of an unmodified machine would run
+     * the whole AML assembler again just to reproduce the same blobs.
+     * Reuse the last build in that case and only restore the in-RAM
+     * copies that the firmware has patched.
+     */
+    if (!build_state->tables_valid ||
+        build_state->hotplug_generation != hotplug_handler_generation()) {
+        if (build_state->tables_valid) {
+            acpi_build_tables_cleanup(&build_state->tables, true);
+        }
+        acpi_build_tables_init(&build_state->tables);
+        acpi_build(&build_state->tables, MACHINE(qdev_get_machine()));
+        build_state->tables_valid = true;
+        build_state->hotplug_generation = hotplug_handler_generation();
+    }
 
-    acpi_ram_update(build_state->table_mr, tables.table_data);
+    acpi_ram_update(build_state->table_mr, build_state->tables.table_data);
 
-    acpi_ram_update(build_state->rsdp_mr, tables.rsdp);
+    acpi_ram_update(build_state->rsdp_mr, build_state->tables.rsdp);
 
-    acpi_ram_update(build_state->linker_mr, tables.linker->cmd_blob);
-    acpi_build_tables_cleanup(&tables, true);
+    acpi_ram_update(build_state->linker_mr,
+                    build_state->tables.linker->cmd_blob);
 }
 
 static void acpi_build_reset(void *build_opaque)
@@ -322,6 +322,15 @@ struct AHCIDevice {
     AHCICmdHdr *cur_cmd;
     NCQTransferState ncq_tfs[AHCI_MAX_CMDS];
     MemReentrancyGuard mem_reentrancy_guard;
+    /*
+     * Where the last sglist population stopped scanning the PRDT, so a
+     * follow-up chunk of the same command can resume there instead of
+     * re-walking the table from entry 0.  Not migrated; a full rescan
+     * yields the same result.
+     */
+    AHCICmdHdr *prdt_resume_cmd;
+    uint32_t prdt_resume_idx;
+    uint64_t prdt_resume_sum;
 };
 
 extern const VMStateDescription vmstate_ahci;
@@ -760,6 +760,7 @@ static bool ahci_map_clb_address(AHCIDevice *ad)
 {
     AHCIPortRegs *pr = &ad->port_regs;
     ad->cur_cmd = NULL;
+    ad->prdt_resume_cmd = NULL;
     map_page(ad->hba->as, &ad->lst,
              ((uint64_t)pr->lst_addr_hi << 32) | pr->lst_addr, 1024);
     if (ad->lst != NULL) {
@@ -976,9 +977,20 @@ static int ahci_populate_sglist(AHCIDevice *ad, QEMUSGList *sglist,
     if (prdtl > 0) {
         AHCI_SG *tbl = (AHCI_SG *)prdt;
         int tbl_entry_size = 0;
+        int start_idx = 0;
 
         sum = 0;
-        for (i = 0; i < prdtl; i++) {
+        /*
+         * Chunked transfers call in with a growing @offset; resume the
+         * scan where the previous chunk of the same command stopped
+         * rather than accumulating entry sizes from the start again.
+         */
+        if (cmd == ad->prdt_resume_cmd && ad->prdt_resume_idx < prdtl &&
+            offset >= ad->prdt_resume_sum) {
+            start_idx = ad->prdt_resume_idx;
+            sum = ad->prdt_resume_sum;
+        }
+        for (i = start_idx; i < prdtl; i++) {
             tbl_entry_size = prdt_tbl_entry_size(&tbl[i]);
             if (offset < (sum + tbl_entry_size)) {
                 off_idx = i;
@@ -994,6 +1006,10 @@ static int ahci_populate_sglist(AHCIDevice *ad, QEMUSGList *sglist,
             goto out;
         }
 
+        ad->prdt_resume_cmd = cmd;
+        ad->prdt_resume_idx = off_idx;
+        ad->prdt_resume_sum = sum;
+
         qemu_sglist_init(sglist, qbus->parent, (prdtl - off_idx),
                          ad->hba->as);
         qemu_sglist_add(sglist, le64_to_cpu(tbl[off_idx].addr) + off_pos,
@@ -40,6 +40,21 @@ static APICCommonState **local_apics;
 static uint32_t max_apics;
 static uint32_t max_apic_words;
 
+/*
+ * Interrupt delivery runs under the BQL and does not nest, so one
+ * scratch bitmask can be shared by all senders instead of allocating
+ * a fresh one per IPI.
+ */
+static uint32_t *deliver_bitmask_scratch;
+
+/*
+ * Local APICs are registered under their initial ID.  Until a guest
+ * reprograms an xAPIC ID away from that value, a physical unicast
+ * destination can only match the APIC registered at that index, which
+ * allows apic_find_dest() to skip the scan over all possible APICs.
+ */
+static bool apic_ids_reprogrammed;
+
 #define TYPE_APIC "apic"
 /*This is reusing the APICCommonState typedef from APIC_COMMON */
 DECLARE_INSTANCE_CHECKER(APICCommonState, APIC,
@@ -59,6 +74,7 @@ void apic_set_max_apic_id(uint32_t max_apic_id)
 
     local_apics = g_malloc0(sizeof(*local_apics) * max_apics);
     max_apic_words = max_apics >> 5;
+    deliver_bitmask_scratch = g_new(uint32_t, max_apic_words);
 }
 
 
@@ -291,7 +307,7 @@ static void apic_deliver_irq(uint32_t dest, uint8_t dest_mode,
                              uint8_t delivery_mode, uint8_t vector_num,
                              uint8_t trigger_mode)
 {
-    g_autofree uint32_t *deliver_bitmask = g_new(uint32_t, max_apic_words);
+    uint32_t *deliver_bitmask = deliver_bitmask_scratch;
 
     trace_apic_deliver_irq(dest, dest_mode, delivery_mode, vector_num,
                            trigger_mode);
@@ -528,6 +544,24 @@ static void apic_find_dest(uint32_t *deliver_bitmask, uint32_t dest)
     APICCommonState *apic = NULL;
     int i;
 
+    /*
+     * With all APICs still at their initial IDs and no IDs above the
+     * 8-bit xAPIC range, a unicast destination below the xAPIC
+     * broadcast ID can only match the APIC registered under that
+     * index: an xAPIC matches on the 8-bit ID and an x2APIC on the
+     * exact initial ID.  Larger configurations keep the scan, since
+     * the truncated xAPIC IDs of high APICs can alias mod 256.
+     */
+    if (!apic_ids_reprogrammed && dest < 0xff && max_apics <= 0x100) {
+        if (dest < max_apics) {
+            apic = local_apics[dest];
+            if (apic && apic_match_dest(apic, dest)) {
+                apic_set_bit(deliver_bitmask, dest);
+            }
+        }
+        return;
+    }
+
     for (i = 0; i < max_apics; i++) {
         apic = local_apics[i];
         if (apic && apic_match_dest(apic, dest)) {
@@ -661,7 +695,7 @@ static void apic_deliver(DeviceState *dev, uint32_t dest, uint8_t dest_mode,
     APICCommonState *s = APIC(dev);
     APICCommonState *apic_iter;
     uint32_t deliver_bitmask_size = max_apic_words * sizeof(uint32_t);
-    g_autofree uint32_t *deliver_bitmask = g_new(uint32_t, max_apic_words);
+    uint32_t *deliver_bitmask = deliver_bitmask_scratch;
     uint32_t current_apic_id;
 
     if (is_x2apic_mode(dev)) {
@@ -956,6 +990,9 @@ static int apic_register_write(int index, uint64_t val)
         }
 
         s->id = (val >> 24);
+        if (s->id != (uint8_t)s->initial_apic_id) {
+            apic_ids_reprogrammed = true;
+        }
         break;
     case 0x03:
         break;
@@ -1118,6 +1155,11 @@ static void apic_pre_save(APICCommonState *s)
 
 static void apic_post_load(APICCommonState *s)
 {
+    /* The source may have migrated a guest with reprogrammed xAPIC IDs. */
+    if (s->id != (uint8_t)s->initial_apic_id) {
+        apic_ids_reprogrammed = true;
+    }
+
     if (s->timer_expiry != -1) {
         timer_mod(s->timer, s->timer_expiry);
     } else {
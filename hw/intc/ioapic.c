@@ -195,6 +195,8 @@ static void ioapic_update_kvm_routes(IOAPICCommonState *s)
     int i;
 
     if (kvm_irqchip_is_split()) {
+        bool changed = false;
+
         for (i = 0; i < IOAPIC_NUM_PINS; i++) {
             MSIMessage msg;
             struct ioapic_entry_info info;
@@ -202,10 +204,13 @@ static void ioapic_update_kvm_routes(IOAPICCommonState *s)
             if (!info.masked) {
                 msg.address = info.addr;
                 msg.data = info.data;
-                kvm_irqchip_update_msi_route(kvm_state, i, msg, NULL);
+                changed |= kvm_irqchip_update_msi_route(kvm_state, i,
+                                                        msg, NULL) > 0;
             }
         }
-        kvm_irqchip_commit_routes(kvm_state);
+        if (changed) {
+            kvm_irqchip_commit_routes(kvm_state);
+        }
     }
 #endif
 }
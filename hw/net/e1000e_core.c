@@ -1320,53 +1320,91 @@ struct NetRxPkt *pkt, const E1000E_RSSInfo *rss_info,
     }
 }
 
-static inline void
-e1000e_pci_dma_write_rx_desc(E1000ECore *core, dma_addr_t addr,
-                             union e1000_rx_desc_union *desc, dma_addr_t len)
+#define E1000E_RX_DESC_WB_MAX 32
+
+typedef struct E1000ERxDescWbState {
+    dma_addr_t base;
+    uint32_t count;
+    uint8_t buf[E1000E_RX_DESC_WB_MAX * sizeof(union e1000_rx_desc_union)]
+        QEMU_ALIGNED(8);
+} E1000ERxDescWbState;
+
+static size_t
+e1000e_rx_desc_status_offset(E1000ECore *core)
+{
+    if (e1000e_rx_use_legacy_descriptor(core)) {
+        return offsetof(struct e1000_rx_desc, status);
+    } else if (core->mac[RCTL] & E1000_RCTL_DTYP_PS) {
+        return offsetof(union e1000_rx_desc_packet_split,
+                        wb.middle.status_error);
+    } else {
+        return offsetof(union e1000_rx_desc_extended, wb.upper.status_error);
+    }
+}
+
+/*
+ * Flush pending descriptor write-backs with a single DMA write covering
+ * the whole contiguous range.  The DD bit of every descriptor is cleared
+ * in the batched write and set afterwards with a separate store, in ring
+ * order, so a guest polling the status field never observes a descriptor
+ * whose remaining fields are not written back yet.  The status field is
+ * little-endian in all descriptor formats, so the DD bit always lives in
+ * its first byte.
+ */
+static void
+e1000e_rx_desc_wb_flush(E1000ECore *core, E1000ERxDescWbState *wb)
 {
     PCIDevice *dev = core->owner;
+    dma_addr_t len = core->rx_desc_len;
+    size_t offset = e1000e_rx_desc_status_offset(core);
+    bool dd[E1000E_RX_DESC_WB_MAX];
+    uint32_t i;
 
-    if (e1000e_rx_use_legacy_descriptor(core)) {
-        struct e1000_rx_desc *d = &desc->legacy;
-        size_t offset = offsetof(struct e1000_rx_desc, status);
-        uint8_t status = d->status;
+    if (wb->count == 0) {
+        return;
+    }
 
-        d->status &= ~E1000_RXD_STAT_DD;
-        pci_dma_write(dev, addr, desc, len);
+    trace_e1000e_rx_desc_wb_flush(wb->base, wb->count);
 
-        if (status & E1000_RXD_STAT_DD) {
-            d->status = status;
-            pci_dma_write(dev, addr + offset, &status, sizeof(status));
-        }
-    } else {
-        if (core->mac[RCTL] & E1000_RCTL_DTYP_PS) {
-            union e1000_rx_desc_packet_split *d = &desc->packet_split;
-            size_t offset = offsetof(union e1000_rx_desc_packet_split,
-                wb.middle.status_error);
-            uint32_t status = d->wb.middle.status_error;
+    for (i = 0; i < wb->count; i++) {
+        uint8_t *status = &wb->buf[i * len + offset];
 
-            d->wb.middle.status_error &= ~E1000_RXD_STAT_DD;
-            pci_dma_write(dev, addr, desc, len);
+        dd[i] = *status & E1000_RXD_STAT_DD;
+        *status &= ~E1000_RXD_STAT_DD;
+    }
 
-            if (status & E1000_RXD_STAT_DD) {
-                d->wb.middle.status_error = status;
-                pci_dma_write(dev, addr + offset, &status, sizeof(status));
-            }
-        } else {
-            union e1000_rx_desc_extended *d = &desc->extended;
-            size_t offset = offsetof(union e1000_rx_desc_extended,
-                wb.upper.status_error);
-            uint32_t status = d->wb.upper.status_error;
+    pci_dma_write(dev, wb->base, wb->buf, wb->count * len);
 
-            d->wb.upper.status_error &= ~E1000_RXD_STAT_DD;
-            pci_dma_write(dev, addr, desc, len);
+    for (i = 0; i < wb->count; i++) {
+        uint8_t *status = &wb->buf[i * len + offset];
 
-            if (status & E1000_RXD_STAT_DD) {
-                d->wb.upper.status_error = status;
-                pci_dma_write(dev, addr + offset, &status, sizeof(status));
-            }
+        if (dd[i]) {
+            *status |= E1000_RXD_STAT_DD;
+            pci_dma_write(dev, wb->base + i * len + offset, status,
+                          sizeof(*status));
         }
     }
+
+    wb->count = 0;
+}
+
+static void
+e1000e_rx_desc_wb_append(E1000ECore *core, E1000ERxDescWbState *wb,
+                         dma_addr_t addr, union e1000_rx_desc_union *desc)
+{
+    dma_addr_t len = core->rx_desc_len;
+
+    if (wb->count == E1000E_RX_DESC_WB_MAX ||
+        (wb->count && addr != wb->base + wb->count * len)) {
+        e1000e_rx_desc_wb_flush(core, wb);
+    }
+
+    if (wb->count == 0) {
+        wb->base = addr;
+    }
+
+    memcpy(&wb->buf[wb->count * len], desc, len);
+    wb->count++;
 }
 
 typedef struct E1000EBAState {
@@ -1497,6 +1535,7 @@ e1000e_write_packet_to_guest(E1000ECore *core, struct NetRxPkt *pkt,
     size_t ps_hdr_len = 0;
     bool do_ps = e1000e_do_ps(core, pkt, &ps_hdr_len);
     bool is_first = true;
+    E1000ERxDescWbState wb = { 0 };
 
     rxi = rxr->i;
 
@@ -1512,6 +1551,7 @@ e1000e_write_packet_to_guest(E1000ECore *core, struct NetRxPkt *pkt,
         }
 
         if (e1000e_ring_empty(core, rxi)) {
+            e1000e_rx_desc_wb_flush(core, &wb);
             return;
         }
 
@@ -1597,13 +1637,15 @@ e1000e_write_packet_to_guest(E1000ECore *core, struct NetRxPkt *pkt,
 
         e1000e_write_rx_descr(core, &desc, is_last ? core->rx_pkt : NULL,
                            rss_info, do_ps ? ps_hdr_len : 0, &bastate.written);
-        e1000e_pci_dma_write_rx_desc(core, base, &desc, core->rx_desc_len);
+        e1000e_rx_desc_wb_append(core, &wb, base, &desc);
 
         e1000e_ring_advance(core, rxi,
                             core->rx_desc_len / E1000_MIN_RX_DESC_LEN);
 
     } while (desc_offset < total_size);
 
+    e1000e_rx_desc_wb_flush(core, &wb);
+
     e1000e_update_rx_stats(core, size, total_size);
 }
 
@@ -1588,36 +1588,87 @@ igb_write_rx_descr(IGBCore *core,
     }
 }
 
-static inline void
-igb_pci_dma_write_rx_desc(IGBCore *core, PCIDevice *dev, dma_addr_t addr,
-                          union e1000_rx_desc_union *desc, dma_addr_t len)
+#define IGB_RX_DESC_WB_MAX 32
+
+typedef struct IGBRxDescWbState {
+    dma_addr_t base;
+    uint32_t count;
+    uint8_t buf[IGB_RX_DESC_WB_MAX * sizeof(union e1000_rx_desc_union)]
+        QEMU_ALIGNED(8);
+} IGBRxDescWbState;
+
+static size_t
+igb_rx_desc_status_offset(IGBCore *core)
 {
     if (igb_rx_use_legacy_descriptor(core)) {
-        struct e1000_rx_desc *d = &desc->legacy;
-        size_t offset = offsetof(struct e1000_rx_desc, status);
-        uint8_t status = d->status;
+        return offsetof(struct e1000_rx_desc, status);
+    } else {
+        return offsetof(union e1000_adv_rx_desc, wb.upper.status_error);
+    }
+}
+
+/*
+ * Flush pending descriptor write-backs with a single DMA write covering
+ * the whole contiguous range.  The DD bit of every descriptor is cleared
+ * in the batched write and set afterwards with a separate store, in ring
+ * order, so a guest polling the status field never observes a descriptor
+ * whose remaining fields are not written back yet.  The status field is
+ * little-endian in both descriptor formats, so the DD bit always lives
+ * in its first byte.
+ */
+static void
+igb_rx_desc_wb_flush(IGBCore *core, PCIDevice *dev, IGBRxDescWbState *wb)
+{
+    dma_addr_t len = core->rx_desc_len;
+    size_t offset = igb_rx_desc_status_offset(core);
+    bool dd[IGB_RX_DESC_WB_MAX];
+    uint32_t i;
 
-        d->status &= ~E1000_RXD_STAT_DD;
-        pci_dma_write(dev, addr, desc, len);
+    if (wb->count == 0) {
+        return;
+    }
 
-        if (status & E1000_RXD_STAT_DD) {
-            d->status = status;
-            pci_dma_write(dev, addr + offset, &status, sizeof(status));
-        }
-    } else {
-        union e1000_adv_rx_desc *d = &desc->adv;
-        size_t offset =
-            offsetof(union e1000_adv_rx_desc, wb.upper.status_error);
-        uint32_t status = d->wb.upper.status_error;
+    trace_e1000e_rx_desc_wb_flush(wb->base, wb->count);
 
-        d->wb.upper.status_error &= ~E1000_RXD_STAT_DD;
-        pci_dma_write(dev, addr, desc, len);
+    for (i = 0; i < wb->count; i++) {
+        uint8_t *status = &wb->buf[i * len + offset];
 
-        if (status & E1000_RXD_STAT_DD) {
-            d->wb.upper.status_error = status;
-            pci_dma_write(dev, addr + offset, &status, sizeof(status));
+        dd[i] = *status & E1000_RXD_STAT_DD;
+        *status &= ~E1000_RXD_STAT_DD;
+    }
+
+    pci_dma_write(dev, wb->base, wb->buf, wb->count * len);
+
+    for (i = 0; i < wb->count; i++) {
+        uint8_t *status = &wb->buf[i * len + offset];
+
+        if (dd[i]) {
+            *status |= E1000_RXD_STAT_DD;
+            pci_dma_write(dev, wb->base + i * len + offset, status,
+                          sizeof(*status));
         }
     }
+
+    wb->count = 0;
+}
+
+static void
+igb_rx_desc_wb_append(IGBCore *core, PCIDevice *dev, IGBRxDescWbState *wb,
+                      dma_addr_t addr, union e1000_rx_desc_union *desc)
+{
+    dma_addr_t len = core->rx_desc_len;
+
+    if (wb->count == IGB_RX_DESC_WB_MAX ||
+        (wb->count && addr != wb->base + wb->count * len)) {
+        igb_rx_desc_wb_flush(core, dev, wb);
+    }
+
+    if (wb->count == 0) {
+        wb->base = addr;
+    }
+
+    memcpy(&wb->buf[wb->count * len], desc, len);
+    wb->count++;
 }
 
 static void
@@ -1900,6 +1951,7 @@ igb_write_packet_to_guest(IGBCore *core, struct NetRxPkt *pkt,
     union e1000_rx_desc_union desc;
     const E1000ERingInfo *rxi;
     size_t rx_desc_len;
+    IGBRxDescWbState wb = { 0 };
 
     IGBPacketRxDMAState pdma_st = {0};
     pdma_st.is_first = true;
@@ -1923,6 +1975,7 @@ igb_write_packet_to_guest(IGBCore *core, struct NetRxPkt *pkt,
         bool is_last = false;
 
         if (igb_ring_empty(core, rxi)) {
+            igb_rx_desc_wb_flush(core, d, &wb);
             return;
         }
 
@@ -1944,10 +1997,12 @@ igb_write_packet_to_guest(IGBCore *core, struct NetRxPkt *pkt,
                            etqf, ts,
                            &pdma_st,
                            rxi);
-        igb_pci_dma_write_rx_desc(core, d, base, &desc, rx_desc_len);
+        igb_rx_desc_wb_append(core, d, &wb, base, &desc);
         igb_ring_advance(core, rxi, rx_desc_len / E1000_MIN_RX_DESC_LEN);
     } while (pdma_st.desc_offset < pdma_st.total_size);
 
+    igb_rx_desc_wb_flush(core, d, &wb);
+
     igb_update_rx_stats(core, rxi, pdma_st.size, pdma_st.total_size);
 }
 
@@ -123,6 +123,24 @@ typedef enum {
     NetPktRssIpV6UdpEx,
 } NetRxPktRssType;
 
+/* Maximum length of the RSS hash input (IPv6 addresses + TCP/UDP ports) */
+#define NET_RX_PKT_RSS_INPUT_MAX 36
+
+/**
+* fills the buffer with the packet bytes the RSS hash is computed over
+*
+* @pkt:            packet
+* @type:           RSS hash type
+* @rss_input:      buffer of at least NET_RX_PKT_RSS_INPUT_MAX bytes
+*
+* Return:  number of bytes written to rss_input.
+*
+*/
+size_t
+net_rx_pkt_rss_prepare(struct NetRxPkt *pkt,
+                       NetRxPktRssType type,
+                       uint8_t *rss_input);
+
 /**
 * calculates RSS hash for packet
 *
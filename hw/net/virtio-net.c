@@ -13,6 +13,7 @@
 
 #include "qemu/osdep.h"
 #include "qemu/atomic.h"
+#include "qemu/defer-call.h"
 #include "qemu/iov.h"
 #include "qemu/log.h"
 #include "qemu/main-loop.h"
@@ -1234,14 +1235,28 @@ static int virtio_net_handle_announce(VirtIONet *n, uint8_t cmd,
     }
 }
 
-static bool virtio_net_attach_ebpf_to_backend(NICState *nic, int prog_fd)
+static bool virtio_net_attach_ebpf_to_backend(VirtIONet *n, int prog_fd)
 {
-    NetClientState *nc = qemu_get_peer(qemu_get_queue(nic), 0);
+    NetClientState *nc = qemu_get_peer(qemu_get_queue(n->nic), 0);
     if (nc == NULL || nc->info->set_steering_ebpf == NULL) {
         return false;
     }
 
-    return nc->info->set_steering_ebpf(nc, prog_fd);
+    /*
+     * The RSS configuration is recommitted on every device status
+     * change; don't repeat the steering ioctl when the program that is
+     * already attached would be attached again.
+     */
+    if (n->ebpf_rss_attach_fd == prog_fd) {
+        return true;
+    }
+
+    if (!nc->info->set_steering_ebpf(nc, prog_fd)) {
+        return false;
+    }
+
+    n->ebpf_rss_attach_fd = prog_fd;
+    return true;
 }
 
 static void rss_data_to_rss_config(struct VirtioNetRssData *data,
@@ -1269,7 +1284,7 @@ static bool virtio_net_attach_epbf_rss(VirtIONet *n)
         return false;
     }
 
-    if (!virtio_net_attach_ebpf_to_backend(n->nic, n->ebpf_rss.program_fd)) {
+    if (!virtio_net_attach_ebpf_to_backend(n, n->ebpf_rss.program_fd)) {
         return false;
     }
 
@@ -1278,11 +1293,29 @@ static bool virtio_net_attach_epbf_rss(VirtIONet *n)
 
 static void virtio_net_detach_epbf_rss(VirtIONet *n)
 {
-    virtio_net_attach_ebpf_to_backend(n->nic, -1);
+    virtio_net_attach_ebpf_to_backend(n, -1);
 }
 
+/*
+ * Software RSS flow cache. Receive traffic is dominated by a handful of
+ * flows, so remembering the Toeplitz hash of recently seen hash inputs
+ * turns the per-packet computation into a fold and a compare.
+ */
+struct VirtioNetRssFlow {
+    uint8_t len;
+    uint8_t type;
+    uint8_t input[NET_RX_PKT_RSS_INPUT_MAX];
+    uint32_t hash;
+};
+
+#define VIRTIO_NET_RSS_FLOWS_LEN 256
+
 static void virtio_net_commit_rss_config(VirtIONet *n)
 {
+    /* The key or hash types may have changed, drop all cached flows */
+    g_free(n->rss_flows);
+    n->rss_flows = NULL;
+
     if (n->rss_data.enabled) {
         n->rss_data.enabled_software_rss = n->rss_data.populate_hash;
         if (n->rss_data.populate_hash) {
@@ -1296,6 +1329,10 @@ static void virtio_net_commit_rss_config(VirtIONet *n)
             }
         }
 
+        if (n->rss_data.enabled_software_rss) {
+            n->rss_flows = g_new0(VirtioNetRssFlow, VIRTIO_NET_RSS_FLOWS_LEN);
+        }
+
         trace_virtio_net_rss_enable(n->rss_data.hash_types,
                                     n->rss_data.indirections_len,
                                     sizeof(n->rss_data.key));
@@ -1352,7 +1389,7 @@ static bool virtio_net_load_ebpf(VirtIONet *n)
 {
     bool ret = false;
 
-    if (virtio_net_attach_ebpf_to_backend(n->nic, -1)) {
+    if (virtio_net_attach_ebpf_to_backend(n, -1)) {
         if (!(n->ebpf_rss_fds && virtio_net_load_ebpf_fds(n))) {
             ret = ebpf_rss_load(&n->ebpf_rss);
         }
@@ -1363,7 +1400,7 @@ static bool virtio_net_load_ebpf(VirtIONet *n)
 
 static void virtio_net_unload_ebpf(VirtIONet *n)
 {
-    virtio_net_attach_ebpf_to_backend(n->nic, -1);
+    virtio_net_attach_ebpf_to_backend(n, -1);
     ebpf_rss_unload(&n->ebpf_rss);
 }
 
@@ -1599,10 +1636,10 @@ static void virtio_net_handle_ctrl(VirtIODevice *vdev, VirtQueue *vq)
         if (written > 0) {
             virtqueue_push(vq, elem, written);
             virtio_notify(vdev, vq);
-            g_free(elem);
+            virtqueue_element_recycle(vq, elem);
         } else {
             virtqueue_detach_element(vq, elem, 0);
-            g_free(elem);
+            virtqueue_element_recycle(vq, elem);
             break;
         }
     }
@@ -1835,6 +1872,47 @@ static uint8_t virtio_net_get_hash_type(bool hasip4,
     return 0xff;
 }
 
+static uint32_t virtio_net_rss_hash(VirtIONet *n, struct NetRxPkt *pkt,
+                                    uint8_t net_hash_type)
+{
+    uint8_t rss_input[NET_RX_PKT_RSS_INPUT_MAX] = {};
+    net_toeplitz_key key_data;
+    VirtioNetRssFlow *flow;
+    uint32_t fold, hash = 0;
+    size_t len;
+    int i;
+
+    if (!n->rss_flows) {
+        return net_rx_pkt_calc_rss_hash(pkt, net_hash_type, n->rss_data.key);
+    }
+
+    len = net_rx_pkt_rss_prepare(pkt, net_hash_type, rss_input);
+
+    /* Fold the zero-padded hash input down to a cache index */
+    fold = net_hash_type;
+    for (i = 0; i < NET_RX_PKT_RSS_INPUT_MAX; i += sizeof(uint32_t)) {
+        fold ^= ldl_he_p(&rss_input[i]);
+    }
+    fold ^= fold >> 16;
+    fold ^= fold >> 8;
+
+    flow = &n->rss_flows[fold % VIRTIO_NET_RSS_FLOWS_LEN];
+    if (flow->len == len && flow->type == net_hash_type &&
+        memcmp(flow->input, rss_input, sizeof(rss_input)) == 0) {
+        return flow->hash;
+    }
+
+    net_toeplitz_key_init(&key_data, n->rss_data.key);
+    net_toeplitz_add(&hash, rss_input, len, &key_data);
+
+    flow->len = len;
+    flow->type = net_hash_type;
+    memcpy(flow->input, rss_input, sizeof(rss_input));
+    flow->hash = hash;
+
+    return hash;
+}
+
 static int virtio_net_process_rss(NetClientState *nc, const uint8_t *buf,
                                   size_t size,
                                   struct virtio_net_hdr_v1_hash *hdr)
@@ -1874,7 +1952,7 @@ static int virtio_net_process_rss(NetClientState *nc, const uint8_t *buf,
         return n->rss_data.redirect ? n->rss_data.default_queue : -1;
     }
 
-    hash = net_rx_pkt_calc_rss_hash(pkt, net_hash_type, n->rss_data.key);
+    hash = virtio_net_rss_hash(n, pkt, net_hash_type);
 
     if (n->rss_data.populate_hash) {
         hdr->hash_value = hash;
@@ -1958,7 +2036,7 @@ static ssize_t virtio_net_receive_rcu(NetClientState *nc, const uint8_t *buf,
             virtio_error(vdev,
                          "virtio-net receive queue contains no in buffers");
             virtqueue_detach_element(q->rx_vq, elem, 0);
-            g_free(elem);
+            virtqueue_element_recycle(q->rx_vq, elem);
             err = -1;
             goto err;
         }
@@ -1998,7 +2076,7 @@ static ssize_t virtio_net_receive_rcu(NetClientState *nc, const uint8_t *buf,
          * Otherwise, drop it. */
         if (!n->mergeable_rx_bufs && offset < size) {
             virtqueue_unpop(q->rx_vq, elem, total);
-            g_free(elem);
+            virtqueue_element_recycle(q->rx_vq, elem);
             err = size;
             goto err;
         }
@@ -2019,7 +2097,7 @@ static ssize_t virtio_net_receive_rcu(NetClientState *nc, const uint8_t *buf,
     for (j = 0; j < i; j++) {
         /* signal other side */
         virtqueue_fill(q->rx_vq, elems[j], lens[j], j);
-        g_free(elems[j]);
+        virtqueue_element_recycle(q->rx_vq, elems[j]);
     }
 
     virtqueue_flush(q->rx_vq, i);
@@ -2030,7 +2108,7 @@ static ssize_t virtio_net_receive_rcu(NetClientState *nc, const uint8_t *buf,
 err:
     for (j = 0; j < i; j++) {
         virtqueue_detach_element(q->rx_vq, elems[j], lens[j]);
-        g_free(elems[j]);
+        virtqueue_element_recycle(q->rx_vq, elems[j]);
     }
 
     return err;
@@ -2660,7 +2738,7 @@ static void virtio_net_tx_complete(NetClientState *nc, ssize_t len)
     virtqueue_push(q->tx_vq, q->async_tx.elem, 0);
     virtio_notify(vdev, q->tx_vq);
 
-    g_free(q->async_tx.elem);
+    virtqueue_element_recycle(q->tx_vq, q->async_tx.elem);
     q->async_tx.elem = NULL;
 
     virtio_queue_set_notification(q->tx_vq, 1);
@@ -2699,6 +2777,9 @@ static int32_t virtio_net_flush_tx(VirtIONetQueue *q)
         return num_packets;
     }
 
+    /* Coalesce the used-ring notifications for the whole burst */
+    defer_call_begin();
+
     for (;;) {
         ssize_t ret;
         unsigned int out_num;
@@ -2765,23 +2846,27 @@ static int32_t virtio_net_flush_tx(VirtIONetQueue *q)
         if (ret == 0) {
             virtio_queue_set_notification(q->tx_vq, 0);
             q->async_tx.elem = elem;
+            defer_call_end();
             return -EBUSY;
         }
 
 drop:
         virtqueue_push(q->tx_vq, elem, 0);
         virtio_notify(vdev, q->tx_vq);
-        g_free(elem);
+        virtqueue_element_recycle(q->tx_vq, elem);
 
         if (++num_packets >= n->tx_burst) {
             break;
         }
     }
+
+    defer_call_end();
     return num_packets;
 
 detach:
     virtqueue_detach_element(q->tx_vq, elem, 0);
-    g_free(elem);
+    virtqueue_element_recycle(q->tx_vq, elem);
+    defer_call_end();
     return -EINVAL;
 }
 
@@ -3804,6 +3889,7 @@ static void virtio_net_device_unrealize(DeviceState *dev)
     qemu_del_nic(n->nic);
     virtio_net_rsc_cleanup(n);
     g_free(n->rss_data.indirections_table);
+    g_free(n->rss_flows);
     net_rx_pkt_uninit(n->rx_pkt);
     virtio_cleanup(vdev);
 }
@@ -3858,6 +3944,7 @@ static void virtio_net_instance_init(Object *obj)
                                   DEVICE(n));
 
     ebpf_rss_init(&n->ebpf_rss);
+    n->ebpf_rss_attach_fd = -2;
 }
 
 static int virtio_net_pre_save(void *opaque)
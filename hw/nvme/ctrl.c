@@ -4898,10 +4898,10 @@ static void nvme_set_blk_stats(NvmeNamespace *ns, struct nvme_stats *stats)
 {
     BlockAcctStats *s = blk_get_stats(ns->blkconf.blk);
 
-    stats->units_read += s->nr_bytes[BLOCK_ACCT_READ];
-    stats->units_written += s->nr_bytes[BLOCK_ACCT_WRITE];
-    stats->read_commands += s->nr_ops[BLOCK_ACCT_READ];
-    stats->write_commands += s->nr_ops[BLOCK_ACCT_WRITE];
+    stats->units_read += stat64_get(&s->nr_bytes[BLOCK_ACCT_READ]);
+    stats->units_written += stat64_get(&s->nr_bytes[BLOCK_ACCT_WRITE]);
+    stats->read_commands += stat64_get(&s->nr_ops[BLOCK_ACCT_READ]);
+    stats->write_commands += stat64_get(&s->nr_ops[BLOCK_ACCT_WRITE]);
 }
 
 static uint16_t nvme_smart_info(NvmeCtrl *n, uint8_t rae, uint32_t buf_len,
@@ -7469,6 +7469,46 @@ static void nvme_ctrl_reset(NvmeCtrl *n, NvmeResetType rst)
         nvme_ns_drain(ns);
     }
 
+    /*
+     * Remove all queue ioeventfds in a single memory transaction instead
+     * of one commit per queue.  The notifiers must still be open when the
+     * transaction commits, so they are only closed afterwards; clearing
+     * ioeventfd_enabled keeps nvme_free_sq()/_cq() from touching them
+     * again (see virtio_device_stop_ioeventfd_impl()).
+     */
+    memory_region_transaction_begin();
+    for (i = 0; i < n->params.max_ioqpairs + 1; i++) {
+        NvmeSQueue *sq = n->sq[i];
+        NvmeCQueue *cq = n->cq[i];
+
+        if (sq && sq->ioeventfd_enabled) {
+            memory_region_del_eventfd(&n->iomem, 0x1000 + (sq->sqid << 3),
+                                      4, false, 0, &sq->notifier);
+            event_notifier_set_handler(&sq->notifier, NULL);
+        }
+        if (cq && cq->ioeventfd_enabled) {
+            memory_region_del_eventfd(&n->iomem,
+                                      0x1000 + (cq->cqid << 3) + (1 << 2),
+                                      4, false, 0, &cq->notifier);
+            event_notifier_set_handler(&cq->notifier, NULL);
+        }
+    }
+    memory_region_transaction_commit();
+
+    for (i = 0; i < n->params.max_ioqpairs + 1; i++) {
+        NvmeSQueue *sq = n->sq[i];
+        NvmeCQueue *cq = n->cq[i];
+
+        if (sq && sq->ioeventfd_enabled) {
+            event_notifier_cleanup(&sq->notifier);
+            sq->ioeventfd_enabled = false;
+        }
+        if (cq && cq->ioeventfd_enabled) {
+            event_notifier_cleanup(&cq->notifier);
+            cq->ioeventfd_enabled = false;
+        }
+    }
+
     for (i = 0; i < n->params.max_ioqpairs + 1; i++) {
         if (n->sq[i] != NULL) {
             nvme_free_sq(n->sq[i], n);
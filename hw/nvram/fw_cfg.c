@@ -356,6 +356,8 @@ static void fw_cfg_dma_transfer(FWCfgState *s)
     dma.length = be32_to_cpu(dma.length);
     dma.control = be32_to_cpu(dma.control);
 
+    trace_fw_cfg_dma_transfer(s, dma.address, dma.length, dma.control);
+
     if (dma.control & FW_CFG_DMA_CTL_SELECT) {
         fw_cfg_select(s, dma.control >> 16);
     }
@@ -17,6 +17,9 @@
 #include "sysemu/dma.h"
 #include "qemu/cutils.h"
 
+/* how many serviced requests each device keeps around for reuse */
+#define SCSI_REQUEST_POOL_SIZE 16
+
 static char *scsibus_get_dev_path(DeviceState *dev);
 static char *scsibus_get_fw_dev_path(DeviceState *dev);
 static void scsi_req_dequeue(SCSIRequest *req);
@@ -350,6 +353,7 @@ static void scsi_qdev_realize(DeviceState *qdev, Error **errp)
     }
 
     QTAILQ_INIT(&dev->requests);
+    QSLIST_INIT(&dev->free_requests);
     scsi_device_realize(dev, &local_err);
     if (local_err) {
         error_propagate(errp, local_err);
@@ -359,6 +363,17 @@ static void scsi_qdev_realize(DeviceState *qdev, Error **errp)
             scsi_dma_restart_cb, dev);
 }
 
+static void scsi_device_free_request_pool(SCSIDevice *dev)
+{
+    SCSIRequest *req;
+
+    while ((req = QSLIST_FIRST(&dev->free_requests)) != NULL) {
+        QSLIST_REMOVE_HEAD(&dev->free_requests, next_free);
+        g_free(req);
+    }
+    dev->nr_free_requests = 0;
+}
+
 static void scsi_qdev_unrealize(DeviceState *qdev)
 {
     SCSIDevice *dev = SCSI_DEVICE(qdev);
@@ -371,6 +386,8 @@ static void scsi_qdev_unrealize(DeviceState *qdev)
 
     scsi_device_unrealize(dev);
 
+    scsi_device_free_request_pool(dev);
+
     blockdev_mark_auto_del(dev->conf.blk);
 }
 
@@ -781,7 +798,23 @@ SCSIRequest *scsi_req_alloc(const SCSIReqOps *reqops, SCSIDevice *d,
     const int memset_off = offsetof(SCSIRequest, sense)
                            + sizeof(req->sense);
 
-    req = g_malloc(reqops->size);
+    /*
+     * Reuse a serviced request if one is pooled; a recycled request
+     * carries no more state than a fresh g_malloc, since everything up
+     * to sense is initialized below or by the caller and everything
+     * after it is zeroed either way.
+     */
+    req = QSLIST_FIRST(&d->free_requests);
+    if (req) {
+        QSLIST_REMOVE_HEAD(&d->free_requests, next_free);
+        d->nr_free_requests--;
+        if (req->ops->size != reqops->size) {
+            g_free(req);
+            req = g_malloc(reqops->size);
+        }
+    } else {
+        req = g_malloc(reqops->size);
+    }
     memset((uint8_t *)req + memset_off, 0, reqops->size - memset_off);
     req->refcount = 1;
     req->bus = bus;
@@ -1453,7 +1486,8 @@ void scsi_req_unref(SCSIRequest *req)
 {
     assert(req->refcount > 0);
     if (--req->refcount == 0) {
-        BusState *qbus = req->dev->qdev.parent_bus;
+        SCSIDevice *d = req->dev;
+        BusState *qbus = d->qdev.parent_bus;
         SCSIBus *bus = DO_UPCAST(SCSIBus, qbus, qbus);
 
         if (bus->info->free_request && req->hba_private) {
@@ -1462,9 +1496,21 @@ void scsi_req_unref(SCSIRequest *req)
         if (req->ops->free_req) {
             req->ops->free_req(req);
         }
-        object_unref(OBJECT(req->dev));
+        /*
+         * Keep the memory around for the next request on this device.
+         * The pool holds no reference on the device; unrealize clears
+         * the realized flag before draining it, so nothing is pooled
+         * once the device is going away.
+         */
+        if (d->qdev.realized &&
+            d->nr_free_requests < SCSI_REQUEST_POOL_SIZE) {
+            QSLIST_INSERT_HEAD(&d->free_requests, req, next_free);
+            d->nr_free_requests++;
+        } else {
+            g_free(req);
+        }
+        object_unref(OBJECT(d));
         object_unref(OBJECT(qbus->parent));
-        g_free(req);
     }
 }
 
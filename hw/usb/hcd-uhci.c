@@ -387,6 +387,9 @@ static void uhci_port_write(void *opaque, hwaddr addr,
 
     trace_usb_uhci_mmio_writew(addr, val);
 
+    /* The guest is talking to us, poll the schedule at full rate again */
+    s->idle_stepdown = 0;
+
     switch(addr) {
     case 0x00:
         if ((val & UHCI_CMD_RS) && !(s->cmd & UHCI_CMD_RS)) {
@@ -878,6 +881,12 @@ static void uhci_async_complete(USBPort *port, USBPacket *packet)
     /* Force processing of this packet *now*, needed for migration */
     s->completions_only = true;
     qemu_bh_schedule(s->bh);
+
+    /* Make sure the completion interrupt goes out within a frame time */
+    s->idle_stepdown = 0;
+    timer_mod_anticipate(s->frame_timer,
+                         qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL) +
+                         NANOSECONDS_PER_SECOND / FRAME_TIMER_FREQ);
 }
 
 static int is_valid(uint32_t link)
@@ -949,7 +958,8 @@ static void uhci_queue_fill(UHCIQueue *q, UHCI_TD *td)
     usb_device_flush_ep_queue(q->ep->dev, q->ep);
 }
 
-static void uhci_process_frame(UHCIState *s)
+/* Returns the number of TDs completed, so idle schedules can be detected */
+static int uhci_process_frame(UHCIState *s)
 {
     uint32_t frame_addr, link, old_td_ctrl, val, int_mask;
     uint32_t curr_qh, td_count = 0;
@@ -1070,6 +1080,7 @@ static void uhci_process_frame(UHCIState *s)
 
 out:
     s->pending_int_mask |= int_mask;
+    return td_count;
 }
 
 static void uhci_bh(void *opaque)
@@ -1082,7 +1093,7 @@ static void uhci_frame_timer(void *opaque)
 {
     UHCIState *s = opaque;
     uint64_t t_now, t_last_run;
-    int i, frames;
+    int i, frames, td_count = 0;
     const uint64_t frame_t = NANOSECONDS_PER_SECOND / FRAME_TIMER_FREQ;
 
     s->completions_only = false;
@@ -1118,7 +1129,7 @@ static void uhci_frame_timer(void *opaque)
         s->frame_bytes = 0;
         trace_usb_uhci_frame_start(s->frnum);
         uhci_async_validate_begin(s);
-        uhci_process_frame(s);
+        td_count += uhci_process_frame(s);
         uhci_async_validate_end(s);
         /* The spec says frnum is the frame currently being processed, and
          * the guest must look at frnum - 1 on interrupt, so inc frnum now */
@@ -1132,9 +1143,24 @@ static void uhci_frame_timer(void *opaque)
         s->status  |= UHCI_STS_USBINT;
         uhci_update_irq(s);
     }
+
+    /*
+     * UHCI has no doorbell, so the schedule must be polled. But when
+     * walking it does no work we can poll less often, processing the
+     * skipped frames in a batch on the next run. New TDs queued while
+     * stepped down wait for that run; completions of packets already in
+     * flight re-arm the timer from uhci_async_complete() and register
+     * accesses reset the step-down, so only a cold submission pays the
+     * extra latency.
+     */
+    if (td_count || s->pending_int_mask) {
+        s->idle_stepdown = 0;
+    } else if (s->idle_stepdown < MAX_FRAMES_PER_TICK - 1) {
+        s->idle_stepdown++;
+    }
     s->pending_int_mask = 0;
 
-    timer_mod(s->frame_timer, t_now + frame_t);
+    timer_mod(s->frame_timer, t_now + frame_t * (s->idle_stepdown + 1));
 }
 
 static const MemoryRegionOps uhci_ioport_ops = {
@@ -58,6 +58,8 @@ typedef struct UHCIState {
     QEMUBH *bh;
     uint32_t frame_bytes;
     uint32_t frame_bandwidth;
+    /* Extra frames the timer sleeps while the schedule is idle */
+    uint32_t idle_stepdown;
     bool completions_only;
     UHCIPort ports[UHCI_PORTS];
     qemu_irq irq;
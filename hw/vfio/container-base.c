@@ -13,16 +13,24 @@
 #include "qemu/osdep.h"
 #include "qapi/error.h"
 #include "qemu/error-report.h"
+#include "qemu/timer.h"
 #include "hw/vfio/vfio-container-base.h"
+#include "trace.h"
 
 int vfio_container_dma_map(VFIOContainerBase *bcontainer,
                            hwaddr iova, ram_addr_t size,
                            void *vaddr, bool readonly)
 {
     VFIOIOMMUClass *vioc = VFIO_IOMMU_GET_CLASS(bcontainer);
+    int64_t start_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+    int ret;
 
     g_assert(vioc->dma_map);
-    return vioc->dma_map(bcontainer, iova, size, vaddr, readonly);
+    ret = vioc->dma_map(bcontainer, iova, size, vaddr, readonly);
+    trace_vfio_container_dma_map(iova, size,
+                                 qemu_clock_get_ns(QEMU_CLOCK_REALTIME) -
+                                 start_ns, ret);
+    return ret;
 }
 
 int vfio_container_dma_unmap(VFIOContainerBase *bcontainer,
@@ -30,9 +38,15 @@ int vfio_container_dma_unmap(VFIOContainerBase *bcontainer,
                              IOMMUTLBEntry *iotlb)
 {
     VFIOIOMMUClass *vioc = VFIO_IOMMU_GET_CLASS(bcontainer);
+    int64_t start_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+    int ret;
 
     g_assert(vioc->dma_unmap);
-    return vioc->dma_unmap(bcontainer, iova, size, iotlb);
+    ret = vioc->dma_unmap(bcontainer, iova, size, iotlb);
+    trace_vfio_container_dma_unmap(iova, size,
+                                   qemu_clock_get_ns(QEMU_CLOCK_REALTIME) -
+                                   start_ns, ret);
+    return ret;
 }
 
 bool vfio_container_add_section_window(VFIOContainerBase *bcontainer,
@@ -458,13 +458,21 @@ static int vfio_save_setup(QEMUFile *f, void *opaque, Error **errp)
     VFIODevice *vbasedev = opaque;
     VFIOMigration *migration = vbasedev->migration;
     uint64_t stop_copy_size = VFIO_MIG_DEFAULT_DATA_BUFFER_SIZE;
+    uint64_t data_buffer_size;
     int ret;
 
     qemu_put_be64(f, VFIO_MIG_FLAG_DEV_SETUP_STATE);
 
+    /*
+     * The default buffer size was tuned on devices with 100s of MB of
+     * state; devices carrying 10s of GB may amortize the read/write round
+     * trips better with a larger one, so let the user override it.
+     */
+    data_buffer_size = vbasedev->migration_data_buffer_size ?:
+                       VFIO_MIG_DEFAULT_DATA_BUFFER_SIZE;
+
     vfio_query_stop_copy_size(vbasedev, &stop_copy_size);
-    migration->data_buffer_size = MIN(VFIO_MIG_DEFAULT_DATA_BUFFER_SIZE,
-                                      stop_copy_size);
+    migration->data_buffer_size = MIN(data_buffer_size, stop_copy_size);
     migration->data_buffer = g_try_malloc0(migration->data_buffer_size);
     if (!migration->data_buffer) {
         error_setg(errp, "%s: Failed to allocate migration data buffer",
@@ -28,6 +28,9 @@ struct VhostIOVATree {
 
     /* IOVA address to qemu memory maps. */
     IOVATree *iova_taddr_map;
+
+    /* Bumped on every modification, so lookup caches can be invalidated */
+    uint32_t generation;
 };
 
 /**
@@ -44,9 +47,20 @@ VhostIOVATree *vhost_iova_tree_new(hwaddr iova_first, hwaddr iova_last)
     tree->iova_last = iova_last;
 
     tree->iova_taddr_map = iova_tree_new();
+    tree->generation = 0;
     return tree;
 }
 
+/**
+ * Return the generation of the tree, incremented on every modification
+ *
+ * @tree: The iova tree
+ */
+uint32_t vhost_iova_tree_generation(const VhostIOVATree *tree)
+{
+    return tree->generation;
+}
+
 /**
  * Delete an iova tree
  */
@@ -87,6 +101,7 @@ int vhost_iova_tree_map_alloc(VhostIOVATree *tree, DMAMap *map)
 {
     /* Some vhost devices do not like addr 0. Skip first page */
     hwaddr iova_first = tree->iova_first ?: qemu_real_host_page_size();
+    int r;
 
     if (map->translated_addr + map->size < map->translated_addr ||
         map->perm == IOMMU_NONE) {
@@ -94,8 +109,12 @@ int vhost_iova_tree_map_alloc(VhostIOVATree *tree, DMAMap *map)
     }
 
     /* Allocate a node in IOVA address */
-    return iova_tree_alloc_map(tree->iova_taddr_map, map, iova_first,
-                               tree->iova_last);
+    r = iova_tree_alloc_map(tree->iova_taddr_map, map, iova_first,
+                            tree->iova_last);
+    if (r == IOVA_OK) {
+        tree->generation++;
+    }
+    return r;
 }
 
 /**
@@ -107,4 +126,5 @@ int vhost_iova_tree_map_alloc(VhostIOVATree *tree, DMAMap *map)
 void vhost_iova_tree_remove(VhostIOVATree *iova_tree, DMAMap map)
 {
     iova_tree_remove(iova_tree->iova_taddr_map, map);
+    iova_tree->generation++;
 }
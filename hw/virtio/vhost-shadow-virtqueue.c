@@ -71,6 +71,50 @@ uint16_t vhost_svq_available_slots(const VhostShadowVirtqueue *svq)
     return svq->num_free;
 }
 
+/**
+ * Look up the IOVA mapping containing a translated address, going through
+ * the per-queue translation cache before falling back to the IOVA tree.
+ * The cache is dropped whenever the tree generation changes, i.e. when the
+ * memory listener has added or removed mappings.
+ *
+ * @svq: Shadow VirtQueue
+ * @needle: The map with the translated address to look up
+ */
+static const DMAMap *vhost_svq_find_iova(VhostShadowVirtqueue *svq,
+                                         const DMAMap *needle)
+{
+    uint32_t gen = vhost_iova_tree_generation(svq->iova_tree);
+    const DMAMap *map;
+
+    if (gen != svq->trans_cache_gen) {
+        svq->trans_cache_num = 0;
+        svq->trans_cache_next = 0;
+        svq->trans_cache_gen = gen;
+    }
+
+    for (unsigned int i = 0; i < svq->trans_cache_num; ++i) {
+        const DMAMap *cached = &svq->trans_cache[i];
+
+        if (needle->translated_addr >= cached->translated_addr &&
+            needle->translated_addr - cached->translated_addr <=
+            cached->size) {
+            return cached;
+        }
+    }
+
+    map = vhost_iova_tree_find_iova(svq->iova_tree, needle);
+    if (map) {
+        svq->trans_cache[svq->trans_cache_next] = *map;
+        map = &svq->trans_cache[svq->trans_cache_next];
+        svq->trans_cache_next = (svq->trans_cache_next + 1) %
+                                ARRAY_SIZE(svq->trans_cache);
+        if (svq->trans_cache_num < ARRAY_SIZE(svq->trans_cache)) {
+            svq->trans_cache_num++;
+        }
+    }
+    return map;
+}
+
 /**
  * Translate addresses between the qemu's virtual address and the SVQ IOVA
  *
@@ -79,7 +123,7 @@ uint16_t vhost_svq_available_slots(const VhostShadowVirtqueue *svq)
  * @iovec: Source qemu's VA addresses
  * @num: Length of iovec and minimum length of vaddr
  */
-static bool vhost_svq_translate_addr(const VhostShadowVirtqueue *svq,
+static bool vhost_svq_translate_addr(VhostShadowVirtqueue *svq,
                                      hwaddr *addrs, const struct iovec *iovec,
                                      size_t num)
 {
@@ -95,7 +139,7 @@ static bool vhost_svq_translate_addr(const VhostShadowVirtqueue *svq,
         Int128 needle_last, map_last;
         size_t off;
 
-        const DMAMap *map = vhost_iova_tree_find_iova(svq->iova_tree, &needle);
+        const DMAMap *map = vhost_svq_find_iova(svq, &needle);
         /*
          * Map cannot be NULL since iova map contains all guest space and
          * qemu already has a physical address mapped
@@ -670,6 +714,11 @@ void vhost_svq_start(VhostShadowVirtqueue *svq, VirtIODevice *vdev,
     svq->vq = vq;
     svq->iova_tree = iova_tree;
 
+    /* The tree may have changed, do not trust cached translations */
+    svq->trans_cache_num = 0;
+    svq->trans_cache_next = 0;
+    svq->trans_cache_gen = vhost_iova_tree_generation(iova_tree);
+
     svq->vring.num = virtio_queue_get_num(vdev, virtio_get_queue_index(vq));
     svq->num_free = svq->vring.num;
     svq->vring.desc = mmap(NULL, vhost_svq_driver_area_size(svq),
@@ -78,6 +78,17 @@ typedef struct VhostShadowVirtqueue {
     /* IOVA mapping */
     VhostIOVATree *iova_tree;
 
+    /*
+     * Cache of recently used translations. Guest buffers come from few
+     * memory regions, so the common lookup is resolved here with a couple
+     * of compares instead of walking the IOVA tree for every descriptor.
+     * Entries are dropped when the tree generation changes.
+     */
+    DMAMap trans_cache[4];
+    unsigned int trans_cache_num;
+    unsigned int trans_cache_next;
+    uint32_t trans_cache_gen;
+
     /* SVQ vring descriptors state */
     SVQDescState *desc_state;
 
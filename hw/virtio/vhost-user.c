@@ -719,6 +719,7 @@ static int send_add_regions(struct vhost_dev *dev,
 {
     struct vhost_user *u = dev->opaque;
     int i, fd, ret, reg_idx, reg_fd_idx;
+    int pending_acks = 0;
     struct vhost_memory_region *reg;
     MemoryRegion *mr;
     ram_addr_t offset;
@@ -796,10 +797,16 @@ static int send_add_regions(struct vhost_dev *dev,
                     return -EPROTO;
                 }
             } else if (reply_supported) {
-                ret = process_message_reply(dev, msg);
-                if (ret) {
-                    return ret;
-                }
+                /*
+                 * The acks are collected after the loop: they arrive in
+                 * order, so mapping N new regions costs one socket round
+                 * trip rather than one per region.  This matters most on
+                 * backend reconnect, when the whole memory table is
+                 * resent.  A failed ack aborts device setup wholesale,
+                 * so the optimistic shadow update below is never
+                 * consumed in that case.
+                 */
+                pending_acks++;
             }
         } else if (track_ramblocks) {
             u->region_rb_offset[reg_idx] = 0;
@@ -821,6 +828,14 @@ static int send_add_regions(struct vhost_dev *dev,
         u->num_shadow_regions++;
     }
 
+    while (pending_acks) {
+        ret = process_message_reply(dev, msg);
+        if (ret) {
+            return ret;
+        }
+        pending_acks--;
+    }
+
     return 0;
 }
 
@@ -1033,6 +1048,13 @@ static int vhost_user_set_mem_table(struct vhost_dev *dev,
     }
 
     if (config_mem_slots) {
+        /*
+         * Only transfer the regions that actually changed against the
+         * shadow table via ADD/REM_MEM_REG, so a virtio-mem resize or
+         * DIMM hotplug does not make the backend re-mmap the regions it
+         * already has.  The full SET_MEM_TABLE below is only for
+         * backends without VHOST_USER_PROTOCOL_F_CONFIGURE_MEM_SLOTS.
+         */
         ret = vhost_user_add_remove_regions(dev, &msg, reply_supported, false);
         if (ret < 0) {
             return ret;
@@ -1216,40 +1238,78 @@ static int vhost_user_set_vring_base(struct vhost_dev *dev,
 
 static int vhost_user_set_vring_enable(struct vhost_dev *dev, int enable)
 {
-    int i;
+    bool reply_supported = virtio_has_feature(dev->protocol_features,
+                                              VHOST_USER_PROTOCOL_F_REPLY_ACK);
+    int i, ret;
 
     if (!virtio_has_feature(dev->features, VHOST_USER_F_PROTOCOL_FEATURES)) {
         return -EINVAL;
     }
 
+    /*
+     * SET_VRING_ENABLE travels from guest to QEMU to vhost-user backend /
+     * control plane thread via unix domain socket. Virtio requests travel
+     * from guest to vhost-user backend / data plane thread via eventfd.
+     * Even if the guest enables the ring first, and pushes its first virtio
+     * request second (conforming to the virtio spec), the data plane thread
+     * in the backend may see the virtio request before the control plane
+     * thread sees the queue enablement. This causes (in fact, requires) the
+     * data plane thread to discard the virtio request (it arrived on a
+     * seemingly disabled queue). To prevent this out-of-order delivery,
+     * don't let the guest proceed to pushing virtio requests until the
+     * backend control plane has acknowledged enabling the queues.
+     *
+     * The acknowledgements are pipelined: all SET_VRING_ENABLE messages
+     * are written before the in-order replies are collected, so enabling
+     * many rings costs one socket round trip rather than one per ring.
+     * This keeps multi-queue backend reconnects fast.
+     */
     for (i = 0; i < dev->nvqs; ++i) {
-        int ret;
-        struct vhost_vring_state state = {
-            .index = dev->vq_index + i,
-            .num   = enable,
+        VhostUserMsg msg = {
+            .hdr.request = VHOST_USER_SET_VRING_ENABLE,
+            .hdr.flags = VHOST_USER_VERSION,
+            .payload.state.index = dev->vq_index + i,
+            .payload.state.num = enable,
+            .hdr.size = sizeof(msg.payload.state),
         };
 
+        if (reply_supported) {
+            msg.hdr.flags |= VHOST_USER_NEED_REPLY_MASK;
+        }
+
+        ret = vhost_user_write(dev, &msg, NULL, 0);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    if (reply_supported) {
+        const VhostUserMsg msg_template = {
+            .hdr.request = VHOST_USER_SET_VRING_ENABLE,
+            .hdr.flags = VHOST_USER_VERSION | VHOST_USER_NEED_REPLY_MASK,
+        };
+
+        for (i = 0; i < dev->nvqs; ++i) {
+            ret = process_message_reply(dev, &msg_template);
+            if (ret < 0) {
+                /*
+                 * Restoring the previous state is likely infeasible, as
+                 * well as proceeding regardless the error, so just bail
+                 * out and hope for the device-level recovery.
+                 */
+                return ret;
+            }
+        }
+    } else {
         /*
-         * SET_VRING_ENABLE travels from guest to QEMU to vhost-user backend /
-         * control plane thread via unix domain socket. Virtio requests travel
-         * from guest to vhost-user backend / data plane thread via eventfd.
-         * Even if the guest enables the ring first, and pushes its first virtio
-         * request second (conforming to the virtio spec), the data plane thread
-         * in the backend may see the virtio request before the control plane
-         * thread sees the queue enablement. This causes (in fact, requires) the
-         * data plane thread to discard the virtio request (it arrived on a
-         * seemingly disabled queue). To prevent this out-of-order delivery,
-         * don't let the guest proceed to pushing the virtio request until the
-         * backend control plane acknowledges enabling the queue -- IOW, pass
-         * wait_for_reply=true below.
+         * The backend cannot acknowledge individual messages; since it
+         * must process them in order, one GET_FEATURES round trip
+         * confirms that every queue enablement has been seen.
          */
-        ret = vhost_set_vring(dev, VHOST_USER_SET_VRING_ENABLE, &state, true);
+        uint64_t dummy;
+
+        ret = vhost_user_get_features(dev, &dummy);
         if (ret < 0) {
-            /*
-             * Restoring the previous state is likely infeasible, as well as
-             * proceeding regardless the error, so just bail out and hope for
-             * the device-level recovery.
-             */
             return ret;
         }
     }
@@ -648,17 +648,14 @@ virtio_balloon_free_page_hint_notify(NotifierWithReturn *n, void *data,
     }
 
     /*
-     * Pages hinted via qemu_guest_free_page_hint() are cleared from the dirty
-     * bitmap and will not get migrated, especially also not when the postcopy
-     * destination starts using them and requests migration from the source; the
-     * faulting thread will stall until postcopy migration finishes and
-     * all threads are woken up. Let's not start free page hinting if postcopy
-     * is possible.
+     * Pages hinted via qemu_guest_free_page_hint() are dropped from the
+     * dirty bitmap but remembered in RAMBlock.hint_bmap, so when the
+     * postcopy destination starts using one of them the source re-dirties
+     * and sends it in response to the page request (see
+     * ram_save_queue_pages()) instead of leaving the fault unanswered.
+     * Hinting is therefore safe to run even when postcopy is possible;
+     * hints are ignored once postcopy has actually started.
      */
-    if (migrate_postcopy_ram()) {
-        return 0;
-    }
-
     switch (pnd->reason) {
     case PRECOPY_NOTIFY_BEFORE_BITMAP_SYNC:
         virtio_balloon_free_page_stop(dev);
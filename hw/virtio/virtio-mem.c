@@ -458,14 +458,13 @@ static void virtio_mem_set_range_unplugged(VirtIOMEM *vmem, uint64_t start_gpa,
 static void virtio_mem_send_response(VirtIOMEM *vmem, VirtQueueElement *elem,
                                      struct virtio_mem_resp *resp)
 {
-    VirtIODevice *vdev = VIRTIO_DEVICE(vmem);
     VirtQueue *vq = vmem->vq;
 
     trace_virtio_mem_send_response(le16_to_cpu(resp->type));
     iov_from_buf(elem->in_sg, elem->in_num, 0, resp, sizeof(*resp));
 
+    /* The caller notifies the guest once the queue has been drained. */
     virtqueue_push(vq, elem, sizeof(*resp));
-    virtio_notify(vdev, vq);
 }
 
 static void virtio_mem_send_response_simple(VirtIOMEM *vmem,
@@ -583,6 +582,17 @@ static void virtio_mem_deactivate_unplugged_memslots(VirtIOMEM *vmem,
     memory_region_transaction_commit();
 }
 
+static int virtio_mem_prealloc_threads(void)
+{
+    /*
+     * Mirror the memory backend default; qemu_prealloc_mem() scales the
+     * actual thread count down for small ranges, so plugging individual
+     * blocks stays single-threaded while preallocating the whole plugged
+     * region on incoming migration is spread over the host.
+     */
+    return current_machine ? current_machine->smp.cpus : 1;
+}
+
 static int virtio_mem_set_block_state(VirtIOMEM *vmem, uint64_t start_gpa,
                                       uint64_t size, bool plug)
 {
@@ -612,7 +622,8 @@ static int virtio_mem_set_block_state(VirtIOMEM *vmem, uint64_t start_gpa,
         int fd = memory_region_get_fd(&vmem->memdev->mr);
         Error *local_err = NULL;
 
-        if (!qemu_prealloc_mem(fd, area, size, 1, NULL, false, &local_err)) {
+        if (!qemu_prealloc_mem(fd, area, size, virtio_mem_prealloc_threads(),
+                               NULL, false, &local_err)) {
             static bool warned;
 
             /*
@@ -811,10 +822,12 @@ static void virtio_mem_handle_request(VirtIODevice *vdev, VirtQueue *vq)
     struct virtio_mem_req req;
     uint16_t type;
 
+    bool responded = false;
+
     while (true) {
         elem = virtqueue_pop(vq, sizeof(VirtQueueElement));
         if (!elem) {
-            return;
+            break;
         }
 
         if (iov_to_buf(elem->out_sg, elem->out_num, 0, &req, len) < len) {
@@ -857,8 +870,14 @@ static void virtio_mem_handle_request(VirtIODevice *vdev, VirtQueue *vq)
             return;
         }
 
+        responded = true;
         g_free(elem);
     }
+
+    /* Notify the guest once for all responses pushed above. */
+    if (responded) {
+        virtio_notify(vdev, vq);
+    }
 }
 
 static void virtio_mem_get_config(VirtIODevice *vdev, uint8_t *config_data)
@@ -1246,7 +1265,8 @@ static int virtio_mem_prealloc_range_cb(VirtIOMEM *vmem, void *arg,
     int fd = memory_region_get_fd(&vmem->memdev->mr);
     Error *local_err = NULL;
 
-    if (!qemu_prealloc_mem(fd, area, size, 1, NULL, false, &local_err)) {
+    if (!qemu_prealloc_mem(fd, area, size, virtio_mem_prealloc_threads(),
+                           NULL, false, &local_err)) {
         error_report_err(local_err);
         return -ENOMEM;
     }
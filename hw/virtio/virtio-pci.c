@@ -1001,7 +1001,10 @@ static int virtio_pci_one_vector_unmask(VirtIOPCIProxy *proxy,
             if (ret < 0) {
                 return ret;
             }
-            kvm_irqchip_commit_routes(kvm_state);
+            if (ret > 0) {
+                kvm_irqchip_commit_routes(kvm_state);
+            }
+            ret = 0;
         }
     }
 
@@ -17,6 +17,7 @@
 #include "qapi/qapi-commands-qom.h"
 #include "qapi/qmp/qobject.h"
 #include "qapi/qmp/qjson.h"
+#include "sysemu/iothread.h"
 #include "hw/virtio/vhost-user.h"
 
 #include "standard-headers/linux/virtio_ids.h"
@@ -838,3 +839,35 @@ VirtVhostQueueStatus *qmp_x_query_virtio_vhost_queue_status(const char *path,
 
     return status;
 }
+
+void qmp_x_virtio_set_vq_iothread(const char *path, uint16_t vq,
+                                  const char *iothread, Error **errp)
+{
+    VirtIODevice *vdev;
+    VirtioDeviceClass *vdc;
+    IOThread *target = NULL;
+
+    vdev = qmp_find_virtio_device(path);
+    if (vdev == NULL) {
+        error_setg(errp, "Path %s is not a realized VirtIODevice", path);
+        return;
+    }
+
+    vdc = VIRTIO_DEVICE_GET_CLASS(vdev);
+    if (!vdc->set_vq_iothread) {
+        error_setg(errp, "%s does not support moving virtqueues between "
+                   "IOThreads", vdev->name);
+        return;
+    }
+
+    if (iothread) {
+        target = iothread_by_id(iothread);
+        if (!target) {
+            error_setg(errp, "IOThread \"%s\" object does not exist",
+                       iothread);
+            return;
+        }
+    }
+
+    vdc->set_vq_iothread(vdev, vq, target, errp);
+}
@@ -0,0 +1,125 @@
+/*
+ * Virtio notification statistics
+ *
+ * Expose the per-device guest kick, interrupt and completed request
+ * counters kept by hw/virtio/virtio.c through the QMP query-stats
+ * command, so that the effectiveness of EVENT_IDX notification
+ * suppression (interrupts per request, kicks per request) can be
+ * monitored on a live guest.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or
+ * later.  See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/module.h"
+#include "hw/qdev-core.h"
+#include "hw/virtio/virtio.h"
+#include "sysemu/stats.h"
+
+#define VIRTIO_STAT_GUEST_KICKS "guest-notifications"
+#define VIRTIO_STAT_IRQS        "interrupts"
+#define VIRTIO_STAT_REQUESTS    "requests"
+
+static StatsList *virtio_stats_add(const char *name, uint64_t value,
+                                   strList *names, StatsList *stats_list)
+{
+    Stats *stats;
+
+    if (!apply_str_list_filter(name, names)) {
+        return stats_list;
+    }
+
+    stats = g_new0(Stats, 1);
+    stats->name = g_strdup(name);
+    stats->value = g_new0(StatsValue, 1);
+    stats->value->type = QTYPE_QNUM;
+    stats->value->u.scalar = value;
+
+    QAPI_LIST_PREPEND(stats_list, stats);
+    return stats_list;
+}
+
+typedef struct VirtioStatsArgs {
+    StatsResultList **result;
+    strList *names;
+} VirtioStatsArgs;
+
+static int virtio_stats_query_dev(Object *child, void *opaque)
+{
+    VirtioStatsArgs *args = opaque;
+    Object *dev = object_dynamic_cast(child, TYPE_VIRTIO_DEVICE);
+    StatsList *stats_list = NULL;
+    uint64_t kicks, irqs, used;
+    g_autofree char *path = NULL;
+
+    if (dev == NULL || !DEVICE(dev)->realized) {
+        return 0;
+    }
+
+    virtio_device_get_notification_stats(VIRTIO_DEVICE(dev),
+                                         &kicks, &irqs, &used);
+
+    stats_list = virtio_stats_add(VIRTIO_STAT_GUEST_KICKS, kicks,
+                                  args->names, stats_list);
+    stats_list = virtio_stats_add(VIRTIO_STAT_IRQS, irqs,
+                                  args->names, stats_list);
+    stats_list = virtio_stats_add(VIRTIO_STAT_REQUESTS, used,
+                                  args->names, stats_list);
+
+    if (!stats_list) {
+        return 0;
+    }
+
+    path = object_get_canonical_path(dev);
+    add_stats_entry(args->result, STATS_PROVIDER_VIRTIO, path, stats_list);
+    return 0;
+}
+
+static void virtio_stats_cb(StatsResultList **result, StatsTarget target,
+                            strList *names, strList *targets, Error **errp)
+{
+    VirtioStatsArgs args;
+
+    if (target != STATS_TARGET_VM) {
+        return;
+    }
+
+    args.result = result;
+    args.names = names;
+    object_child_foreach_recursive(object_get_root(),
+                                   virtio_stats_query_dev, &args);
+}
+
+static StatsSchemaValueList *virtio_schemas_add(const char *name,
+                                                StatsSchemaValueList *list)
+{
+    StatsSchemaValueList *schema_entry = g_new0(StatsSchemaValueList, 1);
+
+    schema_entry->value = g_new0(StatsSchemaValue, 1);
+    schema_entry->value->type = STATS_TYPE_CUMULATIVE;
+    schema_entry->value->name = g_strdup(name);
+    schema_entry->next = list;
+
+    return schema_entry;
+}
+
+static void virtio_schemas_cb(StatsSchemaList **result, Error **errp)
+{
+    StatsSchemaValueList *stats_list = NULL;
+
+    stats_list = virtio_schemas_add(VIRTIO_STAT_GUEST_KICKS, stats_list);
+    stats_list = virtio_schemas_add(VIRTIO_STAT_IRQS, stats_list);
+    stats_list = virtio_schemas_add(VIRTIO_STAT_REQUESTS, stats_list);
+
+    add_stats_schema(result, STATS_PROVIDER_VIRTIO, STATS_TARGET_VM,
+                     stats_list);
+}
+
+static void virtio_stats_register(void)
+{
+    add_stats_callbacks(STATS_PROVIDER_VIRTIO, virtio_stats_cb,
+                        virtio_schemas_cb);
+}
+
+type_init(virtio_stats_register);
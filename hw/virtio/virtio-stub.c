@@ -40,3 +40,9 @@ VirtioQueueElement *qmp_x_query_virtio_queue_element(const char *path,
 {
     return qmp_virtio_unsupported(errp);
 }
+
+void qmp_x_virtio_set_vq_iothread(const char *path, uint16_t vq,
+                                  const char *iothread, Error **errp)
+{
+    qmp_virtio_unsupported(errp);
+}
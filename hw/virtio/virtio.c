@@ -146,6 +146,15 @@ struct VirtQueue
 
     unsigned int inuse;
 
+    /* Free VirtQueueElement allocations kept for reuse by virtqueue_pop() */
+    VirtQueueElement *elem_cache[32];
+    unsigned int elem_cache_num;
+
+    /* Lifetime counters reported through query-stats */
+    uint64_t stat_kicks;
+    uint64_t stat_irqs;
+    uint64_t stat_used;
+
     uint16_t vector;
     VirtIOHandleOutput handle_output;
     VirtIODevice *vdev;
@@ -605,12 +614,14 @@ static void vring_packed_desc_read(VirtIODevice *vdev,
         smp_rmb();
     }
 
+    /*
+     * addr, len and id are contiguous in the descriptor, both in guest
+     * memory and in VRingPackedDesc, so fetch them with a single cached
+     * read instead of one per field.  flags has already been read above
+     * and must not be refetched.
+     */
     address_space_read_cached(cache, off + offsetof(VRingPackedDesc, addr),
-                              &desc->addr, sizeof(desc->addr));
-    address_space_read_cached(cache, off + offsetof(VRingPackedDesc, id),
-                              &desc->id, sizeof(desc->id));
-    address_space_read_cached(cache, off + offsetof(VRingPackedDesc, len),
-                              &desc->len, sizeof(desc->len));
+                              desc, offsetof(VRingPackedDesc, flags));
     virtio_tswap64s(vdev, &desc->addr);
     virtio_tswap16s(vdev, &desc->id);
     virtio_tswap32s(vdev, &desc->len);
@@ -621,17 +632,16 @@ static void vring_packed_desc_write_data(VirtIODevice *vdev,
                                          MemoryRegionCache *cache,
                                          int i)
 {
-    hwaddr off_id = i * sizeof(VRingPackedDesc) +
-                    offsetof(VRingPackedDesc, id);
     hwaddr off_len = i * sizeof(VRingPackedDesc) +
                     offsetof(VRingPackedDesc, len);
+    size_t len = offsetof(VRingPackedDesc, flags) -
+                 offsetof(VRingPackedDesc, len);
 
     virtio_tswap32s(vdev, &desc->len);
     virtio_tswap16s(vdev, &desc->id);
-    address_space_write_cached(cache, off_id, &desc->id, sizeof(desc->id));
-    address_space_cache_invalidate(cache, off_id, sizeof(desc->id));
-    address_space_write_cached(cache, off_len, &desc->len, sizeof(desc->len));
-    address_space_cache_invalidate(cache, off_len, sizeof(desc->len));
+    /* len and id are adjacent: write both back with one access. */
+    address_space_write_cached(cache, off_len, &desc->len, len);
+    address_space_cache_invalidate(cache, off_len, len);
 }
 
 static void vring_packed_desc_write_flags(VirtIODevice *vdev,
@@ -932,6 +942,18 @@ static void virtqueue_ordered_fill(VirtQueue *vq, const VirtQueueElement *elem,
     unsigned int i, steps, max_steps;
 
     i = vq->used_idx % vq->vring.num;
+
+    /*
+     * A device completing buffers in the order it popped them fills the
+     * slot right at used_idx; take that fast path before setting up the
+     * search.
+     */
+    if (likely(vq->used_elems[i].index == elem->index)) {
+        vq->used_elems[i].len = len;
+        vq->used_elems[i].in_order_filled = true;
+        return;
+    }
+
     steps = 0;
     /*
      * We shouldn't need to increase 'i' by more than the distance
@@ -1151,6 +1173,8 @@ void virtqueue_flush(VirtQueue *vq, unsigned int count)
         return;
     }
 
+    vq->stat_used += count;
+
     if (virtio_vdev_has_feature(vq->vdev, VIRTIO_F_IN_ORDER)) {
         virtqueue_ordered_flush(vq);
     } else if (virtio_vdev_has_feature(vq->vdev, VIRTIO_F_RING_PACKED)) {
@@ -1648,18 +1672,43 @@ void virtqueue_map(VirtIODevice *vdev, VirtQueueElement *elem)
                                                                         false);
 }
 
-static void *virtqueue_alloc_element(size_t sz, unsigned out_num, unsigned in_num)
+/* Largest allocation worth keeping in a queue's element cache */
+#define VIRTQUEUE_ELEM_CACHE_MAX_BYTES 32768
+
+static void *virtqueue_alloc_element(VirtQueue *vq, size_t sz,
+                                     unsigned out_num, unsigned in_num)
 {
-    VirtQueueElement *elem;
+    VirtQueueElement *elem = NULL;
     size_t in_addr_ofs = QEMU_ALIGN_UP(sz, __alignof__(elem->in_addr[0]));
     size_t out_addr_ofs = in_addr_ofs + in_num * sizeof(elem->in_addr[0]);
     size_t out_addr_end = out_addr_ofs + out_num * sizeof(elem->out_addr[0]);
     size_t in_sg_ofs = QEMU_ALIGN_UP(out_addr_end, __alignof__(elem->in_sg[0]));
     size_t out_sg_ofs = in_sg_ofs + in_num * sizeof(elem->in_sg[0]);
     size_t out_sg_end = out_sg_ofs + out_num * sizeof(elem->out_sg[0]);
+    unsigned int i;
 
     assert(sz >= sizeof(VirtQueueElement));
-    elem = g_malloc(out_sg_end);
+
+    /* Prefer a recycled allocation that is large enough */
+    if (vq) {
+        for (i = 0; i < vq->elem_cache_num; i++) {
+            if (vq->elem_cache[i]->alloc_size >= out_sg_end) {
+                elem = vq->elem_cache[i];
+                vq->elem_cache[i] = vq->elem_cache[--vq->elem_cache_num];
+                break;
+            }
+        }
+    }
+    if (!elem) {
+        /*
+         * Round the allocation up so that elements with slightly
+         * different scatter/gather counts can share cache entries.
+         */
+        size_t alloc_size = ROUND_UP(out_sg_end, 512);
+
+        elem = g_malloc(alloc_size);
+        elem->alloc_size = alloc_size;
+    }
     trace_virtqueue_alloc_element(elem, sz, in_num, out_num);
     elem->out_num = out_num;
     elem->in_num = in_num;
@@ -1670,6 +1719,35 @@ static void *virtqueue_alloc_element(size_t sz, unsigned out_num, unsigned in_nu
     return elem;
 }
 
+/*
+ * Return an element popped from @vq to the queue's cache so the next
+ * virtqueue_pop() can reuse the allocation instead of hitting the
+ * allocator.  Callers must be done with the element (it has already
+ * been pushed or detached) and must run in the queue's AioContext,
+ * like virtqueue_pop() itself.  Elements that do not fit in the cache
+ * are simply freed, so this is always a valid replacement for
+ * g_free() on an element obtained from virtqueue_pop().
+ */
+void virtqueue_element_recycle(VirtQueue *vq, VirtQueueElement *elem)
+{
+    if (!elem) {
+        return;
+    }
+    if (vq->elem_cache_num == ARRAY_SIZE(vq->elem_cache) ||
+        elem->alloc_size > VIRTQUEUE_ELEM_CACHE_MAX_BYTES) {
+        g_free(elem);
+        return;
+    }
+    vq->elem_cache[vq->elem_cache_num++] = elem;
+}
+
+static void virtqueue_elem_cache_drop(VirtQueue *vq)
+{
+    while (vq->elem_cache_num > 0) {
+        g_free(vq->elem_cache[--vq->elem_cache_num]);
+    }
+}
+
 static void *virtqueue_split_pop(VirtQueue *vq, size_t sz)
 {
     unsigned int i, head, max, idx;
@@ -1710,7 +1788,17 @@ static void *virtqueue_split_pop(VirtQueue *vq, size_t sz)
     }
 
     if (virtio_vdev_has_feature(vdev, VIRTIO_RING_F_EVENT_IDX)) {
-        vring_set_avail_event(vq, vq->last_avail_idx);
+        /*
+         * Ask to be kicked only for buffers beyond what the guest had
+         * published when we last looked at the ring.  Everything up to
+         * shadow_avail_idx is consumed by the current processing loop
+         * before the device goes idle again, so a notification per
+         * buffer while we are draining would be pure overhead.  Once
+         * the loop observes an empty ring, shadow_avail_idx equals
+         * last_avail_idx and this degenerates to the conservative
+         * "kick on the next buffer" setting.
+         */
+        vring_set_avail_event(vq, vq->shadow_avail_idx);
     }
 
     i = head;
@@ -1784,7 +1872,7 @@ static void *virtqueue_split_pop(VirtQueue *vq, size_t sz)
     }
 
     /* Now copy what we have collected and mapped */
-    elem = virtqueue_alloc_element(sz, out_num, in_num);
+    elem = virtqueue_alloc_element(vq, sz, out_num, in_num);
     elem->index = head;
     elem->ndescs = 1;
     for (i = 0; i < out_num; i++) {
@@ -1924,7 +2012,7 @@ static void *virtqueue_packed_pop(VirtQueue *vq, size_t sz)
     }
 
     /* Now copy what we have collected and mapped */
-    elem = virtqueue_alloc_element(sz, out_num, in_num);
+    elem = virtqueue_alloc_element(vq, sz, out_num, in_num);
     for (i = 0; i < out_num; i++) {
         elem->out_addr[i] = addr[i];
         elem->out_sg[i] = iov[i];
@@ -2113,7 +2201,7 @@ void *qemu_get_virtqueue_element(VirtIODevice *vdev, QEMUFile *f, size_t sz)
     assert(ARRAY_SIZE(data.in_addr) >= data.in_num);
     assert(ARRAY_SIZE(data.out_addr) >= data.out_num);
 
-    elem = virtqueue_alloc_element(sz, data.out_num, data.in_num);
+    elem = virtqueue_alloc_element(NULL, sz, data.out_num, data.in_num);
     elem->index = data.index;
 
     for (i = 0; i < elem->in_num; i++) {
@@ -2281,6 +2369,7 @@ static void __virtio_queue_reset(VirtIODevice *vdev, uint32_t i)
     vdev->vq[i].notification = true;
     vdev->vq[i].vring.num = vdev->vq[i].vring.num_default;
     vdev->vq[i].inuse = 0;
+    virtqueue_elem_cache_drop(&vdev->vq[i]);
     virtio_virtqueue_reset_region_cache(&vdev->vq[i]);
 }
 
@@ -2481,6 +2570,7 @@ static void virtio_queue_notify_vq(VirtQueue *vq)
         }
 
         trace_virtio_queue_notify(vdev, vq - vdev->vq, vq);
+        vq->stat_kicks++;
         vq->handle_output(vdev, vq);
 
         if (unlikely(vdev->start_on_kick)) {
@@ -2499,8 +2589,10 @@ void virtio_queue_notify(VirtIODevice *vdev, int n)
 
     trace_virtio_queue_notify(vdev, vq - vdev->vq, vq);
     if (vq->host_notifier_enabled) {
+        /* Counted as a kick when the notifier handler runs */
         event_notifier_set(&vq->host_notifier);
     } else if (vq->handle_output) {
+        vq->stat_kicks++;
         vq->handle_output(vdev, vq);
 
         if (unlikely(vdev->start_on_kick)) {
@@ -2509,6 +2601,20 @@ void virtio_queue_notify(VirtIODevice *vdev, int n)
     }
 }
 
+void virtio_device_get_notification_stats(VirtIODevice *vdev,
+                                          uint64_t *kicks, uint64_t *irqs,
+                                          uint64_t *used)
+{
+    int i;
+
+    *kicks = *irqs = *used = 0;
+    for (i = 0; i < VIRTIO_QUEUE_MAX; i++) {
+        *kicks += vdev->vq[i].stat_kicks;
+        *irqs += vdev->vq[i].stat_irqs;
+        *used += vdev->vq[i].stat_used;
+    }
+}
+
 uint16_t virtio_queue_vector(VirtIODevice *vdev, int n)
 {
     return n < VIRTIO_QUEUE_MAX ? vdev->vq[n].vector :
@@ -2561,6 +2667,7 @@ void virtio_delete_queue(VirtQueue *vq)
     vq->handle_output = NULL;
     g_free(vq->used_elems);
     vq->used_elems = NULL;
+    virtqueue_elem_cache_drop(vq);
     virtio_virtqueue_reset_region_cache(vq);
 }
 
@@ -2681,6 +2788,7 @@ void virtio_notify_irqfd(VirtIODevice *vdev, VirtQueue *vq)
     }
 
     trace_virtio_notify_irqfd(vdev, vq);
+    vq->stat_irqs++;
 
     /*
      * virtio spec 1.0 says ISR bit 0 should be ignored with MSI, but
@@ -2707,6 +2815,15 @@ static void virtio_irq(VirtQueue *vq)
     virtio_notify_vector(vq->vdev, vq->vector);
 }
 
+/* Batch irqs while inside a defer_call_begin()/defer_call_end() section */
+static void virtio_notify_deferred_fn(void *opaque)
+{
+    VirtQueue *vq = opaque;
+
+    trace_virtio_notify_deferred_fn(vq->vdev, vq);
+    virtio_notify_vector(vq->vdev, vq->vector);
+}
+
 void virtio_notify(VirtIODevice *vdev, VirtQueue *vq)
 {
     WITH_RCU_READ_LOCK_GUARD() {
@@ -2716,7 +2833,9 @@ void virtio_notify(VirtIODevice *vdev, VirtQueue *vq)
     }
 
     trace_virtio_notify(vdev, vq);
-    virtio_irq(vq);
+    vq->stat_irqs++;
+    virtio_set_isr(vq->vdev, 0x1);
+    defer_call(virtio_notify_deferred_fn, vq);
 }
 
 void virtio_notify_config(VirtIODevice *vdev)
@@ -27,6 +27,8 @@
 
 #include "qemu/timed-average.h"
 #include "qemu/thread.h"
+#include "qemu/rcu.h"
+#include "qemu/stats64.h"
 #include "qapi/qapi-types-common.h"
 
 typedef struct BlockAcctTimedStats BlockAcctTimedStats;
@@ -50,6 +52,8 @@ struct BlockAcctTimedStats {
 };
 
 typedef struct BlockLatencyHistogram {
+    struct rcu_head rcu;
+
     /* The following histogram is represented like this:
      *
      * 5|           *
@@ -76,22 +80,30 @@ typedef struct BlockLatencyHistogram {
     int nbins;
     uint64_t *boundaries; /* @nbins-1 numbers here
                              (all boundaries, except 0 and +inf) */
-    uint64_t *bins;
+    Stat64 *bins;
 } BlockLatencyHistogram;
 
 struct BlockAcctStats {
+    /* Protects intervals; the plain counters are Stat64 and the latency
+     * histograms are RCU-managed, so both can be updated from any queue
+     * without taking it. */
     QemuMutex lock;
-    uint64_t nr_bytes[BLOCK_MAX_IOTYPE];
-    uint64_t nr_ops[BLOCK_MAX_IOTYPE];
-    uint64_t invalid_ops[BLOCK_MAX_IOTYPE];
-    uint64_t failed_ops[BLOCK_MAX_IOTYPE];
-    uint64_t total_time_ns[BLOCK_MAX_IOTYPE];
-    uint64_t merged[BLOCK_MAX_IOTYPE];
-    int64_t last_access_time_ns;
+    Stat64 nr_bytes[BLOCK_MAX_IOTYPE];
+    Stat64 nr_ops[BLOCK_MAX_IOTYPE];
+    Stat64 invalid_ops[BLOCK_MAX_IOTYPE];
+    Stat64 failed_ops[BLOCK_MAX_IOTYPE];
+    Stat64 total_time_ns[BLOCK_MAX_IOTYPE];
+    Stat64 merged[BLOCK_MAX_IOTYPE];
+    Stat64 last_access_time_ns;
     QSLIST_HEAD(, BlockAcctTimedStats) intervals;
     bool account_invalid;
     bool account_failed;
-    BlockLatencyHistogram latency_histogram[BLOCK_MAX_IOTYPE];
+    /*
+     * Written under the BQL by block_latency_histogram_set() and
+     * accessed with qatomic_rcu_read() from the I/O path.  NULL means
+     * no histogram is configured for that I/O type.
+     */
+    BlockLatencyHistogram *latency_histogram[BLOCK_MAX_IOTYPE];
 };
 
 typedef struct BlockAcctCookie {
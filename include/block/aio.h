@@ -183,6 +183,15 @@ struct AioContext {
     /* Chained BH list slices for each nested aio_bh_poll() call */
     QSIMPLEQ_HEAD(, BHListSlice) bh_slice_list;
 
+    /*
+     * Histogram of bottom half schedule-to-run latency.  Bucket i counts
+     * bottom halves that started running less than 2^i nanoseconds after
+     * they were scheduled.  Written by aio_bh_poll(), read racily by
+     * monitoring code.
+     */
+#define AIO_BH_LATENCY_BUCKETS 24
+    uint64_t bh_latency[AIO_BH_LATENCY_BUCKETS];
+
     /* Used by aio_notify.
      *
      * "notified" is used to avoid expensive event_notifier_test_and_clear
@@ -217,6 +226,8 @@ struct AioContext {
     /* State for file descriptor monitoring using Linux io_uring */
     struct io_uring fdmon_io_uring;
     AioHandlerSList submit_list;
+    /* Multishot poll support; cleared at runtime on older kernels */
+    bool fdmon_io_uring_multishot;
 #endif
 
     /* TimerLists for calling timers - one per clock type.  Has its own
@@ -704,6 +715,23 @@ void aio_context_set_poll_params(AioContext *ctx, int64_t max_ns,
                                  int64_t grow, int64_t shrink,
                                  Error **errp);
 
+typedef void AioPollHandlerStatsFn(int fd, int64_t poll_ns, uint64_t hits,
+                                   uint64_t calls, uint64_t dispatch_ns,
+                                   uint64_t dispatch_calls, void *opaque);
+
+/**
+ * aio_context_foreach_poll_stats:
+ * @ctx: the aio context
+ * @fn: called once per handler that participates in polling
+ * @opaque: user data for @fn
+ *
+ * Report per-handler polling and dispatch statistics.  May be called
+ * from any thread; the counters are read racily, which is acceptable
+ * for monitoring purposes.  No-op on hosts without userspace polling.
+ */
+void aio_context_foreach_poll_stats(AioContext *ctx, AioPollHandlerStatsFn *fn,
+                                    void *opaque);
+
 /**
  * aio_context_set_aio_params:
  * @ctx: the aio context
@@ -28,6 +28,7 @@
 #include "block/block-common.h"
 #include "block/block-global-state.h"
 #include "block/snapshot.h"
+#include "qemu/interval-tree.h"
 #include "qemu/iov.h"
 #include "qemu/rcu.h"
 #include "qemu/stats64.h"
@@ -83,7 +84,11 @@ typedef struct BdrvTrackedRequest {
     int64_t overlap_offset;
     int64_t overlap_bytes;
 
-    QLIST_ENTRY(BdrvTrackedRequest) list;
+    /*
+     * Position in bs->tracked_requests, keyed by the overlap range.
+     * Maintained by block/io.c under bs->reqs_lock.
+     */
+    IntervalTreeNode tree_node;
     Coroutine *co; /* owner, used for deadlock detection */
     CoQueue wait_queue; /* coroutines blocked on this request */
 
@@ -1237,7 +1242,7 @@ struct BlockDriverState {
 
     /* Protected by reqs_lock.  */
     QemuMutex reqs_lock;
-    QLIST_HEAD(, BdrvTrackedRequest) tracked_requests;
+    IntervalTreeRoot tracked_requests;
     CoQueue flush_queue;                  /* Serializing flush queue */
     bool active_flush_req;                /* Flush request in flight? */
 
@@ -44,6 +44,13 @@ void GRAPH_RDLOCK
 bdrv_query_block_graph_info(BlockDriverState *bs, BlockGraphInfo **p_info,
                             Error **errp);
 
+/*
+ * Main-loop variants of the query-block and query-blockstats handlers,
+ * for callers that do not run in coroutine context.
+ */
+BlockInfoList *bdrv_query_block_info_list(Error **errp);
+BlockStatsList *bdrv_query_blockstats_list(bool query_nodes);
+
 void bdrv_snapshot_dump(QEMUSnapshotInfo *sn);
 void bdrv_image_info_specific_dump(ImageInfoSpecific *info_spec,
                                    const char *prefix,
@@ -73,6 +73,12 @@ struct SocketChardev {
 
     bool is_websock;
 
+    /* Cached TLS resumption data, refreshed after each handshake */
+    uint8_t *tls_session_data;
+    size_t tls_session_data_len;
+    bool tls_in_handshake;
+    GSource *tls_defer_timer;
+
     GSource *reconnect_timer;
     int64_t reconnect_time;
     bool connect_err_reported;
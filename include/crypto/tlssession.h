@@ -238,6 +238,37 @@ ssize_t qcrypto_tls_session_write(QCryptoTLSSession *sess,
                                   size_t len,
                                   Error **errp);
 
+/**
+ * qcrypto_tls_session_cork:
+ * @sess: the TLS session object
+ *
+ * Start queuing plain text given to qcrypto_tls_session_write()
+ * instead of sending it immediately, so that several small
+ * writes are coalesced into full sized TLS records rather than
+ * producing one record per write. Nothing is sent to the peer
+ * until qcrypto_tls_session_uncork() is called.
+ */
+void qcrypto_tls_session_cork(QCryptoTLSSession *sess);
+
+/**
+ * qcrypto_tls_session_uncork:
+ * @sess: the TLS session object
+ * @errp: pointer to hold returned error object
+ *
+ * Encrypt the data queued since qcrypto_tls_session_cork() and
+ * send it to the remote peer. If the underlying data channel
+ * cannot accept all of it, the remainder stays queued in the
+ * session and this method must be called again, once the
+ * channel is ready for writing, before any further data is
+ * written to the session.
+ *
+ * Returns: 0 if all queued data was flushed,
+ * QCRYPTO_TLS_SESSION_ERR_BLOCK if some data remains queued,
+ * or -1 on error.
+ */
+int qcrypto_tls_session_uncork(QCryptoTLSSession *sess,
+                               Error **errp);
+
 /**
  * qcrypto_tls_session_read:
  * @sess: the TLS session object
@@ -353,4 +384,58 @@ int qcrypto_tls_session_get_key_size(QCryptoTLSSession *sess,
  */
 char *qcrypto_tls_session_get_peer_name(QCryptoTLSSession *sess);
 
+/**
+ * qcrypto_tls_session_get_session_data:
+ * @sess: the TLS session object
+ * @data: pointer to be filled with the resumption data
+ * @len: pointer to be filled with the length of @data
+ * @errp: pointer to a NULL-initialized error object
+ *
+ * Fetch the data needed to resume this session later,
+ * typically a session ticket issued by the server. Only
+ * valid on the client side of a completed handshake, and
+ * may fail transiently if the server has not yet sent a
+ * ticket.
+ *
+ * The returned data must be released with g_free()
+ * when no longer required.
+ *
+ * Returns: 0 on success, -1 on error
+ */
+int qcrypto_tls_session_get_session_data(QCryptoTLSSession *sess,
+                                         uint8_t **data,
+                                         size_t *len,
+                                         Error **errp);
+
+/**
+ * qcrypto_tls_session_set_session_data:
+ * @sess: the TLS session object
+ * @data: resumption data from an earlier session
+ * @len: length of @data
+ * @errp: pointer to a NULL-initialized error object
+ *
+ * Request resumption of an earlier session, using data
+ * previously obtained with qcrypto_tls_session_get_session_data().
+ * Must be called on a client session before the handshake is
+ * started. If the server rejects the stale ticket the handshake
+ * transparently falls back to a full key exchange.
+ *
+ * Returns: 0 on success, -1 on error
+ */
+int qcrypto_tls_session_set_session_data(QCryptoTLSSession *sess,
+                                         const uint8_t *data,
+                                         size_t len,
+                                         Error **errp);
+
+/**
+ * qcrypto_tls_session_resumed:
+ * @sess: the TLS session object
+ *
+ * Check whether the completed handshake resumed an earlier
+ * session rather than negotiating from scratch.
+ *
+ * Returns: true if the session was resumed
+ */
+bool qcrypto_tls_session_resumed(QCryptoTLSSession *sess);
+
 #endif /* QCRYPTO_TLSSESSION_H */
@@ -15,6 +15,7 @@
 typedef struct CPUBreakpoint {
     vaddr pc;
     int flags; /* BP_* */
+    uint64_t hit_count; /* only maintained for BP_TRACE */
     QTAILQ_ENTRY(CPUBreakpoint) entry;
 } CPUBreakpoint;
 
@@ -24,6 +25,7 @@ typedef struct CPUWatchpoint {
     vaddr hitaddr;
     MemTxAttrs hitattrs;
     int flags; /* BP_* */
+    uint64_t hit_count; /* only maintained for BP_TRACE */
     QTAILQ_ENTRY(CPUWatchpoint) entry;
 } CPUWatchpoint;
 
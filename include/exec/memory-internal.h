@@ -36,6 +36,11 @@ static inline AddressSpaceDispatch *address_space_to_dispatch(AddressSpace *as)
 FlatView *address_space_get_flatview(AddressSpace *as);
 void flatview_unref(FlatView *view);
 
+void address_space_drain_bounce_pool(AddressSpace *as);
+
+/* Current memory topology generation, bumped on every region change */
+uint64_t memory_region_topology_generation(void);
+
 extern const MemoryRegionOps unassigned_mem_ops;
 
 void flatview_add_to_dispatch(FlatView *fv, MemoryRegionSection *section);
@@ -789,6 +789,8 @@ struct MemoryRegion {
     MemoryRegion *alias;
     hwaddr alias_offset;
     int32_t priority;
+    /* Topology generation of the last change in this region's subtree */
+    uint64_t update_gen;
     QTAILQ_HEAD(, MemoryRegion) subregions;
     QTAILQ_ENTRY(MemoryRegion) subregions_link;
     QTAILQ_HEAD(, CoalescedMemoryRange) coalesced;
@@ -843,6 +845,14 @@ struct MemoryListener {
      * #MemoryListener.region_del() or #MemoryListener.region_nop(),
      * #MemoryListener.log_start() and #MemoryListener.log_stop().
      *
+     * Listeners that talk to an external entity (ioctl, vhost message)
+     * should queue the sections passed to #MemoryListener.region_add()
+     * and #MemoryListener.region_del() and apply the whole change-set
+     * here, rather than acting on each section individually: a single
+     * device hotplug can produce dozens of section updates per
+     * transaction.  See kvm_region_commit() and vhost_commit() for
+     * examples.
+     *
      * @listener: The #MemoryListener.
      */
     void (*commit)(MemoryListener *listener);
@@ -854,6 +864,10 @@ struct MemoryListener {
      * for a section of the address space that is new in this address space
      * space since the last transaction.
      *
+     * Expensive reactions to the new section are best deferred to
+     * #MemoryListener.commit(), which sees the complete change-set of
+     * the transaction.
+     *
      * @listener: The #MemoryListener.
      * @section: The new #MemoryRegionSection.
      */
@@ -866,6 +880,9 @@ struct MemoryListener {
      * for a section of the address space that has disappeared in the address
      * space since the last transaction.
      *
+     * As with #MemoryListener.region_add(), expensive reactions are
+     * best deferred to #MemoryListener.commit().
+     *
      * @listener: The #MemoryListener.
      * @section: The old #MemoryRegionSection.
      */
@@ -1086,6 +1103,14 @@ typedef struct AddressSpaceMapClient {
 
 #define DEFAULT_MAX_BOUNCE_BUFFER_SIZE (4096)
 
+/*
+ * Freed DMA bounce buffers are recycled through per-AddressSpace pools,
+ * one per power-of-two size class from 4KiB up to 512KiB.
+ */
+#define BOUNCE_BUFFER_SIZE_CLASSES 8
+
+typedef struct BounceBuffer BounceBuffer;
+
 /**
  * struct AddressSpace: describes a mapping of addresses to #MemoryRegion objects
  */
@@ -1108,6 +1133,10 @@ struct AddressSpace {
     size_t max_bounce_buffer_size;
     /* Total size of bounce buffers currently allocated, atomically accessed */
     size_t bounce_buffer_size;
+    /* Freed bounce buffers kept for reuse, one list per size class */
+    QemuMutex bounce_pool_lock;
+    QSLIST_HEAD(, BounceBuffer) bounce_pool[BOUNCE_BUFFER_SIZE_CLASSES];
+    uint32_t bounce_pool_len[BOUNCE_BUFFER_SIZE_CLASSES];
     /* List of callbacks to invoke when buffers free up */
     QemuMutex map_client_list_lock;
     QLIST_HEAD(, AddressSpaceMapClient) map_client_list;
@@ -1127,6 +1156,10 @@ struct FlatView {
     unsigned nr_allocated;
     struct AddressSpaceDispatch *dispatch;
     MemoryRegion *root;
+    /* Topology generation at the time the view was rendered */
+    uint64_t render_gen;
+    /* Whether rendering followed an alias out of the root's subtree */
+    bool foreign_deps;
 };
 
 static inline FlatView *address_space_to_flatview(AddressSpace *as)
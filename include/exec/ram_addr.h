@@ -282,7 +282,10 @@ static inline void cpu_physical_memory_set_dirty_flag(ram_addr_t addr,
 
     blocks = qatomic_rcu_read(&ram_list.dirty_memory[client]);
 
-    set_bit_atomic(offset, blocks->blocks[idx]);
+    /* Avoid the locked RMW and the cacheline bounce if already dirty */
+    if (!test_bit(offset, blocks->blocks[idx])) {
+        set_bit_atomic(offset, blocks->blocks[idx]);
+    }
 }
 
 static inline void cpu_physical_memory_set_dirty_range(ram_addr_t start,
@@ -337,6 +340,21 @@ static inline void cpu_physical_memory_set_dirty_range(ram_addr_t start,
 
 #if !defined(_WIN32)
 
+/*
+ * OR @mask into the dirty bitmap word @word, skipping the atomic when all
+ * of the bits are already set.  The plain read keeps the cacheline in the
+ * shared state while a device or vCPU rewrites the same pages, the same
+ * idea that cpu_physical_memory_range_includes_clean() applies at range
+ * granularity.
+ */
+static inline void cpu_physical_memory_dirty_bitmap_word(unsigned long *word,
+                                                         unsigned long mask)
+{
+    if ((*word & mask) != mask) {
+        qatomic_or(word, mask);
+    }
+}
+
 /*
  * Contrary to cpu_physical_memory_sync_dirty_bitmap() this function returns
  * the number of dirty pages in @bitmap passed as argument. On the other hand,
@@ -381,10 +399,11 @@ uint64_t cpu_physical_memory_set_dirty_lebitmap(unsigned long *bitmap,
                     unsigned long temp = leul_to_cpu(bitmap[k]);
 
                     nbits = ctpopl(temp);
-                    qatomic_or(&blocks[DIRTY_MEMORY_VGA][idx][offset], temp);
+                    cpu_physical_memory_dirty_bitmap_word(
+                            &blocks[DIRTY_MEMORY_VGA][idx][offset], temp);
 
                     if (global_dirty_tracking) {
-                        qatomic_or(
+                        cpu_physical_memory_dirty_bitmap_word(
                                 &blocks[DIRTY_MEMORY_MIGRATION][idx][offset],
                                 temp);
                         if (unlikely(
@@ -396,8 +415,8 @@ uint64_t cpu_physical_memory_set_dirty_lebitmap(unsigned long *bitmap,
                     num_dirty += nbits;
 
                     if (tcg_enabled()) {
-                        qatomic_or(&blocks[DIRTY_MEMORY_CODE][idx][offset],
-                                   temp);
+                        cpu_physical_memory_dirty_bitmap_word(
+                                &blocks[DIRTY_MEMORY_CODE][idx][offset], temp);
                     }
                 }
 
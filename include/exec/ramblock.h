@@ -45,6 +45,12 @@ struct RAMBlock {
     size_t page_size;
     /* dirty bitmap used during migration */
     unsigned long *bmap;
+    /*
+     * Pages the guest reported free via virtio-balloon free page hinting
+     * and that have not been dirtied since.  Allocated on the first hint,
+     * protected by RAMState.bitmap_mutex; only used during migration.
+     */
+    unsigned long *hint_bmap;
 
     /*
      * Below fields are only used by mapped-ram migration
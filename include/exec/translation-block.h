@@ -89,6 +89,22 @@ struct TranslationBlock {
     uint16_t size;
     uint16_t icount;
 
+    /*
+     * Approximate execution count, bumped on each entry from the main
+     * loop.  Executions reached through goto_tb/goto_ptr chaining are
+     * not counted, so this undercounts the interior of hot chains;
+     * it is only a relative hotness signal for cache reclamation.
+     * Racy increments from multiple vCPUs are acceptable.
+     */
+    uint32_t exec_count;
+
+    /*
+     * Set when this TB was generated with translation-region extension
+     * enabled (see CPUState::region_extend_pc), so that a hot extended
+     * TB is not invalidated for re-extension over and over.
+     */
+    bool region_extended;
+
     struct tb_tc tc;
 
     /*
@@ -141,6 +157,23 @@ struct TranslationBlock {
     uintptr_t jmp_list_head;
     uintptr_t jmp_list_next[2];
     uintptr_t jmp_dest[2];
+
+    /*
+     * Inline cache of indirect branch targets taken from this TB,
+     * filled by helper_lookup_tb_ptr.  Entries are hints: a hit is
+     * only accepted after validating the target block's comparison
+     * fields, exactly as for the hashed jump cache.  The cache is
+     * shared between vCPUs executing the same block, so all accesses
+     * to @tb must be atomic; @indirect_flush_count records
+     * tb_ctx.tb_flush_count at the last fill, and a mismatch rejects
+     * entries that may point into reclaimed code buffer regions.
+     */
+#define TB_INDIRECT_CACHE_SIZE 2
+    struct {
+        vaddr pc;
+        TranslationBlock *tb;
+    } indirect[TB_INDIRECT_CACHE_SIZE];
+    unsigned indirect_flush_count;
 };
 
 /* The alignment given to TranslationBlock during allocation. */
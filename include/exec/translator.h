@@ -74,6 +74,8 @@ typedef enum DisasJumpType {
  * @singlestep_enabled: "Hardware" single stepping enabled.
  * @plugin_enabled: TCG plugin enabled in this TB.
  * @fake_insn: True if translator_fake_ldb used.
+ * @region_extend: This TB is a hot retranslation; the target may keep
+ *                 translating through unconditional direct jumps.
  * @insn_start: The last op emitted by the insn_start hook,
  *              which is expected to be INDEX_op_insn_start.
  *
@@ -89,6 +91,7 @@ struct DisasContextBase {
     bool singlestep_enabled;
     bool plugin_enabled;
     bool fake_insn;
+    bool region_extend;
     struct TCGOp *insn_start;
     void *host_addr[2];
 
@@ -197,8 +197,12 @@ struct CPUClass {
  */
 #define NB_MMU_MODES 16
 
-/* Use a fully associative victim tlb of 8 entries. */
-#define CPU_VTLB_SIZE 8
+/*
+ * Use a fully associative victim tlb of 16 entries.  Enough to cover
+ * the conflict-miss working set of pointer-chasing guest workloads
+ * without making the linear scan in victim_tlb_hit noticeable.
+ */
+#define CPU_VTLB_SIZE 16
 
 /*
  * The full TLB entry, which is not accessed by generated TCG code,
@@ -488,6 +492,13 @@ struct CPUState {
     bool exit_request;
     int exclusive_context_count;
     uint32_t cflags_next_tb;
+    /*
+     * When a hot TB ending in a direct jump is invalidated for
+     * retranslation, this holds its guest pc; the next translation
+     * starting there may extend through unconditional jumps so that
+     * globals stay in host registers across them.  -1 if unset.
+     */
+    vaddr region_extend_pc;
     /* updates protected by BQL */
     uint32_t interrupt_request;
     int singlestep_enabled;
@@ -1088,7 +1099,7 @@ void cpu_single_step(CPUState *cpu, int enabled);
 #define BP_MEM_WRITE          0x02
 #define BP_MEM_ACCESS         (BP_MEM_READ | BP_MEM_WRITE)
 #define BP_STOP_BEFORE_ACCESS 0x04
-/* 0x08 currently unused */
+#define BP_TRACE              0x08
 #define BP_GDB                0x10
 #define BP_CPU                0x20
 #define BP_ANY                (BP_GDB | BP_CPU)
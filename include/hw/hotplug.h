@@ -96,4 +96,13 @@ void hotplug_handler_unplug_request(HotplugHandler *plug_handler,
 void hotplug_handler_unplug(HotplugHandler *plug_handler,
                             DeviceState *plugged_dev,
                             Error **errp);
+
+/**
+ * hotplug_handler_generation:
+ *
+ * Returns a counter that is bumped whenever a device is plugged or
+ * unplugged.  Users deriving state from the set of plugged devices
+ * (e.g. cached firmware tables) can compare it to detect staleness.
+ */
+unsigned int hotplug_handler_generation(void);
 #endif
@@ -49,6 +49,7 @@ struct SCSIRequest {
     BlockAIOCB        *aiocb;
     QEMUSGList        *sg;
     QTAILQ_ENTRY(SCSIRequest) next;
+    QSLIST_ENTRY(SCSIRequest) next_free;
 };
 
 #define TYPE_SCSI_DEVICE "scsi-device"
@@ -82,6 +83,14 @@ struct SCSIDevice
      */
     QTAILQ_HEAD(, SCSIRequest) requests;
 
+    /*
+     * Serviced requests kept around for reuse, to spare an allocation
+     * per command.  Accessed under the same rule as @requests, drained
+     * on unrealize.
+     */
+    QSLIST_HEAD(, SCSIRequest) free_requests;
+    uint32_t nr_free_requests;
+
     uint32_t channel;
     uint32_t lun;
     int blocksize;
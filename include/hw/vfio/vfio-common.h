@@ -131,6 +131,7 @@ typedef struct VFIODevice {
     bool ram_block_discard_allowed;
     OnOffAuto enable_migration;
     bool migration_events;
+    uint64_t migration_data_buffer_size;
     VFIODeviceOps *ops;
     unsigned int num_irqs;
     unsigned int num_regions;
@@ -71,6 +71,13 @@ struct VirtIOBlock {
      */
     AioContext **vq_aio_context;
 
+    /*
+     * The IOThread backing each entry of vq_aio_context, or NULL for
+     * virtqueues handled by the main loop. One reference is held per
+     * virtqueue. May change at runtime via x-virtio-set-vq-iothread.
+     */
+    IOThread **vq_iothread;
+
     uint64_t host_features;
     size_t config_size;
     BlockRAMRegistrar blk_ram_registrar;
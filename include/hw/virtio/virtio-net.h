@@ -151,6 +151,9 @@ typedef struct VirtioNetRssData {
     uint16_t default_queue;
 } VirtioNetRssData;
 
+/* Software RSS flow cache entry, defined in virtio-net.c */
+typedef struct VirtioNetRssFlow VirtioNetRssFlow;
+
 typedef struct VirtIONetQueue {
     VirtQueue *rx_vq;
     VirtQueue *tx_vq;
@@ -223,8 +226,17 @@ struct VirtIONet {
     bool primary_opts_from_json;
     NotifierWithReturn migration_state;
     VirtioNetRssData rss_data;
+    /* Cache of Toeplitz hashes for recent flows, only for software RSS */
+    VirtioNetRssFlow *rss_flows;
     struct NetRxPkt *rx_pkt;
     struct EBPFRSSContext ebpf_rss;
+    /*
+     * Program fd currently attached to the backend, or -1 if detached.
+     * The initial -2 means unknown, so the first (re)attach is never
+     * skipped.  Used to elide redundant steering ioctls when the RSS
+     * configuration is recommitted without changes.
+     */
+    int ebpf_rss_attach_fd;
     uint32_t nr_ebpf_rss_fds;
     char **ebpf_rss_fds;
 };
@@ -37,6 +37,7 @@
                                 (0x1ULL << VIRTIO_F_ANY_LAYOUT))
 
 struct VirtQueue;
+struct IOThread;
 
 static inline hwaddr vring_align(hwaddr addr,
                                              unsigned long align)
@@ -71,6 +72,8 @@ typedef struct VirtQueueElement
     unsigned int in_num;
     /* Element has been processed (VIRTIO_F_IN_ORDER) */
     bool in_order_filled;
+    /* Size of the allocation backing this element, for recycling */
+    size_t alloc_size;
     hwaddr *in_addr;
     hwaddr *out_addr;
     struct iovec *in_sg;
@@ -210,6 +213,12 @@ struct VirtioDeviceClass {
     void (*guest_notifier_mask)(VirtIODevice *vdev, int n, bool mask);
     int (*start_ioeventfd)(VirtIODevice *vdev);
     void (*stop_ioeventfd)(VirtIODevice *vdev);
+    /* Move host notifier handling for a virtqueue to @iothread (or back to
+     * the main loop when @iothread is NULL) while the guest is running.
+     * Device must validate queue_index.
+     */
+    void (*set_vq_iothread)(VirtIODevice *vdev, uint16_t queue_index,
+                            struct IOThread *iothread, Error **errp);
     /* Saving and loading of a device; trying to deprecate save/load
      * use vmsd for new devices.
      */
@@ -268,6 +277,10 @@ void virtqueue_fill(VirtQueue *vq, const VirtQueueElement *elem,
 
 void virtqueue_map(VirtIODevice *vdev, VirtQueueElement *elem);
 void *virtqueue_pop(VirtQueue *vq, size_t sz);
+void virtqueue_element_recycle(VirtQueue *vq, VirtQueueElement *elem);
+void virtio_device_get_notification_stats(VirtIODevice *vdev,
+                                          uint64_t *kicks, uint64_t *irqs,
+                                          uint64_t *used);
 unsigned int virtqueue_drop_all(VirtQueue *vq);
 void *qemu_get_virtqueue_element(VirtIODevice *vdev, QEMUFile *f, size_t sz);
 void qemu_put_virtqueue_element(VirtIODevice *vdev, QEMUFile *f,
@@ -49,6 +49,8 @@ struct QIOChannelTLS {
     QCryptoTLSSession *session;
     QIOChannelShutdown shutdown;
     guint hs_ioc_tag;
+    /* true when a blocked uncork left records queued in the session */
+    bool uncork_pending;
 };
 
 /**
@@ -92,9 +92,13 @@ void net_toeplitz_add(uint32_t *result,
         register uint8_t bit;
 
         for (bit = 0; bit < 8; bit++) {
-            if (input_byte & (1 << 7)) {
-                accumulator ^= leftmost_32_bits;
-            }
+            /*
+             * XOR the key window in under a mask instead of a branch: the
+             * input bits are effectively random, so the branch would be
+             * mispredicted half of the time.
+             */
+            accumulator ^= leftmost_32_bits &
+                           -(uint32_t)((input_byte >> 7) & 1);
 
             leftmost_32_bits =
                 (leftmost_32_bits << 1) | ((key_byte & (1 << 7)) >> 7);
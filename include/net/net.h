@@ -134,6 +134,13 @@ struct SocketReadState {
     uint32_t packet_len;
     uint32_t vnet_hdr_len;
     uint8_t buf[NET_BUFSIZE];
+    /*
+     * Points at the current packet for the duration of the finalize
+     * callback.  This is buf when the packet had to be reassembled from
+     * several reads, or the caller's buffer when a complete packet
+     * arrived in one piece and no copy was needed.
+     */
+    const uint8_t *data;
     SocketReadStateFinalize *finalize;
 };
 
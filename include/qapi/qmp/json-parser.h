@@ -14,6 +14,8 @@
 #ifndef QAPI_QMP_JSON_PARSER_H
 #define QAPI_QMP_JSON_PARSER_H
 
+typedef struct JSONTokenChunk JSONTokenChunk;
+
 typedef struct JSONLexer {
     int start_state, state;
     GString *token;
@@ -29,6 +31,7 @@ typedef struct JSONMessageParser {
     int bracket_count;
     GQueue tokens;
     uint64_t token_size;
+    JSONTokenChunk *token_arena;
 } JSONMessageParser;
 
 void json_message_parser_init(JSONMessageParser *parser,
@@ -74,4 +74,11 @@ void qemu_coroutine_delete(Coroutine *co);
 CoroutineAction qemu_coroutine_switch(Coroutine *from, Coroutine *to,
                                       CoroutineAction action);
 
+/*
+ * Release the backing memory of a terminated coroutine's stack while it
+ * sits in the release pool.  Only the shallow parked trampoline frame is
+ * retained; the mapping stays valid and refaults on reuse.
+ */
+void qemu_coroutine_trim_stack(Coroutine *co);
+
 #endif
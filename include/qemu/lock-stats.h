@@ -0,0 +1,52 @@
+/*
+ * Lightweight mutex contention statistics
+ *
+ * Copyright Red Hat, Inc. 2026
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#ifndef QEMU_LOCK_STATS_H
+#define QEMU_LOCK_STATS_H
+
+#include "qemu/thread.h"
+#include "qemu/stats64.h"
+
+/*
+ * Unlike the sync profiler (qsp), which wraps every lock through
+ * function pointers, contention statistics are opt-in per mutex and
+ * stay enabled for the lifetime of the process.  Uncontended
+ * acquisitions of an instrumented mutex cost one trylock instead of a
+ * lock, and acquisitions of uninstrumented mutexes only a pointer
+ * test, so this is cheap enough for production use.
+ *
+ * Statistics entries are registered in a global list and never freed,
+ * so instrumentation is meant for long-lived locks.
+ */
+typedef struct QemuMutexStats QemuMutexStats;
+
+struct QemuMutexStats {
+    char *name;
+    Stat64 contentions;
+    Stat64 total_wait_ns;
+    Stat64 max_wait_ns;
+    QemuMutexStats *next;
+};
+
+/**
+ * qemu_mutex_enable_stats: start collecting contention statistics
+ * @mutex: an initialized mutex, instrumented from now on
+ * @name: the name reported by query-lock-stats; copied
+ *
+ * Enabling statistics twice on the same mutex is a no-op.
+ */
+void qemu_mutex_enable_stats(QemuMutex *mutex, const char *name);
+
+/* Called by the lock implementations after a contended acquisition. */
+void qemu_mutex_stats_record(QemuMutexStats *stats, int64_t wait_ns);
+
+typedef void QemuMutexStatsIterFn(QemuMutexStats *stats, void *opaque);
+void qemu_mutex_stats_foreach(QemuMutexStatsIterFn *fn, void *opaque);
+
+#endif
@@ -59,6 +59,21 @@
 #else
 #define QEMU_MADV_POPULATE_WRITE QEMU_MADV_INVALID
 #endif
+#ifdef MADV_FREE
+#define QEMU_MADV_FREE MADV_FREE
+#else
+#define QEMU_MADV_FREE QEMU_MADV_DONTNEED
+#endif
+#ifdef MADV_COLD
+#define QEMU_MADV_COLD MADV_COLD
+#else
+#define QEMU_MADV_COLD QEMU_MADV_INVALID
+#endif
+#ifdef MADV_PAGEOUT
+#define QEMU_MADV_PAGEOUT MADV_PAGEOUT
+#else
+#define QEMU_MADV_PAGEOUT QEMU_MADV_INVALID
+#endif
 
 #elif defined(CONFIG_POSIX_MADVISE)
 
@@ -73,6 +88,9 @@
 #define QEMU_MADV_NOHUGEPAGE  QEMU_MADV_INVALID
 #define QEMU_MADV_REMOVE QEMU_MADV_DONTNEED
 #define QEMU_MADV_POPULATE_WRITE QEMU_MADV_INVALID
+#define QEMU_MADV_FREE QEMU_MADV_INVALID
+#define QEMU_MADV_COLD QEMU_MADV_INVALID
+#define QEMU_MADV_PAGEOUT QEMU_MADV_INVALID
 
 #else /* no-op */
 
@@ -87,6 +105,9 @@
 #define QEMU_MADV_NOHUGEPAGE  QEMU_MADV_INVALID
 #define QEMU_MADV_REMOVE QEMU_MADV_INVALID
 #define QEMU_MADV_POPULATE_WRITE QEMU_MADV_INVALID
+#define QEMU_MADV_FREE QEMU_MADV_INVALID
+#define QEMU_MADV_COLD QEMU_MADV_INVALID
+#define QEMU_MADV_PAGEOUT QEMU_MADV_INVALID
 
 #endif
 
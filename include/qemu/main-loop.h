@@ -342,6 +342,25 @@ void bql_lock_impl(const char *file, int line);
  */
 void bql_unlock(void);
 
+/**
+ * bql_prof_enable: Enable or disable the BQL sampling profiler.
+ *
+ * While enabled, a fraction of BQL acquisitions is timed and
+ * attributed to its call site; see the x-query-bql-profile QMP
+ * command and the "info bql-profile" HMP command for the report.
+ */
+void bql_prof_enable(bool enable);
+
+/**
+ * bql_prof_is_enabled: Return whether the BQL sampling profiler is on.
+ */
+bool bql_prof_is_enabled(void);
+
+/**
+ * bql_prof_reset: Discard all samples collected by the BQL profiler.
+ */
+void bql_prof_reset(void);
+
 /**
  * BQL_LOCK_GUARD
  *
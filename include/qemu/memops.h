@@ -0,0 +1,45 @@
+/*
+ * Bulk memory comparison helpers for guest pages
+ *
+ * Copyright (c) 2024
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#ifndef QEMU_MEMOPS_H
+#define QEMU_MEMOPS_H
+
+/* Granularity at which qemu_mem_first_diff() reports differences */
+#define QEMU_MEM_DIFF_LINE 64
+
+/**
+ * qemu_mem_first_diff:
+ * @a: first buffer
+ * @b: second buffer
+ * @len: number of bytes to compare
+ *
+ * Compare two buffers at QEMU_MEM_DIFF_LINE granularity.
+ *
+ * Returns: the offset of the first differing line, rounded down to a
+ * multiple of QEMU_MEM_DIFF_LINE, or @len if the buffers are equal.
+ */
+size_t qemu_mem_first_diff(const void *a, const void *b, size_t len);
+
+/**
+ * qemu_mem_copy_if_different:
+ * @dst: destination buffer
+ * @src: source buffer
+ * @len: number of bytes
+ *
+ * Make @dst equal to @src while only writing the QEMU_MEM_DIFF_LINE
+ * sized lines that actually differ.  Useful when @dst is usually
+ * almost identical to @src and avoiding stores reduces cache and
+ * memory write traffic, e.g. when overwriting a guest page with a new
+ * version of itself.
+ *
+ * Returns: true if anything was written to @dst.
+ */
+bool qemu_mem_copy_if_different(void *dst, const void *src, size_t len);
+
+#endif
@@ -793,6 +793,20 @@ int qemu_msync(void *addr, size_t length, int fd);
  */
 size_t qemu_get_host_physmem(void);
 
+/**
+ * qemu_get_thp_bytes:
+ * @ptr: start of the mapping to inspect
+ * @size: size of the mapping in bytes
+ *
+ * Query how much of the given mapping is currently backed by
+ * transparent huge pages.  Purely advisory: the kernel may split or
+ * collapse pages at any time.
+ *
+ * Returns the number of bytes backed by transparent huge pages, or
+ * (size_t)-1 if the host cannot report it.
+ */
+size_t qemu_get_thp_bytes(void *ptr, size_t size);
+
 /*
  * Toggle write/execute on the pages marked MAP_JIT
  * for the current thread.
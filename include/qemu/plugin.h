@@ -72,6 +72,8 @@ enum plugin_dyn_cb_type {
     PLUGIN_CB_MEM_REGULAR,
     PLUGIN_CB_INLINE_ADD_U64,
     PLUGIN_CB_INLINE_STORE_U64,
+    PLUGIN_CB_INLINE_RANGE_ADD_U64,
+    PLUGIN_CB_INLINE_RANGE_STORE_U64,
 };
 
 struct qemu_plugin_regular_cb {
@@ -87,6 +89,15 @@ struct qemu_plugin_inline_cb {
     enum qemu_plugin_mem_rw rw;
 };
 
+/* As above, but only applied to accesses within [low, high]. */
+struct qemu_plugin_inline_range_cb {
+    qemu_plugin_u64 entry;
+    uint64_t imm;
+    uint64_t low;
+    uint64_t high;
+    enum qemu_plugin_mem_rw rw;
+};
+
 struct qemu_plugin_conditional_cb {
     union qemu_plugin_cb_sig f;
     TCGHelperInfo *info;
@@ -107,6 +118,7 @@ struct qemu_plugin_dyn_cb {
         struct qemu_plugin_regular_cb regular;
         struct qemu_plugin_conditional_cb cond;
         struct qemu_plugin_inline_cb inline_insn;
+        struct qemu_plugin_inline_range_cb inline_range;
     };
 };
 
@@ -65,6 +65,7 @@ typedef uint64_t qemu_plugin_id_t;
  *
  * version 4:
  * - added qemu_plugin_read_memory_vaddr
+ * - added qemu_plugin_register_vcpu_mem_range_inline_per_vcpu
  */
 
 extern QEMU_PLUGIN_EXPORT int qemu_plugin_version;
@@ -701,6 +702,30 @@ void qemu_plugin_register_vcpu_mem_inline_per_vcpu(
     qemu_plugin_u64 entry,
     uint64_t imm);
 
+/**
+ * qemu_plugin_register_vcpu_mem_range_inline_per_vcpu() - filtered inline op
+ * @insn: handle for instruction to instrument
+ * @rw: apply to reads, writes or both
+ * @low: lowest virtual address of the range, inclusive
+ * @high: highest virtual address of the range, inclusive
+ * @op: the op, of type qemu_plugin_op
+ * @entry: entry to run op
+ * @imm: immediate data for @op
+ *
+ * As qemu_plugin_register_vcpu_mem_inline_per_vcpu(), but the op is
+ * only applied to accesses whose virtual address falls within
+ * [@low, @high].  The filter is evaluated in generated code, so
+ * accesses outside the range never leave the translated block.
+ */
+QEMU_PLUGIN_API
+void qemu_plugin_register_vcpu_mem_range_inline_per_vcpu(
+    struct qemu_plugin_insn *insn,
+    enum qemu_plugin_mem_rw rw,
+    uint64_t low, uint64_t high,
+    enum qemu_plugin_op op,
+    qemu_plugin_u64 entry,
+    uint64_t imm);
+
 /**
  * qemu_plugin_request_time_control() - request the ability to control time
  *
@@ -18,6 +18,12 @@ struct qht {
     qht_cmp_func_t cmp;
     QemuMutex lock; /* serializes setters of ht->map */
     unsigned int mode;
+    /*
+     * Resize observability.  Written under ht->lock; read racily by
+     * qht_statistics_init, which is tolerable for monitoring output.
+     */
+    size_t n_resizes;
+    int64_t resize_stall_ns; /* cumulative time with all buckets locked */
 };
 
 /**
@@ -29,6 +35,9 @@ struct qht {
  *         chain, excluding empty chains.
  * @occupancy: frequency distribution representing chain occupancy rate.
  *             Valid range: from 0.0 (empty) to 1.0 (full occupancy).
+ * @n_resizes: number of resizes performed since qht_init.
+ * @resize_stall_ns: cumulative time spent resizing with all bucket locks
+ *                   held, i.e. with concurrent writers stalled.
  *
  * An entry is a pointer-hash pair.
  * Each bucket can host several entries.
@@ -40,6 +49,8 @@ struct qht_stats {
     size_t entries;
     struct qdist chain;
     struct qdist occupancy;
+    size_t n_resizes;
+    int64_t resize_stall_ns;
 };
 
 typedef bool (*qht_lookup_func_t)(const void *obj, const void *userp);
@@ -39,9 +39,20 @@ typedef struct {
  */
 static inline int64_t ratelimit_calculate_delay(RateLimit *limit, uint64_t n)
 {
-    int64_t now = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+    int64_t now;
     double delay_slices;
 
+    /*
+     * Jobs call this for every chunk they process; skip the lock and
+     * the clock read entirely while throttling is disabled.  A caller
+     * racing with a speed change simply accounts from the next chunk.
+     */
+    if (!qatomic_read(&limit->slice_quota)) {
+        return 0;
+    }
+
+    now = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+
     QEMU_LOCK_GUARD(&limit->lock);
     if (!limit->slice_quota) {
         /* Throttling disabled.  */
@@ -88,9 +99,10 @@ static inline void ratelimit_set_speed(RateLimit *limit, uint64_t speed,
     QEMU_LOCK_GUARD(&limit->lock);
     limit->slice_ns = slice_ns;
     if (speed == 0) {
-        limit->slice_quota = 0;
+        qatomic_set(&limit->slice_quota, 0);
     } else {
-        limit->slice_quota = MAX(((double)speed * slice_ns) / 1000000000ULL, 1);
+        qatomic_set(&limit->slice_quota,
+                    MAX(((double)speed * slice_ns) / 1000000000ULL, 1));
     }
 }
 
@@ -143,6 +143,14 @@ struct rcu_head {
 void call_rcu1(struct rcu_head *head, RCUCBFunc *func);
 void drain_call_rcu(void);
 
+/*
+ * rcu_get_stats: report grace period count, cumulative grace period
+ * duration in nanoseconds, and the current reclamation queue depth.
+ * The values are read racily and are meant for monitoring only.
+ */
+void rcu_get_stats(uint64_t *gp_count, uint64_t *gp_total_ns,
+                   int64_t *pending);
+
 /* The operands of the minus operator must have the same type,
  * which must be the one that we specify in the cast.
  */
@@ -10,6 +10,7 @@ struct QemuMutex {
     const char *file;
     int line;
 #endif
+    struct QemuMutexStats *stats;
     bool initialized;
 };
 
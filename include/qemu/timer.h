@@ -104,6 +104,18 @@ extern QEMUTimerListGroup main_loop_tlg;
  */
 int64_t qemu_clock_get_ns(QEMUClockType type);
 
+/**
+ * qemu_timer_set_virtual_slack:
+ * @ns: coalescing window in nanoseconds, 0 to disable
+ *
+ * Round QEMU_CLOCK_VIRTUAL deadlines up to multiples of @ns when
+ * computing poll timeouts, so that timers due close together are
+ * served by a single wakeup.  Each timer may fire up to @ns late.
+ * Must not be used when the virtual clock needs to be deterministic
+ * (icount, record/replay).
+ */
+void qemu_timer_set_virtual_slack(int64_t ns);
+
 /**
  * qemu_clock_get_ms;
  * @type: the clock type
@@ -22,16 +22,26 @@
 typedef struct VuFdWatch {
     VuDev *vu_dev;
     int fd; /*kick fd*/
+    int qidx; /* virtqueue index, or -1 if fd is not a virtqueue kick fd */
+    AioContext *ctx; /* AioContext monitoring fd, NULL while detached */
     void *pvt;
     vu_watch_cb cb;
     QTAILQ_ENTRY(VuFdWatch) next;
 } VuFdWatch;
 
+/* Counters kept for each virtqueue, updated with atomic accesses */
+typedef struct VuQueueStats {
+    uint64_t kicks; /* kick fd activations */
+    uint64_t requests; /* requests popped by the device implementation */
+} VuQueueStats;
+
 /**
  * VuServer:
  * A vhost-user server instance with user-defined VuDevIface callbacks.
  * Vhost-user device backends can be implemented using VuServer. VuDevIface
- * callbacks and virtqueue kicks run in the given AioContext.
+ * callbacks and virtqueue kicks run in the given AioContext, unless
+ * vhost_user_server_set_queue_contexts() has spread virtqueue processing
+ * across additional AioContexts.
  */
 typedef struct {
     QIONetListener *listener;
@@ -40,12 +50,19 @@ typedef struct {
     int max_queues;
     const VuDevIface *vu_iface;
 
+    /* AioContexts for virtqueue kick processing, round-robin per queue */
+    AioContext **vq_ctx;
+    unsigned int n_vq_ctx;
+    VuQueueStats *vq_stats;
+
     unsigned int in_flight; /* atomic */
+    unsigned int quiesce_pending; /* atomic */
 
     /* Protected by ctx lock */
     bool in_qio_channel_yield;
     bool wait_idle;
     bool quiescing;
+    bool kicks_detached;
     VuDev vu_dev;
     QIOChannel *ioc; /* The I/O channel with the client */
     QIOChannelSocket *sioc; /* The underlying data channel with the client */
@@ -63,10 +80,17 @@ bool vhost_user_server_start(VuServer *server,
 
 void vhost_user_server_stop(VuServer *server);
 
+void vhost_user_server_set_queue_contexts(VuServer *server,
+                                          AioContext **ctx, unsigned int n);
+
 void vhost_user_server_inc_in_flight(VuServer *server);
 void vhost_user_server_dec_in_flight(VuServer *server);
 bool vhost_user_server_has_in_flight(VuServer *server);
 
+void vhost_user_server_inc_queue_requests(VuServer *server, unsigned int qidx);
+void vhost_user_server_get_queue_stats(VuServer *server, unsigned int qidx,
+                                       uint64_t *kicks, uint64_t *requests);
+
 void vhost_user_server_attach_aio_context(VuServer *server, AioContext *ctx);
 void vhost_user_server_detach_aio_context(VuServer *server);
 
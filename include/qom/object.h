@@ -136,6 +136,14 @@ struct ObjectClass
     ObjectUnparent *unparent;
 
     GHashTable *properties;
+
+    /*
+     * Lazily built view of @properties flattened across the class
+     * hierarchy, so a lookup is one hash probe instead of a walk up to
+     * the root class.  Rebuilt when any class gains a property.
+     */
+    GHashTable *flat_properties;
+    unsigned flat_properties_gen;
 };
 
 /**
@@ -158,6 +166,8 @@ struct Object
     GHashTable *properties;
     uint32_t ref;
     Object *parent;
+    /* The child property of @parent that owns this object, or NULL */
+    ObjectProperty *parent_prop;
 };
 
 /**
@@ -1951,6 +1961,27 @@ ObjectProperty *object_class_property_add_uint64_ptr(ObjectClass *klass,
 ObjectProperty *object_property_add_alias(Object *obj, const char *name,
                                Object *target_obj, const char *target_name);
 
+/**
+ * object_class_property_add_alias:
+ * @klass: the class to add a property to
+ * @name: the name of the property
+ * @target_name: the name of the class property to forward accesses to
+ *
+ * Add an alias for a class property on the same class.  This function
+ * will add a property of the same type as the forwarded property, and
+ * accesses to it are forwarded to @target_name on the object being
+ * accessed.  Unlike object_property_add_alias(), a single registration
+ * covers all instances of @klass.
+ *
+ * @target_name must already be registered on @klass (or a parent class)
+ * when this function is called.
+ *
+ * Returns: The newly added property on success, or %NULL on failure.
+ */
+ObjectProperty *object_class_property_add_alias(ObjectClass *klass,
+                                                const char *name,
+                                                const char *target_name);
+
 /**
  * object_property_add_const_link:
  * @obj: the object to add a property to
@@ -38,6 +38,12 @@ struct AccelOpsClass {
     void (*cpu_reset_hold)(CPUState *cpu);
 
     void (*create_vcpu_thread)(CPUState *cpu); /* MANDATORY NON-NULL */
+    /*
+     * True if the vCPU threads can finish their setup concurrently,
+     * in which case qemu_init_vcpu() does not wait for each thread in
+     * turn and cpu_resume() synchronizes with creation instead.
+     */
+    bool parallel_vcpu_create;
     void (*kick_vcpu_thread)(CPUState *cpu);
     bool (*cpu_thread_is_idle)(CPUState *cpu);
 
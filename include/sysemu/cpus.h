@@ -50,4 +50,23 @@ void cpu_synchronize_all_post_reset(void);
 void cpu_synchronize_all_post_init(void);
 void cpu_synchronize_all_pre_loadvm(void);
 
+/**
+ * vcpu_prof_enable: Enable or disable the vCPU sampling profiler.
+ *
+ * While enabled, every running vCPU's guest PC is sampled
+ * periodically; see the x-query-profile QMP command and the
+ * "info vcpu-profile" HMP command for the report.
+ */
+void vcpu_prof_enable(bool enable);
+
+/**
+ * vcpu_prof_is_enabled: Return whether the vCPU sampling profiler is on.
+ */
+bool vcpu_prof_is_enabled(void);
+
+/**
+ * vcpu_prof_reset: Discard all samples collected by the vCPU profiler.
+ */
+void vcpu_prof_reset(void);
+
 #endif
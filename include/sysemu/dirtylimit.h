@@ -12,7 +12,12 @@
 #ifndef QEMU_DIRTYRLIMIT_H
 #define QEMU_DIRTYRLIMIT_H
 
-#define DIRTYLIMIT_CALC_TIME_MS         1000    /* 1000ms */
+/*
+ * Measurement epoch of the per-vcpu dirty page rate.  Short epochs
+ * let the throttle react quickly; individual samples are smoothed
+ * with a moving average since a single epoch is noisy.
+ */
+#define DIRTYLIMIT_CALC_TIME_MS         100     /* 100ms */
 
 int64_t vcpu_dirty_rate_get(int cpu_index);
 void vcpu_dirty_rate_stat_start(void);
@@ -15,6 +15,7 @@
 #define DUMP_H
 
 #include "qapi/qapi-types-dump.h"
+#include "qemu/ratelimit.h"
 #include "qemu/thread.h"
 
 #define MAKEDUMPFILE_SIGNATURE      "makedumpfile"
@@ -136,14 +137,6 @@ typedef struct QEMU_PACKED KdumpSubHeader64 {
     uint64_t max_mapnr_64;          /* header_version 6 and later */
 } KdumpSubHeader64;
 
-typedef struct DataCache {
-    DumpState *state;   /* dump state related to this data */
-    uint8_t *buf;       /* buffer for cached data */
-    size_t buf_size;    /* size of the buf */
-    size_t data_size;   /* size of cached data in buf */
-    off_t offset;       /* offset of the file */
-} DataCache;
-
 typedef struct QEMU_PACKED PageDescriptor {
     uint64_t offset;                /* the offset of the page data*/
     uint32_t size;                  /* the size of this dump page */
@@ -160,6 +153,7 @@ typedef struct DumpState {
     bool kdump_raw;
     hwaddr memory_offset;
     int fd;
+    RateLimit rate_limit;       /* bounds bytes/s written to the vmcore */
 
     /*
      * Dump filter area variables
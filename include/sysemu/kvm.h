@@ -486,6 +486,19 @@ void kvm_init_cpu_signals(CPUState *cpu);
  * @return: virq (>=0) when success, errno (<0) when failed.
  */
 int kvm_irqchip_add_msi_route(KVMRouteChange *c, int vector, PCIDevice *dev);
+/**
+ * kvm_irqchip_update_msi_route - Update the MSI message of a route
+ * @s:    KVM state.
+ * @virq: the route to update.
+ * @msg:  new MSI message.
+ * @dev:  Owner PCI device of the route.
+ * @return: 1 when the route was modified and needs a commit, 0 when the
+ *          message matched the existing route (no commit needed), errno (<0)
+ *          when failed.
+ *
+ * Callers can skip kvm_irqchip_commit_routes(), which is an expensive
+ * full-table update in the kernel, unless 1 is returned.
+ */
 int kvm_irqchip_update_msi_route(KVMState *s, int virq, MSIMessage msg,
                                  PCIDevice *dev);
 void kvm_irqchip_commit_routes(KVMState *s);
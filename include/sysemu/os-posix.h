@@ -82,6 +82,20 @@ void *qemu_alloc_stack(size_t *sz);
  */
 void qemu_free_stack(void *stack, size_t sz);
 
+/**
+ * qemu_shrink_stack:
+ * @stack: stack allocated via qemu_alloc_stack()
+ * @sz: size of stack in bytes
+ * @keep: number of bytes at the top of the stack to leave untouched
+ *
+ * Tell the host kernel that all but the topmost @keep bytes of the
+ * stack are no longer needed, so their backing memory can be
+ * reclaimed.  The mapping stays valid and is repopulated on demand.
+ * Use this on stacks that are parked for reuse: the caller must
+ * guarantee that live frames fit within @keep bytes.
+ */
+void qemu_shrink_stack(void *stack, size_t sz, size_t keep);
+
 /* POSIX and Mingw32 differ in the name of the stdio lock functions.  */
 
 static inline void qemu_flockfile(FILE *f)
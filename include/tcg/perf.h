@@ -21,6 +21,12 @@ void perf_report_prologue(const void *start, size_t size);
 void perf_report_code(uint64_t guest_pc, TranslationBlock *tb,
                       const void *start);
 
+/* Open a host iTLB miss counter for the calling thread. */
+void perf_itlb_counter_open(void);
+
+/* Sum the host iTLB miss counters of all translation threads. */
+bool perf_itlb_misses(uint64_t *misses);
+
 /* Stop writing perf-<pid>.map and/or jit-<pid>.dump. */
 void perf_exit(void);
 #else
@@ -41,6 +47,15 @@ static inline void perf_report_code(uint64_t guest_pc, TranslationBlock *tb,
 {
 }
 
+static inline void perf_itlb_counter_open(void)
+{
+}
+
+static inline bool perf_itlb_misses(uint64_t *misses)
+{
+    return false;
+}
+
 static inline void perf_exit(void)
 {
 }
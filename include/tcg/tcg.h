@@ -421,6 +421,13 @@ typedef struct TCGTemp {
        allocated separately.  */
     uintptr_t state;
     void *state_ptr;
+
+    /*
+     * Generation stamp for state_ptr as used by the optimizer; when it
+     * does not match TCGContext.opt_gen, state_ptr is stale (its arena
+     * allocation was recycled by an intervening tcg_pool_reset).
+     */
+    uint64_t opt_gen;
 } TCGTemp;
 
 typedef struct TCGContext TCGContext;
@@ -481,6 +488,7 @@ struct TCGContext {
     int nb_temps;
     int nb_indirects;
     int nb_ops;
+    uint64_t opt_gen;             /* see TCGTemp.opt_gen */
     TCGType addr_type;            /* TCG_TYPE_I32 or TCG_TYPE_I64 */
 
     int page_mask;
@@ -759,6 +767,7 @@ void tcg_pool_reset(TCGContext *s);
 TranslationBlock *tcg_tb_alloc(TCGContext *s);
 
 void tcg_region_reset_all(void);
+size_t tcg_region_evict_cold(void (*evict)(TranslationBlock *tb));
 
 size_t tcg_code_size(void);
 size_t tcg_code_capacity(void);
@@ -852,6 +861,24 @@ typedef struct TCGTargetOpDef {
 
 bool tcg_op_supported(TCGOpcode op);
 
+/*
+ * Inline expansion of tiny pure helpers.
+ *
+ * A target may register an expansion callback for a helper whose body is
+ * small enough that emitting equivalent TCG ops beats the cost of a call
+ * (argument marshalling, register spills, icache).  The callback receives
+ * the return temp and the argument temps in declaration order; it returns
+ * true if it emitted an inline expansion, or false to fall back to the
+ * regular call, e.g. when the expansion would be too large for a given
+ * argument pattern.
+ *
+ * Only helpers flagged TCG_CALL_NO_SIDE_EFFECTS are eligible.  All
+ * registrations must happen in the TCGCPUOps ->initialize() hook, before
+ * the first translation.
+ */
+typedef bool (*TCGHelperInlineFn)(TCGTemp *ret, TCGTemp **args);
+void tcg_register_helper_inline(void *func, TCGHelperInlineFn fn);
+
 void tcg_gen_call0(void *func, TCGHelperInfo *, TCGTemp *ret);
 void tcg_gen_call1(void *func, TCGHelperInfo *, TCGTemp *ret, TCGTemp *);
 void tcg_gen_call2(void *func, TCGHelperInfo *, TCGTemp *ret,
@@ -18,6 +18,12 @@
 typedef struct DisplaySurface {
     pixman_image_t *image;
     uint8_t flags;
+    /*
+     * Per-scanline content signatures, allocated on first use by
+     * dpy_gfx_update() to trim damage rectangles down to the scanlines
+     * that actually changed.  0 means "not computed yet".
+     */
+    uint64_t *line_sig;
 #ifdef CONFIG_OPENGL
     GLenum glformat;
     GLenum gltype;
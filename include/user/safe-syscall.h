@@ -123,6 +123,12 @@
  * us about whether to do a restart of the syscall or not; we do not
  * need to check SA_RESTART flags in QEMU or distinguish the various
  * kinds of restartability.
+ *
+ * Note also that this scheme adds no work to the hot path: no signal
+ * mask manipulation and no extra host syscalls, just a load of the
+ * pending flag before the syscall instruction.  Any replacement (e.g.
+ * routing blocking I/O through a submission interface) must clear the
+ * same bar, since it would be paid on every interruptible syscall.
  */
 
 /* The core part of this function is implemented in assembly */
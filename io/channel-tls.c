@@ -25,6 +25,12 @@
 #include "trace.h"
 #include "qemu/atomic.h"
 
+/*
+ * Flush a corked session once this much plain text has been queued,
+ * rather than letting the buffered data grow with the iov count.
+ */
+#define QIO_CHANNEL_TLS_CORK_FLUSH_LIMIT (64 * 1024)
+
 
 static ssize_t qio_channel_tls_write_handler(const char *buf,
                                              size_t len,
@@ -262,6 +268,21 @@ static void qio_channel_tls_finalize(Object *obj)
 }
 
 
+static ssize_t qio_channel_tls_uncork_records(QIOChannelTLS *tioc,
+                                              Error **errp)
+{
+    ssize_t ret = qcrypto_tls_session_uncork(tioc->session, errp);
+
+    if (ret == QCRYPTO_TLS_SESSION_ERR_BLOCK) {
+        tioc->uncork_pending = true;
+        return QIO_CHANNEL_ERR_BLOCK;
+    } else if (ret < 0) {
+        return -1;
+    }
+    tioc->uncork_pending = false;
+    return 0;
+}
+
 static ssize_t qio_channel_tls_readv(QIOChannel *ioc,
                                      const struct iovec *iov,
                                      size_t niov,
@@ -274,6 +295,17 @@ static ssize_t qio_channel_tls_readv(QIOChannel *ioc,
     size_t i;
     ssize_t got = 0;
 
+    /*
+     * If the last write left records queued, try to push them out
+     * now, lest a caller which has turned around to wait for the
+     * peer's reply never sends the tail of its request.  EAGAIN is
+     * not an error here; the flush is retried by the next I/O.
+     */
+    if (tioc->uncork_pending &&
+        qio_channel_tls_uncork_records(tioc, errp) == -1) {
+        return -1;
+    }
+
     for (i = 0 ; i < niov ; i++) {
         ssize_t ret = qcrypto_tls_session_read(
             tioc->session,
@@ -310,12 +342,36 @@ static ssize_t qio_channel_tls_writev(QIOChannel *ioc,
     QIOChannelTLS *tioc = QIO_CHANNEL_TLS(ioc);
     size_t i;
     ssize_t done = 0;
+    size_t queued = 0;
+    bool cork = niov > 1;
+    ssize_t ret;
+
+    /*
+     * Records queued by an earlier blocked uncork must go out first,
+     * otherwise gnutls would buffer the new data behind them.
+     */
+    if (tioc->uncork_pending) {
+        ret = qio_channel_tls_uncork_records(tioc, errp);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    /*
+     * With more than one element, cork the session so that small
+     * elements are coalesced into full sized TLS records, rather
+     * than paying for one record (and one write to the underlying
+     * channel) per element.
+     */
+    if (cork) {
+        qcrypto_tls_session_cork(tioc->session);
+    }
 
     for (i = 0 ; i < niov ; i++) {
-        ssize_t ret = qcrypto_tls_session_write(tioc->session,
-                                                iov[i].iov_base,
-                                                iov[i].iov_len,
-                                                errp);
+        ret = qcrypto_tls_session_write(tioc->session,
+                                        iov[i].iov_base,
+                                        iov[i].iov_len,
+                                        errp);
         if (ret == QCRYPTO_TLS_SESSION_ERR_BLOCK) {
             if (done) {
                 return done;
@@ -326,9 +382,34 @@ static ssize_t qio_channel_tls_writev(QIOChannel *ioc,
             return -1;
         }
         done += ret;
+        queued += ret;
         if (ret < iov[i].iov_len) {
             break;
         }
+        if (cork && queued >= QIO_CHANNEL_TLS_CORK_FLUSH_LIMIT) {
+            ret = qio_channel_tls_uncork_records(tioc, errp);
+            if (ret == QIO_CHANNEL_ERR_BLOCK) {
+                /* the queued bytes are already counted in @done */
+                return done;
+            } else if (ret < 0) {
+                return -1;
+            }
+            qcrypto_tls_session_cork(tioc->session);
+            queued = 0;
+        }
+    }
+
+    if (cork) {
+        ret = qio_channel_tls_uncork_records(tioc, errp);
+        if (ret == QIO_CHANNEL_ERR_BLOCK) {
+            if (done) {
+                return done;
+            } else {
+                return QIO_CHANNEL_ERR_BLOCK;
+            }
+        } else if (ret < 0) {
+            return -1;
+        }
     }
     return done;
 }
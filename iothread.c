@@ -339,9 +339,29 @@ AioContext *iothread_get_aio_context(IOThread *iothread)
     return iothread->ctx;
 }
 
+static void query_one_poll_handler(int fd, int64_t poll_ns, uint64_t hits,
+                                   uint64_t calls, uint64_t dispatch_ns,
+                                   uint64_t dispatch_calls, void *opaque)
+{
+    IOThreadPollHandlerInfoList ***tail = opaque;
+    IOThreadPollHandlerInfo *info;
+
+    info = g_new0(IOThreadPollHandlerInfo, 1);
+    info->fd = fd;
+    info->poll_ns = poll_ns;
+    info->poll_hits = hits;
+    info->poll_calls = calls;
+    info->dispatch_ns = dispatch_ns;
+    info->dispatch_calls = dispatch_calls;
+
+    QAPI_LIST_APPEND(**tail, info);
+}
+
 static int query_one_iothread(Object *object, void *opaque)
 {
     IOThreadInfoList ***tail = opaque;
+    IOThreadPollHandlerInfoList **ph_tail;
+    uint64List **lat_tail;
     IOThreadInfo *info;
     IOThread *iothread;
 
@@ -358,6 +378,15 @@ static int query_one_iothread(Object *object, void *opaque)
     info->poll_shrink = iothread->poll_shrink;
     info->aio_max_batch = iothread->parent_obj.aio_max_batch;
 
+    ph_tail = &info->poll_handlers;
+    aio_context_foreach_poll_stats(iothread->ctx, query_one_poll_handler,
+                                   &ph_tail);
+
+    lat_tail = &info->bh_latency_histogram;
+    for (size_t i = 0; i < AIO_BH_LATENCY_BUCKETS; i++) {
+        QAPI_LIST_APPEND(lat_tail, iothread->ctx->bh_latency[i]);
+    }
+
     QAPI_LIST_APPEND(*tail, info);
     return 0;
 }
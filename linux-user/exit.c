@@ -32,6 +32,9 @@ void preexit_cleanup(CPUArchState *env, int code)
 #ifdef CONFIG_GCOV
         __gcov_dump();
 #endif
+        if (syscall_stats_enabled) {
+            syscall_stats_report();
+        }
         gdb_exit(code);
         qemu_plugin_user_exit();
         perf_exit();
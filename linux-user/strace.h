@@ -24,6 +24,13 @@ void print_syscall(CPUArchState *cpu_env, int num,
 void print_syscall_ret(CPUArchState *cpu_env, int num, abi_long ret,
                        abi_long arg1, abi_long arg2, abi_long arg3,
                        abi_long arg4, abi_long arg5, abi_long arg6);
+/**
+ * get_syscall_name:
+ * @num: target syscall number
+ *
+ * Returns: the name of the syscall, or NULL if it is not known.
+ */
+const char *get_syscall_name(int num);
 /**
  * print_taken_signal:
  * @target_signum: target signal being taken
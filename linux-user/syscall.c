@@ -7752,6 +7752,21 @@ static int do_futex(CPUState *cpu, bool time64, target_ulong uaddr,
     void *haddr2 = NULL;
     int base_op;
 
+    /*
+     * Fast path for private waits and wakes without a timeout.  These
+     * dominate contended pthread locks in the guest, require no argument
+     * translation beyond the value swap, and are not affected by the
+     * VAL2 aliasing of the timeout argument, so hand them straight to
+     * the host before the full decode below.
+     */
+    if (op == (FUTEX_WAIT | FUTEX_PRIVATE_FLAG) && !timeout) {
+        return do_safe_futex(g2h(cpu, uaddr), op, tswap32(val),
+                             NULL, NULL, 0);
+    }
+    if (op == (FUTEX_WAKE | FUTEX_PRIVATE_FLAG)) {
+        return do_safe_futex(g2h(cpu, uaddr), op, val, NULL, NULL, 0);
+    }
+
     /* We assume FUTEX_* constants are the same on both host and target. */
 #ifdef FUTEX_CMD_MASK
     base_op = op & FUTEX_CMD_MASK;
@@ -13745,6 +13760,41 @@ static abi_long do_syscall1(CPUArchState *cpu_env, int num, abi_long arg1,
     return ret;
 }
 
+/* Syscall frequency accounting, enabled with -syscall-stats */
+bool syscall_stats_enabled;
+
+#define SYSCALL_STATS_MAX 2048
+static unsigned long syscall_stats_counts[SYSCALL_STATS_MAX];
+
+static int syscall_stats_cmp(const void *a, const void *b)
+{
+    unsigned long ca = syscall_stats_counts[*(const int *)a];
+    unsigned long cb = syscall_stats_counts[*(const int *)b];
+
+    return ca < cb ? 1 : ca > cb ? -1 : 0;
+}
+
+void syscall_stats_report(void)
+{
+    int idx[SYSCALL_STATS_MAX];
+    int i, n = 0;
+
+    for (i = 0; i < SYSCALL_STATS_MAX; i++) {
+        if (syscall_stats_counts[i]) {
+            idx[n++] = i;
+        }
+    }
+    qsort(idx, n, sizeof(idx[0]), syscall_stats_cmp);
+
+    qemu_log("syscall frequencies (most frequent first):\n");
+    for (i = 0; i < n; i++) {
+        const char *name = get_syscall_name(idx[i]);
+
+        qemu_log("%5d %-24s %12lu\n", idx[i], name ? name : "?",
+                 syscall_stats_counts[idx[i]]);
+    }
+}
+
 abi_long do_syscall(CPUArchState *cpu_env, int num, abi_long arg1,
                     abi_long arg2, abi_long arg3, abi_long arg4,
                     abi_long arg5, abi_long arg6, abi_long arg7,
@@ -13753,6 +13803,11 @@ abi_long do_syscall(CPUArchState *cpu_env, int num, abi_long arg1,
     CPUState *cpu = env_cpu(cpu_env);
     abi_long ret;
 
+    if (unlikely(syscall_stats_enabled) &&
+        num >= 0 && num < SYSCALL_STATS_MAX) {
+        qatomic_inc(&syscall_stats_counts[num]);
+    }
+
 #ifdef DEBUG_ERESTARTSYS
     /* Debug-only code for exercising the syscall-restart code paths
      * in the per-architecture cpu main loops: restart every syscall
@@ -165,6 +165,18 @@ static void file_create_incoming_channels(QIOChannel *ioc, char *filename,
     }
 
     for (i = 0; i < channels; i++) {
+#if defined(__linux__)
+        /*
+         * Restore reads the file essentially sequentially (mapped-ram
+         * walks the dirty bitmap in ascending offset order), so start
+         * kernel readahead now to overlap disk I/O with page placement.
+         * Pointless under O_DIRECT, which bypasses the page cache.
+         */
+        if (!(flags & O_DIRECT)) {
+            posix_fadvise(QIO_CHANNEL_FILE(iocs[i])->fd, 0, 0,
+                          POSIX_FADV_SEQUENTIAL);
+        }
+#endif
         qio_channel_set_name(iocs[i], "migration-file-incoming");
         qio_channel_add_watch_full(iocs[i], G_IO_IN,
                                    file_accept_incoming_migration,
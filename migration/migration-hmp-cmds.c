@@ -175,6 +175,11 @@ void hmp_info_migrate(Monitor *mon, const QDict *qdict)
                        info->dirty_limit_ring_full_time);
     }
 
+    if (info->has_dirty_limit_effective_rate) {
+        monitor_printf(mon, "dirty-limit effective rate: %" PRIu64 " MB/s\n",
+                       info->dirty_limit_effective_rate);
+    }
+
     if (info->has_postcopy_blocktime) {
         monitor_printf(mon, "postcopy blocktime: %u\n",
                        info->postcopy_blocktime);
@@ -1242,6 +1242,10 @@ static void populate_ram_info(MigrationInfo *info, MigrationState *s)
 
         info->has_dirty_limit_ring_full_time = true;
         info->dirty_limit_ring_full_time = dirtylimit_ring_full_time();
+
+        info->has_dirty_limit_effective_rate = true;
+        info->dirty_limit_effective_rate =
+                            migration_dirty_limit_effective_rate();
     }
 }
 
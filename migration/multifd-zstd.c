@@ -13,6 +13,7 @@
 #include "qemu/osdep.h"
 #include <zstd.h>
 #include "qemu/rcu.h"
+#include "qemu/timer.h"
 #include "exec/ramblock.h"
 #include "exec/target_page.h"
 #include "qapi/error.h"
@@ -21,6 +22,9 @@
 #include "options.h"
 #include "multifd.h"
 
+/* Re-evaluate the compression level after this much guest data */
+#define ZSTD_ADAPT_WINDOW (32 * 1024 * 1024)
+
 struct zstd_data {
     /* stream for compression */
     ZSTD_CStream *zcs;
@@ -33,10 +37,61 @@ struct zstd_data {
     uint8_t *zbuff;
     /* size of compressed buffer */
     uint32_t zbuff_len;
+    /* level the compression stream currently runs at */
+    int level;
+    /* level the controller wants; applied at the next frame boundary */
+    int pending_level;
+    /* true while the compression stream is inside a frame */
+    bool frame_open;
+    /* uncompressed/compressed bytes in the current adaptation window */
+    uint64_t in_bytes;
+    uint64_t out_bytes;
+    /* time spent inside ZSTD_compressStream2() in the current window */
+    int64_t comp_ns;
 };
 
 /* Multifd zstd compression */
 
+/*
+ * Pick the compression level for the next adaptation window.
+ *
+ * The configured multifd-zstd-level is only the starting point; each
+ * channel then steers itself between ratio and speed.  Incompressible
+ * data (encrypted or already compressed guest memory) drops straight to
+ * level 1, since higher levels only burn CPU there.  Otherwise the
+ * channel compares its compression throughput against its share of
+ * max-bandwidth: when the compressor cannot keep the wire busy the
+ * level goes down, and when it clearly outruns the wire the spare CPU
+ * is spent on a better ratio.
+ */
+static void multifd_zstd_adapt_level(MultiFDSendParams *p, struct zstd_data *z)
+{
+    uint64_t target = migrate_max_bandwidth() / migrate_multifd_channels();
+    int level = z->level;
+
+    if (z->out_bytes * 100 >= z->in_bytes * 95) {
+        level = 1;
+    } else if (target && z->comp_ns) {
+        uint64_t tput = z->in_bytes * NANOSECONDS_PER_SECOND / z->comp_ns;
+
+        if (tput < target) {
+            level--;
+        } else if (tput > target * 2) {
+            level++;
+        }
+    }
+    level = CLAMP(level, 1, 20);
+
+    if (level != z->pending_level) {
+        trace_multifd_zstd_adapt_level(p->id, z->level, level);
+        z->pending_level = level;
+    }
+
+    z->in_bytes = 0;
+    z->out_bytes = 0;
+    z->comp_ns = 0;
+}
+
 static int multifd_zstd_send_setup(MultiFDSendParams *p, Error **errp)
 {
     struct zstd_data *z = g_new0(struct zstd_data, 1);
@@ -66,6 +121,8 @@ static int multifd_zstd_send_setup(MultiFDSendParams *p, Error **errp)
         error_setg(errp, "multifd %u: out of memory for zbuff", p->id);
         return -1;
     }
+    z->level = migrate_multifd_zstd_level();
+    z->pending_level = z->level;
     p->compress_data = z;
 
     /* Needs 2 IOVs, one for packet header and one for compressed data */
@@ -92,6 +149,8 @@ static int multifd_zstd_send_prepare(MultiFDSendParams *p, Error **errp)
 {
     MultiFDPages_t *pages = &p->data->u.ram;
     struct zstd_data *z = p->compress_data;
+    bool level_change = z->pending_level != z->level;
+    int64_t start_ns;
     int ret;
     uint32_t i;
 
@@ -99,15 +158,37 @@ static int multifd_zstd_send_prepare(MultiFDSendParams *p, Error **errp)
         goto out;
     }
 
+    if (level_change && !z->frame_open) {
+        /*
+         * The level may only change between frames.  The receiving side
+         * doesn't care: the frame header carries everything the
+         * decompressor needs.
+         */
+        if (!ZSTD_isError(ZSTD_CCtx_setParameter(z->zcs,
+                                                 ZSTD_c_compressionLevel,
+                                                 z->pending_level))) {
+            z->level = z->pending_level;
+        } else {
+            z->pending_level = z->level;
+        }
+        level_change = false;
+    }
+
     z->out.dst = z->zbuff;
     z->out.size = z->zbuff_len;
     z->out.pos = 0;
 
+    start_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
     for (i = 0; i < pages->normal_num; i++) {
         ZSTD_EndDirective flush = ZSTD_e_continue;
 
         if (i == pages->normal_num - 1) {
-            flush = ZSTD_e_flush;
+            /*
+             * Close the frame when a level change is pending so the
+             * new level can be applied on the next packet; otherwise
+             * keep the frame open to preserve the match window.
+             */
+            flush = level_change ? ZSTD_e_end : ZSTD_e_flush;
         }
         z->in.src = pages->block->host + pages->offset[i];
         z->in.size = multifd_ram_page_size();
@@ -136,6 +217,14 @@ static int multifd_zstd_send_prepare(MultiFDSendParams *p, Error **errp)
             return -1;
         }
     }
+    z->frame_open = !level_change;
+    z->comp_ns += qemu_clock_get_ns(QEMU_CLOCK_REALTIME) - start_ns;
+    z->in_bytes += (uint64_t)pages->normal_num * multifd_ram_page_size();
+    z->out_bytes += z->out.pos;
+    if (z->in_bytes >= ZSTD_ADAPT_WINDOW) {
+        multifd_zstd_adapt_level(p, z);
+    }
+
     p->iov[p->iovs_num].iov_base = z->zbuff;
     p->iov[p->iovs_num].iov_len = z->out.pos;
     p->iovs_num++;
@@ -249,7 +249,8 @@ static int multifd_recv_unfill_packet(MultiFDRecvParams *p, Error **errp)
 
     p->flags = be32_to_cpu(packet->flags);
     p->next_packet_size = be32_to_cpu(packet->next_packet_size);
-    p->packet_num = be64_to_cpu(packet->packet_num);
+    /* read by multifd_recv_sync_main() without taking a lock */
+    qatomic_set(&p->packet_num, be64_to_cpu(packet->packet_num));
     p->packets_recved++;
 
     if (!(p->flags & MULTIFD_FLAG_SYNC)) {
@@ -1004,7 +1005,6 @@ static void multifd_recv_cleanup_channel(MultiFDRecvParams *p)
     migration_ioc_unregister_yank(p->c);
     object_unref(OBJECT(p->c));
     p->c = NULL;
-    qemu_mutex_destroy(&p->mutex);
     qemu_sem_destroy(&p->sem_sync);
     qemu_sem_destroy(&p->sem);
     g_free(p->data);
@@ -1103,11 +1103,10 @@ void multifd_recv_sync_main(void)
      */
     for (i = 0; i < thread_count; i++) {
         MultiFDRecvParams *p = &multifd_recv_state->params[i];
+        uint64_t packet_num = qatomic_read(&p->packet_num);
 
-        WITH_QEMU_LOCK_GUARD(&p->mutex) {
-            if (multifd_recv_state->packet_num < p->packet_num) {
-                multifd_recv_state->packet_num = p->packet_num;
-            }
+        if (multifd_recv_state->packet_num < packet_num) {
+            multifd_recv_state->packet_num = packet_num;
         }
         trace_multifd_recv_sync_main_signal(p->id);
         qemu_sem_post(&p->sem_sync);
@@ -1141,10 +1140,8 @@ static void *multifd_recv_thread(void *opaque)
                 break;
             }
 
-            qemu_mutex_lock(&p->mutex);
             ret = multifd_recv_unfill_packet(p, &local_err);
             if (ret) {
-                qemu_mutex_unlock(&p->mutex);
                 break;
             }
 
@@ -1154,7 +1151,6 @@ static void *multifd_recv_thread(void *opaque)
             if (!(flags & MULTIFD_FLAG_SYNC)) {
                 has_data = p->normal_num || p->zero_num;
             }
-            qemu_mutex_unlock(&p->mutex);
         } else {
             /*
              * No packets, so we need to wait for the vmstate code to
@@ -1245,7 +1241,6 @@ int multifd_recv_setup(Error **errp)
     for (i = 0; i < thread_count; i++) {
         MultiFDRecvParams *p = &multifd_recv_state->params[i];
 
-        qemu_mutex_init(&p->mutex);
         qemu_sem_init(&p->sem_sync, 0);
         qemu_sem_init(&p->sem, 0);
         p->pending_job = false;
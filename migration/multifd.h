@@ -192,19 +192,20 @@ typedef struct {
     /* sem where to wait for more work */
     QemuSemaphore sem;
 
-    /* this mutex protects the following parameters */
-    QemuMutex mutex;
-    /* should this thread finish */
-    bool quit;
-    /* multifd flags for each packet */
-    uint32_t flags;
-    /* global number of generated multifd packets */
+    /*
+     * Written by the channel thread, read by the migration thread in
+     * multifd_recv_sync_main() with atomic accesses; the sem_sync
+     * handshake orders the reads against the SYNC packet's update.
+     */
     uint64_t packet_num;
     int pending_job;
     MultiFDRecvData *data;
 
     /* thread local variables. No locking required */
 
+    /* multifd flags for each packet */
+    uint32_t flags;
+
     /* pointer to the packet */
     MultiFDPacket_t *packet;
     /* size of the next packet that contains pages */
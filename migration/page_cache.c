@@ -17,6 +17,7 @@
 #include "qapi/qmp/qerror.h"
 #include "qapi/error.h"
 #include "qemu/host-utils.h"
+#include "qemu/memops.h"
 #include "page_cache.h"
 #include "trace.h"
 
@@ -166,7 +167,16 @@ int cache_insert(PageCache *cache, uint64_t addr, const uint8_t *pdata,
         cache->num_items++;
     }
 
-    memcpy(it->it_data, pdata, cache->page_size);
+    if (it->it_addr == addr) {
+        /*
+         * Refreshing the cached copy of a page we already hold: most
+         * lines usually survive from one sync to the next, so only
+         * write back the ones that changed.
+         */
+        qemu_mem_copy_if_different(it->it_data, pdata, cache->page_size);
+    } else {
+        memcpy(it->it_data, pdata, cache->page_size);
+    }
 
     it->it_age = current_age;
     it->it_addr = addr;
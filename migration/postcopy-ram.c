@@ -1295,8 +1295,12 @@ static int qemu_ufd_copy_ioctl(MigrationIncomingState *mis, void *host_addr,
         /*
          * If this page resolves a page fault for a previous recorded faulted
          * address, take a special note to maintain the requested page list.
+         * Checking the count first keeps the common background-stream case
+         * (no faults outstanding) to a single counter read per page instead
+         * of a tree lookup.
          */
-        if (g_tree_lookup(mis->page_requested, host_addr)) {
+        if (qatomic_read(&mis->page_requested_count) &&
+            g_tree_lookup(mis->page_requested, host_addr)) {
             g_tree_remove(mis->page_requested, host_addr);
             int left_pages = qatomic_dec_fetch(&mis->page_requested_count);
 
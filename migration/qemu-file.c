@@ -34,7 +34,15 @@
 #include "rdma.h"
 #include "io/channel-file.h"
 
-#define IO_BUF_SIZE 32768
+/*
+ * The read side refills in IO_BUF_SIZE chunks, so this bounds the
+ * per-call overhead when restoring vmstate from a block device, where
+ * every refill is a bdrv_load_vmstate() round trip.  256k matches what
+ * the write side already batches per flush (MAX_IOV_SIZE page-sized
+ * iovecs).  Only a handful of QEMUFiles exist at a time, so the larger
+ * embedded buffer is not a concern.
+ */
+#define IO_BUF_SIZE (256 * 1024)
 #define MAX_IOV_SIZE MIN_CONST(IOV_MAX, 64)
 
 struct QEMUFile {
@@ -439,6 +447,19 @@ void qemu_put_buffer(QEMUFile *f, const uint8_t *buf, size_t size)
         return;
     }
 
+    /*
+     * A large write would be chopped into IO_BUF_SIZE staging copies.
+     * Reference the caller's buffer in the iovec instead and flush
+     * before returning, since unlike qemu_put_buffer_async() callers
+     * the caller is free to reuse the buffer immediately.
+     */
+    if (size >= IO_BUF_SIZE) {
+        if (!add_to_iovec(f, buf, size, false)) {
+            qemu_fflush(f);
+        }
+        return;
+    }
+
     while (size > 0) {
         l = IO_BUF_SIZE - f->buf_index;
         if (l > size) {
@@ -32,6 +32,7 @@
 #include "qemu/bitmap.h"
 #include "qemu/madvise.h"
 #include "qemu/main-loop.h"
+#include "qemu/memops.h"
 #include "xbzrle.h"
 #include "ram.h"
 #include "migration.h"
@@ -918,6 +919,17 @@ static void ramblock_sync_dirty_bitmap(RAMState *rs, RAMBlock *rb)
     uint64_t new_dirty_pages =
         cpu_physical_memory_sync_dirty_bitmap(rb, 0, rb->used_length);
 
+    /*
+     * A page that was hinted free but has been written to since must be
+     * migrated like any other; forget the hint.  Dirty pages that were
+     * simply not sent yet lose their hint bit too, which is harmless:
+     * they are in the bitmap and will be sent with their real contents.
+     */
+    if (rb->hint_bmap) {
+        bitmap_andnot(rb->hint_bmap, rb->hint_bmap, rb->bmap,
+                      rb->used_length >> TARGET_PAGE_BITS);
+    }
+
     rs->migration_dirty_pages += new_dirty_pages;
     rs->num_dirty_pages_period += new_dirty_pages;
 }
@@ -982,28 +994,45 @@ static void migration_update_rates(RAMState *rs, int64_t end_time)
     }
 }
 
+/*
+ * Per-vCPU dirty page rate quota (MB/s) currently applied by the
+ * dirty-limit throttle, for query-migrate.  Zero when not throttling.
+ */
+static int64_t dirty_limit_quota_dirtyrate;
+
+int64_t migration_dirty_limit_effective_rate(void)
+{
+    return qatomic_read__nocheck(&dirty_limit_quota_dirtyrate);
+}
+
 /*
  * Enable dirty-limit to throttle down the guest
  */
 static void migration_dirty_limit_guest(void)
 {
-    /*
-     * dirty page rate quota for all vCPUs fetched from
-     * migration parameter 'vcpu_dirty_limit'
-     */
-    static int64_t quota_dirtyrate;
+    int64_t quota_dirtyrate;
     MigrationState *s = migrate_get_current();
+    MachineState *ms = MACHINE(qdev_get_machine());
 
     /*
-     * If dirty limit already enabled and migration parameter
-     * vcpu-dirty-limit untouched.
+     * Rather than stepping blindly, size the per-vCPU quota from the
+     * measured link bandwidth: convergence needs the aggregate dirty
+     * rate below the throttle-trigger-threshold fraction of what the
+     * link moves per period, so give each vCPU an equal share of that
+     * budget.  The vcpu-dirty-limit parameter acts as the ceiling.
      */
+    quota_dirtyrate = (int64_t)(s->mbps / 8 / ms->smp.cpus *
+                                migrate_throttle_trigger_threshold() / 100);
+    quota_dirtyrate = MIN(quota_dirtyrate,
+                          (int64_t)s->parameters.vcpu_dirty_limit);
+    quota_dirtyrate = MAX(quota_dirtyrate, 1);
+
     if (dirtylimit_in_service() &&
-        quota_dirtyrate == s->parameters.vcpu_dirty_limit) {
+        quota_dirtyrate == migration_dirty_limit_effective_rate()) {
         return;
     }
 
-    quota_dirtyrate = s->parameters.vcpu_dirty_limit;
+    qatomic_set__nocheck(&dirty_limit_quota_dirtyrate, quota_dirtyrate);
 
     /*
      * Set all vCPU a quota dirtyrate, note that the second
@@ -1919,6 +1948,26 @@ int ram_save_queue_pages(const char *rbname, ram_addr_t start, ram_addr_t len,
         return -1;
     }
 
+    /*
+     * A request for a page that was dropped from the bitmap as guest-free
+     * means the destination guest is reusing it.  Put it back, so it is
+     * sent like any pending page instead of being mistaken for one that
+     * was already transferred, which would leave the fault unanswered.
+     */
+    qemu_mutex_lock(&rs->bitmap_mutex);
+    if (ramblock->hint_bmap) {
+        unsigned long page = start >> TARGET_PAGE_BITS;
+        unsigned long npages = len >> TARGET_PAGE_BITS;
+
+        for (; npages; page++, npages--) {
+            if (test_and_clear_bit(page, ramblock->hint_bmap) &&
+                !test_and_set_bit(page, ramblock->bmap)) {
+                rs->migration_dirty_pages++;
+            }
+        }
+    }
+    qemu_mutex_unlock(&rs->bitmap_mutex);
+
     /*
      * When with postcopy preempt, we send back the page directly in the
      * rp-return thread.
@@ -2358,6 +2407,8 @@ static void ram_bitmaps_destroy(void)
         block->clear_bmap = NULL;
         g_free(block->bmap);
         block->bmap = NULL;
+        g_free(block->hint_bmap);
+        block->hint_bmap = NULL;
         g_free(block->file_bmap);
         block->file_bmap = NULL;
     }
@@ -2863,6 +2914,15 @@ void qemu_guest_free_page_hint(void *addr, size_t len)
         return;
     }
 
+    /*
+     * Once postcopy has started the destination may already be running on
+     * any page, so dropping pages from the bitmap is no longer safe; late
+     * hints still queued in the balloon device are simply ignored.
+     */
+    if (migration_in_postcopy()) {
+        return;
+    }
+
     for (; len > 0; len -= used_len, addr += used_len) {
         block = qemu_ram_block_from_host(addr, false, &offset);
         if (unlikely(!block || offset >= block->used_length)) {
@@ -2895,6 +2955,15 @@ void qemu_guest_free_page_hint(void *addr, size_t len)
         ram_state->migration_dirty_pages -=
                       bitmap_count_one_with_offset(block->bmap, start, npages);
         bitmap_clear(block->bmap, start, npages);
+        /*
+         * Remember which pages were dropped as free, so a postcopy page
+         * request for one of them can be told apart from a request for a
+         * page that was already sent (see ram_save_queue_pages()).
+         */
+        if (!block->hint_bmap) {
+            block->hint_bmap = bitmap_new(block->max_length >> TARGET_PAGE_BITS);
+        }
+        bitmap_set(block->hint_bmap, start, npages);
         qemu_mutex_unlock(&ram_state->bitmap_mutex);
     }
 }
@@ -3881,7 +3950,12 @@ void colo_flush_ram_cache(void)
                          + (((ram_addr_t)offset) << TARGET_PAGE_BITS);
                 src_host = block->colo_cache
                          + (((ram_addr_t)offset) << TARGET_PAGE_BITS);
-                memcpy(dst_host, src_host, TARGET_PAGE_SIZE * num);
+                /*
+                 * Dirty pages are frequently rewritten with identical
+                 * content, so only touch the lines that changed.
+                 */
+                qemu_mem_copy_if_different(dst_host, src_host,
+                                           TARGET_PAGE_SIZE * num);
                 offset += num;
             }
         }
@@ -100,6 +100,22 @@ static void vmstate_handle_alloc(void *ptr, const VMStateField *field,
     }
 }
 
+/*
+ * Byte-wide scalar arrays are stored element by element on the wire, so
+ * one buffer access produces exactly the same bytes as a get()/put()
+ * call per element; large arrays (NVRAM contents, FIFOs) are common
+ * enough in device state that the per-element calls show up at
+ * switchover time.
+ */
+static bool vmstate_field_is_byte_array(const VMStateField *field, int size,
+                                        int n_elems)
+{
+    return n_elems > 1 && size == 1 &&
+           !(field->flags & VMS_ARRAY_OF_POINTER) &&
+           (field->info == &vmstate_info_uint8 ||
+            field->info == &vmstate_info_int8);
+}
+
 int vmstate_load_state(QEMUFile *f, const VMStateDescription *vmsd,
                        void *opaque, int version_id)
 {
@@ -140,6 +156,19 @@ int vmstate_load_state(QEMUFile *f, const VMStateDescription *vmsd,
                 first_elem = *(void **)first_elem;
                 assert(first_elem || !n_elems || !size);
             }
+            if (vmstate_field_is_byte_array(field, size, n_elems)) {
+                /* One read instead of a get() call per element */
+                qemu_get_buffer(f, first_elem, n_elems);
+                ret = qemu_file_get_error(f);
+                if (ret < 0) {
+                    error_report("Failed to load %s:%s", vmsd->name,
+                                 field->name);
+                    trace_vmstate_load_field_error(field->name, ret);
+                    return ret;
+                }
+                /* All elements consumed, skip the per-element loop */
+                n_elems = 0;
+            }
             for (i = 0; i < n_elems; i++) {
                 void *curr_elem = first_elem + size * i;
 
@@ -384,6 +413,18 @@ int vmstate_save_state_v(QEMUFile *f, const VMStateDescription *vmsd,
                 first_elem = *(void **)first_elem;
                 assert(first_elem || !n_elems || !size);
             }
+            if (vmstate_field_is_byte_array(field, size, n_elems) &&
+                (!vmdesc || vmsd_can_compress(field))) {
+                /*
+                 * One write instead of a put() call per element; the
+                 * vmdesc entry matches the compressed form the loop
+                 * would emit for element 0.
+                 */
+                vmsd_desc_field_start(vmsd, vmdesc_loop, field, 0, n_elems);
+                qemu_put_buffer(f, first_elem, n_elems);
+                vmsd_desc_field_end(vmsd, vmdesc_loop, field, size, 0);
+                n_elems = 0;
+            }
             for (i = 0; i < n_elems; i++) {
                 void *curr_elem = first_elem + size * i;
 
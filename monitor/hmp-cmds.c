@@ -28,6 +28,8 @@
 #include "qapi/qmp/qdict.h"
 #include "qemu/cutils.h"
 #include "qemu/log.h"
+#include "qemu/main-loop.h"
+#include "sysemu/cpus.h"
 #include "sysemu/sysemu.h"
 
 bool hmp_handle_error(Monitor *mon, Error *err)
@@ -118,6 +120,66 @@ void hmp_sync_profile(Monitor *mon, const QDict *qdict)
     }
 }
 
+void hmp_bql_profile(Monitor *mon, const QDict *qdict)
+{
+    const char *op = qdict_get_try_str(qdict, "op");
+
+    if (op == NULL) {
+        bool on = bql_prof_is_enabled();
+
+        monitor_printf(mon, "bql-profile is %s\n", on ? "on" : "off");
+        return;
+    }
+    if (!strcmp(op, "on")) {
+        bql_prof_enable(true);
+    } else if (!strcmp(op, "off")) {
+        bql_prof_enable(false);
+    } else if (!strcmp(op, "reset")) {
+        bql_prof_reset();
+    } else {
+        Error *err = NULL;
+
+        error_setg(&err, "invalid parameter '%s',"
+                   " expecting 'on', 'off', or 'reset'", op);
+        hmp_handle_error(mon, err);
+    }
+}
+
+void hmp_info_bql_profile(Monitor *mon, const QDict *qdict)
+{
+    hmp_human_readable_text_helper(mon, qmp_x_query_bql_profile);
+}
+
+void hmp_vcpu_profile(Monitor *mon, const QDict *qdict)
+{
+    const char *op = qdict_get_try_str(qdict, "op");
+
+    if (op == NULL) {
+        bool on = vcpu_prof_is_enabled();
+
+        monitor_printf(mon, "vcpu-profile is %s\n", on ? "on" : "off");
+        return;
+    }
+    if (!strcmp(op, "on")) {
+        vcpu_prof_enable(true);
+    } else if (!strcmp(op, "off")) {
+        vcpu_prof_enable(false);
+    } else if (!strcmp(op, "reset")) {
+        vcpu_prof_reset();
+    } else {
+        Error *err = NULL;
+
+        error_setg(&err, "invalid parameter '%s',"
+                   " expecting 'on', 'off', or 'reset'", op);
+        hmp_handle_error(mon, err);
+    }
+}
+
+void hmp_info_vcpu_profile(Monitor *mon, const QDict *qdict)
+{
+    hmp_human_readable_text_helper(mon, qmp_x_query_profile);
+}
+
 void hmp_exit_preconfig(Monitor *mon, const QDict *qdict)
 {
     Error *err = NULL;
@@ -29,6 +29,7 @@
 #include "qapi/qapi-emit-events.h"
 #include "qapi/qapi-visit-control.h"
 #include "qapi/qmp/qdict.h"
+#include "qapi/qmp/qjson.h"
 #include "qemu/error-report.h"
 #include "qemu/option.h"
 #include "sysemu/qtest.h"
@@ -337,17 +338,41 @@ static void monitor_qapi_event_emit(QAPIEvent event, QDict *qdict)
 {
     Monitor *mon;
     MonitorQMP *qmp_mon;
+    GString *json[2] = { NULL, NULL };
 
     trace_monitor_protocol_event_emit(event, qdict);
     QTAILQ_FOREACH(mon, &mon_list, entry) {
+        bool pretty;
+
         if (!monitor_is_qmp(mon)) {
             continue;
         }
 
         qmp_mon = container_of(mon, MonitorQMP, common);
-        if (qmp_mon->commands != &qmp_cap_negotiation_commands) {
-            qmp_send_response(qmp_mon, qdict);
+        if (qmp_mon->commands == &qmp_cap_negotiation_commands) {
+            continue;
         }
+
+        /*
+         * Serialize the event once per output flavour and share the
+         * result between monitors instead of re-encoding the QDict for
+         * every subscriber.
+         */
+        pretty = qmp_mon->pretty;
+        if (!json[pretty]) {
+            json[pretty] = qobject_to_json_pretty(QOBJECT(qdict), pretty);
+            assert(json[pretty] != NULL);
+            g_string_append_c(json[pretty], '\n');
+        }
+        trace_monitor_qmp_respond(qmp_mon, json[pretty]->str);
+        monitor_puts(mon, json[pretty]->str);
+    }
+
+    if (json[0]) {
+        g_string_free(json[0], true);
+    }
+    if (json[1]) {
+        g_string_free(json[1], true);
     }
 }
 
@@ -14,6 +14,7 @@
  */
 
 #include "qemu/osdep.h"
+#include "qemu/lock-stats.h"
 #include "qemu/sockets.h"
 #include "monitor-internal.h"
 #include "monitor/qdev.h"
@@ -40,6 +41,27 @@ NameInfo *qmp_query_name(Error **errp)
     return info;
 }
 
+static void query_lock_stats_one(QemuMutexStats *stats, void *opaque)
+{
+    LockStatsInfoList ***tail = opaque;
+    LockStatsInfo *info = g_new0(LockStatsInfo, 1);
+
+    info->name = g_strdup(stats->name);
+    info->contentions = stat64_get(&stats->contentions);
+    info->total_wait = stat64_get(&stats->total_wait_ns);
+    info->max_wait = stat64_get(&stats->max_wait_ns);
+    QAPI_LIST_APPEND(*tail, info);
+}
+
+LockStatsInfoList *qmp_query_lock_stats(Error **errp)
+{
+    LockStatsInfoList *head = NULL;
+    LockStatsInfoList **tail = &head;
+
+    qemu_mutex_stats_foreach(query_lock_stats_one, &tail);
+    return head;
+}
+
 void qmp_quit(Error **errp)
 {
     shutdown_action = SHUTDOWN_ACTION_POWEROFF;
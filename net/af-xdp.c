@@ -43,6 +43,7 @@ typedef struct AFXDPState {
     bool                 read_poll;
     bool                 write_poll;
     uint32_t             outstanding_tx;
+    uint32_t             rx_burst_avg;
 
     uint64_t             *pool;
     uint32_t             n_pool;
@@ -147,8 +148,16 @@ static ssize_t af_xdp_receive(NetClientState *nc,
     uint32_t idx;
     void *data;
 
-    /* Try to recover buffers that are already sent. */
-    af_xdp_complete_tx(s);
+    /*
+     * Recover buffers that are already sent, but only once enough
+     * completions have accumulated or the frame pool runs low; walking
+     * the completion ring for every transmitted packet costs more than
+     * the send itself.
+     */
+    if (s->n_pool < AF_XDP_BATCH_SIZE ||
+        s->outstanding_tx >= AF_XDP_BATCH_SIZE) {
+        af_xdp_complete_tx(s);
+    }
 
     if (size > XSK_UMEM__DEFAULT_FRAME_SIZE) {
         /* We can't transmit packet this size... */
@@ -254,7 +263,16 @@ static void af_xdp_send(void *opaque)
 
     /* Release actually sent descriptors and try to re-fill. */
     xsk_ring_cons__release(&s->rx, n_rx);
-    af_xdp_fq_refill(s, AF_XDP_BATCH_SIZE);
+
+    /*
+     * Size the refill from recent burst statistics: under sustained load
+     * (full batches on most callbacks) keep the fill queue deeper so the
+     * kernel does not starve for frames between callbacks, while idle
+     * links keep the smaller refill.
+     */
+    s->rx_burst_avg = (3 * s->rx_burst_avg + n_rx) / 4;
+    af_xdp_fq_refill(s, s->rx_burst_avg > AF_XDP_BATCH_SIZE / 2 ?
+                        2 * AF_XDP_BATCH_SIZE : AF_XDP_BATCH_SIZE);
 }
 
 /* Flush and close. */
@@ -333,6 +351,28 @@ static int af_xdp_umem_create(AFXDPState *s, int sock_fd, Error **errp)
     return 0;
 }
 
+/*
+ * Bind the socket, negotiating zero-copy mode: unless copy mode was forced
+ * or the program runs in skb mode, request XDP_ZEROCOPY first and fall back
+ * to letting the kernel choose when the driver does not support it.
+ */
+static int af_xdp_socket_bind(AFXDPState *s, int queue_id,
+                              struct xsk_socket_config *cfg)
+{
+    if (!(cfg->bind_flags & XDP_COPY) &&
+        !(cfg->xdp_flags & XDP_FLAGS_SKB_MODE)) {
+        cfg->bind_flags |= XDP_ZEROCOPY;
+        if (!xsk_socket__create(&s->xsk, s->ifname, queue_id,
+                                s->umem, &s->rx, &s->tx, cfg)) {
+            return 0;
+        }
+        cfg->bind_flags &= ~XDP_ZEROCOPY;
+    }
+
+    return xsk_socket__create(&s->xsk, s->ifname, queue_id,
+                              s->umem, &s->rx, &s->tx, cfg);
+}
+
 static int af_xdp_socket_create(AFXDPState *s,
                                 const NetdevAFXDPOptions *opts, Error **errp)
 {
@@ -363,22 +403,19 @@ static int af_xdp_socket_create(AFXDPState *s,
         /* Specific mode requested. */
         cfg.xdp_flags |= (opts->mode == AFXDP_MODE_NATIVE)
                          ? XDP_FLAGS_DRV_MODE : XDP_FLAGS_SKB_MODE;
-        if (xsk_socket__create(&s->xsk, s->ifname, queue_id,
-                               s->umem, &s->rx, &s->tx, &cfg)) {
+        if (af_xdp_socket_bind(s, queue_id, &cfg)) {
             error = errno;
         }
     } else {
         /* No mode requested, try native first. */
         cfg.xdp_flags |= XDP_FLAGS_DRV_MODE;
 
-        if (xsk_socket__create(&s->xsk, s->ifname, queue_id,
-                               s->umem, &s->rx, &s->tx, &cfg)) {
+        if (af_xdp_socket_bind(s, queue_id, &cfg)) {
             /* Can't use native mode, try skb. */
             cfg.xdp_flags &= ~XDP_FLAGS_DRV_MODE;
             cfg.xdp_flags |= XDP_FLAGS_SKB_MODE;
 
-            if (xsk_socket__create(&s->xsk, s->ifname, queue_id,
-                                   s->umem, &s->rx, &s->tx, &cfg)) {
+            if (af_xdp_socket_bind(s, queue_id, &cfg)) {
                 error = errno;
             }
         }
@@ -249,11 +249,11 @@ static int packet_enqueue(CompareState *s, int mode, Connection **con)
     int ret;
 
     if (mode == PRIMARY_IN) {
-        pkt = packet_new(s->pri_rs.buf,
+        pkt = packet_new(s->pri_rs.data,
                          s->pri_rs.packet_len,
                          s->pri_rs.vnet_hdr_len);
     } else {
-        pkt = packet_new(s->sec_rs.buf,
+        pkt = packet_new(s->sec_rs.data,
                          s->sec_rs.packet_len,
                          s->sec_rs.vnet_hdr_len);
     }
@@ -343,6 +343,30 @@ static int colo_compare_packet_payload(Packet *ppkt,
     return memcmp(ppkt->data + poffset, spkt->data + soffset, len);
 }
 
+/*
+ * The transport checksum summarizes the whole datagram and, for UDP and
+ * ICMP, the checksum field itself lies inside the region that
+ * colo_compare_packet_payload() compares.  So when the two fields differ
+ * the full memcmp can only fail as well, and checking them first keeps
+ * the quadratic list scan in colo_compare_packet() cheap while packets
+ * wait for their peer to arrive.  When the fields match (or the packet
+ * is too short to carry one) we still fall through to the memcmp.
+ */
+static bool colo_packet_checksum_differs(Packet *ppkt, Packet *spkt,
+                                         uint16_t offset, uint16_t sum_offset)
+{
+    uint16_t psum, ssum;
+
+    if (ppkt->size < offset + sum_offset + sizeof(uint16_t)) {
+        return false;
+    }
+
+    memcpy(&psum, (uint8_t *)ppkt->data + offset + sum_offset, sizeof(psum));
+    memcpy(&ssum, (uint8_t *)spkt->data + offset + sum_offset, sizeof(ssum));
+
+    return psum != ssum;
+}
+
 /*
  * return true means that the payload is consist and
  * need to make the next comparison, false means do
@@ -526,6 +550,11 @@ static int colo_packet_compare_udp(Packet *spkt, Packet *ppkt)
         trace_colo_compare_main("UDP: payload size of packets are different");
         return -1;
     }
+    if (colo_packet_checksum_differs(ppkt, spkt, offset,
+                                     offsetof(struct udp_hdr, uh_sum))) {
+        trace_colo_compare_main("UDP: checksum of packets are different");
+        return -1;
+    }
     if (colo_compare_packet_payload(ppkt, spkt, offset, offset,
                                     ppkt->size - offset)) {
         trace_colo_compare_udp_miscompare("primary pkt size", ppkt->size);
@@ -565,6 +594,11 @@ static int colo_packet_compare_icmp(Packet *spkt, Packet *ppkt)
         trace_colo_compare_main("ICMP: payload size of packets are different");
         return -1;
     }
+    /* the ICMP checksum sits two bytes into the ICMP header */
+    if (colo_packet_checksum_differs(ppkt, spkt, offset, 2)) {
+        trace_colo_compare_main("ICMP: checksum of packets are different");
+        return -1;
+    }
     if (colo_compare_packet_payload(ppkt, spkt, offset, offset,
                                     ppkt->size - offset)) {
         trace_colo_compare_icmp_miscompare("primary pkt size",
@@ -1155,7 +1189,7 @@ static void compare_pri_rs_finalize(SocketReadState *pri_rs)
     if (packet_enqueue(s, PRIMARY_IN, &conn)) {
         trace_colo_compare_main("primary: unsupported packet in");
         compare_chr_send(s,
-                         pri_rs->buf,
+                         (uint8_t *)pri_rs->data,
                          pri_rs->packet_len,
                          pri_rs->vnet_hdr_len,
                          false,
@@ -1187,14 +1221,14 @@ static void compare_notify_rs_finalize(SocketReadState *notify_rs)
     int ret;
 
     if (packet_matches_str("COLO_USERSPACE_PROXY_INIT",
-                           notify_rs->buf,
+                           notify_rs->data,
                            notify_rs->packet_len)) {
         ret = compare_chr_send(s, (uint8_t *)msg, strlen(msg), 0, true, false);
         if (ret < 0) {
             error_report("Notify Xen COLO-frame INIT failed");
         }
     } else if (packet_matches_str("COLO_CHECKPOINT",
-                                  notify_rs->buf,
+                                  notify_rs->data,
                                   notify_rs->packet_len)) {
         /* colo-compare do checkpoint, flush pri packet and remove sec packet */
         g_queue_foreach(&s->conn_list, colo_flush_packets, s);
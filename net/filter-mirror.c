@@ -272,7 +272,7 @@ static void redirector_rs_finalize(SocketReadState *rs)
     MirrorState *s = container_of(rs, MirrorState, rs);
     NetFilterState *nf = NETFILTER(s);
 
-    redirector_to_filter(nf, rs->buf, rs->packet_len);
+    redirector_to_filter(nf, rs->data, rs->packet_len);
 }
 
 static void filter_redirector_setup(NetFilterState *nf, Error **errp)
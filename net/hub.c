@@ -16,17 +16,28 @@
 #include "qapi/error.h"
 #include "monitor/monitor.h"
 #include "net/net.h"
+#include "net/eth.h"
 #include "clients.h"
 #include "hub.h"
 #include "qemu/iov.h"
+#include "qemu/timer.h"
 #include "qemu/error-report.h"
 #include "sysemu/qtest.h"
 
 /*
  * A hub broadcasts incoming packets to all its ports except the source port.
  * Hubs can be used to provide independent emulated network segments.
+ *
+ * To avoid copying every frame to every port, the hub learns which port a
+ * source MAC address lives behind and delivers unicast frames with a known
+ * destination to that port only, like a learning switch.  Broadcast,
+ * multicast and unknown-destination frames are still flooded, and learned
+ * entries age out so a MAC that moves between ports recovers on its own.
  */
 
+#define NET_HUB_FDB_SIZE 64
+#define NET_HUB_FDB_AGE_NS (60 * NANOSECONDS_PER_SECOND)
+
 typedef struct NetHub NetHub;
 
 typedef struct NetHubPort {
@@ -36,20 +47,89 @@ typedef struct NetHubPort {
     int id;
 } NetHubPort;
 
+typedef struct NetHubFDBEntry {
+    uint8_t mac[ETH_ALEN];
+    NetHubPort *port;   /* NULL if the entry is unused */
+    int64_t expires;
+} NetHubFDBEntry;
+
 struct NetHub {
     int id;
     QLIST_ENTRY(NetHub) next;
     int num_ports;
     QLIST_HEAD(, NetHubPort) ports;
+    NetHubFDBEntry fdb[NET_HUB_FDB_SIZE];
 };
 
 static QLIST_HEAD(, NetHub) hubs = QLIST_HEAD_INITIALIZER(&hubs);
 
+static NetHubFDBEntry *net_hub_fdb_entry(NetHub *hub, const uint8_t *mac)
+{
+    /* The low bytes of a MAC carry most of the entropy */
+    unsigned int slot = (mac[3] ^ mac[4] ^ mac[5]) % NET_HUB_FDB_SIZE;
+
+    return &hub->fdb[slot];
+}
+
+/*
+ * Record which port a source MAC was last seen on and return the port a
+ * unicast destination was learned on, or NULL if the frame must be
+ * flooded.  @hdr must cover the destination and source MAC addresses.
+ */
+static NetHubPort *net_hub_fdb_update(NetHub *hub, NetHubPort *source_port,
+                                      const uint8_t *hdr)
+{
+    const uint8_t *dst_mac = hdr;
+    const uint8_t *src_mac = hdr + ETH_ALEN;
+    int64_t now = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
+    NetHubFDBEntry *entry;
+
+    /* Group bit set on a source address means a malformed frame */
+    if (!(src_mac[0] & 0x01)) {
+        entry = net_hub_fdb_entry(hub, src_mac);
+        memcpy(entry->mac, src_mac, ETH_ALEN);
+        entry->port = source_port;
+        entry->expires = now + NET_HUB_FDB_AGE_NS;
+    }
+
+    if (dst_mac[0] & 0x01) {
+        return NULL; /* broadcast/multicast, flood */
+    }
+
+    entry = net_hub_fdb_entry(hub, dst_mac);
+    if (entry->port && entry->port != source_port &&
+        now < entry->expires &&
+        memcmp(entry->mac, dst_mac, ETH_ALEN) == 0) {
+        return entry->port;
+    }
+
+    return NULL;
+}
+
+static void net_hub_fdb_flush_port(NetHub *hub, NetHubPort *port)
+{
+    int i;
+
+    for (i = 0; i < NET_HUB_FDB_SIZE; i++) {
+        if (hub->fdb[i].port == port) {
+            hub->fdb[i].port = NULL;
+        }
+    }
+}
+
 static ssize_t net_hub_receive(NetHub *hub, NetHubPort *source_port,
                                const uint8_t *buf, size_t len)
 {
     NetHubPort *port;
 
+    if (len >= 2 * ETH_ALEN) {
+        port = net_hub_fdb_update(hub, source_port, buf);
+        if (port) {
+            qemu_send_packet(&port->nc, buf, len);
+            return len;
+        }
+    }
+
     QLIST_FOREACH(port, &hub->ports, next) {
         if (port == source_port) {
             continue;
@@ -65,6 +145,15 @@ static ssize_t net_hub_receive_iov(NetHub *hub, NetHubPort *source_port,
 {
     NetHubPort *port;
     ssize_t len = iov_size(iov, iovcnt);
+    uint8_t hdr[2 * ETH_ALEN];
+
+    if (iov_to_buf(iov, iovcnt, 0, hdr, sizeof(hdr)) == sizeof(hdr)) {
+        port = net_hub_fdb_update(hub, source_port, hdr);
+        if (port) {
+            qemu_sendv_packet(&port->nc, iov, iovcnt);
+            return len;
+        }
+    }
 
     QLIST_FOREACH(port, &hub->ports, next) {
         if (port == source_port) {
@@ -80,7 +169,7 @@ static NetHub *net_hub_new(int id)
 {
     NetHub *hub;
 
-    hub = g_malloc(sizeof(*hub));
+    hub = g_malloc0(sizeof(*hub));
     hub->id = id;
     hub->num_ports = 0;
     QLIST_INIT(&hub->ports);
@@ -129,6 +218,7 @@ static void net_hub_port_cleanup(NetClientState *nc)
 {
     NetHubPort *port = DO_UPCAST(NetHubPort, nc, nc);
 
+    net_hub_fdb_flush_port(port->hub, port);
     QLIST_REMOVE(port, next);
 }
 
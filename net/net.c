@@ -2017,6 +2017,7 @@ void net_socket_rs_init(SocketReadState *rs,
     rs->packet_len = 0;
     rs->vnet_hdr_len = 0;
     memset(rs->buf, 0, sizeof(rs->buf));
+    rs->data = rs->buf;
     rs->finalize = finalize;
 }
 
@@ -2078,6 +2079,21 @@ int net_fill_rstate(SocketReadState *rs, const uint8_t *buf, int size)
             if (l > size) {
                 l = size;
             }
+            if (rs->index == 0 && l == rs->packet_len &&
+                l <= sizeof(rs->buf)) {
+                /*
+                 * The whole packet is sitting in the caller's buffer:
+                 * hand it to the finalize callback in place instead of
+                 * reassembling it in rs->buf.
+                 */
+                rs->data = buf;
+                buf += l;
+                size -= l;
+                rs->state = 0;
+                assert(rs->finalize);
+                rs->finalize(rs);
+                break;
+            }
             if (rs->index + l <= sizeof(rs->buf)) {
                 memcpy(rs->buf + rs->index, buf, l);
             } else {
@@ -2093,6 +2109,7 @@ int net_fill_rstate(SocketReadState *rs, const uint8_t *buf, int size)
             if (rs->index >= rs->packet_len) {
                 rs->index = 0;
                 rs->state = 0;
+                rs->data = rs->buf;
                 assert(rs->finalize);
                 rs->finalize(rs);
             }
@@ -45,10 +45,20 @@ struct NetPacket {
     NetClientState *sender;
     unsigned flags;
     int size;
+    size_t alloc_size; /* usable bytes in data[], for recycling */
     NetPacketSent *sent_cb;
     uint8_t data[];
 };
 
+/*
+ * Deferred packets are allocated and freed at a high rate when a peer
+ * applies backpressure (filter chains do this for every packet), so
+ * delivered packets are parked on a small free list and reused instead
+ * of going back to the allocator.
+ */
+#define NET_QUEUE_PACKET_CACHE_LEN 32
+#define NET_QUEUE_PACKET_CACHE_MAX_BYTES (68 * 1024)
+
 struct NetQueue {
     void *opaque;
     uint32_t nq_maxlen;
@@ -56,10 +66,44 @@ struct NetQueue {
     NetQueueDeliverFunc *deliver;
 
     QTAILQ_HEAD(, NetPacket) packets;
+    QTAILQ_HEAD(, NetPacket) free_packets;
+    uint32_t nq_free_count;
 
     unsigned delivering : 1;
 };
 
+static NetPacket *qemu_net_queue_packet_new(NetQueue *queue, size_t size)
+{
+    NetPacket *packet;
+    size_t alloc_size;
+
+    QTAILQ_FOREACH(packet, &queue->free_packets, entry) {
+        if (packet->alloc_size >= size) {
+            QTAILQ_REMOVE(&queue->free_packets, packet, entry);
+            queue->nq_free_count--;
+            return packet;
+        }
+    }
+
+    /* Round up so a recycled packet can carry most later payloads */
+    alloc_size = ROUND_UP(size, 2048);
+    packet = g_malloc(sizeof(NetPacket) + alloc_size);
+    packet->alloc_size = alloc_size;
+    return packet;
+}
+
+static void qemu_net_queue_packet_free(NetQueue *queue, NetPacket *packet)
+{
+    if (queue->nq_free_count >= NET_QUEUE_PACKET_CACHE_LEN ||
+        packet->alloc_size > NET_QUEUE_PACKET_CACHE_MAX_BYTES) {
+        g_free(packet);
+        return;
+    }
+
+    QTAILQ_INSERT_HEAD(&queue->free_packets, packet, entry);
+    queue->nq_free_count++;
+}
+
 NetQueue *qemu_new_net_queue(NetQueueDeliverFunc *deliver, void *opaque)
 {
     NetQueue *queue;
@@ -72,6 +116,7 @@ NetQueue *qemu_new_net_queue(NetQueueDeliverFunc *deliver, void *opaque)
     queue->deliver = deliver;
 
     QTAILQ_INIT(&queue->packets);
+    QTAILQ_INIT(&queue->free_packets);
 
     queue->delivering = 0;
 
@@ -87,6 +132,11 @@ void qemu_del_net_queue(NetQueue *queue)
         g_free(packet);
     }
 
+    QTAILQ_FOREACH_SAFE(packet, &queue->free_packets, entry, next) {
+        QTAILQ_REMOVE(&queue->free_packets, packet, entry);
+        g_free(packet);
+    }
+
     g_free(queue);
 }
 
@@ -102,7 +152,7 @@ static void qemu_net_queue_append(NetQueue *queue,
     if (queue->nq_count >= queue->nq_maxlen && !sent_cb) {
         return; /* drop if queue full and no callback */
     }
-    packet = g_malloc(sizeof(NetPacket) + size);
+    packet = qemu_net_queue_packet_new(queue, size);
     packet->sender = sender;
     packet->flags = flags;
     packet->size = size;
@@ -131,7 +181,7 @@ void qemu_net_queue_append_iov(NetQueue *queue,
         max_len += iov[i].iov_len;
     }
 
-    packet = g_malloc(sizeof(NetPacket) + max_len);
+    packet = qemu_net_queue_packet_new(queue, max_len);
     packet->sender = sender;
     packet->sent_cb = sent_cb;
     packet->flags = flags;
@@ -254,7 +304,7 @@ void qemu_net_queue_purge(NetQueue *queue, NetClientState *from)
             if (packet->sent_cb) {
                 packet->sent_cb(packet->sender, 0);
             }
-            g_free(packet);
+            qemu_net_queue_packet_free(queue, packet);
         }
     }
 }
@@ -287,7 +337,7 @@ bool qemu_net_queue_flush(NetQueue *queue)
             packet->sent_cb(packet->sender, ret);
         }
 
-        g_free(packet);
+        qemu_net_queue_packet_free(queue, packet);
     }
     return true;
 }
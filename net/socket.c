@@ -145,7 +145,7 @@ static void net_socket_rs_finalize(SocketReadState *rs)
 {
     NetSocketState *s = container_of(rs, NetSocketState, rs);
 
-    if (qemu_send_packet_async(&s->nc, rs->buf,
+    if (qemu_send_packet_async(&s->nc, rs->data,
                                rs->packet_len,
                                net_socket_send_completed) == 0) {
         net_socket_read_poll(s, false);
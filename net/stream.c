@@ -51,6 +51,8 @@ typedef struct NetStreamState {
     guint ioc_write_tag;
     SocketReadState rs;
     unsigned int send_index;      /* number of bytes sent*/
+    struct iovec *tx_iov;         /* recycled array for the length header */
+    int tx_iov_len;
     uint32_t reconnect;
     guint timer_tag;
     SocketAddress *addr;
@@ -74,28 +76,48 @@ static gboolean net_stream_writable(QIOChannel *ioc,
     return G_SOURCE_REMOVE;
 }
 
-static ssize_t net_stream_receive(NetClientState *nc, const uint8_t *buf,
-                                  size_t size)
+static ssize_t net_stream_receive_iov(NetClientState *nc,
+                                      const struct iovec *iov, int iovcnt)
 {
     NetStreamState *s = DO_UPCAST(NetStreamState, nc, nc);
+    size_t size = iov_size(iov, iovcnt);
     uint32_t len = htonl(size);
-    struct iovec iov[] = {
-        {
-            .iov_base = &len,
-            .iov_len  = sizeof(len),
-        }, {
-            .iov_base = (void *)buf,
-            .iov_len  = size,
-        },
-    };
-    struct iovec local_iov[2];
-    unsigned int nlocal_iov;
-    size_t remaining;
+    size_t skip = s->send_index;
+    size_t remaining = sizeof(len) + size - skip;
+    unsigned int nlocal_iov = 0;
     ssize_t ret;
+    int i;
+
+    if (s->tx_iov_len < iovcnt + 1) {
+        s->tx_iov = g_renew(struct iovec, s->tx_iov, iovcnt + 1);
+        s->tx_iov_len = iovcnt + 1;
+    }
 
-    remaining = iov_size(iov, 2) - s->send_index;
-    nlocal_iov = iov_copy(local_iov, 2, iov, 2, s->send_index, remaining);
-    ret = qio_channel_writev(s->ioc, local_iov, nlocal_iov, NULL);
+    /*
+     * Prepend the length header and skip whatever a previous partial
+     * write already pushed out; the peer resends the same payload until
+     * we report it complete.
+     */
+    if (skip < sizeof(len)) {
+        s->tx_iov[nlocal_iov].iov_base = (uint8_t *)&len + skip;
+        s->tx_iov[nlocal_iov].iov_len = sizeof(len) - skip;
+        nlocal_iov++;
+        skip = 0;
+    } else {
+        skip -= sizeof(len);
+    }
+    for (i = 0; i < iovcnt; i++) {
+        if (skip >= iov[i].iov_len) {
+            skip -= iov[i].iov_len;
+            continue;
+        }
+        s->tx_iov[nlocal_iov].iov_base = (uint8_t *)iov[i].iov_base + skip;
+        s->tx_iov[nlocal_iov].iov_len = iov[i].iov_len - skip;
+        nlocal_iov++;
+        skip = 0;
+    }
+
+    ret = qio_channel_writev(s->ioc, s->tx_iov, nlocal_iov, NULL);
     if (ret == QIO_CHANNEL_ERR_BLOCK) {
         ret = 0; /* handled further down */
     }
@@ -113,6 +135,17 @@ static ssize_t net_stream_receive(NetClientState *nc, const uint8_t *buf,
     return size;
 }
 
+static ssize_t net_stream_receive(NetClientState *nc, const uint8_t *buf,
+                                  size_t size)
+{
+    struct iovec iov = {
+        .iov_base = (void *)buf,
+        .iov_len  = size,
+    };
+
+    return net_stream_receive_iov(nc, &iov, 1);
+}
+
 static gboolean net_stream_send(QIOChannel *ioc,
                                 GIOCondition condition,
                                 gpointer data);
@@ -131,7 +164,7 @@ static void net_stream_rs_finalize(SocketReadState *rs)
 {
     NetStreamState *s = container_of(rs, NetStreamState, rs);
 
-    if (qemu_send_packet_async(&s->nc, rs->buf,
+    if (qemu_send_packet_async(&s->nc, rs->data,
                                rs->packet_len,
                                net_stream_send_completed) == 0) {
         if (s->ioc_read_tag) {
@@ -225,12 +258,16 @@ static void net_stream_cleanup(NetClientState *nc)
         object_unref(OBJECT(s->listen_ioc));
         s->listen_ioc = NULL;
     }
+    g_free(s->tx_iov);
+    s->tx_iov = NULL;
+    s->tx_iov_len = 0;
 }
 
 static NetClientInfo net_stream_info = {
     .type = NET_CLIENT_DRIVER_STREAM,
     .size = sizeof(NetStreamState),
     .receive = net_stream_receive,
+    .receive_iov = net_stream_receive_iov,
     .cleanup = net_stream_cleanup,
 };
 
@@ -53,6 +53,9 @@ typedef struct TAPState {
     char down_script[1024];
     char down_script_arg[128];
     uint8_t buf[NET_BUFSIZE];
+    /* Recycled iovec array for prepending the vnet header on transmit */
+    struct iovec *tx_iov;
+    int tx_iov_len;
     bool read_poll;
     bool write_poll;
     bool using_vnet_hdr;
@@ -118,15 +121,22 @@ static ssize_t tap_receive_iov(NetClientState *nc, const struct iovec *iov,
 {
     TAPState *s = DO_UPCAST(TAPState, nc, nc);
     const struct iovec *iovp = iov;
-    g_autofree struct iovec *iov_copy = NULL;
     struct virtio_net_hdr hdr = { };
 
     if (s->host_vnet_hdr_len && !s->using_vnet_hdr) {
-        iov_copy = g_new(struct iovec, iovcnt + 1);
-        iov_copy[0].iov_base = &hdr;
-        iov_copy[0].iov_len =  s->host_vnet_hdr_len;
-        memcpy(&iov_copy[1], iov, iovcnt * sizeof(*iov));
-        iovp = iov_copy;
+        /*
+         * Recycle the iovec array across packets instead of allocating one
+         * per transmitted packet; this path runs for every packet when the
+         * peer does not supply a vnet header itself.
+         */
+        if (s->tx_iov_len < iovcnt + 1) {
+            s->tx_iov = g_renew(struct iovec, s->tx_iov, iovcnt + 1);
+            s->tx_iov_len = iovcnt + 1;
+        }
+        s->tx_iov[0].iov_base = &hdr;
+        s->tx_iov[0].iov_len =  s->host_vnet_hdr_len;
+        memcpy(&s->tx_iov[1], iov, iovcnt * sizeof(*iov));
+        iovp = s->tx_iov;
         iovcnt++;
     }
 
@@ -303,6 +313,9 @@ static void tap_cleanup(NetClientState *nc)
 
     tap_read_poll(s, false);
     tap_write_poll(s, false);
+    g_free(s->tx_iov);
+    s->tx_iov = NULL;
+    s->tx_iov_len = 0;
     close(s->fd);
     s->fd = -1;
 }
@@ -367,6 +367,37 @@ void plugin_register_inline_op_on_entry(GArray **arr,
     dyn_cb->inline_insn = inline_cb;
 }
 
+static enum plugin_dyn_cb_type op_to_range_cb_type(enum qemu_plugin_op op)
+{
+    switch (op) {
+    case QEMU_PLUGIN_INLINE_ADD_U64:
+        return PLUGIN_CB_INLINE_RANGE_ADD_U64;
+    case QEMU_PLUGIN_INLINE_STORE_U64:
+        return PLUGIN_CB_INLINE_RANGE_STORE_U64;
+    default:
+        g_assert_not_reached();
+    }
+}
+
+void plugin_register_inline_range_op_on_entry(GArray **arr,
+                                              enum qemu_plugin_mem_rw rw,
+                                              uint64_t low, uint64_t high,
+                                              enum qemu_plugin_op op,
+                                              qemu_plugin_u64 entry,
+                                              uint64_t imm)
+{
+    struct qemu_plugin_dyn_cb *dyn_cb;
+
+    struct qemu_plugin_inline_range_cb range_cb = { .rw = rw,
+                                                    .entry = entry,
+                                                    .low = low,
+                                                    .high = high,
+                                                    .imm = imm };
+    dyn_cb = plugin_get_dyn_cb(arr);
+    dyn_cb->type = op_to_range_cb_type(op);
+    dyn_cb->inline_range = range_cb;
+}
+
 void plugin_register_dyn_cb__udata(GArray **arr,
                                    qemu_plugin_vcpu_udata_cb_t cb,
                                    enum qemu_plugin_cb_flags flags,
@@ -601,6 +632,29 @@ void exec_inline_op(enum plugin_dyn_cb_type type,
     }
 }
 
+/* The range check has already been performed by the caller. */
+static void exec_inline_range_op(enum plugin_dyn_cb_type type,
+                                 struct qemu_plugin_inline_range_cb *cb,
+                                 int cpu_index)
+{
+    char *ptr = cb->entry.score->data->data;
+    size_t elem_size = g_array_get_element_size(
+        cb->entry.score->data);
+    size_t offset = cb->entry.offset;
+    uint64_t *val = (uint64_t *)(ptr + offset + cpu_index * elem_size);
+
+    switch (type) {
+    case PLUGIN_CB_INLINE_RANGE_ADD_U64:
+        *val += cb->imm;
+        break;
+    case PLUGIN_CB_INLINE_RANGE_STORE_U64:
+        *val = cb->imm;
+        break;
+    default:
+        g_assert_not_reached();
+    }
+}
+
 void qemu_plugin_vcpu_mem_cb(CPUState *cpu, uint64_t vaddr,
                              uint64_t value_low,
                              uint64_t value_high,
@@ -634,6 +688,15 @@ void qemu_plugin_vcpu_mem_cb(CPUState *cpu, uint64_t vaddr,
                 exec_inline_op(cb->type, &cb->inline_insn, cpu->cpu_index);
             }
             break;
+        case PLUGIN_CB_INLINE_RANGE_ADD_U64:
+        case PLUGIN_CB_INLINE_RANGE_STORE_U64:
+            if ((rw & cb->inline_range.rw) &&
+                vaddr >= cb->inline_range.low &&
+                vaddr <= cb->inline_range.high) {
+                exec_inline_range_op(cb->type, &cb->inline_range,
+                                     cpu->cpu_index);
+            }
+            break;
         default:
             g_assert_not_reached();
         }
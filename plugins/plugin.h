@@ -74,6 +74,13 @@ void plugin_register_inline_op_on_entry(GArray **arr,
                                         qemu_plugin_u64 entry,
                                         uint64_t imm);
 
+void plugin_register_inline_range_op_on_entry(GArray **arr,
+                                              enum qemu_plugin_mem_rw rw,
+                                              uint64_t low, uint64_t high,
+                                              enum qemu_plugin_op op,
+                                              qemu_plugin_u64 entry,
+                                              uint64_t imm);
+
 void plugin_reset_uninstall(qemu_plugin_id_t id,
                             qemu_plugin_simple_cb_t cb,
                             bool reset);
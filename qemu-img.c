@@ -1187,10 +1187,22 @@ static int is_allocated_sectors(const uint8_t *buf, int n, int *pnum,
         return 0;
     }
     is_zero = buffer_is_zero(buf, BDRV_SECTOR_SIZE);
-    for(i = 1; i < n; i++) {
-        buf += BDRV_SECTOR_SIZE;
-        if (is_zero != buffer_is_zero(buf, BDRV_SECTOR_SIZE)) {
-            break;
+    if (is_zero &&
+        buffer_is_zero(buf + BDRV_SECTOR_SIZE,
+                       (size_t)(n - 1) * BDRV_SECTOR_SIZE)) {
+        /*
+         * Checking the remainder in one go lets buffer_is_zero() run its
+         * vectorized kernel over the whole buffer instead of one sector at
+         * a time, and a fully zeroed buffer is the common case for sparse
+         * images.
+         */
+        i = n;
+    } else {
+        for (i = 1; i < n; i++) {
+            buf += BDRV_SECTOR_SIZE;
+            if (is_zero != buffer_is_zero(buf, BDRV_SECTOR_SIZE)) {
+                break;
+            }
         }
     }
 
@@ -1664,7 +1676,7 @@ enum ImgConvertBlockStatus {
     BLK_BACKING_FILE,
 };
 
-#define MAX_COROUTINES 16
+#define MAX_COROUTINES 64
 #define CONVERT_THROTTLE_GROUP "img_convert"
 
 typedef struct ImgConvertState {
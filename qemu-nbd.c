@@ -70,6 +70,7 @@
 #define QEMU_NBD_OPT_PID_FILE      265
 #define QEMU_NBD_OPT_SELINUX_LABEL 266
 #define QEMU_NBD_OPT_TLSHOSTNAME   267
+#define QEMU_NBD_OPT_IOTHREAD      268
 
 #define MBR_SIZE 512
 
@@ -120,6 +121,8 @@ static void usage(const char *name)
 "  --fork                    fork off the server process and exit the parent\n"
 "                            once the server is running\n"
 "  --pid-file=PATH           store the server's process ID in the given file\n"
+"  --iothread=ID             run the export in the iothread with the given ID\n"
+"                            (defined with an earlier --object iothread,...)\n"
 #ifdef CONFIG_SELINUX
 "  --selinux-label=LABEL     set SELinux process label on listening socket\n"
 #endif
@@ -578,6 +581,7 @@ int main(int argc, char **argv)
         { "pid-file", required_argument, NULL, QEMU_NBD_OPT_PID_FILE },
         { "selinux-label", required_argument, NULL,
           QEMU_NBD_OPT_SELINUX_LABEL },
+        { "iothread", required_argument, NULL, QEMU_NBD_OPT_IOTHREAD },
         { NULL, 0, NULL, 0 }
     };
     int ch;
@@ -605,6 +609,7 @@ int main(int argc, char **argv)
     unsigned socket_activation;
     const char *pid_file_name = NULL;
     const char *selinux_label = NULL;
+    const char *iothread_id = NULL;
     BlockExportOptions *export_opts;
     struct NbdClientOpts opts = {
         .fork_process = false,
@@ -815,6 +820,9 @@ int main(int argc, char **argv)
         case QEMU_NBD_OPT_SELINUX_LABEL:
             selinux_label = optarg;
             break;
+        case QEMU_NBD_OPT_IOTHREAD:
+            iothread_id = optarg;
+            break;
         }
     }
 
@@ -1163,6 +1171,9 @@ int main(int argc, char **argv)
         .writethrough       = writethrough,
         .has_writable       = true,
         .writable           = !readonly,
+        .iothread           = g_strdup(iothread_id),
+        .has_fixed_iothread = !!iothread_id,
+        .fixed_iothread     = !!iothread_id,
         .u.nbd = {
             .name                 = g_strdup(export_name),
             .description          = g_strdup(export_description),
@@ -3706,6 +3706,7 @@ DEF("chardev", HAS_ARG, QEMU_OPTION_chardev,
     "-chardev vc,id=id[[,width=width][,height=height]][[,cols=cols][,rows=rows]]\n"
     "         [,mux=on|off][,logfile=PATH][,logappend=on|off]\n"
     "-chardev ringbuf,id=id[,size=size][,logfile=PATH][,logappend=on|off]\n"
+    "-chardev buffer,id=id,chardev=id[,size=size][,logfile=PATH][,logappend=on|off]\n"
     "-chardev file,id=id,path=path[,input-path=input-file][,mux=on|off][,logfile=PATH][,logappend=on|off]\n"
     "-chardev pipe,id=id,path=path[,mux=on|off][,logfile=PATH][,logappend=on|off]\n"
 #ifdef _WIN32
@@ -3909,6 +3910,14 @@ The available backends are:
     Create a ring buffer with fixed size ``size``. size must be a power
     of two and defaults to ``64K``.
 
+``-chardev buffer,id=id,chardev=id[,size=size]``
+    Buffer output to the chardev ``chardev`` in a ring of ``size``
+    bytes and write it out in bulk, either when a flush timer fires or
+    when the ring is half full. size must be a power of two and
+    defaults to ``64K``. This cuts the per-byte cost of chatty writers
+    such as guest serial consoles. Buffering statistics are shown by
+    ``info chardev``.
+
 ``-chardev file,id=id,path=path[,input-path=input-path]``
     Log all traffic received from the guest to a file.
 
@@ -657,6 +657,31 @@ struct GuestFileSeek *qmp_guest_file_seek(int64_t handle, int64_t offset,
     }
 
     fh = gfh->fh;
+
+#if defined(SEEK_HOLE) && defined(SEEK_DATA)
+    if (whence == SEEK_HOLE || whence == SEEK_DATA) {
+        off_t pos;
+
+        /*
+         * stdio only understands SEEK_SET/CUR/END; flush the stream,
+         * resolve the hole or data offset on the file descriptor and
+         * reposition the stream at the result.
+         */
+        if (fflush(fh) == EOF) {
+            error_setg_errno(errp, errno, "failed to flush file");
+            return NULL;
+        }
+        pos = lseek(fileno(fh), offset, whence);
+        if (pos < 0) {
+            error_setg_errno(errp, errno, "failed to seek file");
+            clearerr(fh);
+            return NULL;
+        }
+        offset = pos;
+        whence = SEEK_SET;
+    }
+#endif
+
     ret = fseek(fh, offset, whence);
     if (ret == -1) {
         error_setg_errno(errp, errno, "failed to seek file");
@@ -694,6 +719,71 @@ void qmp_guest_file_flush(int64_t handle, Error **errp)
     }
 }
 
+#define QGA_CHECKSUM_CHUNK_SIZE (64 * 1024)
+
+GuestFileChecksum *qmp_guest_file_checksum(int64_t handle,
+                                           bool has_offset, int64_t offset,
+                                           bool has_count, int64_t count,
+                                           Error **errp)
+{
+    GuestFileHandle *gfh = guest_file_handle_find(handle, errp);
+    g_autoptr(GChecksum) sum = NULL;
+    g_autofree guchar *buf = NULL;
+    GuestFileChecksum *result;
+    int fd;
+
+    if (!gfh) {
+        return NULL;
+    }
+
+    if (!has_offset) {
+        offset = 0;
+    }
+    if (offset < 0 || (has_count && count < 0)) {
+        error_setg(errp, "invalid offset or count");
+        return NULL;
+    }
+
+    /* make buffered writes visible before reading via the descriptor */
+    if (gfh->state == RW_STATE_WRITING) {
+        if (fflush(gfh->fh) == EOF) {
+            error_setg_errno(errp, errno, "failed to flush file");
+            return NULL;
+        }
+        gfh->state = RW_STATE_NEW;
+    }
+
+    fd = fileno(gfh->fh);
+    buf = g_malloc(QGA_CHECKSUM_CHUNK_SIZE);
+    sum = g_checksum_new(G_CHECKSUM_SHA256);
+
+    while (!has_count || count > 0) {
+        size_t chunk = QGA_CHECKSUM_CHUNK_SIZE;
+        ssize_t n;
+
+        if (has_count && count < QGA_CHECKSUM_CHUNK_SIZE) {
+            chunk = count;
+        }
+        n = RETRY_ON_EINTR(pread(fd, buf, chunk, offset));
+        if (n < 0) {
+            error_setg_errno(errp, errno, "failed to read file");
+            return NULL;
+        }
+        if (n == 0) {
+            break;
+        }
+        g_checksum_update(sum, buf, n);
+        offset += n;
+        if (has_count) {
+            count -= n;
+        }
+    }
+
+    result = g_new0(GuestFileChecksum, 1);
+    result->checksum = g_strdup(g_checksum_get_string(sum));
+    return result;
+}
+
 #if defined(CONFIG_FSFREEZE) || defined(CONFIG_FSTRIM)
 void free_fs_mount_list(FsMountList *mounts)
 {
@@ -549,6 +549,14 @@ int ga_parse_whence(GuestFileWhence *whence, Error **errp)
         return SEEK_CUR;
     case QGA_SEEK_END:
         return SEEK_END;
+    case QGA_SEEK_HOLE:
+    case QGA_SEEK_DATA:
+#if defined(SEEK_HOLE) && defined(SEEK_DATA)
+        return whence->u.value == QGA_SEEK_HOLE ? SEEK_HOLE : SEEK_DATA;
+#else
+        error_setg(errp, "hole/data seeks are not supported on this platform");
+        return -1;
+#endif
     }
     error_setg(errp, "invalid whence code %"PRId64, whence->u.value);
     return -1;
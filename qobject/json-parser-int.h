@@ -48,7 +48,10 @@ void json_message_process_token(JSONLexer *lexer, GString *input,
                                 JSONTokenType type, int x, int y);
 
 /* json-parser.c */
-JSONToken *json_token(JSONTokenType type, int x, int y, GString *tokstr);
+JSONToken *json_token(JSONMessageParser *parser, JSONTokenType type,
+                      int x, int y, GString *tokstr);
+void json_token_arena_reset(JSONMessageParser *parser);
+void json_token_arena_destroy(JSONMessageParser *parser);
 QObject *json_parser_parse(GQueue *tokens, va_list *ap, Error **errp);
 
 #endif
@@ -31,6 +31,21 @@ struct JSONToken {
     char str[];
 };
 
+/*
+ * The tokens queued up for a message all become garbage together once
+ * the message has been parsed.  Carving them out of a few large chunks
+ * instead of one allocation per token keeps the tokenizer off the
+ * allocator's hot path when a monitor streams many small commands.
+ */
+#define JSON_TOKEN_CHUNK_SIZE (8 * 1024)
+
+struct JSONTokenChunk {
+    JSONTokenChunk *next;
+    size_t capacity;
+    size_t used;
+    char data[];
+};
+
 typedef struct JSONParserContext {
     Error *err;
     JSONToken *current;
@@ -236,12 +251,12 @@ out:
 }
 
 /* Note: the token object returned by parser_context_peek_token or
- * parser_context_pop_token is deleted as soon as parser_context_pop_token
- * is called again.
+ * parser_context_pop_token lives in the message parser's token arena
+ * and is deleted only when the arena is reset, after the whole message
+ * has been parsed.
  */
 static JSONToken *parser_context_pop_token(JSONParserContext *ctxt)
 {
-    g_free(ctxt->current);
     ctxt->current = g_queue_pop_head(ctxt->buf);
     return ctxt->current;
 }
@@ -559,9 +574,26 @@ static QObject *parse_value(JSONParserContext *ctxt)
     }
 }
 
-JSONToken *json_token(JSONTokenType type, int x, int y, GString *tokstr)
+JSONToken *json_token(JSONMessageParser *parser, JSONTokenType type,
+                      int x, int y, GString *tokstr)
 {
-    JSONToken *token = g_malloc(sizeof(JSONToken) + tokstr->len + 1);
+    size_t size = QEMU_ALIGN_UP(sizeof(JSONToken) + tokstr->len + 1,
+                                sizeof(void *));
+    JSONTokenChunk *chunk = parser->token_arena;
+    JSONToken *token;
+
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        size_t capacity = MAX(size, (size_t)JSON_TOKEN_CHUNK_SIZE);
+
+        chunk = g_malloc(sizeof(JSONTokenChunk) + capacity);
+        chunk->next = parser->token_arena;
+        chunk->capacity = capacity;
+        chunk->used = 0;
+        parser->token_arena = chunk;
+    }
+
+    token = (JSONToken *)(chunk->data + chunk->used);
+    chunk->used += size;
 
     token->type = type;
     memcpy(token->str, tokstr->str, tokstr->len);
@@ -571,6 +603,40 @@ JSONToken *json_token(JSONTokenType type, int x, int y, GString *tokstr)
     return token;
 }
 
+void json_token_arena_reset(JSONMessageParser *parser)
+{
+    JSONTokenChunk *chunk, *next, *keep = NULL;
+
+    /*
+     * Keep one normal-sized chunk so back-to-back messages don't go
+     * through malloc at all; oversized chunks go back right away.
+     */
+    for (chunk = parser->token_arena; chunk; chunk = next) {
+        next = chunk->next;
+        if (!keep && chunk->capacity == JSON_TOKEN_CHUNK_SIZE) {
+            keep = chunk;
+        } else {
+            g_free(chunk);
+        }
+    }
+    if (keep) {
+        keep->next = NULL;
+        keep->used = 0;
+    }
+    parser->token_arena = keep;
+}
+
+void json_token_arena_destroy(JSONMessageParser *parser)
+{
+    JSONTokenChunk *chunk, *next;
+
+    for (chunk = parser->token_arena; chunk; chunk = next) {
+        next = chunk->next;
+        g_free(chunk);
+    }
+    parser->token_arena = NULL;
+}
+
 QObject *json_parser_parse(GQueue *tokens, va_list *ap, Error **errp)
 {
     JSONParserContext ctxt = { .buf = tokens, .ap = ap };
@@ -581,10 +647,8 @@ QObject *json_parser_parse(GQueue *tokens, va_list *ap, Error **errp)
 
     error_propagate(errp, ctxt.err);
 
-    while (!g_queue_is_empty(ctxt.buf)) {
-        parser_context_pop_token(&ctxt);
-    }
-    g_free(ctxt.current);
+    /* Leftover tokens after an error die with the arena, just drop them */
+    g_queue_clear(ctxt.buf);
 
     return result;
 }
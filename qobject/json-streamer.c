@@ -21,11 +21,8 @@
 
 static void json_message_free_tokens(JSONMessageParser *parser)
 {
-    JSONToken *token;
-
-    while ((token = g_queue_pop_head(&parser->tokens))) {
-        g_free(token);
-    }
+    g_queue_clear(&parser->tokens);
+    json_token_arena_reset(parser);
 }
 
 void json_message_process_token(JSONLexer *lexer, GString *input,
@@ -79,7 +76,7 @@ void json_message_process_token(JSONLexer *lexer, GString *input,
         goto out_emit;
     }
 
-    token = json_token(type, x, y, input);
+    token = json_token(parser, type, x, y, input);
     parser->token_size += input->len;
 
     g_queue_push_tail(&parser->tokens, token);
@@ -111,6 +108,7 @@ void json_message_parser_init(JSONMessageParser *parser,
     parser->bracket_count = 0;
     g_queue_init(&parser->tokens);
     parser->token_size = 0;
+    parser->token_arena = NULL;
 
     json_lexer_init(&parser->lexer, !!ap);
 }
@@ -131,4 +129,5 @@ void json_message_parser_destroy(JSONMessageParser *parser)
 {
     json_lexer_destroy(&parser->lexer);
     json_message_free_tokens(parser);
+    json_token_arena_destroy(parser);
 }
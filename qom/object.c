@@ -76,6 +76,9 @@ struct TypeImpl
 
 static Type type_interface;
 
+/* Bumped when any class gains a property; see object_class_flat_properties() */
+static unsigned class_properties_gen = 1;
+
 static GHashTable *type_table_get(void)
 {
     static GHashTable *type_table;
@@ -685,29 +688,16 @@ static void object_property_del_all(Object *obj)
 
 static void object_property_del_child(Object *obj, Object *child)
 {
-    ObjectProperty *prop;
-    GHashTableIter iter;
-    gpointer key, value;
+    ObjectProperty *prop = child->parent_prop;
 
-    g_hash_table_iter_init(&iter, obj->properties);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        prop = value;
-        if (object_property_is_child(prop) && prop->opaque == child) {
-            if (prop->release) {
-                prop->release(obj, prop->name, prop->opaque);
-                prop->release = NULL;
-            }
-            break;
-        }
-    }
-    g_hash_table_iter_init(&iter, obj->properties);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        prop = value;
-        if (object_property_is_child(prop) && prop->opaque == child) {
-            g_hash_table_iter_remove(&iter);
-            break;
-        }
+    g_assert(prop && prop->opaque == child);
+
+    if (prop->release) {
+        prop->release(obj, prop->name, prop->opaque);
+        prop->release = NULL;
     }
+    /* prop->name stays valid until the property is removed */
+    g_hash_table_remove(obj->properties, prop->name);
 }
 
 void object_unparent(Object *obj)
@@ -1110,6 +1100,7 @@ typedef struct OCFData
 {
     void (*fn)(ObjectClass *klass, void *opaque);
     const char *implements_type;
+    TypeImpl *implements_class_type;
     bool include_abstract;
     void *opaque;
 } OCFData;
@@ -1121,6 +1112,18 @@ static void object_class_foreach_tramp(gpointer key, gpointer value,
     TypeImpl *type = value;
     ObjectClass *k;
 
+    /*
+     * When filtering on a non-interface type, whether the cast below
+     * would succeed is determined by the parent chain alone, so skip
+     * unrelated types without initializing their classes.  This keeps
+     * class_init lazy across enumerations such as the machine class
+     * lookup at startup.
+     */
+    if (data->implements_class_type &&
+        !type_is_ancestor(type, data->implements_class_type)) {
+        return;
+    }
+
     type_initialize(type);
     k = type->class;
 
@@ -1140,7 +1143,16 @@ void object_class_foreach(void (*fn)(ObjectClass *klass, void *opaque),
                           const char *implements_type, bool include_abstract,
                           void *opaque)
 {
-    OCFData data = { fn, implements_type, include_abstract, opaque };
+    OCFData data = { fn, implements_type, NULL, include_abstract, opaque };
+
+    if (implements_type) {
+        TypeImpl *target_type = type_get_by_name(implements_type);
+
+        /* Interfaces cannot be filtered through the type tree. */
+        if (target_type && !type_is_ancestor(target_type, type_interface)) {
+            data.implements_class_type = target_type;
+        }
+    }
 
     enumerating_types = true;
     g_hash_table_foreach(type_table_get(), object_class_foreach_tramp, &data);
@@ -1333,6 +1345,9 @@ object_class_property_add(ObjectClass *klass,
 
     g_hash_table_insert(klass->properties, prop->name, prop);
 
+    /* Subclasses inherit the new property: their flat tables are stale */
+    class_properties_gen++;
+
     return prop;
 }
 
@@ -1387,20 +1402,44 @@ void object_class_property_iter_init(ObjectPropertyIterator *iter,
     iter->nextclass = object_class_get_parent(klass);
 }
 
-ObjectProperty *object_class_property_find(ObjectClass *klass, const char *name)
+/*
+ * Merge the property tables of @klass and all its parents into one
+ * table keyed by the interned name strings of the per-class entries.
+ * The walk inserts parents last with replacement, preserving the
+ * historical behaviour that a parent's property shadows a same-named
+ * property of a subclass.
+ */
+static GHashTable *object_class_flat_properties(ObjectClass *klass)
 {
-    ObjectClass *parent_klass;
+    ObjectClass *k;
+
+    if (klass->flat_properties &&
+        klass->flat_properties_gen == class_properties_gen) {
+        return klass->flat_properties;
+    }
 
-    parent_klass = object_class_get_parent(klass);
-    if (parent_klass) {
-        ObjectProperty *prop =
-            object_class_property_find(parent_klass, name);
-        if (prop) {
-            return prop;
+    if (klass->flat_properties) {
+        g_hash_table_destroy(klass->flat_properties);
+    }
+    klass->flat_properties = g_hash_table_new(g_str_hash, g_str_equal);
+    klass->flat_properties_gen = class_properties_gen;
+
+    for (k = klass; k; k = object_class_get_parent(k)) {
+        GHashTableIter iter;
+        gpointer key, value;
+
+        g_hash_table_iter_init(&iter, k->properties);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            g_hash_table_replace(klass->flat_properties, key, value);
         }
     }
 
-    return g_hash_table_lookup(klass->properties, name);
+    return klass->flat_properties;
+}
+
+ObjectProperty *object_class_property_find(ObjectClass *klass, const char *name)
+{
+    return g_hash_table_lookup(object_class_flat_properties(klass), name);
 }
 
 ObjectProperty *object_class_property_find_err(ObjectClass *klass,
@@ -1796,6 +1835,7 @@ static void object_finalize_child_property(Object *obj, const char *name,
         (child->class->unparent)(child);
     }
     child->parent = NULL;
+    child->parent_prop = NULL;
     object_unref(child);
 }
 
@@ -1819,6 +1859,7 @@ object_property_try_add_child(Object *obj, const char *name,
     op->resolve = object_resolve_child_property;
     object_ref(child);
     child->parent = obj;
+    child->parent_prop = op;
     return op;
 }
 
@@ -2059,26 +2100,15 @@ object_property_add_const_link(Object *obj, const char *name,
 
 const char *object_get_canonical_path_component(const Object *obj)
 {
-    ObjectProperty *prop = NULL;
-    GHashTableIter iter;
-
     if (obj->parent == NULL) {
         return NULL;
     }
 
-    g_hash_table_iter_init(&iter, obj->parent->properties);
-    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&prop)) {
-        if (!object_property_is_child(prop)) {
-            continue;
-        }
+    /* obj had a parent, so it must be somebody's child property */
+    g_assert(obj->parent_prop);
+    g_assert(obj->parent_prop->opaque == obj);
 
-        if (prop->opaque == obj) {
-            return prop->name;
-        }
-    }
-
-    /* obj had a parent but was not a child, should never happen */
-    g_assert_not_reached();
+    return obj->parent_prop->name;
 }
 
 char *object_get_canonical_path(const Object *obj)
@@ -2774,7 +2804,7 @@ object_class_property_add_uint64_ptr(ObjectClass *klass, const char *name,
 }
 
 typedef struct {
-    Object *target_obj;
+    Object *target_obj; /* NULL means the object being accessed */
     char *target_name;
 } AliasProperty;
 
@@ -2784,7 +2814,8 @@ static void property_get_alias(Object *obj, Visitor *v, const char *name,
     AliasProperty *prop = opaque;
     Visitor *alias_v = visitor_forward_field(v, prop->target_name, name);
 
-    object_property_get(prop->target_obj, prop->target_name, alias_v, errp);
+    object_property_get(prop->target_obj ?: obj, prop->target_name,
+                        alias_v, errp);
     visit_free(alias_v);
 }
 
@@ -2794,7 +2825,8 @@ static void property_set_alias(Object *obj, Visitor *v, const char *name,
     AliasProperty *prop = opaque;
     Visitor *alias_v = visitor_forward_field(v, prop->target_name, name);
 
-    object_property_set(prop->target_obj, prop->target_name, alias_v, errp);
+    object_property_set(prop->target_obj ?: obj, prop->target_name,
+                        alias_v, errp);
     visit_free(alias_v);
 }
 
@@ -2803,7 +2835,8 @@ static Object *property_resolve_alias(Object *obj, void *opaque,
 {
     AliasProperty *prop = opaque;
 
-    return object_resolve_path_component(prop->target_obj, prop->target_name);
+    return object_resolve_path_component(prop->target_obj ?: obj,
+                                         prop->target_name);
 }
 
 static void property_release_alias(Object *obj, const char *name, void *opaque)
@@ -2852,6 +2885,44 @@ object_property_add_alias(Object *obj, const char *name,
     return op;
 }
 
+ObjectProperty *
+object_class_property_add_alias(ObjectClass *klass, const char *name,
+                                const char *target_name)
+{
+    AliasProperty *prop;
+    ObjectProperty *op;
+    ObjectProperty *target_prop;
+    g_autofree char *prop_type = NULL;
+
+    target_prop = object_class_property_find_err(klass, target_name,
+                                                 &error_abort);
+
+    if (object_property_is_child(target_prop)) {
+        prop_type = g_strdup_printf("link%s",
+                                    target_prop->type + strlen("child"));
+    } else {
+        prop_type = g_strdup(target_prop->type);
+    }
+
+    prop = g_malloc(sizeof(*prop));
+    prop->target_obj = NULL;
+    prop->target_name = g_strdup(target_name);
+
+    op = object_class_property_add(klass, name, prop_type,
+                                   property_get_alias,
+                                   property_set_alias,
+                                   NULL,
+                                   prop);
+    op->resolve = property_resolve_alias;
+    if (target_prop->defval) {
+        op->defval = qobject_ref(target_prop->defval);
+    }
+
+    object_class_property_set_description(klass, op->name,
+                                          target_prop->description);
+    return op;
+}
+
 void object_property_set_description(Object *obj, const char *name,
                                      const char *description)
 {
@@ -22,9 +22,19 @@
 #include "block/snapshot.h"
 #include "migration/snapshot.h"
 
+/*
+ * While re-executing towards a seek target, save an automatic
+ * snapshot each time this many instructions pass without reaching
+ * it, so that later reverse operations restart from a nearby
+ * checkpoint instead of the last user-created snapshot.
+ */
+#define REPLAY_CHECKPOINT_INTERVAL  1000000000LL
+
 static bool replay_is_debugging;
 static int64_t replay_last_breakpoint;
 static int64_t replay_last_snapshot;
+static int64_t replay_seek_target = -1;
+static QEMUTimerCB *replay_seek_callback;
 
 bool replay_running_debug(void)
 {
@@ -176,6 +186,28 @@ fail:
     return ret;
 }
 
+static void replay_seek(int64_t icount, QEMUTimerCB callback, Error **errp);
+static void replay_stop_vm_debug(void *opaque);
+
+static void replay_next_checkpoint(void *opaque)
+{
+    Error *err = NULL;
+
+    replay_delete_break();
+    if (replay_can_snapshot()) {
+        g_autofree char *name =
+            g_strdup_printf("replay_ckpt_%" PRId64,
+                            replay_get_current_icount());
+        /* Failing to snapshot here only loses the shortcut */
+        save_snapshot(name, true, NULL, false, NULL, NULL);
+    }
+    replay_seek(replay_seek_target, replay_seek_callback, &err);
+    if (err) {
+        error_free(err);
+        replay_stop_vm_debug(NULL);
+    }
+}
+
 static void replay_seek(int64_t icount, QEMUTimerCB callback, Error **errp)
 {
     char *snapshot = NULL;
@@ -196,7 +228,20 @@ static void replay_seek(int64_t icount, QEMUTimerCB callback, Error **errp)
         g_free(snapshot);
     }
     if (replay_get_current_icount() <= icount) {
-        replay_break(icount, callback, NULL);
+        if (icount - replay_get_current_icount()
+            > REPLAY_CHECKPOINT_INTERVAL) {
+            /*
+             * The target is far away; stop off at intermediate points
+             * to leave checkpoints for later reverse operations.
+             */
+            replay_seek_target = icount;
+            replay_seek_callback = callback;
+            replay_break(replay_get_current_icount()
+                         + REPLAY_CHECKPOINT_INTERVAL,
+                         replay_next_checkpoint, NULL);
+        } else {
+            replay_break(icount, callback, NULL);
+        }
         vm_start();
     } else {
         error_setg(errp, "cannot seek to the specified instruction count");
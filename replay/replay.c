@@ -25,6 +25,8 @@
 #define REPLAY_VERSION              0xe0200c
 /* Size of replay log header */
 #define HEADER_SIZE                 (sizeof(uint32_t) + sizeof(uint64_t))
+/* Size of the stdio buffer used for the replay log */
+#define REPLAY_FILE_BUF_SIZE        (1024 * 1024)
 
 ReplayMode replay_mode = REPLAY_MODE_NONE;
 char *replay_snapshot;
@@ -361,6 +363,12 @@ static void replay_enable(const char *fname, int mode)
         exit(1);
     }
 
+    /*
+     * The log is read and written strictly sequentially; a large stdio
+     * buffer keeps the syscall count down on multi-gigabyte logs.
+     */
+    setvbuf(replay_file, NULL, _IOFBF, REPLAY_FILE_BUF_SIZE);
+
     replay_filename = g_strdup(fname);
     replay_mode = mode;
     replay_mutex_init();
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Summarise guest boot phase timing from a simpletrace file
+#
+# Run QEMU with the simple trace backend and
+#
+#   -trace qdev_machine_init_phase -trace qdev_realize \
+#   -trace fw_cfg_select -trace vm_state_notify -trace cpu_exec_first
+#
+# then feed trace-<pid> to this script to get a boot timeline and the
+# device classes whose realize took longest.
+#
+
+import simpletrace
+import argparse
+
+
+class BootAnalyser(simpletrace.Analyzer):
+    "A simpletrace Analyser correlating machine bring-up events."
+
+    def __init__(self):
+        self.origin = None
+        self.timeline = []
+        self.realizes = {}
+        self.seen_fw_cfg = False
+
+    def _mark(self, timestamp, label):
+        ts = timestamp[0]
+        if self.origin is None:
+            self.origin = ts
+        self.timeline.append((ts, label))
+
+    def qdev_machine_init_phase(self, timestamp, phase, name):
+        self._mark(timestamp, "phase %s" % name.decode())
+
+    def qdev_realize(self, timestamp, obj, objtype, ns):
+        rec = self.realizes.setdefault(objtype.decode(), [0, 0])
+        rec[0] += 1
+        rec[1] += ns
+
+    def fw_cfg_select(self, timestamp, s, key_value, key_name, ret):
+        if not self.seen_fw_cfg:
+            self.seen_fw_cfg = True
+            self._mark(timestamp, "firmware handoff (first fw_cfg select)")
+
+    def vm_state_notify(self, timestamp, running, reason, reason_str):
+        if running:
+            self._mark(timestamp, "vm start (%s)" % reason_str.decode())
+
+    def cpu_exec_first(self, timestamp, cpu_index):
+        self._mark(timestamp, "first guest code on vCPU %d" % cpu_index)
+
+
+def get_args():
+    "Grab options"
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--realize-top", type=int, default=20,
+                        help="how many device classes to list")
+    parser.add_argument("events", type=str, help='trace events file')
+    parser.add_argument("tracefile", type=str, help='trace file read from')
+    return parser.parse_args()
+
+if __name__ == '__main__':
+    args = get_args()
+
+    analyser = BootAnalyser()
+    simpletrace.process(args.events, args.tracefile, analyser)
+
+    print("Boot timeline (ms since first event):")
+    for ts, label in analyser.timeline:
+        print("  %10.3f  %s" % ((ts - analyser.origin) / 1e6, label))
+
+    print("Slowest device classes by cumulative realize time:")
+    ordered = sorted(analyser.realizes.items(),
+                     key=lambda k_v: k_v[1][1], reverse=True)
+    for objtype, (count, ns) in ordered[:args.realize_top]:
+        print("  %10.3f ms  %4d device(s)  %s" % (ns / 1e6, count, objtype))
@@ -0,0 +1,108 @@
+/*
+ * RCU grace period statistics
+ *
+ * Expose the counters kept by util/rcu.c through the QMP query-stats
+ * command, so that grace period frequency and duration can be monitored
+ * without a debugger.  Registration lives here rather than in util/rcu.c
+ * because the latter is also linked into tools that do not carry the
+ * stats subsystem.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or
+ * later.  See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/module.h"
+#include "qemu/rcu.h"
+#include "sysemu/stats.h"
+
+#define RCU_STAT_GRACE_PERIODS      "grace-periods"
+#define RCU_STAT_GRACE_PERIOD_NS    "grace-period-ns"
+#define RCU_STAT_PENDING_CALLBACKS  "pending-callbacks"
+
+static StatsList *rcu_stats_add(const char *name, uint64_t value,
+                                strList *names, StatsList *stats_list)
+{
+    Stats *stats;
+
+    if (!apply_str_list_filter(name, names)) {
+        return stats_list;
+    }
+
+    stats = g_new0(Stats, 1);
+    stats->name = g_strdup(name);
+    stats->value = g_new0(StatsValue, 1);
+    stats->value->type = QTYPE_QNUM;
+    stats->value->u.scalar = value;
+
+    QAPI_LIST_PREPEND(stats_list, stats);
+    return stats_list;
+}
+
+static void rcu_stats_cb(StatsResultList **result, StatsTarget target,
+                         strList *names, strList *targets, Error **errp)
+{
+    StatsList *stats_list = NULL;
+    uint64_t gp_count, gp_total_ns;
+    int64_t pending;
+
+    if (target != STATS_TARGET_VM) {
+        return;
+    }
+
+    rcu_get_stats(&gp_count, &gp_total_ns, &pending);
+
+    stats_list = rcu_stats_add(RCU_STAT_GRACE_PERIODS, gp_count,
+                               names, stats_list);
+    stats_list = rcu_stats_add(RCU_STAT_GRACE_PERIOD_NS, gp_total_ns,
+                               names, stats_list);
+    stats_list = rcu_stats_add(RCU_STAT_PENDING_CALLBACKS, pending,
+                               names, stats_list);
+
+    if (!stats_list) {
+        return;
+    }
+
+    add_stats_entry(result, STATS_PROVIDER_RCU, NULL, stats_list);
+}
+
+static StatsSchemaValueList *rcu_schemas_add(const char *name, StatsType type,
+                                             StatsSchemaValueList *list)
+{
+    StatsSchemaValueList *schema_entry = g_new0(StatsSchemaValueList, 1);
+
+    schema_entry->value = g_new0(StatsSchemaValue, 1);
+    schema_entry->value->type = type;
+    schema_entry->value->name = g_strdup(name);
+    schema_entry->next = list;
+
+    return schema_entry;
+}
+
+static void rcu_schemas_cb(StatsSchemaList **result, Error **errp)
+{
+    StatsSchemaValueList *stats_list = NULL;
+
+    stats_list = rcu_schemas_add(RCU_STAT_GRACE_PERIODS,
+                                 STATS_TYPE_CUMULATIVE, stats_list);
+
+    stats_list = rcu_schemas_add(RCU_STAT_GRACE_PERIOD_NS,
+                                 STATS_TYPE_CUMULATIVE, stats_list);
+    stats_list->value->has_unit = true;
+    stats_list->value->unit = STATS_UNIT_SECONDS;
+    stats_list->value->has_base = true;
+    stats_list->value->base = 10;
+    stats_list->value->exponent = -9;
+
+    stats_list = rcu_schemas_add(RCU_STAT_PENDING_CALLBACKS,
+                                 STATS_TYPE_INSTANT, stats_list);
+
+    add_stats_schema(result, STATS_PROVIDER_RCU, STATS_TARGET_VM, stats_list);
+}
+
+static void rcu_stats_register(void)
+{
+    add_stats_callbacks(STATS_PROVIDER_RCU, rcu_stats_cb, rcu_schemas_cb);
+}
+
+type_init(rcu_stats_register);
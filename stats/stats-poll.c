@@ -0,0 +1,123 @@
+/*
+ * Background statistics polling
+ *
+ * Periodically gathers statistics from all providers into a snapshot
+ * that can be queried out-of-band, so fleet telemetry agents polling
+ * at a high rate do not make every provider (and in particular the
+ * per-vCPU KVM stat fds) pay for every query.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or
+ * (at your option) any later version.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/lockable.h"
+#include "qemu/timer.h"
+#include "qapi/clone-visitor.h"
+#include "qapi/error.h"
+#include "qapi/qapi-commands-stats.h"
+#include "qapi/qapi-visit-stats.h"
+#include "sysemu/stats.h"
+
+/*
+ * The poll timer runs in the main loop and replaces the snapshot under
+ * @snapshot_lock; x-query-stats-snapshot is out-of-band capable and
+ * reads it under the same lock, without ever taking the BQL.
+ */
+static QemuMutex snapshot_lock;
+static StatsResultList *snapshot_stats;
+static int64_t snapshot_timestamp_ms;
+static QEMUTimer *poll_timer;
+static int64_t poll_interval_ms;
+
+static void __attribute__((constructor)) stats_poll_init(void)
+{
+    qemu_mutex_init(&snapshot_lock);
+}
+
+static void stats_poll_timer_cb(void *opaque)
+{
+    static const StatsTarget targets[] = {
+        STATS_TARGET_VM, STATS_TARGET_VCPU, STATS_TARGET_CRYPTODEV,
+    };
+    StatsResultList *results = NULL, *old;
+    int64_t now = qemu_clock_get_ms(QEMU_CLOCK_REALTIME);
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(targets); i++) {
+        StatsFilter filter = { .target = targets[i] };
+        StatsResultList *part, *tail;
+        Error *local_err = NULL;
+
+        part = qmp_query_stats(&filter, &local_err);
+        if (local_err) {
+            /* A failing provider must not starve the others */
+            error_free(local_err);
+            continue;
+        }
+        if (part) {
+            for (tail = part; tail->next; tail = tail->next) {
+            }
+            tail->next = results;
+            results = part;
+        }
+    }
+
+    WITH_QEMU_LOCK_GUARD(&snapshot_lock) {
+        old = snapshot_stats;
+        snapshot_stats = results;
+        snapshot_timestamp_ms = now;
+    }
+    qapi_free_StatsResultList(old);
+
+    if (poll_interval_ms) {
+        timer_mod(poll_timer, now + poll_interval_ms);
+    }
+}
+
+void qmp_x_stats_polling(int64_t interval_ms, Error **errp)
+{
+    StatsResultList *old = NULL;
+
+    if (interval_ms < 0) {
+        error_setg(errp, "interval-ms must not be negative");
+        return;
+    }
+
+    poll_interval_ms = interval_ms;
+
+    if (!interval_ms) {
+        if (poll_timer) {
+            timer_del(poll_timer);
+        }
+        WITH_QEMU_LOCK_GUARD(&snapshot_lock) {
+            old = snapshot_stats;
+            snapshot_stats = NULL;
+            snapshot_timestamp_ms = 0;
+        }
+        qapi_free_StatsResultList(old);
+        return;
+    }
+
+    if (!poll_timer) {
+        poll_timer = timer_new_ms(QEMU_CLOCK_REALTIME, stats_poll_timer_cb,
+                                  NULL);
+    }
+    /* Take the first snapshot right away; the callback rearms the timer */
+    stats_poll_timer_cb(NULL);
+}
+
+StatsSnapshot *qmp_x_query_stats_snapshot(Error **errp)
+{
+    StatsSnapshot *ret;
+
+    QEMU_LOCK_GUARD(&snapshot_lock);
+    if (!snapshot_stats) {
+        error_setg(errp, "stats polling is not enabled, use x-stats-polling");
+        return NULL;
+    }
+    ret = g_new0(StatsSnapshot, 1);
+    ret->timestamp_ms = snapshot_timestamp_ms;
+    ret->stats = QAPI_CLONE(StatsResultList, snapshot_stats);
+    return ret;
+}
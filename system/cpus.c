@@ -28,12 +28,15 @@
 #include "qapi/error.h"
 #include "qapi/qapi-commands-machine.h"
 #include "qapi/qapi-commands-misc.h"
+#include "qapi/type-helpers.h"
 #include "qapi/qapi-events-run-state.h"
 #include "qapi/qmp/qerror.h"
 #include "exec/gdbstub.h"
 #include "sysemu/hw_accel.h"
 #include "exec/cpu-common.h"
 #include "qemu/thread.h"
+#include "qemu/lock-stats.h"
+#include "qemu/timer.h"
 #include "qemu/main-loop.h"
 #include "qemu/plugin.h"
 #include "sysemu/cpus.h"
@@ -65,6 +68,10 @@
 
 #endif /* CONFIG_LINUX */
 
+#ifdef CONFIG_BACKTRACE
+#include <execinfo.h>
+#endif
+
 /* The Big QEMU Lock (BQL) */
 static QemuMutex bql;
 
@@ -421,6 +428,7 @@ void qemu_init_cpu_loop(void)
     qemu_cond_init(&qemu_cpu_cond);
     qemu_cond_init(&qemu_pause_cond);
     qemu_mutex_init(&bql);
+    qemu_mutex_enable_stats(&bql, "bql");
 
     qemu_thread_get_self(&io_thread);
 }
@@ -524,6 +532,361 @@ bool qemu_in_main_thread(void)
     return bql_locked();
 }
 
+/*
+ * Sampling profiler for BQL acquisitions.  One acquisition in
+ * BQL_PROF_PERIOD is timed and attributed to its call site and, when
+ * the host supports backtrace(3), its call stack.  Everything except
+ * the enable flag and the per-thread skid counter is only touched
+ * with the BQL held, so the profile needs no locking of its own.
+ */
+#define BQL_PROF_PERIOD 64
+#define BQL_PROF_MAX_FRAMES 16
+
+typedef struct BqlProfSite {
+    const char *file;
+    int line;
+    int n_frames;
+    void *frames[BQL_PROF_MAX_FRAMES];
+    uint64_t samples;
+    uint64_t wait_ns;
+    uint64_t wait_ns_max;
+    uint64_t hold_ns;
+    uint64_t hold_ns_max;
+} BqlProfSite;
+
+static GHashTable *bql_prof_sites;
+static BqlProfSite *bql_prof_held;
+static int64_t bql_prof_hold_start;
+static bool bql_prof_enabled;
+static __thread unsigned bql_prof_skid;
+
+static guint bql_prof_site_hash(gconstpointer key)
+{
+    const BqlProfSite *site = key;
+    guint hash = g_direct_hash(site->file) ^ site->line;
+    int i;
+
+    for (i = 0; i < site->n_frames; i++) {
+        hash = hash * 31 + g_direct_hash(site->frames[i]);
+    }
+    return hash;
+}
+
+static gboolean bql_prof_site_equal(gconstpointer a, gconstpointer b)
+{
+    const BqlProfSite *sa = a;
+    const BqlProfSite *sb = b;
+
+    return sa->file == sb->file && sa->line == sb->line &&
+           sa->n_frames == sb->n_frames &&
+           !memcmp(sa->frames, sb->frames, sa->n_frames * sizeof(void *));
+}
+
+void bql_prof_enable(bool enable)
+{
+    qatomic_set(&bql_prof_enabled, enable);
+}
+
+bool bql_prof_is_enabled(void)
+{
+    return qatomic_read(&bql_prof_enabled);
+}
+
+void bql_prof_reset(void)
+{
+    BQL_LOCK_GUARD();
+
+    if (bql_prof_sites) {
+        g_hash_table_remove_all(bql_prof_sites);
+    }
+    bql_prof_held = NULL;
+}
+
+/* Called with the BQL just acquired */
+static void bql_prof_sample(const char *file, int line, int64_t wait_ns)
+{
+    BqlProfSite key = { .file = file, .line = line };
+    BqlProfSite *site;
+
+#ifdef CONFIG_BACKTRACE
+    key.n_frames = backtrace(key.frames, BQL_PROF_MAX_FRAMES);
+#endif
+    if (!bql_prof_sites) {
+        bql_prof_sites = g_hash_table_new_full(bql_prof_site_hash,
+                                               bql_prof_site_equal,
+                                               g_free, NULL);
+    }
+    site = g_hash_table_lookup(bql_prof_sites, &key);
+    if (!site) {
+        site = g_new(BqlProfSite, 1);
+        *site = key;
+        g_hash_table_insert(bql_prof_sites, site, site);
+    }
+    site->samples++;
+    site->wait_ns += wait_ns;
+    site->wait_ns_max = MAX(site->wait_ns_max, (uint64_t)wait_ns);
+    bql_prof_held = site;
+    bql_prof_hold_start = get_clock();
+}
+
+/* Called with the BQL held, before it is dropped */
+static void bql_prof_end_hold(void)
+{
+    if (bql_prof_held) {
+        uint64_t hold_ns = get_clock() - bql_prof_hold_start;
+
+        bql_prof_held->hold_ns += hold_ns;
+        bql_prof_held->hold_ns_max = MAX(bql_prof_held->hold_ns_max, hold_ns);
+        bql_prof_held = NULL;
+    }
+}
+
+static gint bql_prof_site_cmp(gconstpointer a, gconstpointer b)
+{
+    const BqlProfSite *sa = *(BqlProfSite * const *)a;
+    const BqlProfSite *sb = *(BqlProfSite * const *)b;
+
+    return sa->wait_ns < sb->wait_ns ? 1 : sa->wait_ns > sb->wait_ns ? -1 : 0;
+}
+
+static void bql_prof_append_stack(GString *buf, const BqlProfSite *site)
+{
+#ifdef CONFIG_BACKTRACE
+    if (site->n_frames > 2) {
+        char **syms = backtrace_symbols((void * const *)site->frames,
+                                        site->n_frames);
+        int i;
+
+        if (syms) {
+            /*
+             * Emit root first, skipping the two innermost frames
+             * (bql_prof_sample and bql_lock_impl).
+             */
+            for (i = site->n_frames - 1; i >= 2; i--) {
+                char *sep = strchr(syms[i], ' ');
+
+                if (sep) {
+                    *sep = 0;
+                }
+                g_string_append(buf, syms[i]);
+                g_string_append_c(buf, ';');
+            }
+            free(syms);
+        }
+    }
+#endif
+    g_string_append_printf(buf, "%s:%d %" PRIu64 "\n",
+                           site->file, site->line, site->samples);
+}
+
+HumanReadableText *qmp_x_query_bql_profile(Error **errp)
+{
+    g_autoptr(GString) buf = g_string_new("");
+    g_autoptr(GPtrArray) sites = g_ptr_array_new();
+    GHashTableIter iter;
+    gpointer value;
+    int i;
+
+    g_string_append_printf(buf, "BQL profile: %s, 1 in %d acquisitions"
+                           " sampled\n",
+                           bql_prof_is_enabled() ? "on" : "off",
+                           BQL_PROF_PERIOD);
+
+    if (bql_prof_sites) {
+        g_hash_table_iter_init(&iter, bql_prof_sites);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            g_ptr_array_add(sites, value);
+        }
+    }
+    g_ptr_array_sort(sites, bql_prof_site_cmp);
+
+    g_string_append_printf(buf, "%-40s %10s %17s %17s\n",
+                           "Site", "Samples", "Wait avg/max (us)",
+                           "Hold avg/max (us)");
+    for (i = 0; i < sites->len; i++) {
+        BqlProfSite *site = g_ptr_array_index(sites, i);
+        g_autofree char *name = g_strdup_printf("%s:%d",
+                                                site->file, site->line);
+
+        g_string_append_printf(buf,
+                               "%-40s %10" PRIu64 " %8.1f/%8.1f %8.1f/%8.1f\n",
+                               name, site->samples,
+                               (double)site->wait_ns / site->samples / 1000.0,
+                               (double)site->wait_ns_max / 1000.0,
+                               (double)site->hold_ns / site->samples / 1000.0,
+                               (double)site->hold_ns_max / 1000.0);
+    }
+
+    g_string_append(buf, "\nCollapsed stacks (count is samples):\n");
+    for (i = 0; i < sites->len; i++) {
+        bql_prof_append_stack(buf, g_ptr_array_index(sites, i));
+    }
+
+    return human_readable_text_from_str(buf);
+}
+
+/*
+ * Guest PC sampling profiler for vCPU threads.  A periodic timer
+ * schedules work on every running vCPU; the work executes in the vCPU
+ * thread with the BQL held, synchronizes the register state and
+ * attributes the sample to the current guest PC.  As with the BQL
+ * profiler above, the sample table is only touched with the BQL held
+ * and needs no locking of its own.
+ */
+#define VCPU_PROF_INTERVAL_MS 10
+
+typedef struct VcpuProfSample {
+    int cpu_index;
+    uint64_t pc;
+    uint64_t samples;
+} VcpuProfSample;
+
+static GHashTable *vcpu_prof_samples;
+static QEMUTimer *vcpu_prof_timer;
+static uint64_t vcpu_prof_total;
+static bool vcpu_prof_enabled;
+
+static guint vcpu_prof_sample_hash(gconstpointer key)
+{
+    const VcpuProfSample *s = key;
+
+    return g_int64_hash(&s->pc) ^ s->cpu_index;
+}
+
+static gboolean vcpu_prof_sample_equal(gconstpointer a, gconstpointer b)
+{
+    const VcpuProfSample *sa = a;
+    const VcpuProfSample *sb = b;
+
+    return sa->cpu_index == sb->cpu_index && sa->pc == sb->pc;
+}
+
+static void vcpu_prof_sample_cpu(CPUState *cpu, run_on_cpu_data data)
+{
+    CPUClass *cc = CPU_GET_CLASS(cpu);
+    VcpuProfSample key, *s;
+
+    if (!qatomic_read(&vcpu_prof_enabled) || !cc->get_pc) {
+        return;
+    }
+
+    cpu_synchronize_state(cpu);
+    key.cpu_index = cpu->cpu_index;
+    key.pc = cc->get_pc(cpu);
+
+    if (!vcpu_prof_samples) {
+        vcpu_prof_samples = g_hash_table_new_full(vcpu_prof_sample_hash,
+                                                  vcpu_prof_sample_equal,
+                                                  g_free, NULL);
+    }
+    s = g_hash_table_lookup(vcpu_prof_samples, &key);
+    if (!s) {
+        s = g_new0(VcpuProfSample, 1);
+        s->cpu_index = key.cpu_index;
+        s->pc = key.pc;
+        g_hash_table_insert(vcpu_prof_samples, s, s);
+    }
+    s->samples++;
+    vcpu_prof_total++;
+}
+
+static void vcpu_prof_tick(void *opaque)
+{
+    CPUState *cpu;
+
+    if (!qatomic_read(&vcpu_prof_enabled)) {
+        return;
+    }
+
+    if (runstate_is_running()) {
+        CPU_FOREACH(cpu) {
+            /*
+             * Kicking a halted TCG vCPU would only profile its idle
+             * loop; a vCPU halted inside KVM_RUN does not mark itself
+             * halted and still gets sampled.
+             */
+            if (!cpu->stopped && !cpu->halted) {
+                async_run_on_cpu(cpu, vcpu_prof_sample_cpu, RUN_ON_CPU_NULL);
+            }
+        }
+    }
+
+    timer_mod(vcpu_prof_timer,
+              qemu_clock_get_ms(QEMU_CLOCK_REALTIME) + VCPU_PROF_INTERVAL_MS);
+}
+
+void vcpu_prof_enable(bool enable)
+{
+    if (enable && !vcpu_prof_timer) {
+        vcpu_prof_timer = timer_new_ms(QEMU_CLOCK_REALTIME,
+                                       vcpu_prof_tick, NULL);
+    }
+    qatomic_set(&vcpu_prof_enabled, enable);
+    if (enable) {
+        timer_mod(vcpu_prof_timer,
+                  qemu_clock_get_ms(QEMU_CLOCK_REALTIME) +
+                  VCPU_PROF_INTERVAL_MS);
+    } else if (vcpu_prof_timer) {
+        timer_del(vcpu_prof_timer);
+    }
+}
+
+bool vcpu_prof_is_enabled(void)
+{
+    return qatomic_read(&vcpu_prof_enabled);
+}
+
+void vcpu_prof_reset(void)
+{
+    BQL_LOCK_GUARD();
+
+    if (vcpu_prof_samples) {
+        g_hash_table_remove_all(vcpu_prof_samples);
+    }
+    vcpu_prof_total = 0;
+}
+
+static gint vcpu_prof_sample_cmp(gconstpointer a, gconstpointer b)
+{
+    const VcpuProfSample *sa = *(VcpuProfSample * const *)a;
+    const VcpuProfSample *sb = *(VcpuProfSample * const *)b;
+
+    return sa->samples < sb->samples ? 1 : sa->samples > sb->samples ? -1 : 0;
+}
+
+HumanReadableText *qmp_x_query_profile(Error **errp)
+{
+    g_autoptr(GString) buf = g_string_new("");
+    g_autoptr(GPtrArray) samples = g_ptr_array_new();
+    GHashTableIter iter;
+    gpointer value;
+    int i;
+
+    g_string_append_printf(buf, "vCPU profile: %s, %" PRIu64 " samples"
+                           " at %d ms intervals\n",
+                           vcpu_prof_is_enabled() ? "on" : "off",
+                           vcpu_prof_total, VCPU_PROF_INTERVAL_MS);
+
+    if (vcpu_prof_samples) {
+        g_hash_table_iter_init(&iter, vcpu_prof_samples);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            g_ptr_array_add(samples, value);
+        }
+    }
+    g_ptr_array_sort(samples, vcpu_prof_sample_cmp);
+
+    g_string_append(buf, "\nCollapsed stacks (count is samples, symbolize"
+                    " against the guest):\n");
+    for (i = 0; i < samples->len; i++) {
+        VcpuProfSample *s = g_ptr_array_index(samples, i);
+
+        g_string_append_printf(buf, "vcpu%d;0x%" PRIx64 " %" PRIu64 "\n",
+                               s->cpu_index, s->pc, s->samples);
+    }
+
+    return human_readable_text_from_str(buf);
+}
+
 /*
  * The BQL is taken from so many places that it is worth profiling the
  * callers directly, instead of funneling them all through a single function.
@@ -531,26 +894,40 @@ bool qemu_in_main_thread(void)
 void bql_lock_impl(const char *file, int line)
 {
     QemuMutexLockFunc bql_lock_fn = qatomic_read(&bql_mutex_lock_func);
+    int64_t start = 0;
+    bool sample = false;
 
     g_assert(!bql_locked());
+    if (qatomic_read(&bql_prof_enabled) && ++bql_prof_skid >= BQL_PROF_PERIOD) {
+        bql_prof_skid = 0;
+        sample = true;
+        start = get_clock();
+    }
     bql_lock_fn(&bql, file, line);
     set_bql_locked(true);
+    if (sample) {
+        bql_prof_sample(file, line, get_clock() - start);
+    }
 }
 
 void bql_unlock(void)
 {
     g_assert(bql_locked());
+    bql_prof_end_hold();
     set_bql_locked(false);
     qemu_mutex_unlock(&bql);
 }
 
 void qemu_cond_wait_bql(QemuCond *cond)
 {
+    /* The lock is dropped across the wait, don't charge it to the sample */
+    bql_prof_end_hold();
     qemu_cond_wait(cond, &bql);
 }
 
 void qemu_cond_timedwait_bql(QemuCond *cond, int ms)
 {
+    bql_prof_end_hold();
     qemu_cond_timedwait(cond, &bql, ms);
 }
 
@@ -580,6 +957,11 @@ void cpu_pause(CPUState *cpu)
 
 void cpu_resume(CPUState *cpu)
 {
+    /* Catch up with a vCPU thread whose creation was not waited for. */
+    while (unlikely(!cpu->created)) {
+        qemu_cond_wait(&qemu_cpu_cond, &bql);
+    }
+
     cpu->stop = false;
     cpu->stopped = false;
     qemu_cpu_kick(cpu);
@@ -683,6 +1065,16 @@ void qemu_init_vcpu(CPUState *cpu)
     g_assert(cpus_accel != NULL && cpus_accel->create_vcpu_thread != NULL);
     cpus_accel->create_vcpu_thread(cpu);
 
+    /*
+     * Accelerators whose threads can set themselves up concurrently
+     * let the next vCPU be created right away; cpu_resume() waits for
+     * stragglers before the first run.  With many vCPUs this takes
+     * the thread start-up handshakes off the serial bring-up path.
+     */
+    if (cpus_accel->parallel_vcpu_create) {
+        return;
+    }
+
     while (!cpu->created) {
         qemu_cond_wait(&qemu_cpu_cond, &bql);
     }
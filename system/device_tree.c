@@ -228,10 +228,53 @@ void *load_device_tree_from_sysfs(void)
 
 #endif /* CONFIG_LINUX */
 
+/*
+ * Building a device tree typically creates a node and then sets a
+ * handful of properties on it, and every helper below looks the node
+ * up again by path, which makes libfdt walk the tree from the root
+ * each time.  Remember the node that was last looked up or created:
+ * all modifications made through these helpers happen inside that
+ * node, which never changes its offset.  Machine init is single
+ * threaded, so no locking is needed.
+ */
+static struct {
+    const void *fdt;
+    char *path;
+    int offset;
+} fdt_cached_node;
+
+static void fdt_invalidate_cached_node(void)
+{
+    fdt_cached_node.fdt = NULL;
+}
+
+static void fdt_cache_node(void *fdt, const char *node_path, int offset)
+{
+    g_free(fdt_cached_node.path);
+    fdt_cached_node.fdt = fdt;
+    fdt_cached_node.path = g_strdup(node_path);
+    fdt_cached_node.offset = offset;
+}
+
 static int findnode_nofail(void *fdt, const char *node_path)
 {
     int offset;
 
+    if (fdt == fdt_cached_node.fdt && node_path[0] == '/' &&
+        !strcmp(node_path, fdt_cached_node.path)) {
+        /*
+         * Callers may mix in structural libfdt calls of their own
+         * that move the cached node; re-checking the node name makes
+         * a stale offset practically impossible to go unnoticed.
+         */
+        const char *basename = strrchr(node_path, '/') + 1;
+        const char *name = fdt_get_name(fdt, fdt_cached_node.offset, NULL);
+
+        if (name && !strcmp(name, basename)) {
+            return fdt_cached_node.offset;
+        }
+    }
+
     offset = fdt_path_offset(fdt, node_path);
     if (offset < 0) {
         error_report("%s Couldn't find node %s: %s", __func__, node_path,
@@ -239,6 +282,8 @@ static int findnode_nofail(void *fdt, const char *node_path)
         exit(1);
     }
 
+    fdt_cache_node(fdt, node_path, offset);
+
     return offset;
 }
 
@@ -522,6 +567,9 @@ int qemu_fdt_nop_node(void *fdt, const char *node_path)
         exit(1);
     }
 
+    /* The cached node is the one that was just nopped out. */
+    fdt_invalidate_cached_node();
+
     return r;
 }
 
@@ -551,6 +599,9 @@ int qemu_fdt_add_subnode(void *fdt, const char *name)
         exit(1);
     }
 
+    /* Properties are usually set on the node right after creating it. */
+    fdt_cache_node(fdt, name, retval);
+
     g_free(dupname);
     return retval;
 }
@@ -561,6 +612,7 @@ int qemu_fdt_add_subnode(void *fdt, const char *name)
  */
 int qemu_fdt_add_path(void *fdt, const char *path)
 {
+    const char *full_path = path;
     const char *name;
     int namelen, retval;
     int parent = 0;
@@ -591,6 +643,12 @@ int qemu_fdt_add_path(void *fdt, const char *path)
         parent = retval;
     } while (path);
 
+    /*
+     * Creating intermediate nodes can move nodes behind them, so any
+     * previously cached offset may be stale; cache the new leaf node.
+     */
+    fdt_cache_node(fdt, full_path, retval);
+
     return retval;
 }
 
@@ -92,9 +92,17 @@ static void vcpu_dirty_rate_stat_collect(void)
                               false);
 
     for (i = 0; i < stat.nvcpu; i++) {
+        int64_t sample = stat.rates[i].dirty_rate;
+        int64_t prev = vcpu_dirty_rate_stat->stat.rates[i].dirty_rate;
+
+        /*
+         * Fold each sample into an exponential moving average so that
+         * the throttle controller sees a stable rate despite the short
+         * measurement epochs.
+         */
         vcpu_dirty_rate_stat->stat.rates[i].id = i;
-        vcpu_dirty_rate_stat->stat.rates[i].dirty_rate =
-            stat.rates[i].dirty_rate;
+        qatomic_set_i64(&vcpu_dirty_rate_stat->stat.rates[i].dirty_rate,
+                        prev ? (prev * 3 + sample) / 4 : sample);
     }
 
     g_free(stat.rates);
@@ -308,10 +316,21 @@ static void dirtylimit_set_throttle(CPUState *cpu,
                                       sleep_pct,
                                       throttle_us);
     } else {
+        /*
+         * Close to the quota, nudge the sleep time proportionally to
+         * the remaining error.  The step shrinks as the error does, so
+         * frequent adjustments converge instead of oscillating around
+         * the quota like a fixed step would.
+         */
+        uint64_t max = MAX(quota, current);
+
+        sleep_pct = (max - MIN(quota, current)) * 100 / max;
+        throttle_us = ring_full_time_us * sleep_pct / 100 / 4;
+
         if (quota < current) {
-            cpu->throttle_us_per_full += ring_full_time_us / 10;
+            cpu->throttle_us_per_full += throttle_us;
         } else {
-            cpu->throttle_us_per_full -= ring_full_time_us / 10;
+            cpu->throttle_us_per_full -= throttle_us;
         }
     }
 
@@ -339,6 +358,8 @@ static void dirtylimit_adjust_throttle(CPUState *cpu)
         dirtylimit_set_throttle(cpu, quota, current);
     }
 
+    trace_dirtylimit_adjust_throttle(cpu_index, quota, current,
+                                     cpu->throttle_us_per_full);
     return;
 }
 
@@ -615,6 +636,8 @@ static struct DirtyLimitInfo *dirtylimit_query_vcpu(int cpu_index)
     info->cpu_index = cpu_index;
     info->limit_rate = dirtylimit_vcpu_get_state(cpu_index)->quota;
     info->current_rate = vcpu_dirty_rate_get(cpu_index);
+    info->throttle_time_per_full =
+        qemu_get_cpu(cpu_index)->throttle_us_per_full;
 
     return info;
 }
@@ -669,9 +692,11 @@ void hmp_info_vcpu_dirty_limit(Monitor *mon, const QDict *qdict)
 
     for (info = head; info != NULL; info = info->next) {
         monitor_printf(mon, "vcpu[%"PRIi64"], limit rate %"PRIi64 " (MB/s),"
-                            " current rate %"PRIi64 " (MB/s)\n",
+                            " current rate %"PRIi64 " (MB/s),"
+                            " throttle time %"PRIi64 " (us)\n",
                             info->value->cpu_index,
                             info->value->limit_rate,
-                            info->value->current_rate);
+                            info->value->current_rate,
+                            info->value->throttle_time_per_full);
     }
 }
@@ -40,6 +40,35 @@
 static unsigned memory_region_transaction_depth;
 static bool memory_region_update_pending;
 static bool ioeventfd_update_pending;
+
+/*
+ * Monotonic counter bumped on every topology change.  Modified regions
+ * propagate it to all their containers, so comparing a FlatView's
+ * render_gen with its root's update_gen tells whether the cached view
+ * still matches the subtree it was rendered from.
+ */
+static uint64_t memory_region_topology_gen;
+/* Generation of the last change that invalidates every FlatView */
+static uint64_t memory_all_views_dirty_gen;
+
+static void memory_region_mark_updated(MemoryRegion *mr)
+{
+    uint64_t gen = ++memory_region_topology_gen;
+
+    for (; mr; mr = mr->container) {
+        mr->update_gen = gen;
+    }
+}
+
+static void memory_region_mark_all_updated(void)
+{
+    memory_all_views_dirty_gen = ++memory_region_topology_gen;
+}
+
+uint64_t memory_region_topology_generation(void)
+{
+    return memory_region_topology_gen;
+}
 unsigned int global_dirty_tracking;
 
 static QTAILQ_HEAD(, MemoryListener) memory_listeners
@@ -563,7 +592,15 @@ static MemTxResult access_with_adjusted_size(hwaddr addr,
     /* FIXME: support unaligned access? */
     access_size = MAX(MIN(size, access_size_max), access_size_min);
     access_mask = MAKE_64BIT_MASK(0, access_size * 8);
-    if (memory_region_big_endian(mr)) {
+    if (likely(access_size == size)) {
+        /*
+         * The common case: the access already fits the implementation,
+         * no splitting or widening needed.  A single access at shift 0
+         * is endianness-agnostic, so skip the device endianness lookup
+         * and the loop bookkeeping entirely.
+         */
+        r = access_fn(mr, addr, value, size, 0, access_mask, attrs);
+    } else if (memory_region_big_endian(mr)) {
         for (i = 0; i < size; i += access_size) {
             r |= access_fn(mr, addr + i, value, access_size,
                         (size - access_size - i) * 8, access_mask, attrs);
@@ -632,6 +669,21 @@ static void render_memory_region(FlatView *view,
     clip = addrrange_intersection(tmp, clip);
 
     if (mr->alias) {
+        /*
+         * An alias pointing outside the root's subtree makes the view
+         * depend on regions whose changes are not visible through the
+         * root's update_gen, so it can never be reused from the cache.
+         */
+        if (!view->foreign_deps) {
+            MemoryRegion *m = mr->alias;
+
+            while (m && m != view->root) {
+                m = m->container;
+            }
+            if (!m) {
+                view->foreign_deps = true;
+            }
+        }
         int128_subfrom(&base, int128_make64(mr->alias->addr));
         int128_subfrom(&base, int128_make64(mr->alias_offset));
         render_memory_region(view, mr->alias, base, clip,
@@ -756,6 +808,7 @@ static FlatView *generate_memory_topology(MemoryRegion *mr)
     FlatView *view;
 
     view = flatview_new(mr);
+    view->render_gen = memory_region_topology_gen;
 
     if (mr) {
         render_memory_region(view, mr, int128_zero(),
@@ -1030,26 +1083,57 @@ static void flatviews_init(void)
     }
 }
 
+static gboolean flatview_is_stale(gpointer key, gpointer value,
+                                  gpointer user_data)
+{
+    MemoryRegion *physmr = key;
+    FlatView *view = value;
+
+    if (!physmr) {
+        return FALSE; /* the shared empty view never goes stale */
+    }
+
+    return view->foreign_deps ||
+           view->render_gen < physmr->update_gen ||
+           view->render_gen < memory_all_views_dirty_gen;
+}
+
+static gboolean flatview_is_unused(gpointer key, gpointer value,
+                                   gpointer user_data)
+{
+    GHashTable *live_roots = user_data;
+
+    return key && !g_hash_table_contains(live_roots, key);
+}
+
 static void flatviews_reset(void)
 {
+    g_autoptr(GHashTable) live_roots = g_hash_table_new(NULL, NULL);
     AddressSpace *as;
 
-    if (flat_views) {
-        g_hash_table_unref(flat_views);
-        flat_views = NULL;
-    }
     flatviews_init();
 
-    /* Render unique FVs */
+    /*
+     * Drop views whose root subtree changed since they were rendered;
+     * the others describe unmodified subtrees and are reused as-is, so
+     * a commit only re-renders the address spaces it actually touched.
+     */
+    g_hash_table_foreach_remove(flat_views, flatview_is_stale, NULL);
+
+    /* Render missing FVs */
     QTAILQ_FOREACH(as, &address_spaces, address_spaces_link) {
         MemoryRegion *physmr = memory_region_get_flatview_root(as->root);
 
+        g_hash_table_add(live_roots, physmr);
         if (g_hash_table_lookup(flat_views, physmr)) {
             continue;
         }
 
         generate_memory_topology(physmr);
     }
+
+    /* Drop views whose root is no longer used by any address space */
+    g_hash_table_foreach_remove(flat_views, flatview_is_unused, live_roots);
 }
 
 static void address_space_set_flatview(AddressSpace *as)
@@ -1472,9 +1556,27 @@ static bool memory_region_dispatch_write_eventfds(MemoryRegion *mr,
         .addr = addrrange_make(int128_make64(addr), int128_make64(size)),
         .data = data,
     };
-    unsigned i;
+    unsigned i, lo, hi;
 
-    for (i = 0; i < mr->ioeventfd_nb; i++) {
+    /*
+     * The array is sorted by (address, size, data); binary search for
+     * the first candidate at this address instead of scanning all
+     * eventfds, which adds up for a notify region with many queues.
+     */
+    lo = 0;
+    hi = mr->ioeventfd_nb;
+    while (lo < hi) {
+        i = (lo + hi) / 2;
+        if (int128_lt(mr->ioeventfds[i].addr.start, ioeventfd.addr.start)) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+
+    for (i = lo; i < mr->ioeventfd_nb &&
+                 int128_eq(mr->ioeventfds[i].addr.start, ioeventfd.addr.start);
+         i++) {
         ioeventfd.match_data = mr->ioeventfds[i].match_data;
         ioeventfd.e = mr->ioeventfds[i].e;
 
@@ -2235,6 +2337,7 @@ void memory_region_set_log(MemoryRegion *mr, bool log, unsigned client)
 
     memory_region_transaction_begin();
     mr->dirty_log_mask = (mr->dirty_log_mask & ~mask) | (log * mask);
+    memory_region_mark_updated(mr);
     memory_region_update_pending |= mr->enabled;
     memory_region_transaction_commit();
 }
@@ -2365,6 +2468,7 @@ void memory_region_set_readonly(MemoryRegion *mr, bool readonly)
     if (mr->readonly != readonly) {
         memory_region_transaction_begin();
         mr->readonly = readonly;
+        memory_region_mark_updated(mr);
         memory_region_update_pending |= mr->enabled;
         memory_region_transaction_commit();
     }
@@ -2375,6 +2479,7 @@ void memory_region_set_nonvolatile(MemoryRegion *mr, bool nonvolatile)
     if (mr->nonvolatile != nonvolatile) {
         memory_region_transaction_begin();
         mr->nonvolatile = nonvolatile;
+        memory_region_mark_updated(mr);
         memory_region_update_pending |= mr->enabled;
         memory_region_transaction_commit();
     }
@@ -2385,6 +2490,7 @@ void memory_region_rom_device_set_romd(MemoryRegion *mr, bool romd_mode)
     if (mr->romd_mode != romd_mode) {
         memory_region_transaction_begin();
         mr->romd_mode = romd_mode;
+        memory_region_mark_updated(mr);
         memory_region_update_pending |= mr->enabled;
         memory_region_transaction_commit();
     }
@@ -2621,6 +2727,7 @@ static void memory_region_update_container_subregions(MemoryRegion *subregion)
     }
     QTAILQ_INSERT_TAIL(&mr->subregions, subregion, subregions_link);
 done:
+    memory_region_mark_updated(subregion);
     memory_region_update_pending |= mr->enabled && subregion->enabled;
     memory_region_transaction_commit();
 }
@@ -2671,6 +2778,8 @@ void memory_region_del_subregion(MemoryRegion *mr,
     }
     QTAILQ_REMOVE(&mr->subregions, subregion, subregions_link);
     memory_region_unref(subregion);
+    memory_region_mark_updated(mr);
+    memory_region_mark_updated(subregion);
     memory_region_update_pending |= mr->enabled && subregion->enabled;
     memory_region_transaction_commit();
 }
@@ -2682,6 +2791,7 @@ void memory_region_set_enabled(MemoryRegion *mr, bool enabled)
     }
     memory_region_transaction_begin();
     mr->enabled = enabled;
+    memory_region_mark_updated(mr);
     memory_region_update_pending = true;
     memory_region_transaction_commit();
 }
@@ -2698,6 +2808,7 @@ void memory_region_set_size(MemoryRegion *mr, uint64_t size)
     }
     memory_region_transaction_begin();
     mr->size = s;
+    memory_region_mark_updated(mr);
     memory_region_update_pending = true;
     memory_region_transaction_commit();
 }
@@ -2734,6 +2845,7 @@ void memory_region_set_alias_offset(MemoryRegion *mr, hwaddr offset)
 
     memory_region_transaction_begin();
     mr->alias_offset = offset;
+    memory_region_mark_updated(mr);
     memory_region_update_pending |= mr->enabled;
     memory_region_transaction_commit();
 }
@@ -2746,6 +2858,7 @@ void memory_region_set_unmergeable(MemoryRegion *mr, bool unmergeable)
 
     memory_region_transaction_begin();
     mr->unmergeable = unmergeable;
+    memory_region_mark_updated(mr);
     memory_region_update_pending |= mr->enabled;
     memory_region_transaction_commit();
 }
@@ -2945,6 +3058,7 @@ bool memory_global_dirty_log_start(unsigned int flags, Error **errp)
         }
 
         memory_region_transaction_begin();
+        memory_region_mark_all_updated();
         memory_region_update_pending = true;
         memory_region_transaction_commit();
     }
@@ -2961,6 +3075,7 @@ static void memory_global_dirty_log_do_stop(unsigned int flags)
 
     if (!global_dirty_tracking) {
         memory_region_transaction_begin();
+        memory_region_mark_all_updated();
         memory_region_update_pending = true;
         memory_region_transaction_commit();
         MEMORY_LISTENER_CALL_GLOBAL(log_global_stop, Reverse);
@@ -3150,6 +3265,11 @@ void address_space_init(AddressSpace *as, MemoryRegion *root, const char *name)
     QTAILQ_INSERT_TAIL(&address_spaces, as, address_spaces_link);
     as->max_bounce_buffer_size = DEFAULT_MAX_BOUNCE_BUFFER_SIZE;
     as->bounce_buffer_size = 0;
+    qemu_mutex_init(&as->bounce_pool_lock);
+    for (unsigned i = 0; i < BOUNCE_BUFFER_SIZE_CLASSES; i++) {
+        QSLIST_INIT(&as->bounce_pool[i]);
+        as->bounce_pool_len[i] = 0;
+    }
     qemu_mutex_init(&as->map_client_list_lock);
     QLIST_INIT(&as->map_client_list);
     as->name = g_strdup(name ? name : "anonymous");
@@ -3162,6 +3282,8 @@ static void do_address_space_destroy(AddressSpace *as)
     assert(qatomic_read(&as->bounce_buffer_size) == 0);
     assert(QLIST_EMPTY(&as->map_client_list));
     qemu_mutex_destroy(&as->map_client_list_lock);
+    address_space_drain_bounce_pool(as);
+    qemu_mutex_destroy(&as->bounce_pool_lock);
 
     assert(QTAILQ_EMPTY(&as->listeners));
 
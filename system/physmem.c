@@ -20,6 +20,7 @@
 #include "qemu/osdep.h"
 #include "exec/page-vary.h"
 #include "qapi/error.h"
+#include "qapi/qapi-events-machine.h"
 
 #include "qemu/cutils.h"
 #include "qemu/cacheflush.h"
@@ -334,19 +335,65 @@ static MemoryRegionSection *phys_page_find(AddressSpaceDispatch *d, hwaddr addr)
     }
 }
 
+/*
+ * Per-thread cache of recently hit sections.  DMA-heavy devices bounce
+ * between a handful of sections (command ring, data buffers, doorbell
+ * MMIO), which thrashes the single shared mru_section and bounces its
+ * cacheline between threads.  Entries point into d->map.sections, which
+ * is immutable once rendered; the (dispatch, generation) pair guards
+ * against a recycled dispatch address after a topology change.
+ */
+#define PHYS_SECTION_CACHE_SIZE 4
+
+typedef struct PhysSectionCache {
+    AddressSpaceDispatch *d;
+    uint64_t gen;
+    unsigned int next;
+    MemoryRegionSection *sections[PHYS_SECTION_CACHE_SIZE];
+} PhysSectionCache;
+
+static __thread PhysSectionCache phys_section_cache;
+
 /* Called from RCU critical section */
 static MemoryRegionSection *address_space_lookup_region(AddressSpaceDispatch *d,
                                                         hwaddr addr,
                                                         bool resolve_subpage)
 {
-    MemoryRegionSection *section = qatomic_read(&d->mru_section);
+    PhysSectionCache *cache = &phys_section_cache;
+    MemoryRegionSection *section = NULL;
     subpage_t *subpage;
+    int i;
 
-    if (!section || section == &d->map.sections[PHYS_SECTION_UNASSIGNED] ||
-        !section_covers_addr(section, addr)) {
-        section = phys_page_find(d, addr);
-        qatomic_set(&d->mru_section, section);
+    if (cache->d == d &&
+        cache->gen == memory_region_topology_generation()) {
+        for (i = 0; i < PHYS_SECTION_CACHE_SIZE; i++) {
+            if (cache->sections[i] &&
+                section_covers_addr(cache->sections[i], addr)) {
+                section = cache->sections[i];
+                break;
+            }
+        }
+    } else {
+        cache->d = d;
+        cache->gen = memory_region_topology_generation();
+        cache->next = 0;
+        memset(cache->sections, 0, sizeof(cache->sections));
+    }
+
+    if (!section) {
+        section = qatomic_read(&d->mru_section);
+        if (!section ||
+            section == &d->map.sections[PHYS_SECTION_UNASSIGNED] ||
+            !section_covers_addr(section, addr)) {
+            section = phys_page_find(d, addr);
+            qatomic_set(&d->mru_section, section);
+        }
+        if (section != &d->map.sections[PHYS_SECTION_UNASSIGNED]) {
+            cache->sections[cache->next] = section;
+            cache->next = (cache->next + 1) % PHYS_SECTION_CACHE_SIZE;
+        }
     }
+
     if (resolve_subpage && section->mr->subpage) {
         subpage = container_of(section->mr, subpage_t, iomem);
         section = &d->map.sections[subpage->sub_section[SUBPAGE_IDX(addr)]];
@@ -2128,13 +2175,25 @@ static void reclaim_ramblock(RAMBlock *block)
         ;
     } else if (xen_enabled()) {
         xen_invalidate_map_cache_entry(block->host);
+    } else {
+        /*
+         * RCU callbacks run with the BQL held, and unmapping a large
+         * block can take tens of milliseconds during which every vCPU
+         * exit that needs the BQL would stall.  Once the grace period
+         * has elapsed nothing can reach the block anymore, so release
+         * the host memory unlocked.
+         */
+        bql_unlock();
 #ifndef _WIN32
-    } else if (block->fd >= 0) {
-        qemu_ram_munmap(block->fd, block->host, block->max_length);
-        close(block->fd);
+        if (block->fd >= 0) {
+            qemu_ram_munmap(block->fd, block->host, block->max_length);
+            close(block->fd);
+        } else
 #endif
-    } else {
-        qemu_anon_ram_free(block->host, block->max_length);
+        {
+            qemu_anon_ram_free(block->host, block->max_length);
+        }
+        bql_lock();
     }
 
     if (block->guest_memfd >= 0) {
@@ -2142,6 +2201,10 @@ static void reclaim_ramblock(RAMBlock *block)
         ram_block_discard_require(false);
     }
 
+    if (block->idstr[0]) {
+        qapi_event_send_ram_block_released(block->idstr, block->max_length);
+    }
+
     g_free(block);
 }
 
@@ -3084,13 +3147,89 @@ void cpu_flush_icache_range(hwaddr start, hwaddr len)
  */
 #define BOUNCE_BUFFER_MAGIC 0xb4017ceb4ffe12ed
 
-typedef struct {
+struct BounceBuffer {
     uint64_t magic;
     MemoryRegion *mr;
     hwaddr addr;
     size_t len;
+    size_t capacity;
+    QSLIST_ENTRY(BounceBuffer) free_next;
     uint8_t buffer[];
-} BounceBuffer;
+};
+
+/* Smallest pooled bounce buffer; classes are powers of two above it */
+#define BOUNCE_POOL_BASE_SIZE 4096
+/* Recycled buffers kept around per size class */
+#define BOUNCE_POOL_MAX_LEN 16
+
+static int bounce_buffer_size_class(size_t len)
+{
+    size_t capacity = BOUNCE_POOL_BASE_SIZE;
+    int cls = 0;
+
+    while (capacity < len) {
+        capacity <<= 1;
+        cls++;
+    }
+    return cls < BOUNCE_BUFFER_SIZE_CLASSES ? cls : -1;
+}
+
+static BounceBuffer *bounce_buffer_get(AddressSpace *as, size_t len)
+{
+    int cls = bounce_buffer_size_class(len);
+    BounceBuffer *bounce = NULL;
+
+    if (cls >= 0) {
+        qemu_mutex_lock(&as->bounce_pool_lock);
+        bounce = QSLIST_FIRST(&as->bounce_pool[cls]);
+        if (bounce) {
+            QSLIST_REMOVE_HEAD(&as->bounce_pool[cls], free_next);
+            as->bounce_pool_len[cls]--;
+        }
+        qemu_mutex_unlock(&as->bounce_pool_lock);
+    }
+    if (!bounce) {
+        size_t capacity = cls >= 0 ? BOUNCE_POOL_BASE_SIZE << cls : len;
+
+        bounce = g_malloc(sizeof(*bounce) + capacity);
+        bounce->capacity = capacity;
+    }
+    bounce->magic = BOUNCE_BUFFER_MAGIC;
+    return bounce;
+}
+
+static void bounce_buffer_put(AddressSpace *as, BounceBuffer *bounce)
+{
+    int cls = bounce_buffer_size_class(bounce->capacity);
+
+    bounce->magic = ~BOUNCE_BUFFER_MAGIC;
+    if (cls >= 0 && (BOUNCE_POOL_BASE_SIZE << cls) == bounce->capacity) {
+        qemu_mutex_lock(&as->bounce_pool_lock);
+        if (as->bounce_pool_len[cls] < BOUNCE_POOL_MAX_LEN) {
+            QSLIST_INSERT_HEAD(&as->bounce_pool[cls], bounce, free_next);
+            as->bounce_pool_len[cls]++;
+            bounce = NULL;
+        }
+        qemu_mutex_unlock(&as->bounce_pool_lock);
+    }
+    g_free(bounce);
+}
+
+void address_space_drain_bounce_pool(AddressSpace *as)
+{
+    int cls;
+
+    qemu_mutex_lock(&as->bounce_pool_lock);
+    for (cls = 0; cls < BOUNCE_BUFFER_SIZE_CLASSES; cls++) {
+        while (!QSLIST_EMPTY(&as->bounce_pool[cls])) {
+            BounceBuffer *bounce = QSLIST_FIRST(&as->bounce_pool[cls]);
+            QSLIST_REMOVE_HEAD(&as->bounce_pool[cls], free_next);
+            g_free(bounce);
+        }
+        as->bounce_pool_len[cls] = 0;
+    }
+    qemu_mutex_unlock(&as->bounce_pool_lock);
+}
 
 static void
 address_space_unregister_map_client_do(AddressSpaceMapClient *client)
@@ -3266,8 +3405,7 @@ void *address_space_map(AddressSpace *as,
             return NULL;
         }
 
-        BounceBuffer *bounce = g_malloc0(l + sizeof(BounceBuffer));
-        bounce->magic = BOUNCE_BUFFER_MAGIC;
+        BounceBuffer *bounce = bounce_buffer_get(as, l);
         memory_region_ref(mr);
         bounce->mr = mr;
         bounce->addr = addr;
@@ -3276,6 +3414,9 @@ void *address_space_map(AddressSpace *as,
         if (!is_write) {
             flatview_read(fv, addr, attrs,
                           bounce->buffer, l);
+        } else {
+            /* match the zero fill that a fresh allocation used to get */
+            memset(bounce->buffer, 0, l);
         }
 
         *plen = l;
@@ -3321,9 +3462,8 @@ void address_space_unmap(AddressSpace *as, void *buffer, hwaddr len,
     }
 
     qatomic_sub(&as->bounce_buffer_size, bounce->len);
-    bounce->magic = ~BOUNCE_BUFFER_MAGIC;
     memory_region_unref(bounce->mr);
-    g_free(bounce);
+    bounce_buffer_put(as, bounce);
     /* Write bounce_buffer_size before reading map_client_list. */
     smp_mb();
     address_space_notify_map_clients(as);
@@ -3618,6 +3758,88 @@ int qemu_ram_foreach_block(RAMBlockIterFunc func, void *opaque)
     return ret;
 }
 
+/*
+ * Advise the host kernel to reclaim guest RAM: with @cold_only the pages
+ * are merely deactivated so they go first when the kernel next reclaims
+ * under pressure, otherwise they are paged out right away.  Either way the
+ * mappings stay intact and guest accesses fault the pages back in on
+ * demand, so this trades access latency for host memory, unlike the
+ * destructive ram_block_discard_range().
+ */
+/*
+ * Sweep cursor for budgeted pageout: the block (by idstr, so a
+ * hot-unplugged block merely restarts the sweep) and the offset where
+ * the previous invocation ran out of budget.
+ */
+static char *pageout_cursor_block;
+static uint64_t pageout_cursor_offset;
+
+uint64_t qemu_ram_pageout_all(bool cold_only, uint64_t max_bytes,
+                              bool *complete, Error **errp)
+{
+    int advice = cold_only ? QEMU_MADV_COLD : QEMU_MADV_PAGEOUT;
+    uint64_t budget = max_bytes ?: UINT64_MAX;
+    uint64_t advised = 0;
+    bool resuming = max_bytes && pageout_cursor_block;
+    RAMBlock *block;
+
+    *complete = false;
+
+    if (advice == QEMU_MADV_INVALID) {
+        error_setg(errp, "madvise %s is not supported by this host",
+                   cold_only ? "MADV_COLD" : "MADV_PAGEOUT");
+        return 0;
+    }
+
+    RCU_READ_LOCK_GUARD();
+    RAMBLOCK_FOREACH(block) {
+        uint64_t offset = 0;
+
+        if (resuming) {
+            if (strcmp(block->idstr, pageout_cursor_block) != 0) {
+                continue;
+            }
+            offset = MIN(pageout_cursor_offset, block->used_length);
+            resuming = false;
+        }
+        if (!block->host) {
+            continue;
+        }
+
+        while (offset < block->used_length) {
+            uint64_t chunk = MIN(block->used_length - offset, budget);
+
+            /* keep the next resume point host page aligned */
+            chunk = MIN(ROUND_UP(chunk, qemu_real_host_page_size()),
+                        block->used_length - offset);
+
+            if (qemu_madvise(block->host + offset, chunk, advice) < 0) {
+                error_setg_errno(errp, errno,
+                                 "madvise of RAM block '%s' failed",
+                                 block->idstr);
+                return advised;
+            }
+            offset += chunk;
+            advised += chunk;
+            budget -= MIN(chunk, budget);
+
+            if (!budget) {
+                g_free(pageout_cursor_block);
+                pageout_cursor_block = g_strdup(block->idstr);
+                pageout_cursor_offset = offset;
+                return advised;
+            }
+        }
+    }
+
+    /* Reached the end of guest RAM: the next sweep starts over */
+    g_free(pageout_cursor_block);
+    pageout_cursor_block = NULL;
+    pageout_cursor_offset = 0;
+    *complete = true;
+    return advised;
+}
+
 /*
  * Unmap pages of memory from start to start+length such that
  * they a) read as 0, b) Trigger whatever fault mechanism
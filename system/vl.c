@@ -27,6 +27,7 @@
 #include "qemu/datadir.h"
 #include "qemu/units.h"
 #include "exec/cpu-common.h"
+#include "exec/memory.h"
 #include "exec/page-vary.h"
 #include "hw/qdev-properties.h"
 #include "qapi/compat-policy.h"
@@ -2649,6 +2650,16 @@ static void qemu_create_cli_devices(void)
 
     /* init generic devices */
     rom_set_order_override(FW_CFG_ORDER_OVERRIDE_DEVICE);
+
+    /*
+     * Batch the memory transactions of all command-line devices into a
+     * single commit: each realize that maps a region would otherwise
+     * rebuild every flat view on its own, which dominates machine
+     * creation time for guests with hundreds of devices.  Nothing
+     * accesses the new regions before machine creation is done, so
+     * deferring their visibility to one commit is safe.
+     */
+    memory_region_transaction_begin();
     qemu_opts_foreach(qemu_find_opts("device"),
                       device_init_func, NULL, &error_fatal);
     QTAILQ_FOREACH(opt, &device_opts, next) {
@@ -2665,6 +2676,7 @@ static void qemu_create_cli_devices(void)
         object_unref(OBJECT(dev));
         loc_pop(&opt->loc);
     }
+    memory_region_transaction_commit();
     rom_reset_order_override();
 }
 
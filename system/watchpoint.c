@@ -40,6 +40,7 @@ int cpu_watchpoint_insert(CPUState *cpu, vaddr addr, vaddr len,
     wp->vaddr = addr;
     wp->len = len;
     wp->flags = flags;
+    wp->hit_count = 0;
 
     /* keep all GDB-injected watchpoints in front */
     if (flags & BP_GDB) {
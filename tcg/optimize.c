@@ -161,10 +161,17 @@ static void init_ts_info(OptContext *ctx, TCGTemp *ts)
     }
     set_bit(idx, ctx->temps_used.l);
 
-    ti = ts->state_ptr;
-    if (ti == NULL) {
+    /*
+     * The TempOptInfo of a previous translation was recycled with the
+     * arena by tcg_pool_reset; detect this by generation rather than
+     * by clearing every state_ptr at the start of each pass.
+     */
+    if (ts->opt_gen != ctx->tcg->opt_gen) {
+        ts->opt_gen = ctx->tcg->opt_gen;
         ti = tcg_malloc(sizeof(TempOptInfo));
         ts->state_ptr = ti;
+    } else {
+        ti = ts->state_ptr;
     }
 
     ti->next_copy = ts;
@@ -2795,21 +2802,18 @@ static bool fold_bitsel_vec(OptContext *ctx, TCGOp *op)
 /* Propagate constants and copies, fold constant expressions. */
 void tcg_optimize(TCGContext *s)
 {
-    int nb_temps, i;
     TCGOp *op, *op_next;
     OptContext ctx = { .tcg = s };
 
     QSIMPLEQ_INIT(&ctx.mem_free);
 
-    /* Array VALS has an element for each temp.
-       If this temp holds a constant then its value is kept in VALS' element.
-       If this temp is a copy of other ones then the other copies are
-       available through the doubly linked circular list. */
-
-    nb_temps = s->nb_temps;
-    for (i = 0; i < nb_temps; ++i) {
-        s->temps[i].state_ptr = NULL;
-    }
+    /*
+     * Each temp's state_ptr points at a TempOptInfo while it is live in
+     * this pass.  Opening a new generation invalidates the state_ptr of
+     * every temp at once; init_ts_info reallocates on first use instead
+     * of us clearing all nb_temps pointers here.
+     */
+    s->opt_gen++;
 
     QTAILQ_FOREACH_SAFE(op, &s->ops, link, op_next) {
         TCGOpcode opc = op->opc;
@@ -9,9 +9,14 @@
  */
 
 #include "qemu/osdep.h"
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+
 #include "elf.h"
 #include "exec/target_page.h"
 #include "exec/translation-block.h"
+#include "qemu/atomic.h"
 #include "qemu/timer.h"
 #include "tcg/debuginfo.h"
 #include "tcg/perf.h"
@@ -241,6 +246,65 @@ void perf_report_prologue(const void *start, size_t size)
     }
 }
 
+/*
+ * Host iTLB miss counters, one per translation thread.  The events are
+ * thread-scoped, so each thread opens its own at registration time and
+ * perf_itlb_misses() sums them up.  Opening can legitimately fail, e.g.
+ * when perf_event_paranoid forbids it; the counter is then simply
+ * reported as unavailable.
+ */
+#define ITLB_MAX_COUNTERS 256
+
+static int itlb_fds[ITLB_MAX_COUNTERS];
+static unsigned itlb_nb_fds;
+
+void perf_itlb_counter_open(void)
+{
+    struct perf_event_attr attr = {
+        .type = PERF_TYPE_HW_CACHE,
+        .size = sizeof(attr),
+        .config = PERF_COUNT_HW_CACHE_ITLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        .exclude_kernel = 1,
+        .exclude_hv = 1,
+    };
+    unsigned i;
+    int fd;
+
+    fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    i = qatomic_fetch_inc(&itlb_nb_fds);
+    if (i >= ITLB_MAX_COUNTERS) {
+        close(fd);
+        return;
+    }
+    qatomic_set(&itlb_fds[i], fd);
+}
+
+bool perf_itlb_misses(uint64_t *misses)
+{
+    unsigned i, n = MIN(qatomic_read(&itlb_nb_fds), ITLB_MAX_COUNTERS);
+    uint64_t total = 0;
+    bool avail = false;
+
+    for (i = 0; i < n; i++) {
+        int fd = qatomic_read(&itlb_fds[i]);
+        uint64_t count;
+
+        if (fd > 0 && read(fd, &count, sizeof(count)) == sizeof(count)) {
+            total += count;
+            avail = true;
+        }
+    }
+
+    *misses = total;
+    return avail;
+}
+
 /* Write a JIT_CODE_DEBUG_INFO jitdump entry. */
 static void write_jr_code_debug_info(const void *start,
                                      const struct debuginfo_query *q,
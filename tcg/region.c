@@ -72,6 +72,8 @@ struct tcg_region_state {
     /* fields protected by the lock */
     size_t current; /* current region index */
     size_t agg_size_full; /* aggregate size of full regions */
+    size_t *recycled; /* stack of evicted region indexes */
+    size_t nb_recycled;
 };
 
 static struct tcg_region_state region;
@@ -359,6 +361,11 @@ static void tcg_region_assign(TCGContext *s, size_t curr_region)
 
 static bool tcg_region_alloc__locked(TCGContext *s)
 {
+    /* Prefer regions reclaimed by tcg_region_evict_cold(). */
+    if (region.nb_recycled > 0) {
+        tcg_region_assign(s, region.recycled[--region.nb_recycled]);
+        return false;
+    }
     if (region.current == region.n) {
         return true;
     }
@@ -403,6 +410,135 @@ void tcg_region_initial_alloc(TCGContext *s)
     qemu_mutex_unlock(&region.lock);
 }
 
+static gboolean tcg_region_collect_tb(gpointer key, gpointer value,
+                                      gpointer data)
+{
+    g_ptr_array_add(data, value);
+    return FALSE;
+}
+
+/* Evict every TB of region @idx and reset the region tree. */
+static void tcg_region_evict_one(size_t idx,
+                                 void (*evict)(TranslationBlock *tb))
+{
+    struct tcg_region_tree *rt = region_trees + idx * tree_size;
+    GPtrArray *tbs = g_ptr_array_new();
+    size_t i;
+
+    qemu_mutex_lock(&rt->lock);
+    q_tree_foreach(rt->tree, tcg_region_collect_tb, tbs);
+    qemu_mutex_unlock(&rt->lock);
+
+    for (i = 0; i < tbs->len; i++) {
+        evict(g_ptr_array_index(tbs, i));
+    }
+
+    /* Increment the refcount first so that destroy acts as a reset */
+    qemu_mutex_lock(&rt->lock);
+    q_tree_ref(rt->tree);
+    q_tree_destroy(rt->tree);
+    qemu_mutex_unlock(&rt->lock);
+
+    g_ptr_array_free(tbs, true);
+}
+
+static gboolean tcg_region_sum_hotness(gpointer key, gpointer value,
+                                       gpointer data)
+{
+    const TranslationBlock *tb = value;
+
+    *(uint64_t *)data += qatomic_read(&tb->exec_count);
+    return FALSE;
+}
+
+/* Aggregate execution count of all TBs currently in region @idx. */
+static uint64_t tcg_region_hotness(size_t idx)
+{
+    struct tcg_region_tree *rt = region_trees + idx * tree_size;
+    uint64_t sum = 0;
+
+    qemu_mutex_lock(&rt->lock);
+    q_tree_foreach(rt->tree, tcg_region_sum_hotness, &sum);
+    qemu_mutex_unlock(&rt->lock);
+    return sum;
+}
+
+/*
+ * Reclaim the least-executed half of the filled regions instead of
+ * flushing the entire code cache.  @evict is called for every TB found
+ * in a victim region and must unlink it from the translation machinery;
+ * the region is then handed back to the allocator.  Regions currently
+ * assigned to a TCGContext are never victims.
+ *
+ * Returns the number of regions reclaimed; 0 means the caller must fall
+ * back to a full flush.  Call from a safe-work context, with no
+ * translation in progress.
+ */
+size_t tcg_region_evict_cold(void (*evict)(TranslationBlock *tb))
+{
+    unsigned int n_ctxs = qatomic_read(&tcg_cur_ctxs);
+    g_autofree bool *excluded = g_new0(bool, region.n);
+    g_autofree size_t *victims = g_new(size_t, region.n);
+    g_autofree uint64_t *score = g_new(uint64_t, region.n);
+    size_t i, j, nb_candidates = 0, nb_victims, goal;
+
+    qemu_mutex_lock(&region.lock);
+    for (i = 0; i < n_ctxs; i++) {
+        TCGContext *s = qatomic_read(&tcg_ctxs[i]);
+        ptrdiff_t offset = s->code_gen_buffer - region.start_aligned;
+
+        excluded[MIN((size_t)offset / region.stride, region.n - 1)] = true;
+    }
+    for (i = 0; i < region.nb_recycled; i++) {
+        excluded[region.recycled[i]] = true;
+    }
+
+    /* Evict at most half of what has been filled. */
+    goal = DIV_ROUND_UP(region.current, 2);
+    for (i = 0; i < region.current; i++) {
+        if (!excluded[i]) {
+            victims[nb_candidates++] = i;
+        }
+    }
+    qemu_mutex_unlock(&region.lock);
+
+    /*
+     * Order candidates by aggregate TB execution count so that the
+     * least-executed code is sacrificed first.  The candidate set is
+     * tiny (at most max_cpus * 8), insertion sort will do.
+     */
+    for (i = 0; i < nb_candidates; i++) {
+        score[i] = tcg_region_hotness(victims[i]);
+        for (j = i; j > 0 && score[j - 1] > score[j]; j--) {
+            uint64_t ts = score[j];
+            size_t tv = victims[j];
+
+            score[j] = score[j - 1];
+            victims[j] = victims[j - 1];
+            score[j - 1] = ts;
+            victims[j - 1] = tv;
+        }
+    }
+    nb_victims = MIN(nb_candidates, goal);
+
+    for (i = 0; i < nb_victims; i++) {
+        tcg_region_evict_one(victims[i], evict);
+    }
+
+    qemu_mutex_lock(&region.lock);
+    for (i = 0; i < nb_victims; i++) {
+        void *start, *end;
+
+        tcg_region_bounds(victims[i], &start, &end);
+        region.agg_size_full -= MIN(region.agg_size_full,
+                                    (size_t)(end - start) - TCG_HIGHWATER);
+        region.recycled[region.nb_recycled++] = victims[i];
+    }
+    qemu_mutex_unlock(&region.lock);
+
+    return nb_victims;
+}
+
 /* Call from a safe-work context */
 void tcg_region_reset_all(void)
 {
@@ -412,6 +548,7 @@ void tcg_region_reset_all(void)
     qemu_mutex_lock(&region.lock);
     region.current = 0;
     region.agg_size_full = 0;
+    region.nb_recycled = 0;
 
     for (i = 0; i < n_ctxs; i++) {
         TCGContext *s = qatomic_read(&tcg_ctxs[i]);
@@ -551,19 +688,40 @@ static int alloc_code_gen_buffer(size_t size, int splitwx, Error **errp)
     return PROT_READ | PROT_WRITE | PROT_EXEC;
 }
 #else
+/*
+ * Trim an over-allocated mapping down to @size bytes starting at the
+ * first QEMU_VMALLOC_ALIGN boundary.  The hugepage madvise in
+ * tcg_region_init is of little use if the buffer starts in the middle
+ * of a huge page, so allocations below over-map by QEMU_VMALLOC_ALIGN
+ * and give the slack back here.
+ */
+static void *trim_to_alignment(void *buf, size_t size)
+{
+    void *aligned = QEMU_ALIGN_PTR_UP(buf, QEMU_VMALLOC_ALIGN);
+    void *end = buf + size + QEMU_VMALLOC_ALIGN;
+
+    if (aligned > buf) {
+        munmap(buf, aligned - buf);
+    }
+    if (end > aligned + size) {
+        munmap(aligned + size, end - (aligned + size));
+    }
+    return aligned;
+}
+
 static int alloc_code_gen_buffer_anon(size_t size, int prot,
                                       int flags, Error **errp)
 {
     void *buf;
 
-    buf = mmap(NULL, size, prot, flags, -1, 0);
+    buf = mmap(NULL, size + QEMU_VMALLOC_ALIGN, prot, flags, -1, 0);
     if (buf == MAP_FAILED) {
         error_setg_errno(errp, errno,
                          "allocate %zu bytes for jit buffer", size);
         return -1;
     }
 
-    region.start_aligned = buf;
+    region.start_aligned = trim_to_alignment(buf, size);
     region.total_size = size;
     return prot;
 }
@@ -574,7 +732,7 @@ static int alloc_code_gen_buffer_anon(size_t size, int prot,
 
 static int alloc_code_gen_buffer_splitwx_memfd(size_t size, Error **errp)
 {
-    void *buf_rw = NULL, *buf_rx = MAP_FAILED;
+    void *buf_rw = NULL, *buf_rx = MAP_FAILED, *reserve = MAP_FAILED;
     int fd = -1;
 
     buf_rw = qemu_memfd_alloc("tcg-jit", size, 0, &fd, errp);
@@ -582,12 +740,31 @@ static int alloc_code_gen_buffer_splitwx_memfd(size_t size, Error **errp)
         goto fail;
     }
 
-    buf_rx = mmap(NULL, size, host_prot_read_exec(), MAP_SHARED, fd, 0);
+    /*
+     * Place the execute mapping at an aligned address so that it can be
+     * backed by transparent huge pages; it is the view the host iTLB
+     * sees.  Reserve an over-sized window, map the memfd into it at the
+     * alignment boundary, and trim the slack.
+     */
+    reserve = mmap(NULL, size + QEMU_VMALLOC_ALIGN, PROT_NONE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reserve == MAP_FAILED) {
+        error_setg_errno(errp, errno,
+                         "failed to reserve memory for execute");
+        goto fail;
+    }
+
+    buf_rx = mmap(QEMU_ALIGN_PTR_UP(reserve, QEMU_VMALLOC_ALIGN), size,
+                  host_prot_read_exec(), MAP_SHARED | MAP_FIXED, fd, 0);
     if (buf_rx == MAP_FAILED) {
         error_setg_errno(errp, errno,
                          "failed to map shared memory for execute");
         goto fail;
     }
+    /* Release the PROT_NONE slack around the execute mapping. */
+    if (trim_to_alignment(reserve, size) != buf_rx) {
+        g_assert_not_reached();
+    }
 
     close(fd);
     region.start_aligned = buf_rw;
@@ -597,7 +774,9 @@ static int alloc_code_gen_buffer_splitwx_memfd(size_t size, Error **errp)
     return PROT_READ | PROT_WRITE;
 
  fail:
-    /* buf_rx is always equal to MAP_FAILED here and does not require cleanup */
+    if (reserve != MAP_FAILED) {
+        munmap(reserve, size + QEMU_VMALLOC_ALIGN);
+    }
     if (buf_rw) {
         munmap(buf_rw, size);
     }
@@ -808,6 +987,8 @@ void tcg_region_init(size_t tb_size, int splitwx, unsigned max_cpus)
 
     /* init the region struct */
     qemu_mutex_init(&region.lock);
+    region.recycled = g_new(size_t, region.n);
+    region.nb_recycled = 0;
 
     /*
      * Set guard pages in the rw buffer, as that's the one into which
@@ -809,6 +809,7 @@ void tcg_register_thread(void)
     }
 
     tcg_ctx = s;
+    perf_itlb_counter_open();
 }
 #endif /* !CONFIG_USER_ONLY */
 
@@ -2239,6 +2240,16 @@ bool tcg_op_supported(TCGOpcode op)
 
 static TCGOp *tcg_op_alloc(TCGOpcode opc, unsigned nargs);
 
+static GHashTable *helper_inline_table;
+
+void tcg_register_helper_inline(void *func, TCGHelperInlineFn fn)
+{
+    if (!helper_inline_table) {
+        helper_inline_table = g_hash_table_new(NULL, NULL);
+    }
+    g_hash_table_insert(helper_inline_table, func, (gpointer)fn);
+}
+
 static void tcg_gen_callN(void *func, TCGHelperInfo *info,
                           TCGTemp *ret, TCGTemp **args)
 {
@@ -2247,6 +2258,18 @@ static void tcg_gen_callN(void *func, TCGHelperInfo *info,
     TCGOp *op;
     int i, n, pi = 0, total_args;
 
+    /*
+     * The table is populated before the first translation and read-only
+     * afterwards, so the lockless lookup is safe under MTTCG.
+     */
+    if (helper_inline_table && (info->flags & TCG_CALL_NO_SIDE_EFFECTS)) {
+        TCGHelperInlineFn fn = g_hash_table_lookup(helper_inline_table, func);
+
+        if (fn && fn(ret, args)) {
+            return;
+        }
+    }
+
     if (unlikely(g_once_init_enter(HELPER_INFO_INIT(info)))) {
         init_call_layout(info);
         g_once_init_leave(HELPER_INFO_INIT(info), HELPER_INFO_INIT_VAL(info));
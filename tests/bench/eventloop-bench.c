@@ -0,0 +1,116 @@
+/*
+ * Event loop primitive speed benchmark
+ *
+ * Measures the round-trip cost of the AioContext primitives device
+ * emulation and the block layer lean on: bottom half scheduling, event
+ * notifier dispatch and timer arm/fire.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or
+ * (at your option) any later version.  See the COPYING file in the
+ * top-level directory.
+ */
+#include "qemu/osdep.h"
+#include "block/aio.h"
+#include "qapi/error.h"
+#include "qemu/main-loop.h"
+
+#define N_OPS 1000000
+
+static AioContext *ctx;
+static unsigned remaining;
+
+static QEMUBH *bh;
+
+static void bh_cb(void *opaque)
+{
+    if (--remaining) {
+        qemu_bh_schedule(bh);
+    }
+}
+
+static void bench_bh(void)
+{
+    remaining = N_OPS;
+    bh = aio_bh_new(ctx, bh_cb, NULL);
+
+    g_test_timer_start();
+    qemu_bh_schedule(bh);
+    while (remaining) {
+        aio_poll(ctx, true);
+    }
+    g_test_timer_elapsed();
+    g_test_message("bh schedule+dispatch: %.1f ns/op",
+                   g_test_timer_last() * 1e9 / N_OPS);
+
+    qemu_bh_delete(bh);
+}
+
+static EventNotifier notifier;
+
+static void notifier_cb(EventNotifier *n)
+{
+    event_notifier_test_and_clear(n);
+    if (--remaining) {
+        event_notifier_set(n);
+    }
+}
+
+static void bench_notifier(void)
+{
+    remaining = N_OPS;
+    event_notifier_init(&notifier, false);
+    aio_set_event_notifier(ctx, &notifier, notifier_cb, NULL, NULL);
+
+    g_test_timer_start();
+    event_notifier_set(&notifier);
+    while (remaining) {
+        aio_poll(ctx, true);
+    }
+    g_test_timer_elapsed();
+    g_test_message("event notifier set+dispatch: %.1f ns/op",
+                   g_test_timer_last() * 1e9 / N_OPS);
+
+    aio_set_event_notifier(ctx, &notifier, NULL, NULL, NULL);
+    event_notifier_cleanup(&notifier);
+}
+
+static QEMUTimer timer;
+
+static void timer_cb(void *opaque)
+{
+    if (--remaining) {
+        timer_mod(&timer, qemu_clock_get_ns(QEMU_CLOCK_REALTIME));
+    }
+}
+
+static void bench_timer(void)
+{
+    /* Timers go through the timer wheel as well, use fewer iterations */
+    unsigned n_ops = N_OPS / 10;
+
+    remaining = n_ops;
+    aio_timer_init(ctx, &timer, QEMU_CLOCK_REALTIME, SCALE_NS, timer_cb, NULL);
+
+    g_test_timer_start();
+    timer_mod(&timer, qemu_clock_get_ns(QEMU_CLOCK_REALTIME));
+    while (remaining) {
+        aio_poll(ctx, true);
+    }
+    g_test_timer_elapsed();
+    g_test_message("timer arm+fire: %.1f ns/op",
+                   g_test_timer_last() * 1e9 / n_ops);
+
+    timer_del(&timer);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    qemu_init_main_loop(&error_fatal);
+    ctx = qemu_get_aio_context();
+
+    g_test_add_func("/bench/bh", bench_bh);
+    g_test_add_func("/bench/notifier", bench_notifier);
+    g_test_add_func("/bench/timer", bench_timer);
+    return g_test_run();
+}
@@ -336,6 +336,9 @@ class Engine(object):
             args.append("quiet")
 
         args.append("ramsize=%s" % hardware._mem)
+        if hardware._dirty_rate:
+            args.append("dirtyrate=%s" % hardware._dirty_rate)
+        args.append("pattern=%s" % hardware._dirty_pattern)
 
         cmdline = " ".join(args)
         if tunnelled:
@@ -24,7 +24,8 @@ class Hardware(object):
                  dst_cpu_bind=None, dst_mem_bind=None,
                  prealloc_pages = False,
                  huge_pages=False, locked_pages=False,
-                 dirty_ring_size=0):
+                 dirty_ring_size=0,
+                 dirty_rate=0, dirty_pattern="sequential"):
         self._cpus = cpus
         self._mem = mem # GiB
         self._src_mem_bind = src_mem_bind # List of NUMA nodes
@@ -35,6 +36,8 @@ class Hardware(object):
         self._huge_pages = huge_pages
         self._locked_pages = locked_pages
         self._dirty_ring_size = dirty_ring_size
+        self._dirty_rate = dirty_rate # Total stress dirty rate, MB/s, 0 == unthrottled
+        self._dirty_pattern = dirty_pattern # "sequential" or "random"
 
 
     def serialize(self):
@@ -49,6 +52,8 @@ class Hardware(object):
             "huge_pages": self._huge_pages,
             "locked_pages": self._locked_pages,
             "dirty_ring_size": self._dirty_ring_size,
+            "dirty_rate": self._dirty_rate,
+            "dirty_pattern": self._dirty_pattern,
         }
 
     @classmethod
@@ -63,4 +68,6 @@ class Hardware(object):
             data["prealloc_pages"],
             data["huge_pages"],
             data["locked_pages"],
-            data["dirty_ring_size"])
+            data["dirty_ring_size"],
+            data["dirty_rate"],
+            data["dirty_pattern"])
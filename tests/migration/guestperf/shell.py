@@ -62,6 +62,11 @@ class BaseShell(object):
         parser.add_argument("--locked-pages", dest="locked_pages", default=False)
         parser.add_argument("--dirty-ring-size", dest="dirty_ring_size",
                             default=0, type=int)
+        parser.add_argument("--dirty-rate", dest="dirty_rate",
+                            default=0, type=int)
+        parser.add_argument("--dirty-pattern", dest="dirty_pattern",
+                            default="sequential",
+                            choices=["sequential", "random"])
 
         self._parser = parser
 
@@ -93,7 +98,10 @@ class BaseShell(object):
                         huge_pages=args.huge_pages,
                         prealloc_pages=args.prealloc_pages,
 
-                        dirty_ring_size=args.dirty_ring_size)
+                        dirty_ring_size=args.dirty_ring_size,
+
+                        dirty_rate=args.dirty_rate,
+                        dirty_pattern=args.dirty_pattern)
 
 
 class Shell(BaseShell):
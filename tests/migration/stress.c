@@ -29,6 +29,11 @@ const char *argv0;
 
 #define RAM_PAGE_SIZE 4096
 
+/* Target dirty rate in MB per second per CPU, 0 == unthrottled */
+static unsigned long long dirtyrate_mb;
+/* Dirty pages in random rather than sequential order */
+static bool dirty_random;
+
 #ifndef CONFIG_GETTID
 static int gettid(void)
 {
@@ -147,6 +152,32 @@ static int random_bytes(char *buf, size_t len)
 }
 
 
+static int parse_pattern(const char *str)
+{
+    if (g_str_equal(str, "random")) {
+        dirty_random = true;
+        return 0;
+    }
+    if (g_str_equal(str, "sequential")) {
+        dirty_random = false;
+        return 0;
+    }
+    fprintf(stderr, "%s (%05d): ERROR: invalid dirty pattern %s\n",
+            argv0, gettid(), str);
+    return -1;
+}
+
+static unsigned long long xorshift64(unsigned long long *state)
+{
+    unsigned long long x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
 static unsigned long long now(void)
 {
     struct timeval tv;
@@ -159,6 +190,7 @@ static unsigned long long now(void)
 static void stressone(unsigned long long ramsizeMB)
 {
     size_t pagesPerMB = 1024 * 1024 / RAM_PAGE_SIZE;
+    size_t nrPages = ramsizeMB * pagesPerMB;
     g_autofree char *ram = g_malloc(ramsizeMB * 1024 * 1024);
     char *ramptr;
     size_t i, j, k;
@@ -166,6 +198,8 @@ static void stressone(unsigned long long ramsizeMB)
     char *dataptr;
     size_t nMB = 0;
     unsigned long long before, after;
+    unsigned long long ratestart, rateMB = 0;
+    unsigned long long prng;
 
     /* We don't care about initial state, but we do want
      * to fault it all into RAM, otherwise the first iter
@@ -174,22 +208,39 @@ static void stressone(unsigned long long ramsizeMB)
      * calloc instead :-) */
     memset(ram, 0xfe, ramsizeMB * 1024 * 1024);
 
-    if (random_bytes(data, RAM_PAGE_SIZE) < 0) {
+    if (random_bytes(data, RAM_PAGE_SIZE) < 0 ||
+        random_bytes((char *)&prng, sizeof(prng)) < 0) {
         return;
     }
+    prng |= 1;
 
-    before = now();
+    before = ratestart = now();
 
     while (1) {
 
-        ramptr = ram;
-        for (i = 0; i < ramsizeMB; i++, nMB++) {
+        for (i = 0; i < ramsizeMB; i++, nMB++, rateMB++) {
             for (j = 0; j < pagesPerMB; j++) {
+                if (dirty_random) {
+                    ramptr = ram + (xorshift64(&prng) % nrPages) *
+                        RAM_PAGE_SIZE;
+                } else {
+                    ramptr = ram + ((i * pagesPerMB) + j) * RAM_PAGE_SIZE;
+                }
                 dataptr = data;
                 for (k = 0; k < RAM_PAGE_SIZE; k += sizeof(long long)) {
+                    *(unsigned long long *)ramptr ^= *(unsigned long long *)dataptr;
                     ramptr += sizeof(long long);
                     dataptr += sizeof(long long);
-                    *(unsigned long long *)ramptr ^= *(unsigned long long *)dataptr;
+                }
+            }
+
+            if (dirtyrate_mb) {
+                unsigned long long deadline =
+                    ratestart + (rateMB + 1) * 1000 / dirtyrate_mb;
+                unsigned long long current = now();
+
+                if (deadline > current) {
+                    usleep((deadline - current) * 1000);
                 }
             }
 
@@ -266,11 +317,13 @@ int main(int argc, char **argv)
     char *end;
     int ch;
     int opt_ind = 0;
-    const char *sopt = "hr:c:";
+    const char *sopt = "hr:c:d:p:";
     struct option lopt[] = {
         { "help", no_argument, NULL, 'h' },
         { "ramsize", required_argument, NULL, 'r' },
         { "cpus", required_argument, NULL, 'c' },
+        { "dirtyrate", required_argument, NULL, 'd' },
+        { "pattern", required_argument, NULL, 'p' },
         { NULL, 0, NULL, 0 }
     };
     int ret;
@@ -300,27 +353,69 @@ int main(int argc, char **argv)
             }
             break;
 
+        case 'd':
+            errno = 0;
+            dirtyrate_mb = strtoll(optarg, &end, 10);
+            if (errno != 0 || *end) {
+                fprintf(stderr, "%s (%05d): ERROR: Cannot parse dirty rate %s\n",
+                        argv0, gettid(), optarg);
+                exit_failure();
+            }
+            break;
+
+        case 'p':
+            if (parse_pattern(optarg) < 0) {
+                exit_failure();
+            }
+            break;
+
         case '?':
         case 'h':
-            fprintf(stderr, "%s: [--help][--ramsize GB][--cpus N]\n", argv0);
+            fprintf(stderr,
+                    "%s: [--help][--ramsize GB][--cpus N]"
+                    "[--dirtyrate MB/s][--pattern sequential|random]\n",
+                    argv0);
             exit_failure();
         }
     }
 
     if (getpid() == 1) {
+        char *patternstr;
+
         if (mount_all() < 0)
             exit_failure();
 
         ret = get_command_arg_ull("ramsize", &ramsizeGB);
         if (ret < 0)
             exit_failure();
+
+        ret = get_command_arg_ull("dirtyrate", &dirtyrate_mb);
+        if (ret < 0)
+            exit_failure();
+
+        ret = get_command_arg_str("pattern", &patternstr);
+        if (ret < 0)
+            exit_failure();
+        if (ret > 0) {
+            if (parse_pattern(patternstr) < 0)
+                exit_failure();
+            g_free(patternstr);
+        }
     }
 
     if (ncpus == 0)
         ncpus = sysconf(_SC_NPROCESSORS_ONLN);
 
-    fprintf(stdout, "%s (%05d): INFO: RAM %llu GiB across %d CPUs\n",
-            argv0, gettid(), ramsizeGB, ncpus);
+    /* The dirty rate limit is a total, shared by all CPUs */
+    if (dirtyrate_mb)
+        dirtyrate_mb = MAX(dirtyrate_mb / ncpus, 1);
+
+    fprintf(stdout, "%s (%05d): INFO: RAM %llu GiB across %d CPUs, %s order\n",
+            argv0, gettid(), ramsizeGB, ncpus,
+            dirty_random ? "random" : "sequential");
+    if (dirtyrate_mb)
+        fprintf(stdout, "%s (%05d): INFO: limiting dirty rate to %llu MB/s per CPU\n",
+                argv0, gettid(), dirtyrate_mb);
 
     stress(ramsizeGB, ncpus);
 
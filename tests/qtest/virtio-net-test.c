@@ -25,6 +25,7 @@
 
 #define QVIRTIO_NET_TIMEOUT_US (30 * 1000 * 1000)
 #define VNET_HDR_SIZE sizeof(struct virtio_net_hdr_mrg_rxbuf)
+#define BENCH_QUEUE_DEPTH 32
 
 #ifndef _WIN32
 
@@ -312,6 +313,64 @@ static void large_tx(void *obj, void *data, QGuestAllocator *t_alloc)
     guest_free(t_alloc, req_addr);
 }
 
+/*
+ * Drive the transmit virtqueue at maximum rate and report the packet
+ * rate.  The hub port has no peer, so the frames are dropped after
+ * going through the whole transmit path in hw/net/virtio-net.c.  Run
+ * with -m slow for a longer measurement.
+ */
+static void bench_tx(void *obj, void *data, QGuestAllocator *t_alloc)
+{
+    QVirtioNet *dev = obj;
+    QVirtQueue *vq = dev->queues[1];
+    QTestState *qts = global_qtest;
+    int rounds = g_test_slow() ? 8192 : 128;
+    uint64_t req_addr;
+    int i, r;
+
+    g_assert_cmpint(BENCH_QUEUE_DEPTH, <=, vq->size);
+
+    /* A minimal frame, shared by every descriptor */
+    req_addr = guest_alloc(t_alloc, 64);
+    memwrite(req_addr + VNET_HDR_SIZE, "TEST", 4);
+
+    g_test_timer_start();
+    for (r = 0; r < rounds; r++) {
+        gint64 start_time = g_get_monotonic_time();
+        int done = 0;
+
+        /*
+         * libqos hands out descriptors without ever recycling them.
+         * Everything the previous round added has completed, so simply
+         * rewind the table.
+         */
+        vq->free_head = 0;
+
+        for (i = 0; i < BENCH_QUEUE_DEPTH; i++) {
+            uint32_t free_head;
+
+            free_head = qvirtqueue_add(qts, vq, req_addr, 64, false, false);
+            qvirtqueue_kick(qts, dev->vdev, vq, free_head);
+        }
+
+        while (done < BENCH_QUEUE_DEPTH) {
+            if (qvirtqueue_get_buf(qts, vq, NULL, NULL)) {
+                done++;
+                continue;
+            }
+            qtest_clock_step(qts, 100);
+            g_assert(g_get_monotonic_time() - start_time <=
+                     QVIRTIO_NET_TIMEOUT_US);
+        }
+    }
+    g_test_timer_elapsed();
+    g_test_message("%.0f packets/sec (depth %d, %d packets)",
+                   rounds * BENCH_QUEUE_DEPTH / g_test_timer_last(),
+                   BENCH_QUEUE_DEPTH, rounds * BENCH_QUEUE_DEPTH);
+
+    guest_free(t_alloc, req_addr);
+}
+
 static void *virtio_net_test_setup_nosocket(GString *cmd_line, void *arg)
 {
     g_string_append(cmd_line, " -netdev hubport,hubid=0,id=hs0 ");
@@ -336,6 +395,9 @@ static void register_virtio_net_test(void)
     qos_add_test("large_tx/uint_max", "virtio-net", large_tx, &opts);
     opts.arg = (gpointer)NET_BUFSIZE;
     qos_add_test("large_tx/net_bufsize", "virtio-net", large_tx, &opts);
+
+    opts.arg = NULL;
+    qos_add_test("bench_tx", "virtio-net", bench_tx, &opts);
 }
 
 libqos_init(register_virtio_net_test);
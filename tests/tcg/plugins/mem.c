@@ -28,6 +28,7 @@ QEMU_PLUGIN_EXPORT int qemu_plugin_version = QEMU_PLUGIN_VERSION;
 typedef struct {
     uint64_t mem_count;
     uint64_t io_count;
+    uint64_t range_count;
 } CPUCount;
 
 typedef struct {
@@ -59,8 +60,11 @@ typedef struct {
 static struct qemu_plugin_scoreboard *counts;
 static qemu_plugin_u64 mem_count;
 static qemu_plugin_u64 io_count;
+static qemu_plugin_u64 range_count;
 static bool do_inline, do_callback, do_print_accesses, do_region_summary;
 static bool do_haddr;
+static bool do_range;
+static uint64_t range_low, range_high;
 static enum qemu_plugin_mem_rw rw = QEMU_PLUGIN_MEM_RW;
 
 
@@ -88,6 +92,10 @@ static void plugin_exit(qemu_plugin_id_t id, void *p)
         g_string_append_printf(out, "io accesses: %" PRIu64 "\n",
                                qemu_plugin_u64_sum(io_count));
     }
+    if (do_range) {
+        g_string_append_printf(out, "range accesses: %" PRIu64 "\n",
+                               qemu_plugin_u64_sum(range_count));
+    }
     qemu_plugin_outs(out->str);
 
 
@@ -305,6 +313,12 @@ static void vcpu_tb_trans(qemu_plugin_id_t id, struct qemu_plugin_tb *tb)
                 QEMU_PLUGIN_INLINE_ADD_U64,
                 mem_count, 1);
         }
+        if (do_range) {
+            qemu_plugin_register_vcpu_mem_range_inline_per_vcpu(
+                insn, rw, range_low, range_high,
+                QEMU_PLUGIN_INLINE_ADD_U64,
+                range_count, 1);
+        }
         if (do_callback || do_region_summary) {
             qemu_plugin_register_vcpu_mem_cb(insn, vcpu_mem,
                                              QEMU_PLUGIN_CB_NO_REGS,
@@ -364,6 +378,16 @@ QEMU_PLUGIN_EXPORT int qemu_plugin_install(qemu_plugin_id_t id,
                 fprintf(stderr, "boolean argument parsing failed: %s\n", opt);
                 return -1;
             }
+        } else if (g_strcmp0(tokens[0], "range") == 0) {
+            g_auto(GStrv) bounds = g_strsplit(tokens[1], "-", 2);
+
+            if (!bounds[0] || !bounds[1]) {
+                fprintf(stderr, "invalid value for argument range: %s\n", opt);
+                return -1;
+            }
+            range_low = g_ascii_strtoull(bounds[0], NULL, 0);
+            range_high = g_ascii_strtoull(bounds[1], NULL, 0);
+            do_range = true;
         } else if (g_strcmp0(tokens[0], "region-summary") == 0) {
             if (!qemu_plugin_bool_parse(tokens[0], tokens[1],
                                         &do_region_summary)) {
@@ -399,6 +423,8 @@ QEMU_PLUGIN_EXPORT int qemu_plugin_install(qemu_plugin_id_t id,
     mem_count = qemu_plugin_scoreboard_u64_in_struct(
         counts, CPUCount, mem_count);
     io_count = qemu_plugin_scoreboard_u64_in_struct(counts, CPUCount, io_count);
+    range_count = qemu_plugin_scoreboard_u64_in_struct(
+        counts, CPUCount, range_count);
     qemu_plugin_register_vcpu_tb_trans_cb(id, vcpu_tb_trans);
     qemu_plugin_register_atexit_cb(id, plugin_exit, NULL);
     return 0;
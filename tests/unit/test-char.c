@@ -338,6 +338,60 @@ static void char_mux_test(void)
 }
 
 
+static void char_buffer_test(void)
+{
+    QemuOpts *opts;
+    Chardev *chr;
+    CharBackend be;
+    char *data;
+    int i, ret;
+
+    opts = qemu_opts_create(qemu_find_opts("chardev"), "buffer-base",
+                            1, &error_abort);
+    qemu_opt_set(opts, "backend", "ringbuf", &error_abort);
+    qemu_opt_set(opts, "size", "128", &error_abort);
+    chr = qemu_chr_new_from_opts(opts, NULL, &error_abort);
+    g_assert_nonnull(chr);
+    qemu_opts_del(opts);
+
+    opts = qemu_opts_create(qemu_find_opts("chardev"), "buffer-label",
+                            1, &error_abort);
+    qemu_opt_set(opts, "backend", "buffer", &error_abort);
+    qemu_opt_set(opts, "chardev", "buffer-base", &error_abort);
+    qemu_opt_set(opts, "size", "64", &error_abort);
+    chr = qemu_chr_new_from_opts(opts, NULL, &error_abort);
+    g_assert_nonnull(chr);
+    qemu_opts_del(opts);
+
+    qemu_chr_fe_init(&be, chr, &error_abort);
+
+    /* a small write stays queued until the flush timer fires */
+    ret = qemu_chr_fe_write(&be, (void *)"hello", 5);
+    g_assert_cmpint(ret, ==, 5);
+    data = qmp_ringbuf_read("buffer-base", 16, false, 0, &error_abort);
+    g_assert_cmpstr(data, ==, "");
+    g_free(data);
+
+    /* crossing the watermark (half the ring) flushes inline */
+    for (i = 0; i < 30; i++) {
+        ret = qemu_chr_fe_write(&be, (void *)"x", 1);
+        g_assert_cmpint(ret, ==, 1);
+    }
+    data = qmp_ringbuf_read("buffer-base", 128, false, 0, &error_abort);
+    g_assert_cmpint(strlen(data), ==, 32);
+    g_assert_true(g_str_has_prefix(data, "hello"));
+    g_free(data);
+
+    /* what is still queued is flushed when the chardev goes away */
+    qemu_chr_fe_deinit(&be, true);
+    data = qmp_ringbuf_read("buffer-base", 128, false, 0, &error_abort);
+    g_assert_cmpstr(data, ==, "xxx");
+    g_free(data);
+
+    object_unparent(OBJECT(qemu_chr_find("buffer-base")));
+}
+
+
 static void websock_server_read(void *opaque, const uint8_t *buf, int size)
 {
     g_assert_cmpint(size, ==, 5);
@@ -1485,6 +1539,7 @@ int main(int argc, char **argv)
     g_test_add_func("/char/invalid", char_invalid_test);
     g_test_add_func("/char/ringbuf", char_ringbuf_test);
     g_test_add_func("/char/mux", char_mux_test);
+    g_test_add_func("/char/buffer", char_buffer_test);
 #ifdef _WIN32
     g_test_add_func("/char/console/subprocess", char_console_test_subprocess);
     g_test_add_func("/char/console", char_console_test);
@@ -0,0 +1,80 @@
+/*
+ * QEMU memory comparison helper tests
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/memops.h"
+
+#define PAGE 4096
+
+static void test_first_diff(void)
+{
+    g_autofree char *a = g_malloc0(PAGE);
+    g_autofree char *b = g_malloc0(PAGE);
+    size_t i;
+
+    /* Equal buffers report len */
+    g_assert_cmpuint(qemu_mem_first_diff(a, b, PAGE), ==, PAGE);
+    g_assert_cmpuint(qemu_mem_first_diff(a, b, 0), ==, 0);
+
+    /* A difference anywhere in a line is reported at the line start */
+    for (i = 0; i < PAGE; i += 53) {
+        b[i] = 1;
+        g_assert_cmpuint(qemu_mem_first_diff(a, b, PAGE), ==,
+                         QEMU_ALIGN_DOWN(i, QEMU_MEM_DIFF_LINE));
+        b[i] = 0;
+    }
+
+    /* Lengths that are not a multiple of the line size */
+    b[PAGE - 1] = 1;
+    g_assert_cmpuint(qemu_mem_first_diff(a, b, PAGE - 7), ==, PAGE - 7);
+    g_assert_cmpuint(qemu_mem_first_diff(a, b, PAGE), ==,
+                     PAGE - QEMU_MEM_DIFF_LINE);
+    b[PAGE - 1] = 0;
+    b[PAGE - 7] = 1;
+    g_assert_cmpuint(qemu_mem_first_diff(a, b, PAGE - 9),
+                     ==, PAGE - 9);
+    g_assert_cmpuint(qemu_mem_first_diff(a, b, PAGE - 5), ==,
+                     PAGE - QEMU_MEM_DIFF_LINE);
+}
+
+static void test_copy_if_different(void)
+{
+    g_autofree char *dst = g_malloc(PAGE);
+    g_autofree char *src = g_malloc(PAGE);
+    size_t i;
+
+    for (i = 0; i < PAGE; i++) {
+        src[i] = i * 7;
+        dst[i] = i * 7;
+    }
+
+    /* Identical buffers write nothing */
+    g_assert_false(qemu_mem_copy_if_different(dst, src, PAGE));
+
+    /* Sparse differences end up copied */
+    for (i = 0; i < PAGE; i += 151) {
+        src[i] ^= 0xff;
+    }
+    g_assert_true(qemu_mem_copy_if_different(dst, src, PAGE));
+    g_assert_cmpint(memcmp(dst, src, PAGE), ==, 0);
+    g_assert_false(qemu_mem_copy_if_different(dst, src, PAGE));
+
+    /* A difference only in the unaligned tail */
+    src[PAGE - 1] ^= 0xff;
+    g_assert_true(qemu_mem_copy_if_different(dst, src, PAGE - 3));
+    g_assert_cmpint(memcmp(dst, src, PAGE - 3), ==, 0);
+    g_assert_true(qemu_mem_copy_if_different(dst, src, PAGE));
+    g_assert_cmpint(memcmp(dst, src, PAGE), ==, 0);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/memops/first_diff", test_first_diff);
+    g_test_add_func("/memops/copy_if_different", test_copy_if_different);
+    return g_test_run();
+}
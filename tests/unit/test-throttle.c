@@ -331,6 +331,30 @@ static void test_config_functions(void)
     }
 }
 
+/* function to test that throttle_config carries bucket levels over */
+static void test_config_preserves_levels(void)
+{
+    ThrottleConfig cfg;
+
+    throttle_init(&ts);
+    throttle_config_init(&cfg);
+    cfg.buckets[THROTTLE_BPS_TOTAL].avg = 100;
+    cfg.buckets[THROTTLE_BPS_TOTAL].max = 200;
+    throttle_config(&ts, QEMU_CLOCK_VIRTUAL, &cfg);
+
+    /* pretend the guest has accumulated some debt */
+    ts.cfg.buckets[THROTTLE_BPS_TOTAL].level = 150;
+
+    /* reconfiguring must not forgive it */
+    throttle_config(&ts, QEMU_CLOCK_VIRTUAL, &cfg);
+    g_assert(double_cmp(ts.cfg.buckets[THROTTLE_BPS_TOTAL].level, 150));
+
+    /* ...but it is clamped to the new bucket size when limits shrink */
+    cfg.buckets[THROTTLE_BPS_TOTAL].max = 100;
+    throttle_config(&ts, QEMU_CLOCK_VIRTUAL, &cfg);
+    g_assert(double_cmp(ts.cfg.buckets[THROTTLE_BPS_TOTAL].level, 100));
+}
+
 /* functions to test is throttle is enabled by a config */
 static void set_cfg_value(bool is_max, int index, int value)
 {
@@ -828,6 +852,8 @@ int main(int argc, char **argv)
     g_test_add_func("/throttle/config/iops_size",
                     test_iops_size_is_missing_limit);
     g_test_add_func("/throttle/config_functions",   test_config_functions);
+    g_test_add_func("/throttle/config_preserves_levels",
+                    test_config_preserves_levels);
     g_test_add_func("/throttle/accounting",         test_accounting);
     g_test_add_func("/throttle/groups",             test_groups);
     return g_test_run();
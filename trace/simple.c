@@ -30,9 +30,6 @@
 /** Records were dropped event ID */
 #define DROPPED_EVENT_ID (~(uint64_t)0 - 1)
 
-/** Trace record is valid */
-#define TRACE_RECORD_VALID ((uint64_t)1 << 63)
-
 /*
  * Trace records are written out by a dedicated thread.  The thread waits for
  * records to become available, writes them out, and then waits again.
@@ -45,14 +42,29 @@ static bool trace_available;
 static bool trace_writeout_enabled;
 
 enum {
-    TRACE_BUF_LEN = 4096 * 64,
+    TRACE_BUF_LEN = 4096 * 16,
     TRACE_BUF_FLUSH_THRESHOLD = TRACE_BUF_LEN / 4,
 };
 
-uint8_t trace_buf[TRACE_BUF_LEN];
-static volatile gint trace_idx;
-static unsigned int writeout_idx;
-static volatile gint dropped_events;
+/*
+ * Each thread records into its own ring so the hot path never touches
+ * shared state: the owning thread advances @head, the writeout thread
+ * advances @tail, and neither takes a lock.  A full ring drops the
+ * event and counts the loss instead of blocking the producer.
+ */
+typedef struct TraceThreadRing {
+    struct TraceThreadRing *next;
+    unsigned int head;          /* written by the owning thread */
+    unsigned int tail;          /* written by the writeout thread */
+    unsigned int dropped;       /* events lost because the ring was full */
+    bool retired;               /* the owning thread has exited */
+    uint8_t buf[TRACE_BUF_LEN];
+} TraceThreadRing;
+
+static GMutex ring_list_lock;
+static TraceThreadRing *ring_list;
+static __thread TraceThreadRing *trace_ring;
+
 static uint32_t trace_pid;
 static FILE *trace_fp;
 static char *trace_file_name;
@@ -76,54 +88,10 @@ typedef struct {
 } TraceLogHeader;
 
 
-static void read_from_buffer(unsigned int idx, void *dataptr, size_t size);
-static unsigned int write_to_buffer(unsigned int idx, void *dataptr, size_t size);
-
-static void clear_buffer_range(unsigned int idx, size_t len)
-{
-    uint32_t num = 0;
-    while (num < len) {
-        if (idx >= TRACE_BUF_LEN) {
-            idx = idx % TRACE_BUF_LEN;
-        }
-        trace_buf[idx++] = 0;
-        num++;
-    }
-}
-/**
- * Read a trace record from the trace buffer
- *
- * @idx         Trace buffer index
- * @record      Trace record to fill
- *
- * Returns false if the record is not valid.
- */
-static bool get_trace_record(unsigned int idx, TraceRecord **recordptr)
-{
-    uint64_t event_flag = 0;
-    TraceRecord record;
-    /* read the event flag to see if its a valid record */
-    read_from_buffer(idx, &record, sizeof(event_flag));
-
-    if (!(record.event & TRACE_RECORD_VALID)) {
-        return false;
-    }
-
-    smp_rmb(); /* read memory barrier before accessing record */
-    /* read the record header to know record length */
-    read_from_buffer(idx, &record, sizeof(TraceRecord));
-    *recordptr = malloc(record.length); /* don't use g_malloc, can deadlock when traced */
-    /* make a copy of record to avoid being overwritten */
-    read_from_buffer(idx, *recordptr, record.length);
-    smp_rmb(); /* memory barrier before clearing valid flag */
-    (*recordptr)->event &= ~TRACE_RECORD_VALID;
-    /* clear the trace buffer range for consumed record otherwise any byte
-     * with its MSB set may be considered as a valid event id when the writer
-     * thread crosses this range of buffer again.
-     */
-    clear_buffer_range(idx, record.length);
-    return true;
-}
+static void ring_read(TraceThreadRing *ring, unsigned int idx,
+                      void *dataptr, size_t size);
+static unsigned int ring_write(TraceThreadRing *ring, unsigned int idx,
+                               void *dataptr, size_t size);
 
 /**
  * Kick writeout thread
@@ -154,42 +122,106 @@ static void wait_for_trace_records_available(void)
     g_mutex_unlock(&trace_lock);
 }
 
-static gpointer writeout_thread(gpointer opaque)
+/**
+ * Retire a ring whose owning thread is exiting
+ *
+ * The ring stays on the list until the writeout thread has drained the
+ * remaining records; only then is it freed.
+ */
+static void trace_ring_retire(gpointer data)
+{
+    TraceThreadRing *ring = data;
+
+    qatomic_set(&ring->retired, true);
+    flush_trace_file(false);
+}
+
+static GPrivate trace_ring_private = G_PRIVATE_INIT(trace_ring_retire);
+
+static TraceThreadRing *trace_ring_register(void)
+{
+    /* don't use g_malloc, can deadlock when traced */
+    TraceThreadRing *ring = calloc(1, sizeof(*ring));
+
+    if (!ring) {
+        return NULL;
+    }
+
+    g_mutex_lock(&ring_list_lock);
+    ring->next = ring_list;
+    ring_list = ring;
+    g_mutex_unlock(&ring_list_lock);
+
+    /* Have trace_ring_retire() called when the owning thread exits */
+    g_private_set(&trace_ring_private, ring);
+    trace_ring = ring;
+    return ring;
+}
+
+/**
+ * Write out all completed records of one ring
+ *
+ * Runs only in the writeout thread, the sole consumer of every ring.
+ */
+static void writeout_ring(TraceThreadRing *ring)
 {
-    TraceRecord *recordptr;
+    static union {
+        TraceRecord rec;
+        uint8_t bytes[TRACE_BUF_LEN];
+    } copy;
     union {
         TraceRecord rec;
         uint8_t bytes[sizeof(TraceRecord) + sizeof(uint64_t)];
     } dropped;
-    unsigned int idx = 0;
-    int dropped_count;
+    unsigned int head, tail, dropped_count;
     size_t unused __attribute__ ((unused));
     uint64_t type = TRACE_RECORD_TYPE_EVENT;
 
+    dropped_count = qatomic_xchg(&ring->dropped, 0);
+    if (dropped_count) {
+        dropped.rec.event = DROPPED_EVENT_ID;
+        dropped.rec.timestamp_ns = get_clock();
+        dropped.rec.length = sizeof(TraceRecord) + sizeof(uint64_t);
+        dropped.rec.pid = trace_pid;
+        dropped.rec.arguments[0] = dropped_count;
+        unused = fwrite(&type, sizeof(type), 1, trace_fp);
+        unused = fwrite(&dropped.rec, dropped.rec.length, 1, trace_fp);
+    }
+
+    tail = ring->tail;
+    head = qatomic_load_acquire(&ring->head);
+    while (tail != head) {
+        /* make a copy of the record to avoid being overwritten */
+        ring_read(ring, tail % TRACE_BUF_LEN, copy.bytes, sizeof(TraceRecord));
+        ring_read(ring, tail % TRACE_BUF_LEN, copy.bytes, copy.rec.length);
+        unused = fwrite(&type, sizeof(type), 1, trace_fp);
+        unused = fwrite(copy.bytes, copy.rec.length, 1, trace_fp);
+        tail += copy.rec.length;
+    }
+    /* release the consumed space back to the producer */
+    qatomic_store_release(&ring->tail, tail);
+}
+
+static gpointer writeout_thread(gpointer opaque)
+{
+    TraceThreadRing *ring, **prev;
+
     for (;;) {
         wait_for_trace_records_available();
 
-        if (g_atomic_int_get(&dropped_events)) {
-            dropped.rec.event = DROPPED_EVENT_ID;
-            dropped.rec.timestamp_ns = get_clock();
-            dropped.rec.length = sizeof(TraceRecord) + sizeof(uint64_t);
-            dropped.rec.pid = trace_pid;
-            do {
-                dropped_count = g_atomic_int_get(&dropped_events);
-            } while (!g_atomic_int_compare_and_exchange(&dropped_events,
-                                                        dropped_count, 0));
-            dropped.rec.arguments[0] = dropped_count;
-            unused = fwrite(&type, sizeof(type), 1, trace_fp);
-            unused = fwrite(&dropped.rec, dropped.rec.length, 1, trace_fp);
-        }
-
-        while (get_trace_record(idx, &recordptr)) {
-            unused = fwrite(&type, sizeof(type), 1, trace_fp);
-            unused = fwrite(recordptr, recordptr->length, 1, trace_fp);
-            writeout_idx += recordptr->length;
-            free(recordptr); /* don't use g_free, can deadlock when traced */
-            idx = writeout_idx % TRACE_BUF_LEN;
+        g_mutex_lock(&ring_list_lock);
+        prev = &ring_list;
+        while ((ring = *prev) != NULL) {
+            writeout_ring(ring);
+            if (qatomic_read(&ring->retired) &&
+                qatomic_load_acquire(&ring->head) == ring->tail) {
+                *prev = ring->next;
+                free(ring); /* don't use g_free, can deadlock when traced */
+            } else {
+                prev = &ring->next;
+            }
         }
+        g_mutex_unlock(&ring_list_lock);
 
         fflush(trace_fp);
     }
@@ -198,50 +230,54 @@ static gpointer writeout_thread(gpointer opaque)
 
 void trace_record_write_u64(TraceBufferRecord *rec, uint64_t val)
 {
-    rec->rec_off = write_to_buffer(rec->rec_off, &val, sizeof(uint64_t));
+    rec->rec_off = ring_write(trace_ring, rec->rec_off, &val, sizeof(uint64_t));
 }
 
 void trace_record_write_str(TraceBufferRecord *rec, const char *s, uint32_t slen)
 {
+    TraceThreadRing *ring = trace_ring;
+
     /* Write string length first */
-    rec->rec_off = write_to_buffer(rec->rec_off, &slen, sizeof(slen));
+    rec->rec_off = ring_write(ring, rec->rec_off, &slen, sizeof(slen));
     /* Write actual string now */
-    rec->rec_off = write_to_buffer(rec->rec_off, (void*)s, slen);
+    rec->rec_off = ring_write(ring, rec->rec_off, (void *)s, slen);
 }
 
 int trace_record_start(TraceBufferRecord *rec, uint32_t event, size_t datasize)
 {
-    unsigned int idx, rec_off, old_idx, new_idx;
+    TraceThreadRing *ring = trace_ring;
+    unsigned int head, rec_off;
     uint32_t rec_len = sizeof(TraceRecord) + datasize;
     uint64_t event_u64 = event;
     uint64_t timestamp_ns = get_clock();
 
-    do {
-        old_idx = g_atomic_int_get(&trace_idx);
-        smp_rmb();
-        new_idx = old_idx + rec_len;
-
-        if (new_idx - writeout_idx > TRACE_BUF_LEN) {
-            /* Trace Buffer Full, Event dropped ! */
-            g_atomic_int_inc(&dropped_events);
-            return -ENOSPC;
+    if (!ring) {
+        ring = trace_ring_register();
+        if (!ring) {
+            return -ENOMEM;
         }
-    } while (!g_atomic_int_compare_and_exchange(&trace_idx, old_idx, new_idx));
+    }
 
-    idx = old_idx % TRACE_BUF_LEN;
+    head = ring->head;
+    if (head + rec_len - qatomic_load_acquire(&ring->tail) > TRACE_BUF_LEN) {
+        /* Trace Buffer Full, Event dropped ! */
+        qatomic_inc(&ring->dropped);
+        return -ENOSPC;
+    }
 
-    rec_off = idx;
-    rec_off = write_to_buffer(rec_off, &event_u64, sizeof(event_u64));
-    rec_off = write_to_buffer(rec_off, &timestamp_ns, sizeof(timestamp_ns));
-    rec_off = write_to_buffer(rec_off, &rec_len, sizeof(rec_len));
-    rec_off = write_to_buffer(rec_off, &trace_pid, sizeof(trace_pid));
+    rec_off = head % TRACE_BUF_LEN;
+    rec_off = ring_write(ring, rec_off, &event_u64, sizeof(event_u64));
+    rec_off = ring_write(ring, rec_off, &timestamp_ns, sizeof(timestamp_ns));
+    rec_off = ring_write(ring, rec_off, &rec_len, sizeof(rec_len));
+    rec_off = ring_write(ring, rec_off, &trace_pid, sizeof(trace_pid));
 
-    rec->tbuf_idx = idx;
-    rec->rec_off  = (idx + sizeof(TraceRecord)) % TRACE_BUF_LEN;
+    rec->tbuf_idx = head;
+    rec->rec_off  = (head + sizeof(TraceRecord)) % TRACE_BUF_LEN;
     return 0;
 }
 
-static void read_from_buffer(unsigned int idx, void *dataptr, size_t size)
+static void ring_read(TraceThreadRing *ring, unsigned int idx,
+                      void *dataptr, size_t size)
 {
     uint8_t *data_ptr = dataptr;
     uint32_t x = 0;
@@ -249,11 +285,12 @@ static void read_from_buffer(unsigned int idx, void *dataptr, size_t size)
         if (idx >= TRACE_BUF_LEN) {
             idx = idx % TRACE_BUF_LEN;
         }
-        data_ptr[x++] = trace_buf[idx++];
+        data_ptr[x++] = ring->buf[idx++];
     }
 }
 
-static unsigned int write_to_buffer(unsigned int idx, void *dataptr, size_t size)
+static unsigned int ring_write(TraceThreadRing *ring, unsigned int idx,
+                               void *dataptr, size_t size)
 {
     uint8_t *data_ptr = dataptr;
     uint32_t x = 0;
@@ -261,21 +298,26 @@ static unsigned int write_to_buffer(unsigned int idx, void *dataptr, size_t size
         if (idx >= TRACE_BUF_LEN) {
             idx = idx % TRACE_BUF_LEN;
         }
-        trace_buf[idx++] = data_ptr[x++];
+        ring->buf[idx++] = data_ptr[x++];
     }
     return idx; /* most callers wants to know where to write next */
 }
 
 void trace_record_finish(TraceBufferRecord *rec)
 {
-    TraceRecord record;
-    read_from_buffer(rec->tbuf_idx, &record, sizeof(TraceRecord));
-    smp_wmb(); /* write barrier before marking as valid */
-    record.event |= TRACE_RECORD_VALID;
-    write_to_buffer(rec->tbuf_idx, &record, sizeof(TraceRecord));
-
-    if (((unsigned int)g_atomic_int_get(&trace_idx) - writeout_idx)
-        > TRACE_BUF_FLUSH_THRESHOLD) {
+    TraceThreadRing *ring = trace_ring;
+    uint32_t rec_len;
+    unsigned int used;
+
+    ring_read(ring, (rec->tbuf_idx + offsetof(TraceRecord, length))
+              % TRACE_BUF_LEN, &rec_len, sizeof(rec_len));
+    /* publish: the record must be fully written before head moves past it */
+    qatomic_store_release(&ring->head, rec->tbuf_idx + rec_len);
+
+    used = ring->head - qatomic_read(&ring->tail);
+    if (used > TRACE_BUF_FLUSH_THRESHOLD &&
+        used - rec_len <= TRACE_BUF_FLUSH_THRESHOLD) {
+        /* only kick the writeout thread when crossing the threshold */
         flush_trace_file(false);
     }
 }
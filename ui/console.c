@@ -32,7 +32,9 @@
 #include "qemu/error-report.h"
 #include "qemu/main-loop.h"
 #include "qemu/module.h"
+#include "qemu/bswap.h"
 #include "qemu/option.h"
+#include "qemu/xxhash.h"
 #include "chardev/char.h"
 #include "trace.h"
 #include "exec/memory.h"
@@ -62,6 +64,8 @@ struct DisplayState {
     uint64_t last_update;
     uint64_t update_interval;
     bool refreshing;
+    bool have_gfx_updates; /* damage reported since the last refresh tick */
+    unsigned idle_ticks;
 
     QLIST_HEAD(, DisplayChangeListener) listeners;
 };
@@ -96,6 +100,22 @@ static void gui_update(void *opaque)
             interval = dcl_interval;
         }
     }
+
+    /*
+     * Damage-rate governor: when refresh ticks keep coming back without
+     * any reported damage, stretch the timer up to the idle interval so
+     * an idle guest is not scanned at full rate.  The first tick that
+     * does see damage snaps back to the interval the listeners asked
+     * for.
+     */
+    if (ds->have_gfx_updates) {
+        ds->have_gfx_updates = false;
+        ds->idle_ticks = 0;
+    } else if (ds->idle_ticks < 8) {
+        ds->idle_ticks++;
+    }
+    interval = MIN(interval << ds->idle_ticks, GUI_REFRESH_INTERVAL_IDLE);
+
     if (ds->update_interval != interval) {
         ds->update_interval = interval;
         trace_console_refresh(interval);
@@ -568,6 +588,7 @@ void qemu_free_displaysurface(DisplaySurface *surface)
     }
     trace_displaysurface_free(surface);
     qemu_pixman_image_unref(surface->image);
+    g_free(surface->line_sig);
     g_free(surface);
 }
 
@@ -794,6 +815,87 @@ int dpy_set_ui_info(QemuConsole *con, QemuUIInfo *info, bool delay)
     return 0;
 }
 
+/*
+ * Signature of one scanline.  This follows the XXH64 round structure
+ * so the 32-byte inner loop vectorizes, but is not byte-for-byte XXH64
+ * (the tail is zero-padded to a full block), which is fine for an
+ * internal change detector.
+ */
+static uint64_t displaysurface_line_sig(const uint8_t *line, size_t len)
+{
+    uint64_t v1 = QEMU_XXHASH_SEED + XXH_PRIME64_1 + XXH_PRIME64_2;
+    uint64_t v2 = QEMU_XXHASH_SEED + XXH_PRIME64_2;
+    uint64_t v3 = QEMU_XXHASH_SEED + 0;
+    uint64_t v4 = QEMU_XXHASH_SEED - XXH_PRIME64_1;
+    uint64_t sig;
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        v1 = XXH64_round(v1, ldq_he_p(line + i));
+        v2 = XXH64_round(v2, ldq_he_p(line + i + 8));
+        v3 = XXH64_round(v3, ldq_he_p(line + i + 16));
+        v4 = XXH64_round(v4, ldq_he_p(line + i + 24));
+    }
+    if (i < len) {
+        uint8_t tail[32] = {};
+
+        memcpy(tail, line + i, len - i);
+        v1 = XXH64_round(v1, ldq_he_p(tail));
+        v2 = XXH64_round(v2, ldq_he_p(tail + 8));
+        v3 = XXH64_round(v3, ldq_he_p(tail + 16));
+        v4 = XXH64_round(v4, ldq_he_p(tail + 24));
+    }
+    sig = XXH64_avalanche(XXH64_mergerounds(v1, v2, v3, v4) + len);
+
+    return sig ? sig : 1; /* 0 is reserved for "not computed yet" */
+}
+
+/*
+ * Graphics devices track damage at dirty page granularity, so the
+ * rectangles handed to dpy_gfx_update() routinely cover many scanlines
+ * that did not change.  For full-width updates, compare per-scanline
+ * signatures with the previous contents and narrow the rectangle to
+ * the span of scanlines that really differ, so the display listeners
+ * copy, convert and encode less data.
+ */
+static void dpy_gfx_trim_damage(DisplaySurface *surface, int x, int w,
+                                int *y, int *h)
+{
+    const uint8_t *data;
+    size_t len;
+    int stride, line, first = -1, last = -1;
+
+    if (*h <= 0 || x != 0 || w != surface_width(surface)) {
+        return;
+    }
+    if (!surface->line_sig) {
+        surface->line_sig = g_new0(uint64_t, surface_height(surface));
+    }
+    data = surface_data(surface);
+    stride = surface_stride(surface);
+    len = (size_t)w * surface_bytes_per_pixel(surface);
+
+    for (line = *y; line < *y + *h; line++) {
+        uint64_t sig = displaysurface_line_sig(data + (size_t)line * stride,
+                                               len);
+
+        if (sig != surface->line_sig[line]) {
+            surface->line_sig[line] = sig;
+            if (first < 0) {
+                first = line;
+            }
+            last = line;
+        }
+    }
+
+    if (first < 0) {
+        *h = 0; /* nothing actually changed */
+    } else {
+        *y = first;
+        *h = last - first + 1;
+    }
+}
+
 void dpy_gfx_update(QemuConsole *con, int x, int y, int w, int h)
 {
     DisplayState *s = con->ds;
@@ -811,6 +913,15 @@ void dpy_gfx_update(QemuConsole *con, int x, int y, int w, int h)
     if (!qemu_console_is_visible(con)) {
         return;
     }
+    if (con->surface) {
+        dpy_gfx_trim_damage(con->surface, x, w, &y, &h);
+        if (h == 0) {
+            return;
+        }
+    }
+    if (w > 0 && h > 0) {
+        s->have_gfx_updates = true;
+    }
     dpy_gfx_update_texture(con, con->surface, x, y, w, h);
     QLIST_FOREACH(dcl, &s->listeners, next) {
         if (con != dcl->con) {
@@ -857,6 +968,7 @@ void dpy_gfx_replace_surface(QemuConsole *con,
 
     con->scanout.kind = SCANOUT_SURFACE;
     con->surface = new_surface;
+    s->have_gfx_updates = true;
     dpy_gfx_create_texture(con, new_surface);
     QLIST_FOREACH(dcl, &s->listeners, next) {
         if (con != dcl->con) {
@@ -130,6 +130,12 @@ static void hmp_info_vnc_clients(Monitor *mon, VncClientInfoList *client)
                        cinfo->x509_dname ?: "none");
         monitor_printf(mon, "    sasl_username: %s\n",
                        cinfo->sasl_username ?: "none");
+        if (cinfo->has_update_count) {
+            monitor_printf(mon, "    updates: %" PRIu64 " sent, %" PRIu64
+                           " throttled, %" PRIu64 " bytes queued\n",
+                           cinfo->update_count, cinfo->throttled_count,
+                           cinfo->output_backlog);
+        }
 
         client = client->next;
     }
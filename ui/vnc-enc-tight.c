@@ -689,11 +689,29 @@ check_solid_tile32(VncState *vs, int x, int y, int w, int h,
     }
 
     for (dy = 0; dy < h; dy++) {
-        for (dx = 0; dx < w; dx++) {
-            if (c != fbptr[dx]) {
+        uint32_t diff = 0;
+
+        /*
+         * Accumulate the comparison over short branchless runs so the
+         * compiler can use vector compares; 16 pixels matches the tile
+         * size most callers pass in.
+         */
+        for (dx = 0; dx + 16 <= w; dx += 16) {
+            int i;
+
+            for (i = 0; i < 16; i++) {
+                diff |= c ^ fbptr[dx + i];
+            }
+            if (diff) {
                 return false;
             }
         }
+        for (; dx < w; dx++) {
+            diff |= c ^ fbptr[dx];
+        }
+        if (diff) {
+            return false;
+        }
         fbptr = (uint32_t *)
             ((uint8_t *)fbptr + vnc_server_fb_stride(vd));
     }
@@ -344,6 +344,13 @@ static VncClientInfo *qmp_query_vnc_client(const VncState *client)
     }
 #endif
 
+    info->has_update_count = true;
+    info->update_count = client->update_count;
+    info->has_throttled_count = true;
+    info->throttled_count = client->throttled_count;
+    info->has_output_backlog = true;
+    info->output_backlog = client->output.offset;
+
     return info;
 }
 
@@ -1156,6 +1163,10 @@ static int vnc_update_client(VncState *vs, int has_dirty)
 
     vs->has_dirty += has_dirty;
     if (!vnc_should_update(vs)) {
+        if (vs->has_dirty) {
+            /* Damage stays in the dirty bitmap and coalesces */
+            vs->throttled_count++;
+        }
         return 0;
     }
 
@@ -1207,6 +1218,7 @@ static int vnc_update_client(VncState *vs, int has_dirty)
     vs->job_update = vs->update;
     vs->update = VNC_STATE_UPDATE_NONE;
     vnc_job_push(job);
+    vs->update_count++;
     vs->has_dirty = 0;
     return n;
 }
@@ -3416,7 +3428,7 @@ void vnc_display_init(const char *id, Error **errp)
     vd->share_policy = VNC_SHARE_POLICY_ALLOW_EXCLUSIVE;
     vd->connections_limit = 32;
 
-    qemu_mutex_init(&vd->mutex);
+    g_rw_lock_init(&vd->lock);
     vnc_start_worker_thread();
 
     vd->dcl.ops = &dcl_ops;
@@ -157,7 +157,12 @@ struct VncDisplay
     QEMUPutLEDEntry *led;
     int ledstate;
     QKbdState *kbd;
-    QemuMutex mutex;
+    /*
+     * Protects the server surface: vnc_refresh_server_surface() takes
+     * the writer side, encoder worker threads only read and hold the
+     * reader side so they can run concurrently.
+     */
+    GRWLock lock;
 
     int cursor_msize;
     uint8_t *cursor_mask;
@@ -249,6 +254,7 @@ struct VncRectEntry
 struct VncJob
 {
     VncState *vs;
+    bool in_progress; /* picked up by a worker thread, still on the queue */
 
     QLIST_HEAD(, VncRectEntry) rectangles;
     QTAILQ_ENTRY(VncJob) next;
@@ -278,6 +284,9 @@ struct VncState
     VncStateUpdate update; /* Most recent pending request from client */
     VncStateUpdate job_update; /* Currently processed by job thread */
     int has_dirty;
+    /* Slow client accounting, reported by query-vnc */
+    uint64_t update_count;
+    uint64_t throttled_count;
     uint32_t features;
     int absolute;
     int last_x;
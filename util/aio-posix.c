@@ -27,6 +27,9 @@
 /* Stop userspace polling on a handler if it isn't active for some time */
 #define POLL_IDLE_INTERVAL_NS (7 * NANOSECONDS_PER_SECOND)
 
+/* Initial polling budget for a handler that has just become active */
+#define POLL_INITIAL_NS 4000
+
 bool aio_poll_disabled(AioContext *ctx)
 {
     return qatomic_read(&ctx->poll_disable_cnt);
@@ -342,6 +345,7 @@ static bool aio_dispatch_handler(AioContext *ctx, AioHandler *node)
         if (ctx->poll_started && node->io_poll_begin) {
             node->io_poll_begin(node->opaque);
         }
+        node->poll_ns = POLL_INITIAL_NS;
         QLIST_INSERT_HEAD(&ctx->poll_aio_handlers, node, node_poll);
     }
     if (!QLIST_IS_INSERTED(node, node_deleted) &&
@@ -395,10 +399,28 @@ static bool aio_dispatch_ready_handlers(AioContext *ctx,
 {
     bool progress = false;
     AioHandler *node;
+    int64_t now;
+
+    if (QLIST_EMPTY(ready_list)) {
+        return false;
+    }
+
+    /*
+     * Attribute dispatch time to each handler by chaining clock reads, one
+     * per dispatched handler instead of two.  Deleted handlers are not freed
+     * until aio_free_deleted_handlers(), so the counters remain valid here.
+     */
+    now = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
 
     while ((node = QLIST_FIRST(ready_list))) {
+        int64_t then = now;
+
         QLIST_REMOVE(node, node_ready);
         progress = aio_dispatch_handler(ctx, node) || progress;
+
+        now = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+        node->dispatch_ns += now - then;
+        node->dispatch_calls++;
     }
 
     return progress;
@@ -431,6 +453,7 @@ void aio_dispatch(AioContext *ctx)
 static bool run_poll_handlers_once(AioContext *ctx,
                                    AioHandlerList *ready_list,
                                    int64_t now,
+                                   int64_t elapsed,
                                    int64_t *timeout)
 {
     bool progress = false;
@@ -438,9 +461,23 @@ static bool run_poll_handlers_once(AioContext *ctx,
     AioHandler *tmp;
 
     QLIST_FOREACH_SAFE(node, &ctx->poll_aio_handlers, node_poll, tmp) {
+        /*
+         * Each handler adapts its own polling budget: handlers whose
+         * budget has run out sit out the rest of this polling round
+         * while latency-critical handlers keep being polled.
+         */
+        if (elapsed >= node->poll_ns) {
+            continue;
+        }
+
+        node->poll_calls++;
         if (node->io_poll(node->opaque)) {
+            int64_t grow = ctx->poll_grow ? ctx->poll_grow : 2;
+
             aio_add_poll_ready_handler(ready_list, node);
 
+            node->poll_hits++;
+            node->poll_ns = MIN(node->poll_ns * grow, ctx->poll_max_ns);
             node->poll_idle_timeout = now + POLL_IDLE_INTERVAL_NS;
 
             /*
@@ -488,6 +525,7 @@ static bool remove_idle_poll_handlers(AioContext *ctx,
         } else if (now >= node->poll_idle_timeout) {
             trace_poll_remove(ctx, node, node->pfd.fd);
             node->poll_idle_timeout = 0LL;
+            node->poll_ns = 0;
             QLIST_SAFE_REMOVE(node, node_poll);
             if (ctx->poll_started && node->io_poll_end) {
                 node->io_poll_end(node->opaque);
@@ -540,9 +578,10 @@ static bool run_poll_handlers(AioContext *ctx, AioHandlerList *ready_list,
     RCU_READ_LOCK_GUARD();
 
     start_time = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+    elapsed_time = 0;
     do {
         progress = run_poll_handlers_once(ctx, ready_list,
-                                          start_time, timeout);
+                                          start_time, elapsed_time, timeout);
         elapsed_time = qemu_clock_get_ns(QEMU_CLOCK_REALTIME) - start_time;
         max_ns = qemu_soonest_timeout(*timeout, max_ns);
         assert(!(max_ns && progress));
@@ -578,13 +617,25 @@ static bool run_poll_handlers(AioContext *ctx, AioHandlerList *ready_list,
 static bool try_poll_mode(AioContext *ctx, AioHandlerList *ready_list,
                           int64_t *timeout)
 {
+    AioHandler *node;
+    int64_t handler_max = 0;
     int64_t max_ns;
 
     if (QLIST_EMPTY_RCU(&ctx->poll_aio_handlers)) {
         return false;
     }
 
-    max_ns = qemu_soonest_timeout(*timeout, ctx->poll_ns);
+    /*
+     * A handler whose budget has grown past the context-wide adapted
+     * value extends the polling round for itself; handlers with small
+     * budgets drop out of it early in run_poll_handlers_once().
+     */
+    QLIST_FOREACH_RCU(node, &ctx->poll_aio_handlers, node_poll) {
+        handler_max = MAX(handler_max, node->poll_ns);
+    }
+    handler_max = MIN(handler_max, ctx->poll_max_ns);
+
+    max_ns = qemu_soonest_timeout(*timeout, MAX(ctx->poll_ns, handler_max));
     if (max_ns && !ctx->fdmon_ops->need_wait(ctx)) {
         /*
          * Enable poll mode. It pairs with the poll_set_started() in
@@ -777,6 +828,22 @@ void aio_context_set_poll_params(AioContext *ctx, int64_t max_ns,
     aio_notify(ctx);
 }
 
+void aio_context_foreach_poll_stats(AioContext *ctx, AioPollHandlerStatsFn *fn,
+                                    void *opaque)
+{
+    AioHandler *node;
+
+    qemu_lockcnt_inc(&ctx->list_lock);
+    QLIST_FOREACH_RCU(node, &ctx->aio_handlers, node) {
+        if (!node->io_poll || QLIST_IS_INSERTED(node, node_deleted)) {
+            continue;
+        }
+        fn(node->pfd.fd, node->poll_ns, node->poll_hits, node->poll_calls,
+           node->dispatch_ns, node->dispatch_calls, opaque);
+    }
+    qemu_lockcnt_dec(&ctx->list_lock);
+}
+
 void aio_context_set_aio_params(AioContext *ctx, int64_t max_batch)
 {
     /*
@@ -37,6 +37,11 @@ struct AioHandler {
     unsigned flags; /* see fdmon-io_uring.c */
 #endif
     int64_t poll_idle_timeout; /* when to stop userspace polling */
+    int64_t poll_ns; /* per-handler polling budget, adapted on poll hits */
+    uint64_t poll_hits; /* ->io_poll() calls that detected an event */
+    uint64_t poll_calls; /* total ->io_poll() calls */
+    uint64_t dispatch_ns; /* time spent in callbacks, aio_poll() path only */
+    uint64_t dispatch_calls; /* dispatches from the aio_poll() ready list */
     bool poll_ready; /* has polling detected an event? */
 };
 
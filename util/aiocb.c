@@ -24,13 +24,64 @@
 
 #include "qemu/osdep.h"
 #include "block/aio.h"
+#include "qemu/coroutine-tls.h"
+#include "qemu/notify.h"
+#include "qemu/thread.h"
+
+/*
+ * A small per-thread cache of freed AIOCBs.  At high request rates the
+ * malloc/free pair for each BlockAIOCB is measurable, and when an AIOCB
+ * is released on a thread other than the one that allocated it the
+ * allocator also pays for cross-thread free traffic.  Objects enter the
+ * cache on the thread that drops the last reference and are reused by
+ * the next allocation of the same size on that thread, so steady-state
+ * submission loops stop hitting malloc altogether.
+ *
+ * AIOCBs are small (aiocb_size is typically well under 1 KB), so the
+ * cache is capped by object count and object size rather than bytes.
+ */
+#define AIOCB_CACHE_SIZE 64
+#define AIOCB_CACHE_MAX_BYTES 1024
+
+typedef struct {
+    BlockAIOCB *acbs[AIOCB_CACHE_SIZE];
+    unsigned int num;
+    Notifier cleanup_notifier;
+} AioCBCache;
+
+QEMU_DEFINE_STATIC_CO_TLS(AioCBCache, aiocb_cache);
+
+static void aiocb_cache_cleanup(Notifier *n, void *value)
+{
+    AioCBCache *cache = container_of(n, AioCBCache, cleanup_notifier);
+
+    while (cache->num > 0) {
+        g_free(cache->acbs[--cache->num]);
+    }
+}
 
 void *qemu_aio_get(const AIOCBInfo *aiocb_info, BlockDriverState *bs,
                    BlockCompletionFunc *cb, void *opaque)
 {
-    BlockAIOCB *acb;
+    AioCBCache *cache = get_ptr_aiocb_cache();
+    BlockAIOCB *acb = NULL;
+    unsigned int i;
+
+    /*
+     * Look for a cached object of the same size.  ->aiocb_info is left
+     * intact when an AIOCB is cached, so it records the object's size.
+     */
+    for (i = 0; i < cache->num; i++) {
+        if (cache->acbs[i]->aiocb_info->aiocb_size == aiocb_info->aiocb_size) {
+            acb = cache->acbs[i];
+            cache->acbs[i] = cache->acbs[--cache->num];
+            break;
+        }
+    }
+    if (!acb) {
+        acb = g_malloc(aiocb_info->aiocb_size);
+    }
 
-    acb = g_malloc(aiocb_info->aiocb_size);
     acb->aiocb_info = aiocb_info;
     acb->bs = bs;
     acb->cb = cb;
@@ -48,8 +99,23 @@ void qemu_aio_ref(void *p)
 void qemu_aio_unref(void *p)
 {
     BlockAIOCB *acb = p;
+    AioCBCache *cache;
+
     assert(acb->refcnt > 0);
-    if (--acb->refcnt == 0) {
+    if (--acb->refcnt > 0) {
+        return;
+    }
+
+    cache = get_ptr_aiocb_cache();
+    if (cache->num == AIOCB_CACHE_SIZE ||
+        acb->aiocb_info->aiocb_size > AIOCB_CACHE_MAX_BYTES) {
         g_free(acb);
+        return;
+    }
+
+    if (!cache->cleanup_notifier.notify) {
+        cache->cleanup_notifier.notify = aiocb_cache_cleanup;
+        qemu_thread_atexit_add(&cache->cleanup_notifier);
     }
+    cache->acbs[cache->num++] = acb;
 }
@@ -30,6 +30,7 @@
 #include "block/graph-lock.h"
 #include "qemu/main-loop.h"
 #include "qemu/atomic.h"
+#include "qemu/host-utils.h"
 #include "qemu/rcu_queue.h"
 #include "block/raw-aio.h"
 #include "qemu/coroutine_int.h"
@@ -65,9 +66,17 @@ struct QEMUBH {
     void *opaque;
     QSLIST_ENTRY(QEMUBH) next;
     unsigned flags;
+    int64_t scheduled_ns; /* when BH_PENDING was set, for latency accounting */
     MemReentrancyGuard *reentrancy_guard;
 };
 
+static unsigned aio_bh_latency_bucket(int64_t latency_ns)
+{
+    unsigned bucket = latency_ns <= 0 ? 0 : 64 - clz64(latency_ns);
+
+    return MIN(bucket, AIO_BH_LATENCY_BUCKETS - 1);
+}
+
 /* Called concurrently from any thread */
 static void aio_bh_enqueue(QEMUBH *bh, unsigned new_flags)
 {
@@ -89,7 +98,11 @@ static void aio_bh_enqueue(QEMUBH *bh, unsigned new_flags)
          *    after aio_bh_dequeue() returns bh.
          * 2. ctx is loaded before the callback has a chance to execute and bh
          *    could be freed.
+         *
+         * The timestamp is written before the insertion makes the bottom
+         * half visible, so aio_bh_poll() reads a consistent value.
          */
+        bh->scheduled_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
         QSLIST_INSERT_HEAD_ATOMIC(&ctx->bh_list, bh, next);
     }
 
@@ -211,6 +224,11 @@ int aio_bh_poll(AioContext *ctx)
         }
 
         if ((flags & (BH_SCHEDULED | BH_DELETED)) == BH_SCHEDULED) {
+            int64_t latency_ns = qemu_clock_get_ns(QEMU_CLOCK_REALTIME) -
+                                 bh->scheduled_ns;
+
+            ctx->bh_latency[aio_bh_latency_bucket(latency_ns)]++;
+
             /* Idle BHs don't count as progress */
             if (!(flags & BH_IDLE)) {
                 ret = 1;
@@ -188,9 +188,18 @@ void bitmap_set_atomic(unsigned long *map, long start, long nr)
 
     assert(start >= 0 && nr >= 0);
 
+    /*
+     * Skip words whose bits are already all set: a plain read leaves the
+     * cacheline shared, whereas a locked RMW bounces it between setters.
+     * Dirty bitmap words are rewritten over and over while a range stays
+     * dirty, so this is the common case.
+     */
+
     /* First word */
     if (nr - bits_to_set > 0) {
-        qatomic_or(p, mask_to_set);
+        if ((*p & mask_to_set) != mask_to_set) {
+            qatomic_or(p, mask_to_set);
+        }
         nr -= bits_to_set;
         bits_to_set = BITS_PER_LONG;
         mask_to_set = ~0UL;
@@ -200,7 +209,9 @@ void bitmap_set_atomic(unsigned long *map, long start, long nr)
     /* Full words */
     if (bits_to_set == BITS_PER_LONG) {
         while (nr >= BITS_PER_LONG) {
-            *p = ~0UL;
+            if (*p != ~0UL) {
+                *p = ~0UL;
+            }
             nr -= BITS_PER_LONG;
             p++;
         }
@@ -209,7 +220,11 @@ void bitmap_set_atomic(unsigned long *map, long start, long nr)
     /* Last word */
     if (nr) {
         mask_to_set &= BITMAP_LAST_WORD_MASK(size);
-        qatomic_or(p, mask_to_set);
+        if ((*p & mask_to_set) != mask_to_set) {
+            qatomic_or(p, mask_to_set);
+        } else {
+            smp_mb();
+        }
     } else {
         /* If we avoided the full barrier in qatomic_or(), issue a
          * barrier to account for the assignments in the while loop.
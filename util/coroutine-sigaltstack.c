@@ -270,6 +270,17 @@ void qemu_coroutine_delete(Coroutine *co_)
     g_free(co);
 }
 
+void qemu_coroutine_trim_stack(Coroutine *co_)
+{
+    CoroutineSigAltStack *co = DO_UPCAST(CoroutineSigAltStack, base, co_);
+
+    /*
+     * A pooled coroutine is parked in coroutine_trampoline() close to
+     * the top of its stack; 64KiB comfortably covers those frames.
+     */
+    qemu_shrink_stack(co->stack, co->stack_size, 64 * 1024);
+}
+
 CoroutineAction qemu_coroutine_switch(Coroutine *from_, Coroutine *to_,
                                       CoroutineAction action)
 {
@@ -299,6 +299,20 @@ void qemu_coroutine_delete(Coroutine *co_)
     g_free(co);
 }
 
+void qemu_coroutine_trim_stack(Coroutine *co_)
+{
+    CoroutineUContext *co = DO_UPCAST(CoroutineUContext, base, co_);
+
+    /*
+     * A pooled coroutine is parked in coroutine_trampoline() close to
+     * the top of its stack; 64KiB comfortably covers those frames.
+     */
+    qemu_shrink_stack(co->stack, co->stack_size, 64 * 1024);
+#ifdef CONFIG_SAFESTACK
+    qemu_shrink_stack(co->unsafe_stack, co->unsafe_stack_size, 64 * 1024);
+#endif
+}
+
 /* This function is marked noinline to prevent GCC from inlining it
  * into coroutine_trampoline(). If we allow it to do that then it
  * hoists the code to get the address of the TLS variable "current"
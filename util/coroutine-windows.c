@@ -87,6 +87,11 @@ void qemu_coroutine_delete(Coroutine *co_)
     g_free(co);
 }
 
+void qemu_coroutine_trim_stack(Coroutine *co_)
+{
+    /* Fiber stacks are managed by the operating system */
+}
+
 Coroutine *qemu_coroutine_self(void)
 {
     Coroutine *current = get_current();
@@ -23,11 +23,13 @@
 #include "qemu/notify.h"
 #include "qemu/thread.h"
 #include "qemu/defer-call.h"
+#include "trace.h"
 
 /* A function call that has been deferred until defer_call_end() */
 typedef struct {
     void (*fn)(void *);
     void *opaque;
+    unsigned batched; /* number of defer_call()s coalesced into this call */
 } DeferredCall;
 
 /* Per-thread state */
@@ -86,6 +88,7 @@ void defer_call(void (*fn)(void *), void *opaque)
     DeferredCall new_fn = {
         .fn = fn,
         .opaque = opaque,
+        .batched = 1,
     };
 
     /*
@@ -94,8 +97,9 @@ void defer_call(void (*fn)(void *), void *opaque)
      * used.
      */
     for (guint i = 0; i < array->len; i++) {
-        if (memcmp(&fns[i], &new_fn, sizeof(new_fn)) == 0) {
-            return; /* already exists */
+        if (fns[i].fn == fn && fns[i].opaque == opaque) {
+            fns[i].batched++; /* already exists */
+            return;
         }
     }
 
@@ -145,6 +149,7 @@ void defer_call_end(void)
     DeferredCall *fns = (DeferredCall *)array->data;
 
     for (guint i = 0; i < array->len; i++) {
+        trace_defer_call_end_fn(fns[i].fn, fns[i].opaque, fns[i].batched);
         fns[i].fn(fns[i].opaque);
     }
 
@@ -25,7 +25,10 @@
  *
  * File descriptor monitoring is implemented using the following operations:
  *
- * 1. IORING_OP_POLL_ADD - adds a file descriptor to be monitored.
+ * 1. IORING_OP_POLL_ADD - adds a file descriptor to be monitored.  Multishot
+ *    mode (IORING_POLL_ADD_MULTI) is used when the kernel supports it, so
+ *    that the request stays armed across completions and no re-arm sqe is
+ *    needed per event.
  * 2. IORING_OP_POLL_REMOVE - removes a file descriptor being monitored.  When
  *    the poll mask changes for a file descriptor it is first removed and then
  *    re-added with the new poll mask, so this operation is also used as part
@@ -172,9 +175,29 @@ static void add_poll_add_sqe(AioContext *ctx, AioHandler *node)
     int events = poll_events_from_pfd(node->pfd.events);
 
     io_uring_prep_poll_add(sqe, node->pfd.fd, events);
+#ifdef IORING_POLL_ADD_MULTI
+    /*
+     * Multishot keeps the poll armed across completions, saving the
+     * re-arm sqe per event.  Kernels without support fail the sqe with
+     * -EINVAL, which process_cqe() handles by downgrading to one-shot.
+     */
+    if (ctx->fdmon_io_uring_multishot) {
+        sqe->len |= IORING_POLL_ADD_MULTI;
+    }
+#endif
     io_uring_sqe_set_data(sqe, node);
 }
 
+/* Does this cqe leave the request armed for further completions? */
+static bool cqe_has_more(const struct io_uring_cqe *cqe)
+{
+#ifdef IORING_CQE_F_MORE
+    return cqe->flags & IORING_CQE_F_MORE;
+#else
+    return false;
+#endif
+}
+
 static void add_poll_remove_sqe(AioContext *ctx, AioHandler *node)
 {
     struct io_uring_sqe *sqe = get_sqe(ctx);
@@ -227,7 +250,6 @@ static bool process_cqe(AioContext *ctx,
                         struct io_uring_cqe *cqe)
 {
     AioHandler *node = io_uring_cqe_get_data(cqe);
-    unsigned flags;
 
     /* poll_timeout and poll_remove have a zero user_data field */
     if (!node) {
@@ -235,20 +257,40 @@ static bool process_cqe(AioContext *ctx,
     }
 
     /*
-     * Deletion can only happen when IORING_OP_POLL_ADD completes.  If we race
-     * with enqueue() here then we can safely clear the FDMON_IO_URING_REMOVE
-     * bit before IORING_OP_POLL_REMOVE is submitted.
+     * Deletion can only happen once IORING_OP_POLL_ADD has produced its
+     * final cqe; a multishot poll may have further completions queued
+     * behind this one.  If we race with enqueue() here then we can safely
+     * clear the FDMON_IO_URING_REMOVE bit before IORING_OP_POLL_REMOVE is
+     * submitted.
      */
-    flags = qatomic_fetch_and(&node->flags, ~FDMON_IO_URING_REMOVE);
-    if (flags & FDMON_IO_URING_REMOVE) {
+    if (qatomic_read(&node->flags) & FDMON_IO_URING_REMOVE) {
+        if (cqe_has_more(cqe)) {
+            return false;
+        }
+        qatomic_and(&node->flags, ~FDMON_IO_URING_REMOVE);
         QLIST_INSERT_HEAD_RCU(&ctx->deleted_aio_handlers, node, node_deleted);
         return false;
     }
 
+    if (unlikely(cqe->res < 0)) {
+#ifdef IORING_POLL_ADD_MULTI
+        /* Kernel predates multishot poll; fall back to one-shot */
+        if (cqe->res == -EINVAL && ctx->fdmon_io_uring_multishot) {
+            ctx->fdmon_io_uring_multishot = false;
+        }
+#endif
+        if (!cqe_has_more(cqe)) {
+            add_poll_add_sqe(ctx, node);
+        }
+        return false;
+    }
+
     aio_add_ready_handler(ready_list, node, pfd_events_from_poll(cqe->res));
 
-    /* IORING_OP_POLL_ADD is one-shot so we must re-arm it */
-    add_poll_add_sqe(ctx, node);
+    /* Re-arm unless the kernel keeps the multishot poll active */
+    if (!cqe_has_more(cqe)) {
+        add_poll_add_sqe(ctx, node);
+    }
     return true;
 }
 
@@ -331,6 +373,7 @@ bool fdmon_io_uring_setup(AioContext *ctx)
     }
 
     QSLIST_INIT(&ctx->submit_list);
+    ctx->fdmon_io_uring_multishot = true;
     ctx->fdmon_ops = &fdmon_io_uring_ops;
     return true;
 }
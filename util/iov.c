@@ -21,22 +21,56 @@
 #include "qemu/sockets.h"
 #include "qemu/cutils.h"
 
+/*
+ * Skip the fragments that @offset points past, returning the index of
+ * the fragment it lands in and the remaining offset within it.  An
+ * offset beyond the end of the vector is a bug in the caller, except
+ * for the historical special case of pointing exactly at the end.
+ */
+static inline unsigned int iov_skip_full(const struct iovec *iov,
+                                         unsigned int iov_cnt, size_t *offset)
+{
+    unsigned int i;
+
+    for (i = 0; i < iov_cnt && *offset >= iov[i].iov_len; i++) {
+        *offset -= iov[i].iov_len;
+    }
+    assert(*offset == 0 || i < iov_cnt);
+    return i;
+}
+
 size_t iov_from_buf_full(const struct iovec *iov, unsigned int iov_cnt,
                          size_t offset, const void *buf, size_t bytes)
 {
     size_t done;
-    unsigned int i;
-    for (i = 0, done = 0; (offset || done < bytes) && i < iov_cnt; i++) {
-        if (offset < iov[i].iov_len) {
-            size_t len = MIN(iov[i].iov_len - offset, bytes - done);
-            memcpy(iov[i].iov_base + offset, buf + done, len);
-            done += len;
-            offset = 0;
-        } else {
-            offset -= iov[i].iov_len;
+    unsigned int i = iov_skip_full(iov, iov_cnt, &offset);
+
+    /*
+     * Requests overwhelmingly fall within one or two fragments
+     * (virtio-net receive buffers, NBD request assembly); flatten
+     * those into straight-line memcpy calls without the bounds
+     * bookkeeping of the generic loop.
+     */
+    if (i < iov_cnt && bytes <= iov[i].iov_len - offset) {
+        memcpy(iov[i].iov_base + offset, buf, bytes);
+        return bytes;
+    }
+    if (i + 1 < iov_cnt) {
+        size_t len = iov[i].iov_len - offset;
+
+        if (bytes - len <= iov[i + 1].iov_len) {
+            memcpy(iov[i].iov_base + offset, buf, len);
+            memcpy(iov[i + 1].iov_base, buf + len, bytes - len);
+            return bytes;
         }
     }
-    assert(offset == 0);
+
+    for (done = 0; done < bytes && i < iov_cnt; i++) {
+        size_t len = MIN(iov[i].iov_len - offset, bytes - done);
+        memcpy(iov[i].iov_base + offset, buf + done, len);
+        done += len;
+        offset = 0;
+    }
     return done;
 }
 
@@ -44,18 +78,29 @@ size_t iov_to_buf_full(const struct iovec *iov, const unsigned int iov_cnt,
                        size_t offset, void *buf, size_t bytes)
 {
     size_t done;
-    unsigned int i;
-    for (i = 0, done = 0; (offset || done < bytes) && i < iov_cnt; i++) {
-        if (offset < iov[i].iov_len) {
-            size_t len = MIN(iov[i].iov_len - offset, bytes - done);
-            memcpy(buf + done, iov[i].iov_base + offset, len);
-            done += len;
-            offset = 0;
-        } else {
-            offset -= iov[i].iov_len;
+    unsigned int i = iov_skip_full(iov, iov_cnt, &offset);
+
+    /* Flatten one- and two-fragment requests, as in iov_from_buf_full() */
+    if (i < iov_cnt && bytes <= iov[i].iov_len - offset) {
+        memcpy(buf, iov[i].iov_base + offset, bytes);
+        return bytes;
+    }
+    if (i + 1 < iov_cnt) {
+        size_t len = iov[i].iov_len - offset;
+
+        if (bytes - len <= iov[i + 1].iov_len) {
+            memcpy(buf, iov[i].iov_base + offset, len);
+            memcpy(buf + len, iov[i + 1].iov_base, bytes - len);
+            return bytes;
         }
     }
-    assert(offset == 0);
+
+    for (done = 0; done < bytes && i < iov_cnt; i++) {
+        size_t len = MIN(iov[i].iov_len - offset, bytes - done);
+        memcpy(buf + done, iov[i].iov_base + offset, len);
+        done += len;
+        offset = 0;
+    }
     return done;
 }
 
@@ -63,18 +108,19 @@ size_t iov_memset(const struct iovec *iov, const unsigned int iov_cnt,
                   size_t offset, int fillc, size_t bytes)
 {
     size_t done;
-    unsigned int i;
-    for (i = 0, done = 0; (offset || done < bytes) && i < iov_cnt; i++) {
-        if (offset < iov[i].iov_len) {
-            size_t len = MIN(iov[i].iov_len - offset, bytes - done);
-            memset(iov[i].iov_base + offset, fillc, len);
-            done += len;
-            offset = 0;
-        } else {
-            offset -= iov[i].iov_len;
-        }
+    unsigned int i = iov_skip_full(iov, iov_cnt, &offset);
+
+    if (i < iov_cnt && bytes <= iov[i].iov_len - offset) {
+        memset(iov[i].iov_base + offset, fillc, bytes);
+        return bytes;
+    }
+
+    for (done = 0; done < bytes && i < iov_cnt; i++) {
+        size_t len = MIN(iov[i].iov_len - offset, bytes - done);
+        memset(iov[i].iov_base + offset, fillc, len);
+        done += len;
+        offset = 0;
     }
-    assert(offset == 0);
     return done;
 }
 
@@ -11,30 +11,19 @@
 
 #include "qemu/osdep.h"
 #include "qemu/iova-tree.h"
+#include "qemu/interval-tree.h"
 
 struct IOVATree {
     GTree *tree;
-};
-
-/* Args to pass to iova_tree_alloc foreach function. */
-struct IOVATreeAllocArgs {
-    /* Size of the desired allocation */
-    size_t new_size;
-
-    /* The minimum address allowed in the allocation */
-    hwaddr iova_begin;
-
-    /* Map at the left of the hole, can be NULL if "this" is first one */
-    const DMAMap *prev;
 
-    /* Map at the right of the hole, can be NULL if "prev" is the last one */
-    const DMAMap *this;
-
-    /* If found, we fill in the IOVA here */
-    hwaddr iova_result;
-
-    /* Whether have we found a valid IOVA */
-    bool iova_found;
+    /*
+     * Interval tree of the address ranges *not* covered by @tree, kept in
+     * sync on every insertion and removal.  Allocation only needs to find
+     * the leftmost free range overlapping [iova_begin, iova_last], which
+     * the interval tree answers in O(log n) instead of walking every
+     * mapping from the bottom of the address space.
+     */
+    IntervalTreeRoot holes;
 };
 
 typedef struct IOVATreeFindIOVAArgs {
@@ -42,19 +31,6 @@ typedef struct IOVATreeFindIOVAArgs {
     const DMAMap *result;
 } IOVATreeFindIOVAArgs;
 
-/**
- * Iterate args to the next hole
- *
- * @args: The alloc arguments
- * @next: The next mapping in the tree. Can be NULL to signal the last one
- */
-static void iova_tree_alloc_args_iterate(struct IOVATreeAllocArgs *args,
-                                         const DMAMap *next)
-{
-    args->prev = args->this;
-    args->this = next;
-}
-
 static int iova_tree_compare(gconstpointer a, gconstpointer b, gpointer data)
 {
     const DMAMap *m1 = a, *m2 = b;
@@ -71,6 +47,61 @@ static int iova_tree_compare(gconstpointer a, gconstpointer b, gpointer data)
     return 0;
 }
 
+static void iova_tree_hole_add(IOVATree *tree, hwaddr start, hwaddr last)
+{
+    IntervalTreeNode *hole = g_new0(IntervalTreeNode, 1);
+
+    hole->start = start;
+    hole->last = last;
+    interval_tree_insert(hole, &tree->holes);
+}
+
+/*
+ * Carve [start, last] out of the hole that contains it.  The caller must
+ * have checked that the range does not overlap any mapping, which implies
+ * it is covered by exactly one hole.
+ */
+static void iova_tree_hole_punch(IOVATree *tree, hwaddr start, hwaddr last)
+{
+    IntervalTreeNode *hole = interval_tree_iter_first(&tree->holes,
+                                                      start, last);
+
+    g_assert(hole && hole->start <= start && hole->last >= last);
+
+    interval_tree_remove(hole, &tree->holes);
+    if (hole->start < start) {
+        iova_tree_hole_add(tree, hole->start, start - 1);
+    }
+    if (hole->last > last) {
+        iova_tree_hole_add(tree, last + 1, hole->last);
+    }
+    g_free(hole);
+}
+
+/* Return [start, last] to the hole tree, merging with adjacent holes. */
+static void iova_tree_hole_fill(IOVATree *tree, hwaddr start, hwaddr last)
+{
+    IntervalTreeNode *next;
+
+    if (start > 0) {
+        next = interval_tree_iter_first(&tree->holes, start - 1, start - 1);
+        if (next) {
+            start = next->start;
+            interval_tree_remove(next, &tree->holes);
+            g_free(next);
+        }
+    }
+    if (last < HWADDR_MAX) {
+        next = interval_tree_iter_first(&tree->holes, last + 1, last + 1);
+        if (next) {
+            last = next->last;
+            interval_tree_remove(next, &tree->holes);
+            g_free(next);
+        }
+    }
+    iova_tree_hole_add(tree, start, last);
+}
+
 IOVATree *iova_tree_new(void)
 {
     IOVATree *iova_tree = g_new0(IOVATree, 1);
@@ -78,6 +109,9 @@ IOVATree *iova_tree_new(void)
     /* We don't have values actually, no need to free */
     iova_tree->tree = g_tree_new_full(iova_tree_compare, NULL, g_free, NULL);
 
+    /* The whole address space is free until mappings are inserted */
+    iova_tree_hole_add(iova_tree, 0, HWADDR_MAX);
+
     return iova_tree;
 }
 
@@ -144,6 +178,7 @@ int iova_tree_insert(IOVATree *tree, const DMAMap *map)
     new = g_new0(DMAMap, 1);
     memcpy(new, map, sizeof(*new));
     iova_tree_insert_internal(tree->tree, new);
+    iova_tree_hole_punch(tree, map->iova, map->iova + map->size);
 
     return IOVA_OK;
 }
@@ -169,114 +204,52 @@ void iova_tree_remove(IOVATree *tree, DMAMap map)
     const DMAMap *overlap;
 
     while ((overlap = iova_tree_find(tree, &map))) {
-        g_tree_remove(tree->tree, overlap);
-    }
-}
-
-/**
- * Try to find an unallocated IOVA range between prev and this elements.
- *
- * @args: Arguments to allocation
- *
- * Cases:
- *
- * (1) !prev, !this: No entries allocated, always succeed
- *
- * (2) !prev, this: We're iterating at the 1st element.
- *
- * (3) prev, !this: We're iterating at the last element.
- *
- * (4) prev, this: this is the most common case, we'll try to find a hole
- * between "prev" and "this" mapping.
- *
- * Note that this function assumes the last valid iova is HWADDR_MAX, but it
- * searches linearly so it's easy to discard the result if it's not the case.
- */
-static void iova_tree_alloc_map_in_hole(struct IOVATreeAllocArgs *args)
-{
-    const DMAMap *prev = args->prev, *this = args->this;
-    uint64_t hole_start, hole_last;
-
-    if (this && this->iova + this->size < args->iova_begin) {
-        return;
-    }
+        hwaddr start = overlap->iova;
+        hwaddr last = overlap->iova + overlap->size;
 
-    hole_start = MAX(prev ? prev->iova + prev->size + 1 : 0, args->iova_begin);
-    hole_last = this ? this->iova : HWADDR_MAX;
-
-    if (hole_last - hole_start > args->new_size) {
-        args->iova_result = hole_start;
-        args->iova_found = true;
+        g_tree_remove(tree->tree, overlap);
+        iova_tree_hole_fill(tree, start, last);
     }
 }
 
-/**
- * Foreach dma node in the tree, compare if there is a hole with its previous
- * node (or minimum iova address allowed) and the node.
- *
- * @key: Node iterating
- * @value: Node iterating
- * @pargs: Struct to communicate with the outside world
- *
- * Return: false to keep iterating, true if needs break.
- */
-static gboolean iova_tree_alloc_traverse(gpointer key, gpointer value,
-                                         gpointer pargs)
-{
-    struct IOVATreeAllocArgs *args = pargs;
-    DMAMap *node = value;
-
-    assert(key == value);
-
-    iova_tree_alloc_args_iterate(args, node);
-    iova_tree_alloc_map_in_hole(args);
-    return args->iova_found;
-}
-
 int iova_tree_alloc_map(IOVATree *tree, DMAMap *map, hwaddr iova_begin,
                         hwaddr iova_last)
 {
-    struct IOVATreeAllocArgs args = {
-        .new_size = map->size,
-        .iova_begin = iova_begin,
-    };
+    IntervalTreeNode *hole;
 
     if (unlikely(iova_last < iova_begin)) {
         return IOVA_ERR_INVALID;
     }
 
     /*
-     * Find a valid hole for the mapping
-     *
-     * Assuming low iova_begin, so no need to do a binary search to
-     * locate the first node.
-     *
-     * TODO: Replace all this with g_tree_node_first/next/last when available
-     * (from glib since 2.68). To do it with g_tree_foreach complicates the
-     * code a lot.
-     *
+     * Walk the free ranges overlapping [iova_begin, iova_last] in ascending
+     * address order and take the first one that is big enough.  Locating
+     * the first candidate is O(log n), and the walk usually stops at it:
+     * subsequent holes only need to be visited when the lowest ones are
+     * smaller than the allocation.
      */
-    g_tree_foreach(tree->tree, iova_tree_alloc_traverse, &args);
-    if (!args.iova_found) {
-        /*
-         * Either tree is empty or the last hole is still not checked.
-         * g_tree_foreach does not compare (last, iova_last] range, so we check
-         * it here.
-         */
-        iova_tree_alloc_args_iterate(&args, NULL);
-        iova_tree_alloc_map_in_hole(&args);
+    for (hole = interval_tree_iter_first(&tree->holes, iova_begin, iova_last);
+         hole; hole = interval_tree_iter_next(hole, iova_begin, iova_last)) {
+        hwaddr alloc_first = MAX(hole->start, iova_begin);
+
+        if (map->size <= hole->last - alloc_first &&
+            alloc_first + map->size <= iova_last) {
+            map->iova = alloc_first;
+            return iova_tree_insert(tree, map);
+        }
     }
 
-    if (!args.iova_found || args.iova_result + map->size > iova_last) {
-        return IOVA_ERR_NOMEM;
-    }
-
-    map->iova = args.iova_result;
-    return iova_tree_insert(tree, map);
+    return IOVA_ERR_NOMEM;
 }
 
 void iova_tree_destroy(IOVATree *tree)
 {
+    IntervalTreeNode *hole;
+
+    while ((hole = interval_tree_iter_first(&tree->holes, 0, HWADDR_MAX))) {
+        interval_tree_remove(hole, &tree->holes);
+        g_free(hole);
+    }
     g_tree_destroy(tree->tree);
     g_free(tree);
 }
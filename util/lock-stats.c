@@ -0,0 +1,52 @@
+/*
+ * Lightweight mutex contention statistics
+ *
+ * Copyright Red Hat, Inc. 2026
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/atomic.h"
+#include "qemu/lock-stats.h"
+
+static QemuMutexStats *lock_stats_list;
+
+void qemu_mutex_enable_stats(QemuMutex *mutex, const char *name)
+{
+    QemuMutexStats *stats;
+
+    assert(mutex->initialized);
+    if (mutex->stats) {
+        return;
+    }
+
+    stats = g_new0(QemuMutexStats, 1);
+    stats->name = g_strdup(name);
+
+    do {
+        stats->next = qatomic_read(&lock_stats_list);
+    } while (qatomic_cmpxchg(&lock_stats_list, stats->next, stats) !=
+             stats->next);
+
+    /* Pairs with the qatomic_read() in the lock slow paths.  */
+    qatomic_set(&mutex->stats, stats);
+}
+
+void qemu_mutex_stats_record(QemuMutexStats *stats, int64_t wait_ns)
+{
+    stat64_add(&stats->contentions, 1);
+    stat64_add(&stats->total_wait_ns, wait_ns);
+    stat64_max(&stats->max_wait_ns, wait_ns);
+}
+
+void qemu_mutex_stats_foreach(QemuMutexStatsIterFn *fn, void *opaque)
+{
+    QemuMutexStats *stats;
+
+    for (stats = qatomic_read(&lock_stats_list); stats;
+         stats = stats->next) {
+        fn(stats, opaque);
+    }
+}
@@ -60,7 +60,8 @@
 
 #include "qemu/mmap-alloc.h"
 
-#define MAX_MEM_PREALLOC_THREAD_COUNT 16
+/* Populate at most this much memory per madvise() call */
+#define MEM_PREALLOC_CHUNK_SIZE (1 * GiB)
 
 struct MemsetThread;
 
@@ -382,7 +383,10 @@ static void *do_madv_populate_write_pages(void *arg)
 {
     MemsetThread *memset_args = (MemsetThread *)arg;
     const size_t size = memset_args->numpages * memset_args->hpagesize;
+    const size_t chunk_size = MAX(MEM_PREALLOC_CHUNK_SIZE,
+                                  memset_args->hpagesize);
     char * const addr = memset_args->addr;
+    size_t done = 0, chunk;
     int ret = 0;
 
     /* See do_touch_pages(). */
@@ -392,8 +396,17 @@ static void *do_madv_populate_write_pages(void *arg)
     }
     qemu_mutex_unlock(&page_mutex);
 
-    if (size && qemu_madvise(addr, size, QEMU_MADV_POPULATE_WRITE)) {
-        ret = -errno;
+    /*
+     * Populate in bounded chunks rather than one syscall for the whole
+     * range, so progress on huge ranges can be observed via tracing.
+     */
+    while (done < size && !ret) {
+        chunk = MIN(size - done, chunk_size);
+        if (qemu_madvise(addr + done, chunk, QEMU_MADV_POPULATE_WRITE)) {
+            ret = -errno;
+        }
+        done += chunk;
+        trace_prealloc_populate_progress(addr, done, size);
     }
     return (void *)(uintptr_t)ret;
 }
@@ -404,8 +417,14 @@ static inline int get_memset_num_threads(size_t hpagesize, size_t numpages,
     long host_procs = sysconf(_SC_NPROCESSORS_ONLN);
     int ret = 1;
 
+    /*
+     * The caller's limit (the prealloc-threads property for memory
+     * backends) is authoritative; don't second-guess it with a hard
+     * cap, which used to leave most of a big host idle while terabytes
+     * of hugepages were populated.
+     */
     if (host_procs > 0) {
-        ret = MIN(MIN(host_procs, MAX_MEM_PREALLOC_THREAD_COUNT), max_threads);
+        ret = MIN(host_procs, max_threads);
     }
 
     /* Especially with gigantic pages, don't create more threads than pages. */
@@ -734,6 +753,21 @@ void qemu_free_stack(void *stack, size_t sz)
     munmap(stack, sz);
 }
 
+void qemu_shrink_stack(void *stack, size_t sz, size_t keep)
+{
+#ifndef CONFIG_DEBUG_STACK_USAGE /* keep the usage watermark pattern intact */
+    size_t pagesz = qemu_real_host_page_size();
+    size_t avail = sz - pagesz; /* the bottom page is the guard page */
+
+    keep = ROUND_UP(keep, pagesz);
+    if (keep >= avail) {
+        return;
+    }
+    /* Stack grows down -- release the pages furthest from the base. */
+    qemu_madvise(stack + pagesz, avail - keep, QEMU_MADV_FREE);
+#endif
+}
+
 /*
  * Disable CFI checks.
  * We are going to call a signal handler directly. Such handler may or may not
@@ -775,6 +809,44 @@ void sigaction_invoke(struct sigaction *action,
     action->sa_sigaction(info->ssi_signo, &si, NULL);
 }
 
+size_t qemu_get_thp_bytes(void *ptr, size_t size)
+{
+#ifdef __linux__
+    const unsigned long long start = (uintptr_t)ptr;
+    const unsigned long long end = start + size;
+    g_autofree char *contents = NULL;
+    g_auto(GStrv) lines = NULL;
+    size_t bytes = 0;
+    bool in_range = false;
+    int i;
+
+    if (!g_file_get_contents("/proc/self/smaps", &contents, NULL, NULL)) {
+        return (size_t)-1;
+    }
+
+    lines = g_strsplit(contents, "\n", -1);
+    for (i = 0; lines[i]; i++) {
+        unsigned long long vm_start, vm_end, kb;
+
+        /*
+         * Mapping headers ("<start>-<end> <perms> ...") toggle whether the
+         * following per-mapping counters fall into the requested range.
+         */
+        if (sscanf(lines[i], "%llx-%llx ", &vm_start, &vm_end) == 2) {
+            in_range = vm_start < end && start < vm_end;
+        } else if (in_range &&
+                   (sscanf(lines[i], "AnonHugePages: %llu kB", &kb) == 1 ||
+                    sscanf(lines[i], "ShmemPmdMapped: %llu kB", &kb) == 1 ||
+                    sscanf(lines[i], "FilePmdMapped: %llu kB", &kb) == 1)) {
+            bytes += kb * 1024;
+        }
+    }
+    return bytes;
+#else
+    return (size_t)-1;
+#endif
+}
+
 size_t qemu_get_host_physmem(void)
 {
 #ifdef _SC_PHYS_PAGES
@@ -824,6 +824,11 @@ bool qemu_write_pidfile(const char *filename, Error **errp)
     return true;
 }
 
+size_t qemu_get_thp_bytes(void *ptr, size_t size)
+{
+    return (size_t)-1;
+}
+
 size_t qemu_get_host_physmem(void)
 {
     MEMORYSTATUSEX statex;
@@ -156,6 +156,18 @@ static void coroutine_pool_refill_local(void)
 /* Add a batch of coroutines to the global pool */
 static void coroutine_pool_put_global(CoroutinePoolBatch *batch)
 {
+    Coroutine *co;
+
+    /*
+     * Coroutines in the global pool may sit idle for a long time, so
+     * release the backing memory of their stacks.  Doing this here
+     * rather than on every local pool put keeps the syscall off the
+     * per-request fast path: it is paid once per batch handoff.
+     */
+    QSLIST_FOREACH(co, &batch->list, pool_next) {
+        qemu_coroutine_trim_stack(co);
+    }
+
     WITH_QEMU_LOCK_GUARD(&global_pool_lock) {
         unsigned int max = MIN(global_pool_max_size,
                                global_pool_hard_max_size);
@@ -356,6 +356,7 @@ listen_ok:
     ((rc) == -EINPROGRESS)
 #endif
 
+#ifdef _WIN32
 static int inet_connect_addr(const InetSocketAddress *saddr,
                              struct addrinfo *addr, Error **errp)
 {
@@ -386,6 +387,222 @@ static int inet_connect_addr(const InetSocketAddress *saddr,
 
     return sock;
 }
+#endif /* _WIN32 */
+
+#ifndef _WIN32
+
+/*
+ * Delay before starting the next connection attempt while earlier
+ * ones are still in flight; the "Connection Attempt Delay" of
+ * RFC 8305 (Happy Eyeballs).
+ */
+#define INET_CONNECT_ATTEMPT_DELAY_MS 250
+
+/*
+ * Fill @out with the entries of @res reordered so that address
+ * families alternate where possible, starting with the family
+ * getaddrinfo() preferred.  A destination whose addresses of one
+ * family are all black holed then costs at most one attempt delay
+ * before the other family is tried.
+ */
+static void inet_interleave_addrinfo(struct addrinfo *res,
+                                     struct addrinfo **out,
+                                     size_t naddr)
+{
+    struct addrinfo *e;
+    size_t n = 0, i, j;
+
+    for (e = res; e != NULL; e = e->ai_next) {
+        out[n++] = e;
+    }
+    assert(n == naddr);
+
+    for (i = 1; i < n; i++) {
+        if (out[i]->ai_family != out[i - 1]->ai_family) {
+            continue;
+        }
+        for (j = i + 1; j < n; j++) {
+            if (out[j]->ai_family != out[i]->ai_family) {
+                struct addrinfo *tmp = out[j];
+                memmove(&out[i + 1], &out[i], (j - i) * sizeof(*out));
+                out[i] = tmp;
+                break;
+            }
+        }
+        if (j == n) {
+            /* only one family remains */
+            break;
+        }
+    }
+}
+
+static int inet_connect_addr_nonblock(const InetSocketAddress *saddr,
+                                      struct addrinfo *addr,
+                                      bool *in_progress,
+                                      Error **errp)
+{
+    int sock, rc;
+
+    *in_progress = false;
+
+    sock = qemu_socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+    if (sock < 0) {
+        error_setg_errno(errp, errno, "Failed to create socket family %d",
+                         addr->ai_family);
+        return -1;
+    }
+    socket_set_fast_reuse(sock);
+    qemu_socket_set_nonblock(sock);
+
+    do {
+        rc = 0;
+        if (connect(sock, addr->ai_addr, addr->ai_addrlen) < 0) {
+            rc = -errno;
+        }
+    } while (rc == -EINTR);
+
+    if (QEMU_SOCKET_RC_INPROGRESS(rc)) {
+        *in_progress = true;
+    } else if (rc < 0) {
+        error_setg_errno(errp, -rc, "Failed to connect to '%s:%s'",
+                         saddr->host, saddr->port);
+        close(sock);
+        return -1;
+    }
+
+    return sock;
+}
+
+/*
+ * Race non-blocking connection attempts against each other, starting
+ * a further attempt each time INET_CONNECT_ATTEMPT_DELAY_MS passes
+ * without one of those in flight succeeding.  The first attempt to
+ * complete wins; the losers are closed.  Blocks until a winner is
+ * found or every attempt has failed, and returns the winning socket
+ * restored to blocking mode.
+ */
+static int inet_connect_saddr_race(InetSocketAddress *saddr,
+                                   struct addrinfo *res,
+                                   Error **errp)
+{
+    g_autofree struct addrinfo **addrs = NULL;
+    g_autofree GPollFD *pfds = NULL;
+    g_autofree int *fds = NULL;
+    Error *local_err = NULL;
+    struct addrinfo *e;
+    size_t naddr = 0, started = 0, active = 0;
+    size_t i;
+    int winner = -1;
+    int rc;
+
+    for (e = res; e != NULL; e = e->ai_next) {
+        naddr++;
+    }
+    addrs = g_new(struct addrinfo *, naddr);
+    inet_interleave_addrinfo(res, addrs, naddr);
+    fds = g_new(int, naddr);
+    pfds = g_new(GPollFD, naddr);
+
+    while (winner < 0) {
+        if (started < naddr) {
+            bool in_progress;
+            int sock;
+
+            e = addrs[started++];
+#ifdef HAVE_IPPROTO_MPTCP
+            if (saddr->has_mptcp && saddr->mptcp) {
+                e->ai_protocol = IPPROTO_MPTCP;
+            }
+#endif
+            error_free(local_err);
+            local_err = NULL;
+
+            sock = inet_connect_addr_nonblock(saddr, e, &in_progress,
+                                              &local_err);
+            if (sock >= 0 && !in_progress) {
+                winner = sock;
+                break;
+            }
+            if (sock >= 0) {
+                fds[active++] = sock;
+            } else if (active == 0 && started < naddr) {
+                /* immediate failure with nothing in flight: try the next */
+                continue;
+            }
+        }
+
+        if (active == 0) {
+            /* nothing in flight and nothing left to start */
+            break;
+        }
+
+        for (i = 0; i < active; i++) {
+            pfds[i].fd = fds[i];
+            pfds[i].events = G_IO_OUT | G_IO_ERR | G_IO_HUP;
+            pfds[i].revents = 0;
+        }
+        rc = g_poll(pfds, active,
+                    started < naddr ? INET_CONNECT_ATTEMPT_DELAY_MS : -1);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error_free(local_err);
+            local_err = NULL;
+            error_setg_errno(&local_err, errno,
+                             "Failed to wait for connection to '%s:%s'",
+                             saddr->host, saddr->port);
+            break;
+        }
+        if (rc == 0) {
+            /* attempt delay expired: start the next attempt */
+            continue;
+        }
+
+        for (i = 0; i < active; i++) {
+            int err;
+            socklen_t len = sizeof(err);
+
+            if (!pfds[i].revents) {
+                continue;
+            }
+            if (getsockopt(fds[i], SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+                err = errno;
+            }
+            if (err == 0) {
+                winner = fds[i];
+                fds[i] = -1;
+                break;
+            }
+            error_free(local_err);
+            local_err = NULL;
+            error_setg_errno(&local_err, err, "Failed to connect to '%s:%s'",
+                             saddr->host, saddr->port);
+            close(fds[i]);
+            fds[i] = fds[active - 1];
+            active--;
+            i--;
+        }
+    }
+
+    /* cancel the losers */
+    for (i = 0; i < active; i++) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+
+    if (winner < 0) {
+        error_propagate(errp, local_err);
+        return -1;
+    }
+
+    error_free(local_err);
+    qemu_socket_set_block(winner);
+    return winner;
+}
+
+#endif /* !_WIN32 */
 
 static struct addrinfo *inet_parse_connect_saddr(InetSocketAddress *saddr,
                                                  Error **errp)
@@ -444,8 +661,7 @@ static struct addrinfo *inet_parse_connect_saddr(InetSocketAddress *saddr,
  */
 int inet_connect_saddr(InetSocketAddress *saddr, Error **errp)
 {
-    Error *local_err = NULL;
-    struct addrinfo *res, *e;
+    struct addrinfo *res;
     int sock = -1;
 
     res = inet_parse_connect_saddr(saddr, errp);
@@ -453,26 +669,40 @@ int inet_connect_saddr(InetSocketAddress *saddr, Error **errp)
         return -1;
     }
 
-    for (e = res; e != NULL; e = e->ai_next) {
-        error_free(local_err);
-        local_err = NULL;
+#ifdef _WIN32
+    {
+        Error *local_err = NULL;
+        struct addrinfo *e;
+
+        for (e = res; e != NULL; e = e->ai_next) {
+            error_free(local_err);
+            local_err = NULL;
 
 #ifdef HAVE_IPPROTO_MPTCP
-        if (saddr->has_mptcp && saddr->mptcp) {
-            e->ai_protocol = IPPROTO_MPTCP;
-        }
+            if (saddr->has_mptcp && saddr->mptcp) {
+                e->ai_protocol = IPPROTO_MPTCP;
+            }
 #endif
 
-        sock = inet_connect_addr(saddr, e, &local_err);
-        if (sock >= 0) {
-            break;
+            sock = inet_connect_addr(saddr, e, &local_err);
+            if (sock >= 0) {
+                break;
+            }
+        }
+
+        if (sock < 0) {
+            error_propagate(errp, local_err);
+        } else {
+            error_free(local_err);
         }
     }
+#else
+    sock = inet_connect_saddr_race(saddr, res, errp);
+#endif
 
     freeaddrinfo(res);
 
     if (sock < 0) {
-        error_propagate(errp, local_err);
         return sock;
     }
 
@@ -22,6 +22,7 @@ static inline void qemu_mutex_post_init(QemuMutex *mutex)
     mutex->file = NULL;
     mutex->line = 0;
 #endif
+    mutex->stats = NULL;
     mutex->initialized = true;
 }
 
@@ -13,7 +13,9 @@
 #include "qemu/osdep.h"
 #include "qemu/thread.h"
 #include "qemu/atomic.h"
+#include "qemu/lock-stats.h"
 #include "qemu/notify.h"
+#include "qemu/timer.h"
 #include "qemu-thread-common.h"
 #include "qemu/tsan.h"
 #include "qemu/bitmap.h"
@@ -91,7 +93,18 @@ void qemu_mutex_lock_impl(QemuMutex *mutex, const char *file, const int line)
 
     assert(mutex->initialized);
     qemu_mutex_pre_lock(mutex, file, line);
-    err = pthread_mutex_lock(&mutex->lock);
+    if (likely(!qatomic_read(&mutex->stats))) {
+        err = pthread_mutex_lock(&mutex->lock);
+    } else {
+        /* Only time the acquisition if somebody else holds the lock. */
+        err = pthread_mutex_trylock(&mutex->lock);
+        if (err == EBUSY) {
+            int64_t start = get_clock();
+
+            err = pthread_mutex_lock(&mutex->lock);
+            qemu_mutex_stats_record(mutex->stats, get_clock() - start);
+        }
+    }
     if (err)
         error_exit(err, __func__);
     qemu_mutex_post_lock(mutex, file, line);
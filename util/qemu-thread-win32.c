@@ -13,7 +13,10 @@
 
 #include "qemu/osdep.h"
 #include "qemu/thread.h"
+#include "qemu/atomic.h"
+#include "qemu/lock-stats.h"
 #include "qemu/notify.h"
+#include "qemu/timer.h"
 #include "qemu-thread-common.h"
 #include <process.h>
 
@@ -82,7 +85,15 @@ void qemu_mutex_lock_impl(QemuMutex *mutex, const char *file, const int line)
 {
     assert(mutex->initialized);
     qemu_mutex_pre_lock(mutex, file, line);
-    AcquireSRWLockExclusive(&mutex->lock);
+    if (likely(!qatomic_read(&mutex->stats))) {
+        AcquireSRWLockExclusive(&mutex->lock);
+    } else if (!TryAcquireSRWLockExclusive(&mutex->lock)) {
+        /* Only time the acquisition if somebody else holds the lock. */
+        int64_t start = get_clock();
+
+        AcquireSRWLockExclusive(&mutex->lock);
+        qemu_mutex_stats_record(mutex->stats, get_clock() - start);
+    }
     qemu_mutex_post_lock(mutex, file, line);
 }
 
@@ -63,6 +63,17 @@ static QEMUClock qemu_clocks[QEMU_CLOCK_MAX];
  * reenabling the clock can call all the notifiers.
  */
 
+/*
+ * Only timers expiring within roughly the next two wheel slots live on
+ * the sorted active_timers list; everything further out is hashed by
+ * expiry into an unsorted coarse-grained wheel, making arming and
+ * deleting far-out timers cheap even with tens of thousands pending.
+ * Wheel entries migrate to the sorted list as the horizon advances.
+ */
+#define TIMER_WHEEL_SLOT_SHIFT  27      /* ~134ms per slot */
+#define TIMER_WHEEL_SLOT_NS     ((int64_t)1 << TIMER_WHEEL_SLOT_SHIFT)
+#define TIMER_WHEEL_SLOTS       64
+
 struct QEMUTimerList {
     QEMUClock *clock;
     QemuMutex active_timers_lock;
@@ -71,10 +82,26 @@ struct QEMUTimerList {
     QEMUTimerListNotifyCB *notify_cb;
     void *notify_opaque;
 
+    /*
+     * Far-out timers, protected by active_timers_lock like the sorted
+     * list.  wheel_min_expire is a lower bound on the earliest wheel
+     * entry, not an exact minimum; it can only cause the deadline to be
+     * conservative (an early wakeup), never a missed timer.
+     */
+    QEMUTimer *wheel[TIMER_WHEEL_SLOTS];
+    unsigned wheel_count;
+    int64_t wheel_min_expire;
+    int64_t wheel_horizon;
+
     /* lightweight method to mark the end of timerlist's running */
     QemuEvent timers_done_ev;
 };
 
+static inline unsigned timer_wheel_slot(int64_t expire_time)
+{
+    return (expire_time >> TIMER_WHEEL_SLOT_SHIFT) & (TIMER_WHEEL_SLOTS - 1);
+}
+
 /**
  * qemu_clock_ptr:
  * @type: type of clock
@@ -103,6 +130,7 @@ QEMUTimerList *timerlist_new(QEMUClockType type,
     timer_list = g_new0(QEMUTimerList, 1);
     qemu_event_init(&timer_list->timers_done_ev, true);
     timer_list->clock = clock;
+    timer_list->wheel_min_expire = INT64_MAX;
     timer_list->notify_cb = cb;
     timer_list->notify_opaque = opaque;
     qemu_mutex_init(&timer_list->active_timers_lock);
@@ -171,7 +199,25 @@ void qemu_clock_enable(QEMUClockType type, bool enabled)
 
 bool timerlist_has_timers(QEMUTimerList *timer_list)
 {
-    return !!qatomic_read(&timer_list->active_timers);
+    return qatomic_read(&timer_list->active_timers) ||
+           qatomic_read(&timer_list->wheel_count);
+}
+
+/*
+ * Earliest expiry across the sorted list and the wheel, or INT64_MAX if
+ * no timer is pending.  Called with active_timers_lock held.
+ */
+static int64_t timerlist_earliest_locked(QEMUTimerList *timer_list)
+{
+    int64_t expire_time = INT64_MAX;
+
+    if (timer_list->active_timers) {
+        expire_time = timer_list->active_timers->expire_time;
+    }
+    if (timer_list->wheel_count) {
+        expire_time = MIN(expire_time, timer_list->wheel_min_expire);
+    }
+    return expire_time;
 }
 
 bool qemu_clock_has_timers(QEMUClockType type)
@@ -184,15 +230,15 @@ bool timerlist_expired(QEMUTimerList *timer_list)
 {
     int64_t expire_time = 0;
 
-    if (!qatomic_read(&timer_list->active_timers)) {
+    if (!timerlist_has_timers(timer_list)) {
         return false;
     }
 
     WITH_QEMU_LOCK_GUARD(&timer_list->active_timers_lock) {
-        if (!timer_list->active_timers) {
+        expire_time = timerlist_earliest_locked(timer_list);
+        if (expire_time == INT64_MAX) {
             return false;
         }
-        expire_time = timer_list->active_timers->expire_time;
     }
 
     return expire_time <= qemu_clock_get_ns(timer_list->clock->type);
@@ -204,6 +250,14 @@ bool qemu_clock_expired(QEMUClockType type)
         main_loop_tlg.tl[type]);
 }
 
+/* Coalescing window for virtual clock deadlines; see the setter's doc. */
+static int64_t virtual_timer_slack_ns;
+
+void qemu_timer_set_virtual_slack(int64_t ns)
+{
+    virtual_timer_slack_ns = ns;
+}
+
 /*
  * As above, but return -1 for no deadline, and do not cap to 2^32
  * as we know the result is always positive.
@@ -214,7 +268,7 @@ int64_t timerlist_deadline_ns(QEMUTimerList *timer_list)
     int64_t delta;
     int64_t expire_time = 0;
 
-    if (!qatomic_read(&timer_list->active_timers)) {
+    if (!timerlist_has_timers(timer_list)) {
         return -1;
     }
 
@@ -227,10 +281,21 @@ int64_t timerlist_deadline_ns(QEMUTimerList *timer_list)
      * the caller should notice the change and there is no race condition.
      */
     WITH_QEMU_LOCK_GUARD(&timer_list->active_timers_lock) {
-        if (!timer_list->active_timers) {
+        expire_time = timerlist_earliest_locked(timer_list);
+        if (expire_time == INT64_MAX) {
             return -1;
         }
-        expire_time = timer_list->active_timers->expire_time;
+    }
+
+    if (timer_list->clock->type == QEMU_CLOCK_VIRTUAL &&
+        virtual_timer_slack_ns &&
+        expire_time < INT64_MAX - virtual_timer_slack_ns) {
+        /*
+         * Round the absolute deadline up to the slack boundary so that
+         * timers due close together share one wakeup; each fires at
+         * most one slack window late.
+         */
+        expire_time = QEMU_ALIGN_UP(expire_time, virtual_timer_slack_ns);
     }
 
     delta = expire_time - qemu_clock_get_ns(timer_list->clock->type);
@@ -261,7 +326,9 @@ int64_t qemu_clock_deadline_ns_all(QEMUClockType type, int attr_mask)
     }
 
     QLIST_FOREACH(timer_list, &clock->timerlists, list) {
-        if (!qatomic_read(&timer_list->active_timers)) {
+        int i;
+
+        if (!timerlist_has_timers(timer_list)) {
             continue;
         }
         qemu_mutex_lock(&timer_list->active_timers_lock);
@@ -270,12 +337,22 @@ int64_t qemu_clock_deadline_ns_all(QEMUClockType type, int attr_mask)
         while (ts && (ts->attributes & ~attr_mask)) {
             ts = ts->next;
         }
-        if (!ts) {
-            qemu_mutex_unlock(&timer_list->active_timers_lock);
-            continue;
+        expire_time = ts ? ts->expire_time : INT64_MAX;
+        /*
+         * The wheel is unsorted, so the attribute filter forces a full
+         * scan; this path is only used for the icount timeout.
+         */
+        for (i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+            for (ts = timer_list->wheel[i]; ts; ts = ts->next) {
+                if (!(ts->attributes & ~attr_mask)) {
+                    expire_time = MIN(expire_time, ts->expire_time);
+                }
+            }
         }
-        expire_time = ts->expire_time;
         qemu_mutex_unlock(&timer_list->active_timers_lock);
+        if (expire_time == INT64_MAX) {
+            continue;
+        }
 
         delta = expire_time - qemu_clock_get_ns(type);
         if (delta <= 0) {
@@ -370,6 +447,7 @@ void timer_deinit(QEMUTimer *ts)
 
 static void timer_del_locked(QEMUTimerList *timer_list, QEMUTimer *ts)
 {
+    int64_t expire_time = ts->expire_time;
     QEMUTimer **pt, *t;
 
     ts->expire_time = -1;
@@ -380,18 +458,37 @@ static void timer_del_locked(QEMUTimerList *timer_list, QEMUTimer *ts)
             break;
         if (t == ts) {
             qatomic_set(pt, t->next);
+            return;
+        }
+        pt = &t->next;
+    }
+
+    if (expire_time < 0) {
+        return;
+    }
+
+    /* Not on the sorted list; it can only be in its wheel slot.  */
+    pt = &timer_list->wheel[timer_wheel_slot(expire_time)];
+    for (;;) {
+        t = *pt;
+        if (!t)
+            break;
+        if (t == ts) {
+            *pt = t->next;
+            qatomic_set(&timer_list->wheel_count,
+                        timer_list->wheel_count - 1);
             break;
         }
         pt = &t->next;
     }
 }
 
-static bool timer_mod_ns_locked(QEMUTimerList *timer_list,
-                                QEMUTimer *ts, int64_t expire_time)
+/* add the timer to the sorted list, returning true if it is the new head */
+static bool timer_sorted_insert_locked(QEMUTimerList *timer_list,
+                                       QEMUTimer *ts, int64_t expire_time)
 {
     QEMUTimer **pt, *t;
 
-    /* add the timer in the sorted list */
     pt = &timer_list->active_timers;
     for (;;) {
         t = *pt;
@@ -407,6 +504,75 @@ static bool timer_mod_ns_locked(QEMUTimerList *timer_list,
     return pt == &timer_list->active_timers;
 }
 
+static bool timer_mod_ns_locked(QEMUTimerList *timer_list,
+                                QEMUTimer *ts, int64_t expire_time)
+{
+    /*
+     * Far-out timers are pushed onto their wheel slot in O(1).  Under
+     * record/replay everything stays on the sorted list so that the
+     * callback order of same-deadline timers remains deterministic.
+     */
+    if (expire_time >= timer_list->wheel_horizon &&
+        replay_mode == REPLAY_MODE_NONE) {
+        unsigned slot = timer_wheel_slot(expire_time);
+        bool rearm = false;
+
+        ts->expire_time = expire_time;
+        ts->next = timer_list->wheel[slot];
+        timer_list->wheel[slot] = ts;
+        qatomic_set(&timer_list->wheel_count, timer_list->wheel_count + 1);
+        if (expire_time < timer_list->wheel_min_expire) {
+            timer_list->wheel_min_expire = expire_time;
+            rearm = !timer_list->active_timers;
+        }
+        return rearm;
+    }
+
+    return timer_sorted_insert_locked(timer_list, ts, expire_time);
+}
+
+/*
+ * Move wheel entries that now fall within the sorted-list window onto
+ * the sorted list and push the horizon out past the next slot boundary.
+ * Each slot is scanned at most once per slot period; entries that wrap
+ * around the wheel are simply put back.
+ */
+static void timerlist_wheel_advance_locked(QEMUTimerList *timer_list,
+                                           int64_t current_time)
+{
+    int64_t horizon = ROUND_UP(current_time + 1, TIMER_WHEEL_SLOT_NS)
+                      + TIMER_WHEEL_SLOT_NS;
+    int64_t first, last, slot;
+
+    if (horizon <= timer_list->wheel_horizon) {
+        return;
+    }
+
+    first = timer_list->wheel_horizon >> TIMER_WHEEL_SLOT_SHIFT;
+    last = horizon >> TIMER_WHEEL_SLOT_SHIFT;
+    if (last - first > TIMER_WHEEL_SLOTS) {
+        first = last - TIMER_WHEEL_SLOTS;
+    }
+    for (slot = first; slot < last && timer_list->wheel_count; slot++) {
+        QEMUTimer **pt = &timer_list->wheel[slot & (TIMER_WHEEL_SLOTS - 1)];
+        QEMUTimer *t;
+
+        while ((t = *pt) != NULL) {
+            if (t->expire_time < horizon) {
+                *pt = t->next;
+                qatomic_set(&timer_list->wheel_count,
+                            timer_list->wheel_count - 1);
+                timer_sorted_insert_locked(timer_list, t, t->expire_time);
+            } else {
+                pt = &t->next;
+            }
+        }
+    }
+    timer_list->wheel_horizon = horizon;
+    timer_list->wheel_min_expire =
+        timer_list->wheel_count ? horizon : INT64_MAX;
+}
+
 static void timerlist_rearm(QEMUTimerList *timer_list)
 {
     /* Interrupt execution to force deadline recalculation.  */
@@ -496,7 +662,7 @@ bool timerlist_run_timers(QEMUTimerList *timer_list)
     QEMUTimerCB *cb;
     void *opaque;
 
-    if (!qatomic_read(&timer_list->active_timers)) {
+    if (!timerlist_has_timers(timer_list)) {
         return false;
     }
 
@@ -535,6 +701,7 @@ bool timerlist_run_timers(QEMUTimerList *timer_list)
      */
     current_time = qemu_clock_get_ns(timer_list->clock->type);
     qemu_mutex_lock(&timer_list->active_timers_lock);
+    timerlist_wheel_advance_locked(timer_list, current_time);
     while ((ts = timer_list->active_timers)) {
         if (!timer_expired_ns(ts, current_time)) {
             /* No expired timers left.  The checkpoint can be skipped
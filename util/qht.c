@@ -70,6 +70,7 @@
 #include "qemu/atomic.h"
 #include "qemu/rcu.h"
 #include "qemu/memalign.h"
+#include "qemu/timer.h"
 
 //#define QHT_DEBUG
 
@@ -472,6 +473,8 @@ void qht_init(struct qht *ht, qht_cmp_func_t cmp, size_t n_elems,
     ht->cmp = cmp;
     ht->mode = mode;
     qemu_mutex_init(&ht->lock);
+    ht->n_resizes = 0;
+    ht->resize_stall_ns = 0;
     map = qht_map_create(n_buckets);
     qatomic_rcu_set(&ht->map, map);
 }
@@ -685,8 +688,21 @@ static __attribute__((noinline)) void qht_grow_maybe(struct qht *ht)
     map = ht->map;
     /* another thread might have just performed the resize we were after */
     if (qht_map_needs_resize(map)) {
-        struct qht_map *new = qht_map_create(map->n_buckets * 2);
+        size_t n_added = qatomic_read(&map->n_added_buckets);
+        struct qht_map *new;
 
+        /*
+         * Each resize stalls all writers while the table is copied.
+         * When insertions have already overshot the threshold by 2x,
+         * growing 2x would only trigger another copy shortly after;
+         * grow 4x instead so that bursts of insertion (e.g. guest
+         * boot filling the TB hash table) pay for fewer copies.
+         */
+        if (n_added > map->n_added_buckets_threshold * 2) {
+            new = qht_map_create(map->n_buckets * 4);
+        } else {
+            new = qht_map_create(map->n_buckets * 2);
+        }
         qht_do_resize(ht, new);
     }
     qht_unlock(ht);
@@ -926,6 +942,7 @@ static void qht_do_resize_reset(struct qht *ht, struct qht_map *new, bool reset)
         .type = QHT_ITER_VOID,
     };
     struct qht_map_copy_data data;
+    int64_t start = get_clock();
 
     old = ht->map;
     qht_map_lock_buckets(old);
@@ -947,6 +964,8 @@ static void qht_do_resize_reset(struct qht *ht, struct qht_map *new, bool reset)
 
     qatomic_rcu_set(&ht->map, new);
     qht_map_unlock_buckets(old);
+    ht->n_resizes++;
+    ht->resize_stall_ns += get_clock() - start;
     call_rcu(old, qht_map_destroy, rcu);
 }
 
@@ -980,6 +999,8 @@ void qht_statistics_init(const struct qht *ht, struct qht_stats *stats)
     stats->entries = 0;
     qdist_init(&stats->chain);
     qdist_init(&stats->occupancy);
+    stats->n_resizes = ht->n_resizes;
+    stats->resize_stall_ns = ht->resize_stall_ns;
     /* bail out if the qht has not yet been initialized */
     if (unlikely(map == NULL)) {
         stats->head_buckets = 0;
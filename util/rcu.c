@@ -32,6 +32,7 @@
 #include "qemu/thread.h"
 #include "qemu/main-loop.h"
 #include "qemu/lockable.h"
+#include "qemu/timer.h"
 #if defined(CONFIG_MALLOC_TRIM)
 #include <malloc.h>
 #endif
@@ -141,8 +142,14 @@ static void wait_for_readers(void)
     QLIST_SWAP(&registry, &qsreaders, node);
 }
 
+/* Written under rcu_sync_lock; read racily by rcu_get_stats().  */
+static uint64_t rcu_gp_count;
+static uint64_t rcu_gp_total_ns;
+
 void synchronize_rcu(void)
 {
+    int64_t start = get_clock();
+
     QEMU_LOCK_GUARD(&rcu_sync_lock);
 
     /* Write RCU-protected pointers before reading p_rcu_reader->ctr.
@@ -171,6 +178,10 @@ void synchronize_rcu(void)
 
         wait_for_readers();
     }
+
+    qatomic_set(&rcu_gp_count, rcu_gp_count + 1);
+    qatomic_set__nocheck(&rcu_gp_total_ns,
+                         rcu_gp_total_ns + get_clock() - start);
 }
 
 
@@ -267,6 +278,14 @@ static void *call_rcu_thread(void *opaque)
          * added before synchronize_rcu() starts.
          */
         while (n == 0 || (n < RCU_CALL_MIN_SIZE && ++tries <= 5)) {
+            /*
+             * Batching serves throughput, but a thread blocked in
+             * drain_call_rcu() only cares about latency: start the
+             * grace period as soon as its callback is in the queue.
+             */
+            if (n > 0 && qatomic_read(&in_drain_call_rcu)) {
+                break;
+            }
             g_usleep(10000);
             if (n == 0) {
                 qemu_event_reset(&rcu_call_ready_event);
@@ -313,6 +332,13 @@ void call_rcu1(struct rcu_head *node, void (*func)(struct rcu_head *node))
     qemu_event_set(&rcu_call_ready_event);
 }
 
+void rcu_get_stats(uint64_t *gp_count, uint64_t *gp_total_ns, int64_t *pending)
+{
+    *gp_count = qatomic_read(&rcu_gp_count);
+    *gp_total_ns = qatomic_read__nocheck(&rcu_gp_total_ns);
+    *pending = qatomic_read(&rcu_call_count);
+}
+
 
 struct rcu_drain {
     struct rcu_head rcu;
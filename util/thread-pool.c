@@ -40,13 +40,13 @@ struct ThreadPoolElement {
     void *arg;
 
     /* Moving state out of THREAD_QUEUED is protected by lock.  After
-     * that, only the worker thread can write to it.  Reads and writes
-     * of state and ret are ordered with memory barriers.
+     * that, only the worker thread can write to it.  The completion
+     * path observes ret through the lock-protected done_list handoff.
      */
     enum ThreadState state;
     int ret;
 
-    /* Access to this list is protected by lock.  */
+    /* Links the element into request_list or done_list; protected by lock. */
     QTAILQ_ENTRY(ThreadPoolElement) reqs;
 
     /* This list is only written by the thread pool's mother thread.  */
@@ -66,6 +66,7 @@ struct ThreadPool {
 
     /* The following variables are protected by lock.  */
     QTAILQ_HEAD(, ThreadPoolElement) request_list;
+    QTAILQ_HEAD(, ThreadPoolElement) done_list;
     int cur_threads;
     int idle_threads;
     int new_threads;     /* backlog of threads we need to create */
@@ -111,12 +112,17 @@ static void *worker_thread(void *opaque)
         ret = req->func(req->arg);
 
         req->ret = ret;
-        /* Write ret before state.  */
-        smp_wmb();
         req->state = THREAD_DONE;
 
-        qemu_bh_schedule(pool->completion_bh);
+        /*
+         * Hand the element over on the done list instead of letting the
+         * completion handler scan all outstanding requests.  The BH is
+         * scheduled once per burst of completions: rescheduling an
+         * already-pending BH is a cheap atomic no-op.
+         */
         qemu_mutex_lock(&pool->lock);
+        QTAILQ_INSERT_TAIL(&pool->done_list, req, reqs);
+        qemu_bh_schedule(pool->completion_bh);
     }
 
     pool->cur_threads--;
@@ -174,14 +180,20 @@ static void spawn_thread(ThreadPool *pool)
 static void thread_pool_completion_bh(void *opaque)
 {
     ThreadPool *pool = opaque;
-    ThreadPoolElement *elem, *next;
+    ThreadPoolElement *elem;
 
     defer_call_begin(); /* cb() may use defer_call() to coalesce work */
 
-restart:
-    QLIST_FOREACH_SAFE(elem, &pool->head, all, next) {
-        if (elem->state != THREAD_DONE) {
-            continue;
+    for (;;) {
+        qemu_mutex_lock(&pool->lock);
+        elem = QTAILQ_FIRST(&pool->done_list);
+        if (elem) {
+            QTAILQ_REMOVE(&pool->done_list, elem, reqs);
+        }
+        qemu_mutex_unlock(&pool->lock);
+
+        if (!elem) {
+            break;
         }
 
         trace_thread_pool_complete(pool, elem, elem->common.opaque,
@@ -189,9 +201,6 @@ restart:
         QLIST_REMOVE(elem, all);
 
         if (elem->common.cb) {
-            /* Read state before ret.  */
-            smp_rmb();
-
             /* Schedule ourselves in case elem->common.cb() calls aio_poll() to
              * wait for another request that completed at the same time.
              */
@@ -201,15 +210,11 @@ restart:
 
             /* We can safely cancel the completion_bh here regardless of someone
              * else having scheduled it meanwhile because we reenter the
-             * completion function anyway (goto restart).
+             * completion function anyway (the loop continues).
              */
             qemu_bh_cancel(pool->completion_bh);
-
-            qemu_aio_unref(elem);
-            goto restart;
-        } else {
-            qemu_aio_unref(elem);
         }
+        qemu_aio_unref(elem);
     }
 
     defer_call_end();
@@ -225,10 +230,11 @@ static void thread_pool_cancel(BlockAIOCB *acb)
     QEMU_LOCK_GUARD(&pool->lock);
     if (elem->state == THREAD_QUEUED) {
         QTAILQ_REMOVE(&pool->request_list, elem, reqs);
-        qemu_bh_schedule(pool->completion_bh);
 
         elem->state = THREAD_DONE;
         elem->ret = -ECANCELED;
+        QTAILQ_INSERT_TAIL(&pool->done_list, elem, reqs);
+        qemu_bh_schedule(pool->completion_bh);
     }
 
 }
@@ -244,6 +250,7 @@ BlockAIOCB *thread_pool_submit_aio(ThreadPoolFunc *func, void *arg,
     ThreadPoolElement *req;
     AioContext *ctx = qemu_get_current_aio_context();
     ThreadPool *pool = aio_get_thread_pool(ctx);
+    bool need_signal;
 
     /* Assert that the thread submitting work is the same running the pool */
     assert(pool->ctx == qemu_get_current_aio_context());
@@ -263,8 +270,17 @@ BlockAIOCB *thread_pool_submit_aio(ThreadPoolFunc *func, void *arg,
         spawn_thread(pool);
     }
     QTAILQ_INSERT_TAIL(&pool->request_list, req, reqs);
+    /*
+     * Only poke the condvar when somebody is waiting on it.  Busy
+     * workers recheck the request list under the lock before going
+     * idle, so no wakeup can be lost, and the submission fast path
+     * saves a futex syscall per request.
+     */
+    need_signal = pool->idle_threads > 0;
     qemu_mutex_unlock(&pool->lock);
-    qemu_cond_signal(&pool->request_cond);
+    if (need_signal) {
+        qemu_cond_signal(&pool->request_cond);
+    }
     return &req->common;
 }
 
@@ -338,6 +354,7 @@ static void thread_pool_init_one(ThreadPool *pool, AioContext *ctx)
 
     QLIST_INIT(&pool->head);
     QTAILQ_INIT(&pool->request_list);
+    QTAILQ_INIT(&pool->done_list);
 
     thread_pool_update_params(pool, ctx);
 }
@@ -397,17 +397,40 @@ void throttle_config(ThrottleState *ts,
                      QEMUClockType clock_type,
                      ThrottleConfig *cfg)
 {
+    int64_t now = qemu_clock_get_ns(clock_type);
     int i;
 
-    ts->cfg = *cfg;
+    /*
+     * Bring the bucket levels up to date under the old configuration
+     * and carry them over, so that changing the limits at runtime
+     * neither grants a fresh burst allowance nor forgives debt that
+     * the guest has already accumulated.  The levels are clamped to
+     * the new bucket sizes in case the limits were lowered.
+     */
+    throttle_do_leak(ts, now);
 
-    /* Zero bucket level */
     for (i = 0; i < BUCKETS_COUNT; i++) {
-        ts->cfg.buckets[i].level = 0;
-        ts->cfg.buckets[i].burst_level = 0;
+        double level = ts->cfg.buckets[i].level;
+        double burst_level = ts->cfg.buckets[i].burst_level;
+        LeakyBucket *bkt;
+        double bucket_size, burst_bucket_size;
+
+        ts->cfg.buckets[i] = cfg->buckets[i];
+        bkt = &ts->cfg.buckets[i];
+
+        if (bkt->max) {
+            bucket_size = (double) bkt->max * bkt->burst_length;
+            burst_bucket_size = (double) bkt->max / 10;
+        } else {
+            bucket_size = (double) bkt->avg / 10;
+            burst_bucket_size = 0;
+        }
+        bkt->level = MIN(level, bucket_size);
+        bkt->burst_level = MIN(burst_level, burst_bucket_size);
     }
 
-    ts->previous_leak = qemu_clock_get_ns(clock_type);
+    ts->cfg.op_size = cfg->op_size;
+    ts->previous_leak = now;
 }
 
 /* used to get config
@@ -27,7 +27,19 @@
  * protocol messages over the UNIX domain socket.
  *
  * When virtqueues are set up libvhost-user calls set_watch() to monitor kick
- * fds. These fds are also handled in the VuServer->ctx AioContext.
+ * fds. These fds are handled in the VuServer->ctx AioContext by default.
+ * vhost_user_server_set_queue_contexts() can assign additional AioContexts
+ * that virtqueue kick fds are spread over round-robin, so that queues are
+ * processed in parallel. Request processing itself then also runs in the
+ * per-queue AioContext because the device implementation spawns coroutines
+ * from the kick handler.
+ *
+ * When queues are processed in multiple AioContexts, vhost-user messages
+ * that change the memory table must not race with virtqueue processing that
+ * dereferences the old mappings. vu_message_read() therefore detaches all
+ * kick fd handlers and waits for in-flight requests to complete before such
+ * a message is handed to libvhost-user, and re-attaches the handlers before
+ * reading the next message.
  *
  * Both vu_client_trip() and kick fd monitoring can be stopped by shutting down
  * the socket connection. Shutting down the socket connection causes
@@ -107,6 +119,106 @@ bool vhost_user_server_has_in_flight(VuServer *server)
     return qatomic_load_acquire(&server->in_flight) > 0;
 }
 
+void vhost_user_server_inc_queue_requests(VuServer *server, unsigned int qidx)
+{
+    if (server->vq_stats && qidx < server->max_queues) {
+        qatomic_inc(&server->vq_stats[qidx].requests);
+    }
+}
+
+void vhost_user_server_get_queue_stats(VuServer *server, unsigned int qidx,
+                                       uint64_t *kicks, uint64_t *requests)
+{
+    assert(server->vq_stats && qidx < server->max_queues);
+
+    *kicks = qatomic_read(&server->vq_stats[qidx].kicks);
+    *requests = qatomic_read(&server->vq_stats[qidx].requests);
+}
+
+/* Return the AioContext in which a kick fd watch should be monitored */
+static AioContext *vu_fd_watch_get_ctx(VuServer *server,
+                                       VuFdWatch *vu_fd_watch)
+{
+    if (vu_fd_watch->qidx >= 0 && server->n_vq_ctx > 0) {
+        return server->vq_ctx[vu_fd_watch->qidx % server->n_vq_ctx];
+    }
+    return server->ctx;
+}
+
+static void kick_handler(void *opaque);
+
+static void vu_fd_watch_attach(VuServer *server, VuFdWatch *vu_fd_watch)
+{
+    AioContext *ctx = vu_fd_watch_get_ctx(server, vu_fd_watch);
+
+    vu_fd_watch->ctx = ctx;
+    aio_set_fd_handler(ctx, vu_fd_watch->fd, kick_handler,
+                       NULL, NULL, NULL, vu_fd_watch);
+}
+
+static void vu_fd_watch_detach(VuServer *server, VuFdWatch *vu_fd_watch)
+{
+    if (vu_fd_watch->ctx) {
+        aio_set_fd_handler(vu_fd_watch->ctx, vu_fd_watch->fd,
+                           NULL, NULL, NULL, NULL, NULL);
+        vu_fd_watch->ctx = NULL;
+    }
+}
+
+static void vu_quiesce_bh(void *opaque)
+{
+    VuServer *server = opaque;
+
+    if (qatomic_fetch_dec(&server->quiesce_pending) == 1) {
+        aio_co_wake(server->co_trip);
+    }
+}
+
+/*
+ * Stop monitoring kick fds and wait for in-flight requests to complete.
+ * Called from the vu_client_trip() coroutine before libvhost-user processes
+ * a message that invalidates guest memory mappings. A bottom half is
+ * bounced through each per-queue AioContext so that a kick handler that was
+ * already running when its fd handler was removed has finished before we
+ * wait for the requests it submitted. The kick fds are re-attached by
+ * vu_message_read() once the message has been processed.
+ */
+static void coroutine_fn vu_quiesce_queues(VuServer *server)
+{
+    VuFdWatch *vu_fd_watch;
+    unsigned int pending = 0;
+
+    QTAILQ_FOREACH(vu_fd_watch, &server->vu_fd_watches, next) {
+        if (vu_fd_watch->ctx) {
+            pending++;
+        }
+    }
+
+    if (pending > 0) {
+        qatomic_set(&server->quiesce_pending, pending);
+
+        QTAILQ_FOREACH(vu_fd_watch, &server->vu_fd_watches, next) {
+            AioContext *ctx = vu_fd_watch->ctx;
+
+            if (!ctx) {
+                continue;
+            }
+            vu_fd_watch_detach(server, vu_fd_watch);
+            aio_bh_schedule_oneshot(ctx, vu_quiesce_bh, server);
+        }
+
+        qemu_coroutine_yield();
+    }
+    server->kicks_detached = true;
+
+    if (vhost_user_server_has_in_flight(server)) {
+        server->wait_idle = true;
+        qemu_coroutine_yield();
+        server->wait_idle = false;
+    }
+    assert(!vhost_user_server_has_in_flight(server));
+}
+
 static bool coroutine_fn
 vu_message_read(VuDev *vu_dev, int conn_fd, VhostUserMsg *vmsg)
 {
@@ -119,6 +231,7 @@ vu_message_read(VuDev *vu_dev, int conn_fd, VhostUserMsg *vmsg)
     const size_t max_fds = G_N_ELEMENTS(vmsg->fds);
     VuServer *server = container_of(vu_dev, VuServer, vu_dev);
     QIOChannel *ioc = server->ioc;
+    VuFdWatch *vu_fd_watch;
 
     vmsg->fd_num = 0;
     if (!ioc) {
@@ -127,6 +240,15 @@ vu_message_read(VuDev *vu_dev, int conn_fd, VhostUserMsg *vmsg)
     }
 
     assert(qemu_in_coroutine());
+
+    /* The previous message has been processed, resume kick handling */
+    if (server->kicks_detached && server->ctx) {
+        QTAILQ_FOREACH(vu_fd_watch, &server->vu_fd_watches, next) {
+            vu_fd_watch_attach(server, vu_fd_watch);
+        }
+        server->kicks_detached = false;
+    }
+
     do {
         size_t nfds = 0;
         int *fds = NULL;
@@ -199,6 +321,17 @@ vu_message_read(VuDev *vu_dev, int conn_fd, VhostUserMsg *vmsg)
         }
     }
 
+    /*
+     * With per-queue AioContexts, virtqueue processing in other threads
+     * must not use stale memory mappings while this message is applied.
+     */
+    if (server->n_vq_ctx > 0 &&
+        (vmsg->request == VHOST_USER_SET_MEM_TABLE ||
+         vmsg->request == VHOST_USER_ADD_MEM_REG ||
+         vmsg->request == VHOST_USER_REM_MEM_REG)) {
+        vu_quiesce_queues(server);
+    }
+
     return true;
 
 fail:
@@ -261,13 +394,16 @@ static void kick_handler(void *opaque)
 {
     VuFdWatch *vu_fd_watch = opaque;
     VuDev *vu_dev = vu_fd_watch->vu_dev;
+    VuServer *server = container_of(vu_dev, VuServer, vu_dev);
+
+    if (vu_fd_watch->qidx >= 0 && server->vq_stats) {
+        qatomic_inc(&server->vq_stats[vu_fd_watch->qidx].kicks);
+    }
 
     vu_fd_watch->cb(vu_dev, 0, vu_fd_watch->pvt);
 
     /* Stop vu_client_trip() if an error occurred in vu_fd_watch->cb() */
     if (vu_dev->broken) {
-        VuServer *server = container_of(vu_dev, VuServer, vu_dev);
-
         qio_channel_shutdown(server->ioc, QIO_CHANNEL_SHUTDOWN_BOTH, NULL);
     }
 }
@@ -284,6 +420,19 @@ static VuFdWatch *find_vu_fd_watch(VuServer *server, int fd)
     return NULL;
 }
 
+/* Return the index of the virtqueue whose kick fd is fd, or -1 */
+static int find_vu_fd_watch_qidx(VuDev *vu_dev, int fd)
+{
+    int i;
+
+    for (i = 0; i < vu_dev->max_queues; i++) {
+        if (vu_get_queue(vu_dev, i)->kick_fd == fd) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 static void
 set_watch(VuDev *vu_dev, int fd, int vu_evt,
           vu_watch_cb cb, void *pvt)
@@ -302,12 +451,12 @@ set_watch(VuDev *vu_dev, int fd, int vu_evt,
         QTAILQ_INSERT_TAIL(&server->vu_fd_watches, vu_fd_watch, next);
 
         vu_fd_watch->fd = fd;
+        vu_fd_watch->qidx = find_vu_fd_watch_qidx(vu_dev, fd);
         vu_fd_watch->cb = cb;
-        qemu_socket_set_nonblock(fd);
-        aio_set_fd_handler(server->ctx, fd, kick_handler,
-                           NULL, NULL, NULL, vu_fd_watch);
         vu_fd_watch->vu_dev = vu_dev;
         vu_fd_watch->pvt = pvt;
+        qemu_socket_set_nonblock(fd);
+        vu_fd_watch_attach(server, vu_fd_watch);
     }
 }
 
@@ -325,7 +474,7 @@ static void remove_watch(VuDev *vu_dev, int fd)
     if (!vu_fd_watch) {
         return;
     }
-    aio_set_fd_handler(server->ctx, fd, NULL, NULL, NULL, NULL, NULL);
+    vu_fd_watch_detach(server, vu_fd_watch);
 
     QTAILQ_REMOVE(&server->vu_fd_watches, vu_fd_watch, next);
     g_free(vu_fd_watch);
@@ -385,8 +534,7 @@ void vhost_user_server_stop(VuServer *server)
         VuFdWatch *vu_fd_watch;
 
         QTAILQ_FOREACH(vu_fd_watch, &server->vu_fd_watches, next) {
-            aio_set_fd_handler(server->ctx, vu_fd_watch->fd,
-                               NULL, NULL, NULL, NULL, vu_fd_watch);
+            vu_fd_watch_detach(server, vu_fd_watch);
         }
 
         qio_channel_shutdown(server->ioc, QIO_CHANNEL_SHUTDOWN_BOTH, NULL);
@@ -398,6 +546,28 @@ void vhost_user_server_stop(VuServer *server)
         qio_net_listener_disconnect(server->listener);
         object_unref(OBJECT(server->listener));
     }
+
+    g_free(server->vq_ctx);
+    server->vq_ctx = NULL;
+    server->n_vq_ctx = 0;
+    g_free(server->vq_stats);
+    server->vq_stats = NULL;
+}
+
+/*
+ * Spread virtqueue kick handling over the given AioContexts, assigned
+ * round-robin per queue index. Must be called before a client connects so
+ * that no kick fds are being monitored yet. Queues keep being processed in
+ * the server's own AioContext when no contexts are assigned.
+ */
+void vhost_user_server_set_queue_contexts(VuServer *server,
+                                          AioContext **ctx, unsigned int n)
+{
+    assert(!server->sioc);
+
+    g_free(server->vq_ctx);
+    server->vq_ctx = n ? g_memdup2(ctx, n * sizeof(*ctx)) : NULL;
+    server->n_vq_ctx = n;
 }
 
 /*
@@ -424,9 +594,9 @@ void vhost_user_server_attach_aio_context(VuServer *server, AioContext *ctx)
     }
 
     QTAILQ_FOREACH(vu_fd_watch, &server->vu_fd_watches, next) {
-        aio_set_fd_handler(ctx, vu_fd_watch->fd, kick_handler, NULL,
-                           NULL, NULL, vu_fd_watch);
+        vu_fd_watch_attach(server, vu_fd_watch);
     }
+    server->kicks_detached = false;
 
     if (server->co_trip) {
         /*
@@ -456,8 +626,7 @@ void vhost_user_server_detach_aio_context(VuServer *server)
         VuFdWatch *vu_fd_watch;
 
         QTAILQ_FOREACH(vu_fd_watch, &server->vu_fd_watches, next) {
-            aio_set_fd_handler(server->ctx, vu_fd_watch->fd,
-                               NULL, NULL, NULL, NULL, vu_fd_watch);
+            vu_fd_watch_detach(server, vu_fd_watch);
         }
     }
 
@@ -503,6 +672,7 @@ bool vhost_user_server_start(VuServer *server,
         .vu_iface              = vu_iface,
         .max_queues            = max_queues,
         .ctx                   = ctx,
+        .vq_stats              = g_new0(VuQueueStats, max_queues),
     };
 
     qio_net_listener_set_name(server->listener, "vhost-user-backend-listener");